@@ -194,6 +194,22 @@ if(NOT MSVC)
   )
   set(ENABLE_AVX2 ${HAVE_AVX2})
 
+  # Check for AVX-512F intrinsics.
+  set(AVX512_CXXFLAGS -mavx -mavx2 -mavx512f)
+  check_cxx_source_compiles_with_flags("
+    #include <immintrin.h>
+
+    int main()
+    {
+      __m512i l = _mm512_set1_epi32(1);
+      __m512i r = _mm512_ternarylogic_epi32(_mm512_ror_epi32(l, 7), l, l, 0x96);
+      return _mm_extract_epi32(_mm512_castsi512_si128(r), 0);
+    }
+    " HAVE_AVX512
+    CXXFLAGS ${AVX512_CXXFLAGS}
+  )
+  set(ENABLE_AVX512 ${HAVE_AVX512})
+
   # Check for x86 SHA-NI intrinsics.
   set(X86_SHANI_CXXFLAGS -msse4 -msha)
   check_cxx_source_compiles_with_flags("
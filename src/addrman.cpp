@@ -11,6 +11,7 @@
 #include <hash.h>
 #include <logging.h>
 #include <logging/timer.h>
+#include <memusage.h>
 #include <netaddress.h>
 #include <protocol.h>
 #include <random.h>
@@ -1174,6 +1175,13 @@ size_t AddrManImpl::Size(std::optional<Network> net, std::optional<bool> in_new)
     return ret;
 }
 
+size_t AddrManImpl::DynamicMemoryUsage() const
+{
+    LOCK(cs);
+    // AddrManImpl itself is heap allocated, and holds the bucket tables.
+    return memusage::MallocUsage(sizeof(AddrManImpl)) + memusage::DynamicUsage(mapInfo) + memusage::DynamicUsage(mapAddr) + memusage::DynamicUsage(vRandom);
+}
+
 bool AddrManImpl::Add(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
 {
     LOCK(cs);
@@ -1299,6 +1307,11 @@ size_t AddrMan::Size(std::optional<Network> net, std::optional<bool> in_new) con
     return m_impl->Size(net, in_new);
 }
 
+size_t AddrMan::DynamicMemoryUsage() const
+{
+    return m_impl->DynamicMemoryUsage();
+}
+
 bool AddrMan::Add(const std::vector<CAddress>& vAddr, const CNetAddr& source, std::chrono::seconds time_penalty)
 {
     return m_impl->Add(vAddr, source, time_penalty);
@@ -110,6 +110,9 @@ public:
     */
     size_t Size(std::optional<Network> net = std::nullopt, std::optional<bool> in_new = std::nullopt) const;
 
+    //! Approximate memory used by addrman, including its bucket tables, in bytes.
+    size_t DynamicMemoryUsage() const;
+
     /**
      * Attempt to add one or more addresses to addrman's new table.
      * If an address already exists in addrman, the existing entry may be updated
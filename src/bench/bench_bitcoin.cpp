@@ -4,6 +4,7 @@
 
 #include <bench/bench.h>
 #include <common/args.h>
+#include <crypto/muhash.h>
 #include <crypto/sha256.h>
 #include <tinyformat.h>
 #include <util/fs.h>
@@ -79,6 +80,7 @@ int main(int argc, char** argv)
     ArgsManager argsman;
     SetupBenchArgs(argsman);
     SHA256AutoDetect();
+    Num3072AutoDetect();
     std::string error;
     if (!argsman.ParseParameters(argc, argv, error)) {
         tfm::format(std::cerr, "Error parsing command line arguments: %s\n", error);
@@ -8,10 +8,12 @@
 #include <key.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <random.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
 #include <test/util/transaction_utils.h>
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -54,4 +56,33 @@ static void CCoinsCaching(benchmark::Bench& bench)
     });
 }
 
+// Pull a block-sized batch of coins from a large parent cache into a child
+// cache and spend them, as connecting a block does.
+static void CCoinsViewCacheFetchSpend(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CCoinsView coins_dummy;
+    CCoinsViewCache base{&coins_dummy, /*deterministic=*/true};
+    std::vector<COutPoint> outpoints;
+    for (uint32_t i = 0; i < 500'000; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), i % 4);
+        Coin coin;
+        coin.out.nValue = COIN;
+        coin.out.scriptPubKey.assign(uint32_t{25}, 1);
+        coin.nHeight = 1;
+        base.AddCoin(outpoints.back(), std::move(coin), /*possible_overwrite=*/false);
+    }
+    std::shuffle(outpoints.begin(), outpoints.end(), rng);
+    outpoints.resize(5'000);
+
+    bench.batch(outpoints.size()).unit("coin").run([&] {
+        CCoinsViewCache cache{&base, /*deterministic=*/true};
+        for (const COutPoint& outpoint : outpoints) {
+            bool success{cache.SpendCoin(outpoint)};
+            assert(success);
+        }
+    });
+}
+
 BENCHMARK(CCoinsCaching, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CCoinsViewCacheFetchSpend, benchmark::PriorityLevel::HIGH);
@@ -8,6 +8,7 @@
 #include <common/args.h>
 #include <consensus/validation.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
 #include <span.h>
@@ -39,6 +40,47 @@ static void DeserializeBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeBlockArenaTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::block413567);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    bench.unit("block").run([&] {
+        CBlock block;
+        UnserializeBlockInArena(stream, block, TX_WITH_WITNESS);
+        bool rewound = stream.Rewind(benchmark::data::block413567.size());
+        assert(rewound);
+    });
+}
+
+// What getblock with verbosity 1 needs: the txids and sizes of a block read
+// from disk. Deserializing computes txids as a side effect.
+static void ParseBlockViewTest(benchmark::Bench& bench)
+{
+    const Span<const std::byte> data{benchmark::data::block413567};
+
+    bench.unit("block").run([&] {
+        const BlockView block{data};
+        for (const TxView& tx : block.Transactions()) {
+            ankerl::nanobench::doNotOptimizeAway(tx.GetHash());
+        }
+        ankerl::nanobench::doNotOptimizeAway(block.GetWeight());
+    });
+}
+
+// How ReadBlock deserializes blocks: like DeserializeBlockTest, but with all
+// txids and wtxids of the block computed in one multi-buffer SHA256 batch.
+static void DeserializeBlockBatchHashedTest(benchmark::Bench& bench)
+{
+    const Span<const std::byte> data{benchmark::data::block413567};
+
+    bench.unit("block").run([&] {
+        const CBlock block{DeserializeBlockBatchHashed(data)};
+        assert(!block.vtx.empty());
+    });
+}
+
 static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
 {
     DataStream stream(benchmark::data::block413567);
@@ -60,5 +102,30 @@ static void DeserializeAndCheckBlockTest(benchmark::Bench& bench)
     });
 }
 
+static void DeserializeAndCheckBlockArenaTest(benchmark::Bench& bench)
+{
+    DataStream stream(benchmark::data::block413567);
+    std::byte a{0};
+    stream.write({&a, 1}); // Prevent compaction
+
+    ArgsManager bench_args;
+    const auto chainParams = CreateChainParams(bench_args, ChainType::MAIN);
+
+    bench.unit("block").run([&] {
+        CBlock block; // Note that CBlock caches its checked state, so we need to recreate it here
+        UnserializeBlockInArena(stream, block, TX_WITH_WITNESS);
+        bool rewound = stream.Rewind(benchmark::data::block413567.size());
+        assert(rewound);
+
+        BlockValidationState validationState;
+        bool checked = CheckBlock(block, validationState, chainParams->GetConsensus());
+        assert(checked);
+    });
+}
+
 BENCHMARK(DeserializeBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockArenaTest, benchmark::PriorityLevel::HIGH);
 BENCHMARK(DeserializeAndCheckBlockTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeAndCheckBlockArenaTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ParseBlockViewTest, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockBatchHashedTest, benchmark::PriorityLevel::HIGH);
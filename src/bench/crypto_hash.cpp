@@ -11,6 +11,7 @@
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
 #include <crypto/siphash.h>
+#include <hash.h>
 #include <random.h>
 #include <span.h>
 #include <tinyformat.h>
@@ -171,6 +172,16 @@ static void SHA256D64_1024_AVX2(benchmark::Bench& bench)
     SHA256AutoDetect();
 }
 
+static void SHA256D64_1024_AVX512(benchmark::Bench& bench)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_AVX512)));
+    std::vector<uint8_t> in(64 * 1024, 0);
+    bench.batch(in.size()).unit("byte").run([&] {
+        SHA256D64(in.data(), in.data(), 1024);
+    });
+    SHA256AutoDetect();
+}
+
 static void SHA256D64_1024_SHANI(benchmark::Bench& bench)
 {
     bench.name(strprintf("%s using the '%s' SHA256 implementation", __func__, SHA256AutoDetect(sha256_implementation::USE_SSE4_AND_SHANI)));
@@ -190,6 +201,28 @@ static void SHA512(benchmark::Bench& bench)
     });
 }
 
+// 1000 compressed public keys, hashed one by one as when deriving addresses.
+static void Hash160_33b(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<unsigned char>> keys(1000);
+    for (auto& key : keys) key = rng.randbytes(33);
+    bench.batch(keys.size()).unit("key").run([&] {
+        for (const auto& key : keys) ankerl::nanobench::doNotOptimizeAway(Hash160(key));
+    });
+}
+
+static void Hash160Many_33b(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<unsigned char>> keys(1000);
+    for (auto& key : keys) key = rng.randbytes(33);
+    const std::vector<Span<const unsigned char>> inputs(keys.begin(), keys.end());
+    bench.batch(keys.size()).unit("key").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(Hash160Many(inputs));
+    });
+}
+
 static void SipHash_32b(benchmark::Bench& bench)
 {
     FastRandomContext rng{/*fDeterministic=*/true};
@@ -205,6 +238,25 @@ static void SipHash_32b(benchmark::Bench& bench)
     });
 }
 
+static void SipHashUint256ExtraMany_64(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto k0{rng.rand64()}, k1{rng.rand64()};
+    std::vector<uint256> vals;
+    std::vector<uint32_t> extras;
+    for (int i = 0; i < 64; ++i) {
+        vals.push_back(rng.rand256());
+        extras.push_back(rng.rand32());
+    }
+    std::vector<const uint256*> ptrs;
+    for (const uint256& val : vals) ptrs.push_back(&val);
+    std::vector<uint64_t> out(vals.size());
+    bench.batch(vals.size()).unit("hash").run([&] {
+        SipHashUint256ExtraMany(k0, k1, ptrs, extras, out.data());
+        ankerl::nanobench::doNotOptimizeAway(out);
+    });
+}
+
 static void MuHash(benchmark::Bench& bench)
 {
     MuHash3072 acc;
@@ -227,6 +279,23 @@ static void MuHashMul(benchmark::Bench& bench)
     });
 }
 
+static void MuHashMulWith(benchmark::Bench& bench, const char* name, muhash_implementation::UseImplementation impl)
+{
+    bench.name(strprintf("%s using the '%s' Num3072 implementation", name, Num3072AutoDetect(impl)));
+    MuHash3072 acc;
+    FastRandomContext rng(true);
+    MuHash3072 muhash{rng.randbytes(32)};
+
+    bench.run([&] {
+        acc *= muhash;
+    });
+    Num3072AutoDetect();
+}
+
+static void MuHashMul_STANDARD(benchmark::Bench& bench) { MuHashMulWith(bench, __func__, muhash_implementation::STANDARD); }
+static void MuHashMul_SOLINAS(benchmark::Bench& bench) { MuHashMulWith(bench, __func__, muhash_implementation::USE_SOLINAS); }
+static void MuHashMul_MULX_ADX(benchmark::Bench& bench) { MuHashMulWith(bench, __func__, muhash_implementation::USE_ALL); }
+
 static void MuHashDiv(benchmark::Bench& bench)
 {
     MuHash3072 acc;
@@ -262,6 +331,29 @@ static void MuHashFinalize(benchmark::Bench& bench)
     });
 }
 
+static void MuHashInsert_60b(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    std::vector<std::vector<unsigned char>> coins(1000);
+    for (auto& coin : coins) coin = rng.randbytes(60);
+    MuHash3072 acc;
+    bench.batch(coins.size()).unit("coin").run([&] {
+        for (const auto& coin : coins) acc.Insert(coin);
+    });
+}
+
+static void MuHashInsertMany_60b(benchmark::Bench& bench)
+{
+    FastRandomContext rng(true);
+    std::vector<std::vector<unsigned char>> coins(1000);
+    for (auto& coin : coins) coin = rng.randbytes(60);
+    const std::vector<Span<const unsigned char>> inputs(coins.begin(), coins.end());
+    MuHash3072 acc;
+    bench.batch(coins.size()).unit("coin").run([&] {
+        acc.InsertMany(inputs);
+    });
+}
+
 BENCHMARK(BenchRIPEMD160, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA1, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_STANDARD, benchmark::PriorityLevel::HIGH);
@@ -276,13 +368,22 @@ BENCHMARK(SHA256_32b_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_AVX2, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256_32b_SHANI, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SipHash_32b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SipHashUint256ExtraMany_64, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160_33b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(Hash160Many_33b, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_STANDARD, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SSE4, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(SHA256D64_1024_AVX512, benchmark::PriorityLevel::HIGH);
 BENCHMARK(SHA256D64_1024_SHANI, benchmark::PriorityLevel::HIGH);
 
 BENCHMARK(MuHash, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashMul, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashMul_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashMul_SOLINAS, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashMul_MULX_ADX, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashDiv, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashPrecompute, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MuHashFinalize, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashInsert_60b, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MuHashInsertMany_60b, benchmark::PriorityLevel::HIGH);
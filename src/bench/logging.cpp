@@ -14,8 +14,12 @@
 // LogWithoutDebug should be ~3 orders of magnitude faster, as nothing is logged.
 //
 // LogWithoutWriteToFile should be ~2 orders of magnitude faster, as it avoids disk writes.
+//
+// The *Async benchmarks only measure the cost to the caller: taking the
+// timestamp and queueing the line. The background thread can't keep up with
+// the benchmark loop, so most lines end up being dropped.
 
-static void Logging(benchmark::Bench& bench, const std::vector<const char*>& extra_args, const std::function<void()>& log)
+static void Logging(benchmark::Bench& bench, const std::vector<const char*>& extra_args, const std::function<void()>& log, bool async = false)
 {
     // Reset any enabled logging categories from a previous benchmark run.
     LogInstance().DisableCategory(BCLog::LogFlags::ALL);
@@ -25,7 +29,9 @@ static void Logging(benchmark::Bench& bench, const std::vector<const char*>& ext
         {.extra_args = extra_args},
     };
 
+    if (async) LogInstance().StartAsyncLogging();
     bench.run([&] { log(); });
+    LogInstance().StopAsyncLogging();
 }
 
 static void LogWithDebug(benchmark::Bench& bench)
@@ -33,6 +39,11 @@ static void LogWithDebug(benchmark::Bench& bench)
     Logging(bench, {"-logthreadnames=0", "-debug=net"}, [] { LogDebug(BCLog::NET, "%s\n", "test"); });
 }
 
+static void LogWithDebugAsync(benchmark::Bench& bench)
+{
+    Logging(bench, {"-logthreadnames=0", "-debug=net"}, [] { LogDebug(BCLog::NET, "%s\n", "test"); }, /*async=*/true);
+}
+
 static void LogWithoutDebug(benchmark::Bench& bench)
 {
     Logging(bench, {"-logthreadnames=0", "-debug=0"}, [] { LogDebug(BCLog::NET, "%s\n", "test"); });
@@ -48,6 +59,11 @@ static void LogWithoutThreadNames(benchmark::Bench& bench)
     Logging(bench, {"-logthreadnames=0"}, [] { LogInfo("%s\n", "test"); });
 }
 
+static void LogWithThreadNamesAsync(benchmark::Bench& bench)
+{
+    Logging(bench, {"-logthreadnames=1"}, [] { LogInfo("%s\n", "test"); }, /*async=*/true);
+}
+
 static void LogWithoutWriteToFile(benchmark::Bench& bench)
 {
     // Disable writing the log to a file, as used for unit tests and fuzzing in `MakeNoLogFileContext`.
@@ -58,7 +74,9 @@ static void LogWithoutWriteToFile(benchmark::Bench& bench)
 }
 
 BENCHMARK(LogWithDebug, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LogWithDebugAsync, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithoutDebug, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithThreadNames, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithoutThreadNames, benchmark::PriorityLevel::HIGH);
+BENCHMARK(LogWithThreadNamesAsync, benchmark::PriorityLevel::HIGH);
 BENCHMARK(LogWithoutWriteToFile, benchmark::PriorityLevel::HIGH);
@@ -11,6 +11,7 @@
 #include <sync.h>
 #include <test/util/setup_common.h>
 #include <test/util/txmempool.h>
+#include <test/util/workload.h>
 #include <txmempool.h>
 #include <validation.h>
 
@@ -126,5 +127,22 @@ static void MempoolCheck(benchmark::Bench& bench)
     });
 }
 
+static void MempoolClusterShapes(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN);
+    WorkloadGenerator generator;
+    const Workload workload{generator.Mempool({.vsize = 1'000'000})};
+    CTxMemPool& pool = *testing_setup.get()->m_node.mempool;
+    LOCK2(cs_main, pool.cs);
+    bench.run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        for (size_t i = 0; i < workload.txs.size(); ++i) {
+            AddToMempool(pool, TestMemPoolEntryHelper{}.Fee(workload.fees[i]).FromTx(workload.txs[i]));
+        }
+        pool.TrimToSize(pool.DynamicMemoryUsage() / 2);
+        pool.TrimToSize(0);
+    });
+}
+
 BENCHMARK(ComplexMemPool, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolClusterShapes, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MempoolCheck, benchmark::PriorityLevel::HIGH);
@@ -4,7 +4,9 @@
 
 #include <bench/bench.h>
 #include <consensus/merkle.h>
+#include <crypto/sha256.h>
 #include <random.h>
+#include <tinyformat.h>
 #include <uint256.h>
 
 #include <vector>
@@ -24,4 +26,32 @@ static void MerkleRoot(benchmark::Bench& bench)
     });
 }
 
+/** Merkle root of a block-sized tree, using the given SHA256D64 implementation. */
+static void MerkleRootWith(benchmark::Bench& bench, const char* name, sha256_implementation::UseImplementation impl)
+{
+    bench.name(strprintf("%s using the '%s' SHA256 implementation", name, SHA256AutoDetect(impl)));
+    FastRandomContext rng(true);
+    std::vector<uint256> leaves(3000);
+    for (auto& item : leaves) {
+        item = rng.rand256();
+    }
+    bench.batch(leaves.size()).unit("leaf").run([&] {
+        bool mutation = false;
+        uint256 hash = ComputeMerkleRoot(std::vector<uint256>(leaves), &mutation);
+        leaves[mutation] = hash;
+    });
+    SHA256AutoDetect();
+}
+
+static void MerkleRoot_STANDARD(benchmark::Bench& bench) { MerkleRootWith(bench, __func__, sha256_implementation::STANDARD); }
+static void MerkleRoot_SSE4(benchmark::Bench& bench) { MerkleRootWith(bench, __func__, sha256_implementation::USE_SSE4); }
+static void MerkleRoot_AVX2(benchmark::Bench& bench) { MerkleRootWith(bench, __func__, sha256_implementation::USE_SSE4_AND_AVX2); }
+static void MerkleRoot_AVX512(benchmark::Bench& bench) { MerkleRootWith(bench, __func__, sha256_implementation::USE_SSE4_AND_AVX512); }
+static void MerkleRoot_SHANI(benchmark::Bench& bench) { MerkleRootWith(bench, __func__, sha256_implementation::USE_SSE4_AND_SHANI); }
+
 BENCHMARK(MerkleRoot, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MerkleRoot_STANDARD, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MerkleRoot_SSE4, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MerkleRoot_AVX2, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MerkleRoot_AVX512, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MerkleRoot_SHANI, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,115 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <serialize.h>
+#include <streams.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+static constexpr size_t NUM_HEADERS{2000};
+static constexpr size_t NUM_OUTPOINTS{5000};
+
+static DataStream SerializedHeaders()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<CBlockHeader> headers(NUM_HEADERS);
+    for (CBlockHeader& header : headers) {
+        header.nVersion = rng.rand32();
+        header.hashPrevBlock = rng.rand256();
+        header.hashMerkleRoot = rng.rand256();
+        header.nTime = rng.rand32();
+        header.nBits = rng.rand32();
+        header.nNonce = rng.rand32();
+    }
+    DataStream stream;
+    stream << headers;
+    return stream;
+}
+
+static DataStream SerializedOutPoints()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<COutPoint> outpoints;
+    for (size_t i = 0; i < NUM_OUTPOINTS; ++i) {
+        outpoints.emplace_back(Txid::FromUint256(rng.rand256()), rng.randrange(100));
+    }
+    DataStream stream;
+    stream << outpoints;
+    return stream;
+}
+
+/** Headers are fixed-layout, so a vector of them is read with one memcpy. */
+static void DeserializeBlockHeaders(benchmark::Bench& bench)
+{
+    const DataStream data{SerializedHeaders()};
+    std::vector<CBlockHeader> headers;
+    bench.batch(NUM_HEADERS).unit("header").run([&] {
+        DataStream stream{data};
+        stream >> headers;
+        assert(headers.size() == NUM_HEADERS);
+    });
+}
+
+/** Baseline for DeserializeBlockHeaders: field by field, as CBlockHeader's SERIALIZE_METHODS do. */
+static void DeserializeBlockHeadersMemberwise(benchmark::Bench& bench)
+{
+    const DataStream data{SerializedHeaders()};
+    std::vector<CBlockHeader> headers;
+    bench.batch(NUM_HEADERS).unit("header").run([&] {
+        DataStream stream{data};
+        headers.resize(ReadCompactSize(stream));
+        for (CBlockHeader& h : headers) {
+            UnserializeMany(stream, h.nVersion, h.hashPrevBlock, h.hashMerkleRoot, h.nTime, h.nBits, h.nNonce);
+        }
+        assert(headers.size() == NUM_HEADERS);
+    });
+}
+
+/** Single headers, as read from the block index and at the start of every block. */
+static void DeserializeBlockHeader(benchmark::Bench& bench)
+{
+    DataStream data{SerializedHeaders()};
+    ReadCompactSize(data);
+    CBlockHeader header;
+    bench.batch(NUM_HEADERS).unit("header").run([&] {
+        SpanReader stream{MakeUCharSpan(data)};
+        for (size_t i = 0; i < NUM_HEADERS; ++i) stream >> header;
+        assert(stream.empty());
+    });
+}
+
+static void DeserializeOutPoints(benchmark::Bench& bench)
+{
+    const DataStream data{SerializedOutPoints()};
+    std::vector<COutPoint> outpoints;
+    bench.batch(NUM_OUTPOINTS).unit("outpoint").run([&] {
+        DataStream stream{data};
+        stream >> outpoints;
+        assert(outpoints.size() == NUM_OUTPOINTS);
+    });
+}
+
+static void DeserializeOutPointsMemberwise(benchmark::Bench& bench)
+{
+    const DataStream data{SerializedOutPoints()};
+    std::vector<COutPoint> outpoints;
+    bench.batch(NUM_OUTPOINTS).unit("outpoint").run([&] {
+        DataStream stream{data};
+        outpoints.resize(ReadCompactSize(stream));
+        for (COutPoint& outpoint : outpoints) UnserializeMany(stream, outpoint.hash, outpoint.n);
+        assert(outpoints.size() == NUM_OUTPOINTS);
+    });
+}
+
+BENCHMARK(DeserializeBlockHeaders, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockHeadersMemberwise, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeBlockHeader, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeOutPoints, benchmark::PriorityLevel::HIGH);
+BENCHMARK(DeserializeOutPointsMemberwise, benchmark::PriorityLevel::HIGH);
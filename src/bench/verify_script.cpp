@@ -3,19 +3,23 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <bench/bench.h>
+#include <coins.h>
 #include <hash.h>
 #include <key.h>
+#include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <pubkey.h>
 #include <script/interpreter.h>
 #include <script/script.h>
 #include <span.h>
 #include <test/util/transaction_utils.h>
+#include <test/util/workload.h>
 #include <uint256.h>
 
 #include <array>
 #include <cassert>
 #include <cstdint>
+#include <map>
 #include <vector>
 
 // Microbenchmark for verification of a basic P2WPKH script. Can be easily
@@ -87,5 +91,40 @@ static void VerifyNestedIfScript(benchmark::Bench& bench)
     });
 }
 
+// Verify every input of a full block of segwit v0 and taproot spends.
+static void VerifyScriptMixedBlock(benchmark::Bench& bench)
+{
+    ECC_Context ecc_context{};
+    WorkloadGenerator generator{uint256::ZERO, /*sign=*/true};
+    const Workload workload{generator.Block()};
+
+    std::map<COutPoint, CTxOut> outputs;
+    for (const auto& [outpoint, coin] : workload.coins) outputs.emplace(outpoint, coin.out);
+    std::vector<PrecomputedTransactionData> txdata(workload.txs.size());
+    size_t num_inputs{0};
+    for (size_t i = 0; i < workload.txs.size(); ++i) {
+        const CTransaction& tx{*workload.txs[i]};
+        std::vector<CTxOut> spent;
+        for (const auto& txin : tx.vin) spent.push_back(outputs.at(txin.prevout));
+        txdata[i].Init(tx, std::move(spent));
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) outputs.emplace(COutPoint{tx.GetHash(), n}, tx.vout[n]);
+        num_inputs += tx.vin.size();
+    }
+
+    bench.unit("input").batch(num_inputs).run([&] {
+        for (size_t i = 0; i < workload.txs.size(); ++i) {
+            const CTransaction& tx{*workload.txs[i]};
+            for (size_t n = 0; n < tx.vin.size(); ++n) {
+                const CTxOut& prevout{txdata[i].m_spent_outputs[n]};
+                ScriptError err;
+                const bool success{VerifyScript(tx.vin[n].scriptSig, prevout.scriptPubKey, &tx.vin[n].scriptWitness, STANDARD_SCRIPT_VERIFY_FLAGS,
+                                                TransactionSignatureChecker(&tx, n, prevout.nValue, txdata[i], MissingDataBehavior::ASSERT_FAIL), &err)};
+                assert(success);
+            }
+        }
+    });
+}
+
 BENCHMARK(VerifyScriptBench, benchmark::PriorityLevel::HIGH);
 BENCHMARK(VerifyNestedIfScript, benchmark::PriorityLevel::HIGH);
+BENCHMARK(VerifyScriptMixedBlock, benchmark::PriorityLevel::LOW);
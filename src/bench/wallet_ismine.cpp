@@ -8,6 +8,7 @@
 #include <bitcoin-build-config.h> // IWYU pragma: keep
 #include <key.h>
 #include <key_io.h>
+#include <outputtype.h>
 #include <script/descriptor.h>
 #include <script/script.h>
 #include <script/signingprovider.h>
@@ -27,7 +28,7 @@
 #include <utility>
 
 namespace wallet {
-static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0)
+static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_combo = 0, bool mine = false)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
 
@@ -60,12 +61,18 @@ static void WalletIsMine(benchmark::Bench& bench, bool legacy_wallet, int num_co
         }
     }
 
-    const CScript script = GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE));
+    CScript script = GetScriptForDestination(DecodeDestination(ADDRESS_BCRT1_UNSPENDABLE));
+    if (mine) {
+        auto dest = wallet->GetNewDestination(OutputType::BECH32, "");
+        assert(dest);
+        script = GetScriptForDestination(*dest);
+    }
+    const isminetype expected = mine ? ISMINE_SPENDABLE : ISMINE_NO;
 
     bench.run([&] {
         LOCK(wallet->cs_wallet);
-        isminetype mine = wallet->IsMine(script);
-        assert(mine == ISMINE_NO);
+        isminetype res = wallet->IsMine(script);
+        assert(res == expected);
     });
 
     TestUnloadWallet(std::move(wallet));
@@ -78,8 +85,12 @@ BENCHMARK(WalletIsMineLegacy, benchmark::PriorityLevel::LOW);
 
 #ifdef USE_SQLITE
 static void WalletIsMineDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false); }
+static void WalletIsMineDescriptorsMine(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/0, /*mine=*/true); }
 static void WalletIsMineMigratedDescriptors(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/2000); }
+static void WalletIsMineMigratedDescriptorsMine(benchmark::Bench& bench) { WalletIsMine(bench, /*legacy_wallet=*/false, /*num_combo=*/2000, /*mine=*/true); }
 BENCHMARK(WalletIsMineDescriptors, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletIsMineDescriptorsMine, benchmark::PriorityLevel::LOW);
 BENCHMARK(WalletIsMineMigratedDescriptors, benchmark::PriorityLevel::LOW);
+BENCHMARK(WalletIsMineMigratedDescriptorsMine, benchmark::PriorityLevel::LOW);
 #endif
 } // namespace wallet
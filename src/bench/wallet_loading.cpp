@@ -9,7 +9,9 @@
 #include <consensus/amount.h>
 #include <outputtype.h>
 #include <primitives/transaction.h>
+#include <script/script.h>
 #include <test/util/setup_common.h>
+#include <test/util/workload.h>
 #include <util/check.h>
 #include <wallet/context.h>
 #include <wallet/db.h>
@@ -33,7 +35,7 @@ static void AddTx(CWallet& wallet)
     wallet.AddToWallet(MakeTransactionRef(mtx), TxStateInactive{});
 }
 
-static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
+static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet, bool large_history = false)
 {
     const auto test_setup = MakeNoLogFileContext<TestingSetup>();
 
@@ -50,9 +52,21 @@ static void WalletLoading(benchmark::Bench& bench, bool legacy_wallet)
     auto database = CreateMockableWalletDatabase();
     auto wallet = TestLoadWallet(std::move(database), context, create_flags);
 
-    // Generate a bunch of transactions and addresses to put into the wallet
-    for (int i = 0; i < 1000; ++i) {
-        AddTx(*wallet);
+    if (large_history) {
+        // Payments to and from a hundred addresses
+        std::vector<CScript> scripts;
+        for (int i = 0; i < 100; ++i) {
+            scripts.push_back(GetScriptForDestination(*Assert(wallet->GetNewDestination(i % 2 ? OutputType::BECH32M : OutputType::BECH32, ""))));
+        }
+        WorkloadGenerator generator;
+        for (const auto& tx : generator.WalletHistory(scripts, {.num_txs = 10'000})) {
+            wallet->AddToWallet(tx, TxStateInactive{});
+        }
+    } else {
+        // Generate a bunch of transactions and addresses to put into the wallet
+        for (int i = 0; i < 1000; ++i) {
+            AddTx(*wallet);
+        }
     }
 
     database = DuplicateMockDatabase(wallet->GetDatabase());
@@ -76,6 +90,8 @@ BENCHMARK(WalletLoadingLegacy, benchmark::PriorityLevel::HIGH);
 
 #ifdef USE_SQLITE
 static void WalletLoadingDescriptors(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false); }
+static void WalletLoadingDescriptorsLargeHistory(benchmark::Bench& bench) { WalletLoading(bench, /*legacy_wallet=*/false, /*large_history=*/true); }
 BENCHMARK(WalletLoadingDescriptors, benchmark::PriorityLevel::HIGH);
+BENCHMARK(WalletLoadingDescriptorsLargeHistory, benchmark::PriorityLevel::LOW);
 #endif
 } // namespace wallet
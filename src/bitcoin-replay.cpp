@@ -0,0 +1,570 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// The bitcoin-replay executable measures end-to-end block connection. It feeds
+// blocks, either read from an existing blocks directory or generated on the
+// fly, through ChainstateManager::ProcessNewBlock into a fresh datadir with
+// fixed cache and thread settings, and prints the results as JSON.
+//
+// Like bitcoin-chainstate, it only depends on libbitcoinkernel and is
+// experimental.
+
+#include <kernel/caches.h>
+#include <kernel/chainparams.h>
+#include <kernel/chainstatemanager_opts.h>
+#include <kernel/checks.h>
+#include <kernel/context.h>
+#include <kernel/notifications_interface.h>
+#include <kernel/validation_profiler.h>
+#include <kernel/warning.h>
+
+#include <consensus/consensus.h>
+#include <consensus/merkle.h>
+#include <consensus/validation.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <node/chainstate.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <streams.h>
+#include <univalue.h>
+#include <util/chaintype.h>
+#include <util/fs.h>
+#include <util/metrics.h>
+#include <util/signalinterrupt.h>
+#include <util/strencodings.h>
+#include <util/task_runner.h>
+#include <util/time.h>
+#include <util/translation.h>
+#include <validation.h>
+#include <validationinterface.h>
+#include <versionbits.h>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+void PrintUsage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " -datadir=<dir> (-blocksdir=<dir> | -synthetic) [options]" << std::endl
+        << "Replay blocks through a fresh chainstate in <dir> and print timings as JSON." << std::endl
+        << std::endl
+        << "  -datadir=<dir>       Empty or non-existent directory for the replayed chainstate" << std::endl
+        << "  -blocksdir=<dir>     Read blocks from the blk?????.dat files in <dir>" << std::endl
+        << "  -chain=<chain>       Chain of the blocks in -blocksdir (default: main)" << std::endl
+        << "  -synthetic           Generate a regtest chain instead of reading one" << std::endl
+        << "  -txs=<n>             Transactions per generated block (default: 200)" << std::endl
+        << "  -blocks=<n>          Number of blocks to measure (default: 1000)" << std::endl
+        << "  -warmup=<n>          Blocks to connect before measuring (default: 0, or " << COINBASE_MATURITY << " with -synthetic)" << std::endl
+        << "  -dbcache=<MiB>       Database cache size (default: " << DEFAULT_KERNEL_CACHE / 1_MiB << ")" << std::endl
+        << "  -par=<n>             Script verification threads (default: 0)" << std::endl
+        << "  -assumevalid=<hash>  Skip script checks for ancestors of <hash> (default: check all)" << std::endl
+        << std::endl
+        << "IMPORTANT: THIS EXECUTABLE IS EXPERIMENTAL, FOR TESTING ONLY, AND EXPECTED TO" << std::endl
+        << "           BREAK IN FUTURE VERSIONS." << std::endl;
+}
+
+/** Produces the blocks to replay, in an order in which they can be connected. */
+class BlockSource
+{
+public:
+    virtual ~BlockSource() = default;
+    //! The next block, or nullptr when there are none left.
+    virtual std::shared_ptr<const CBlock> Next() = 0;
+};
+
+/**
+ * Reads the blocks of a blocks directory in file order. Blocks are stored in
+ * the order they were downloaded, so a block whose parent has not been seen yet
+ * is held back until it has.
+ */
+class BlockFileSource final : public BlockSource
+{
+    const fs::path m_dir;
+    const MessageStartChars m_message_start;
+    const uint256 m_genesis_hash;
+    std::vector<std::byte> m_xor_key;
+    int m_file_num{0};
+    std::optional<AutoFile> m_file;
+    std::map<uint256, std::vector<std::shared_ptr<const CBlock>>> m_unknown_parent;
+    std::deque<std::shared_ptr<const CBlock>> m_ready;
+    std::set<uint256> m_seen;
+
+    std::shared_ptr<const CBlock> ReadFromFile()
+    {
+        while (true) {
+            if (!m_file) {
+                const fs::path path{m_dir / fs::u8path(strprintf("blk%05u.dat", m_file_num))};
+                std::FILE* file{fsbridge::fopen(path, "rb")};
+                if (!file) return nullptr;
+                m_file.emplace(file, m_xor_key);
+                ++m_file_num;
+            }
+            try {
+                MessageStartChars message_start;
+                uint32_t size;
+                *m_file >> message_start >> size;
+                // Block files are preallocated, so the end of the data shows as zeros.
+                if (message_start == m_message_start && size >= 80 && size <= MAX_BLOCK_SERIALIZED_SIZE) {
+                    auto block{std::make_shared<CBlock>()};
+                    *m_file >> TX_WITH_WITNESS(*block);
+                    return block;
+                }
+            } catch (const std::ios_base::failure&) {
+                // End of file
+            }
+            m_file.reset();
+        }
+    }
+
+public:
+    BlockFileSource(fs::path dir, const CChainParams& params)
+        : m_dir{std::move(dir)}, m_message_start{params.MessageStart()}, m_genesis_hash{params.GetConsensus().hashGenesisBlock}
+    {
+        const fs::path xor_path{m_dir / "xor.dat"};
+        if (fs::exists(xor_path)) {
+            std::array<std::byte, 8> xor_key;
+            AutoFile{fsbridge::fopen(xor_path, "rb")} >> xor_key;
+            m_xor_key.assign(xor_key.begin(), xor_key.end());
+        }
+        m_seen.insert(m_genesis_hash);
+    }
+
+    std::shared_ptr<const CBlock> Next() override
+    {
+        while (m_ready.empty()) {
+            auto block{ReadFromFile()};
+            if (!block) return nullptr;
+            const uint256 hash{block->GetHash()};
+            if (hash == m_genesis_hash) continue;
+            if (!m_seen.contains(block->hashPrevBlock)) {
+                m_unknown_parent[block->hashPrevBlock].push_back(std::move(block));
+                continue;
+            }
+            // Queue the block and every held back descendant of it.
+            std::deque<std::shared_ptr<const CBlock>> queue{std::move(block)};
+            while (!queue.empty()) {
+                auto next{std::move(queue.front())};
+                queue.pop_front();
+                const uint256 next_hash{next->GetHash()};
+                m_seen.insert(next_hash);
+                m_ready.push_back(std::move(next));
+                if (auto it{m_unknown_parent.find(next_hash)}; it != m_unknown_parent.end()) {
+                    queue.insert(queue.end(), it->second.begin(), it->second.end());
+                    m_unknown_parent.erase(it);
+                }
+            }
+        }
+        auto block{std::move(m_ready.front())};
+        m_ready.pop_front();
+        return block;
+    }
+};
+
+/**
+ * Generates a regtest chain. Every output is spendable by an empty scriptSig,
+ * so blocks are cheap to build, and the workload is dominated by UTXO lookups
+ * rather than signature checks. Coinbases and transactions fan out into many
+ * outputs, so the UTXO set keeps growing, and transactions spend coins picked
+ * at random from all mature outputs, most of which were created long before,
+ * so their lookups go to the database rather than to recently added entries.
+ */
+class SyntheticSource final : public BlockSource
+{
+    //! Outputs of each coinbase.
+    static constexpr size_t COINBASE_OUTPUTS{100};
+    //! Inputs and outputs of every other transaction.
+    static constexpr size_t TX_INPUTS{2};
+    static constexpr size_t TX_OUTPUTS{5};
+
+    using Output = std::pair<COutPoint, CAmount>;
+
+    const CChainParams& m_params;
+    const size_t m_txs_per_block;
+    uint256 m_prev_hash;
+    uint32_t m_prev_time;
+    int m_height{0};
+    //! Seeded the same on every run, so every run replays the same chain.
+    FastRandomContext m_rng{uint256::ONE};
+    //! Outputs that can be spent, in no particular order.
+    std::vector<Output> m_spendable;
+    //! Outputs of the last COINBASE_MATURITY blocks, one entry per block. They only become
+    //! spendable once the block is buried that deep, so no transaction spends a recent coin.
+    std::deque<std::vector<Output>> m_recent;
+
+    Output TakeRandomSpendable()
+    {
+        const size_t pos{m_rng.randrange(m_spendable.size())};
+        std::swap(m_spendable[pos], m_spendable.back());
+        const Output out{m_spendable.back()};
+        m_spendable.pop_back();
+        return out;
+    }
+
+public:
+    SyntheticSource(const CChainParams& params, size_t txs_per_block)
+        : m_params{params}, m_txs_per_block{txs_per_block},
+          m_prev_hash{params.GenesisBlock().GetHash()}, m_prev_time{params.GenesisBlock().nTime} {}
+
+    std::shared_ptr<const CBlock> Next() override
+    {
+        ++m_height;
+        auto block{std::make_shared<CBlock>()};
+        block->nVersion = VERSIONBITS_TOP_BITS;
+        block->hashPrevBlock = m_prev_hash;
+        block->nTime = ++m_prev_time;
+        block->nBits = m_params.GenesisBlock().nBits;
+
+        const CScript anyone_can_spend{CScript{} << OP_TRUE};
+        const auto add_outputs{[&](CMutableTransaction& tx, CAmount value, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                const CAmount part{value / CAmount(count - i)};
+                tx.vout.emplace_back(part, anyone_can_spend);
+                value -= part;
+            }
+        }};
+        std::vector<Output>& created{m_recent.emplace_back()};
+        const auto add_tx{[&](CMutableTransaction&& tx) {
+            const auto& ref{block->vtx.emplace_back(MakeTransactionRef(std::move(tx)))};
+            for (uint32_t n = 0; n < ref->vout.size(); ++n) {
+                created.emplace_back(COutPoint{ref->GetHash(), n}, ref->vout[n].nValue);
+            }
+        }};
+
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vin[0].scriptSig = CScript{} << m_height << OP_0;
+        add_outputs(coinbase, GetBlockSubsidy(m_height, m_params.GetConsensus()), COINBASE_OUTPUTS);
+        add_tx(std::move(coinbase));
+        if (m_recent.size() > COINBASE_MATURITY) {
+            m_spendable.insert(m_spendable.end(), m_recent.front().begin(), m_recent.front().end());
+            m_recent.pop_front();
+        }
+
+        for (size_t i = 0; i < m_txs_per_block && m_spendable.size() >= TX_INPUTS; ++i) {
+            CMutableTransaction tx;
+            CAmount value{0};
+            for (size_t j = 0; j < TX_INPUTS; ++j) {
+                const auto [prevout, amount]{TakeRandomSpendable()};
+                tx.vin.emplace_back(prevout);
+                value += amount;
+            }
+            add_outputs(tx, value, TX_OUTPUTS);
+            add_tx(std::move(tx));
+        }
+
+        block->hashMerkleRoot = BlockMerkleRoot(*block);
+        while (!CheckProofOfWork(block->GetPoWHash(), block->nBits, m_params.GetConsensus())) ++block->nNonce;
+        m_prev_hash = block->GetHash();
+        return block;
+    }
+};
+
+class ReplayNotifications final : public kernel::Notifications
+{
+public:
+    kernel::InterruptResult blockTip(SynchronizationState, CBlockIndex&) override { return {}; }
+    void headerTip(SynchronizationState, int64_t, int64_t, bool) override {}
+    void progress(const bilingual_str&, int, bool) override {}
+    void warningSet(kernel::Warning, const bilingual_str&) override {}
+    void warningUnset(kernel::Warning) override {}
+    void flushError(const bilingual_str& message) override
+    {
+        std::cerr << "Error flushing block data to disk: " << message.original << std::endl;
+    }
+    void fatalError(const bilingual_str& message) override
+    {
+        std::cerr << "Error: " << message.original << std::endl;
+    }
+};
+
+/** Remembers the first block that failed validation. */
+class InvalidBlockCatcher final : public CValidationInterface
+{
+public:
+    std::optional<std::pair<uint256, BlockValidationState>> m_invalid;
+
+protected:
+    void BlockChecked(const CBlock& block, const BlockValidationState& state) override
+    {
+        if (!state.IsValid() && !m_invalid) m_invalid.emplace(block.GetHash(), state);
+    }
+};
+
+/** Bucket counts and sum of a validation stage histogram at some point in time. */
+struct StageSnapshot {
+    std::vector<uint64_t> counts;
+    uint64_t sum{0};
+
+    explicit StageSnapshot(const metrics::Histogram& histogram)
+        : sum{histogram.Sum()}
+    {
+        for (size_t i = 0; i <= histogram.Bounds().size(); ++i) counts.push_back(histogram.BucketCount(i));
+    }
+};
+
+UniValue StageStats(const metrics::Histogram& histogram, const StageSnapshot& before)
+{
+    const StageSnapshot after{histogram};
+    std::vector<uint64_t> counts(after.counts.size());
+    uint64_t count{0};
+    for (size_t i = 0; i < counts.size(); ++i) count += counts[i] = after.counts[i] - before.counts[i];
+    // Same as Histogram::Quantile, over the measured blocks only.
+    const auto quantile{[&](double q) -> UniValue {
+        if (count == 0) return 0;
+        const auto target{static_cast<uint64_t>(std::ceil(q * count))};
+        uint64_t cumulative{0};
+        for (size_t i = 0; i < histogram.Bounds().size(); ++i) {
+            cumulative += counts[i];
+            if (cumulative >= target) return histogram.Bounds()[i];
+        }
+        return UniValue{};
+    }};
+    const uint64_t total{after.sum - before.sum};
+    UniValue stats{UniValue::VOBJ};
+    stats.pushKV("count", count);
+    stats.pushKV("total_us", total);
+    stats.pushKV("mean_us", count ? total / count : 0);
+    stats.pushKV("p50_us", quantile(0.5));
+    stats.pushKV("p99_us", quantile(0.99));
+    return stats;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    LogInstance().DisableLogging();
+
+    // SETUP: Argument parsing and handling
+    std::map<std::string, std::string, std::less<>> args;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg{argv[i]};
+        if (arg.size() < 2 || arg[0] != '-') {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        const size_t eq{arg.find('=')};
+        args.emplace(arg.substr(1, eq == arg.npos ? arg.npos : eq - 1), eq == arg.npos ? "" : arg.substr(eq + 1));
+    }
+    const auto get_int{[&](std::string_view name, int64_t def) -> std::optional<int64_t> {
+        const auto it{args.find(name)};
+        if (it == args.end()) return def;
+        const auto value{ToIntegral<int64_t>(it->second)};
+        if (!value || *value < 0) std::cerr << "Invalid -" << name << "=" << it->second << std::endl;
+        return value && *value >= 0 ? value : std::nullopt;
+    }};
+
+    const bool synthetic{args.contains("synthetic")};
+    if (!args.contains("datadir") || synthetic == args.contains("blocksdir")) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    const auto txs{get_int("txs", 200)};
+    const auto blocks{get_int("blocks", 1000)};
+    const auto warmup{get_int("warmup", synthetic ? COINBASE_MATURITY : 0)};
+    const auto dbcache{get_int("dbcache", DEFAULT_KERNEL_CACHE / 1_MiB)};
+    const auto par{get_int("par", 0)};
+    if (!txs || !blocks || !warmup || !dbcache || !par) return 1;
+
+    const std::string chain_name{synthetic ? "regtest" : args.contains("chain") ? args.at("chain") : "main"};
+    const auto chain_type{ChainTypeFromString(chain_name)};
+    std::unique_ptr<const CChainParams> chainparams;
+    if (chain_type == ChainType::MAIN) {
+        chainparams = CChainParams::Main();
+    } else if (chain_type == ChainType::TESTNET) {
+        chainparams = CChainParams::TestNet();
+    } else if (chain_type == ChainType::TESTNET4) {
+        chainparams = CChainParams::TestNet4();
+    } else if (chain_type == ChainType::REGTEST) {
+        chainparams = CChainParams::RegTest({});
+    } else {
+        // Signets need their challenge, which can't be passed here.
+        std::cerr << "Unsupported -chain=" << chain_name << std::endl;
+        return 1;
+    }
+
+    std::optional<uint256> assumed_valid{uint256{}};
+    if (args.contains("assumevalid")) {
+        assumed_valid = uint256::FromHex(args.at("assumevalid"));
+        if (!assumed_valid) {
+            std::cerr << "Invalid -assumevalid=" << args.at("assumevalid") << std::endl;
+            return 1;
+        }
+    }
+
+    const fs::path abs_datadir{fs::absolute(fs::PathFromString(args.at("datadir")))};
+    fs::create_directories(abs_datadir);
+    if (!fs::is_empty(abs_datadir)) {
+        std::cerr << "The datadir " << fs::PathToString(abs_datadir) << " is not empty." << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<BlockSource> source;
+    if (synthetic) {
+        source = std::make_unique<SyntheticSource>(*chainparams, *txs);
+    } else {
+        source = std::make_unique<BlockFileSource>(fs::absolute(fs::PathFromString(args.at("blocksdir"))), *chainparams);
+    }
+
+    // SETUP: Context
+    kernel::Context kernel_context{};
+    assert(kernel::SanityChecks(kernel_context));
+
+    ValidationSignals validation_signals{std::make_unique<util::ImmediateTaskRunner>()};
+    ReplayNotifications notifications;
+    const kernel::CacheSizes cache_sizes{size_t(*dbcache) * 1_MiB};
+
+    // SETUP: Chainstate
+    const ChainstateManager::Options chainman_opts{
+        .chainparams = *chainparams,
+        .datadir = abs_datadir,
+        .minimum_chain_work = arith_uint256{},
+        .assumed_valid_block = assumed_valid,
+        .notifications = notifications,
+        .signals = &validation_signals,
+        .worker_threads_num = int(*par),
+    };
+    const node::BlockManager::Options blockman_opts{
+        .chainparams = chainman_opts.chainparams,
+        .blocks_dir = abs_datadir / "blocks",
+        .notifications = chainman_opts.notifications,
+        .block_tree_db_params = DBParams{
+            .path = abs_datadir / "blocks" / "index",
+            .cache_bytes = cache_sizes.block_tree_db,
+        },
+    };
+    util::SignalInterrupt interrupt;
+    ChainstateManager chainman{interrupt, chainman_opts, blockman_opts};
+
+    int ret{1};
+    auto catcher{std::make_shared<InvalidBlockCatcher>()};
+    // Lookups are counted in a private registry so the node's metrics keep their meaning.
+    metrics::Registry registry;
+    metrics::Counter cache_hits{"replay_coins_cache_hits", "", {}, 1.0, registry};
+    metrics::Counter cache_misses{"replay_coins_cache_misses", "", {}, 1.0, registry};
+
+    node::ChainstateLoadOptions options;
+    auto [status, error] = node::LoadChainstate(chainman, cache_sizes, options);
+    if (status != node::ChainstateLoadStatus::SUCCESS) {
+        std::cerr << "Failed to load the chainstate: " << error.original << std::endl;
+        goto epilogue;
+    }
+    validation_signals.RegisterSharedValidationInterface(catcher);
+
+    {
+        std::array<std::optional<StageSnapshot>, kernel::NUM_VALIDATION_STAGES> stages_before;
+        SteadyClock::duration connect_time{0};
+        const auto wall_start{SteadyClock::now()};
+        uint64_t measured_blocks{0}, measured_txs{0}, measured_inputs{0};
+        int start_height{0};
+
+        for (int64_t i = 0; i < *warmup + *blocks; ++i) {
+            if (i == *warmup) {
+                LOCK(cs_main);
+                for (size_t stage = 0; stage < kernel::NUM_VALIDATION_STAGES; ++stage) {
+                    stages_before[stage].emplace(chainman.GetValidationProfiler().GetHistogram(kernel::ValidationStage(stage)));
+                }
+                chainman.ActiveChainstate().CoinsTip().SetLookupCounters(&cache_hits, &cache_misses);
+                start_height = chainman.ActiveHeight();
+            }
+            const auto block{source->Next()};
+            if (!block) break;
+
+            const auto start{SteadyClock::now()};
+            bool new_block;
+            const bool accepted{chainman.ProcessNewBlock(block, /*force_processing=*/true, /*min_pow_checked=*/true, &new_block)};
+            if (i >= *warmup) connect_time += SteadyClock::now() - start;
+
+            if (catcher->m_invalid || !accepted) {
+                std::cerr << "Block " << block->GetHash().ToString() << " is invalid";
+                if (catcher->m_invalid) std::cerr << ": " << catcher->m_invalid->second.ToString();
+                std::cerr << std::endl;
+                goto epilogue;
+            }
+            if (i >= *warmup) {
+                ++measured_blocks;
+                measured_txs += block->vtx.size();
+                for (const auto& tx : block->vtx) measured_inputs += tx->IsCoinBase() ? 0 : tx->vin.size();
+            }
+        }
+        if (!stages_before[0]) {
+            std::cerr << "Ran out of blocks during the warmup." << std::endl;
+            goto epilogue;
+        }
+
+        const double connect_seconds{Ticks<SecondsDouble>(connect_time)};
+        UniValue result{UniValue::VOBJ};
+        result.pushKV("source", synthetic ? "synthetic" : "blocksdir");
+        result.pushKV("chain", chain_name);
+        result.pushKV("dbcache_mib", *dbcache);
+        result.pushKV("par", *par);
+        result.pushKV("warmup", *warmup);
+        result.pushKV("blocks", measured_blocks);
+        result.pushKV("transactions", measured_txs);
+        result.pushKV("inputs", measured_inputs);
+        result.pushKV("start_height", start_height);
+        result.pushKV("end_height", WITH_LOCK(cs_main, return chainman.ActiveHeight()));
+        result.pushKV("connect_seconds", connect_seconds);
+        result.pushKV("wall_seconds", Ticks<SecondsDouble>(SteadyClock::now() - wall_start));
+        result.pushKV("blocks_per_second", connect_seconds > 0 ? measured_blocks / connect_seconds : 0);
+        result.pushKV("transactions_per_second", connect_seconds > 0 ? measured_txs / connect_seconds : 0);
+
+        UniValue utxo_cache{UniValue::VOBJ};
+        const uint64_t lookups{cache_hits.Get() + cache_misses.Get()};
+        utxo_cache.pushKV("hits", cache_hits.Get());
+        utxo_cache.pushKV("misses", cache_misses.Get());
+        utxo_cache.pushKV("hit_rate", lookups ? double(cache_hits.Get()) / lookups : 0);
+        {
+            LOCK(cs_main);
+            Chainstate& chainstate{chainman.ActiveChainstate()};
+            utxo_cache.pushKV("entries", chainstate.CoinsTip().GetCacheSize());
+            utxo_cache.pushKV("usage_bytes", chainstate.CoinsTip().DynamicMemoryUsage());
+            utxo_cache.pushKV("limit_bytes", chainstate.m_coinstip_cache_size_bytes);
+        }
+        result.pushKV("utxo_cache", std::move(utxo_cache));
+
+        UniValue stages{UniValue::VOBJ};
+        for (size_t stage = 0; stage < kernel::NUM_VALIDATION_STAGES; ++stage) {
+            const auto& histogram{chainman.GetValidationProfiler().GetHistogram(kernel::ValidationStage(stage))};
+            stages.pushKV(std::string{kernel::ValidationStageName(kernel::ValidationStage(stage))}, StageStats(histogram, *stages_before[stage]));
+        }
+        result.pushKV("stages", std::move(stages));
+
+        std::cout << result.write(2) << std::endl;
+        ret = 0;
+    }
+
+epilogue:
+    // Without this precise shutdown sequence, there will be a lot of nullptr
+    // dereferencing and UB.
+    validation_signals.FlushBackgroundCallbacks();
+    validation_signals.UnregisterAllValidationInterfaces();
+    {
+        LOCK(cs_main);
+        for (Chainstate* chainstate : chainman.GetAll()) {
+            if (chainstate->CanFlushToDisk()) {
+                chainstate->CoinsTip().SetLookupCounters(nullptr, nullptr);
+                chainstate->ForceFlushStateToDisk();
+                chainstate->ResetCoinsViews();
+            }
+        }
+    }
+    return ret;
+}
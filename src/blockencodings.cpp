@@ -10,23 +10,31 @@
 #include <crypto/sha256.h>
 #include <crypto/siphash.h>
 #include <logging.h>
+#include <memusage.h>
 #include <random.h>
 #include <streams.h>
 #include <txmempool.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <array>
 #include <unordered_map>
 
+/** Number of mempool transactions whose short IDs are computed together. */
+static constexpr size_t SHORTID_CHUNK{64};
+
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce) :
         nonce(nonce),
         shorttxids(block.vtx.size() - 1), prefilledtxn(1), header(block) {
     FillShortTxIDSelector();
     //TODO: Use our mempool prior to block acceptance to predictively fill more than just the coinbase
     prefilledtxn[0] = {0, block.vtx[0]};
+    std::vector<const uint256*> wtxids;
+    wtxids.reserve(shorttxids.size());
     for (size_t i = 1; i < block.vtx.size(); i++) {
-        const CTransaction& tx = *block.vtx[i];
-        shorttxids[i - 1] = GetShortID(tx.GetWitnessHash());
+        wtxids.push_back(&block.vtx[i]->GetWitnessHash().ToUint256());
     }
+    GetShortIDs(wtxids, shorttxids.data());
 }
 
 void CBlockHeaderAndShortTxIDs::FillShortTxIDSelector() const {
@@ -45,6 +53,11 @@ uint64_t CBlockHeaderAndShortTxIDs::GetShortID(const Wtxid& wtxid) const {
     return SipHashUint256(shorttxidk0, shorttxidk1, wtxid) & 0xffffffffffffL;
 }
 
+void CBlockHeaderAndShortTxIDs::GetShortIDs(Span<const uint256* const> wtxids, uint64_t* out) const {
+    SipHashUint256Many(shorttxidk0, shorttxidk1, wtxids, out);
+    for (size_t i = 0; i < wtxids.size(); i++) out[i] &= 0xffffffffffffL;
+}
+
 
 
 ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<CTransactionRef>& extra_txn) {
@@ -107,8 +120,19 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& tx : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(tx->GetWitnessHash());
+    // Short IDs are computed a chunk at a time, so several SipHashes run in parallel lanes.
+    std::array<const uint256*, SHORTID_CHUNK> wtxids;
+    std::array<uint64_t, SHORTID_CHUNK> shortids;
+    size_t chunk_pos{SHORTID_CHUNK};
+    for (size_t i = 0; i < pool->txns_randomized.size(); i++) {
+        const auto& tx = pool->txns_randomized[i];
+        if (chunk_pos == SHORTID_CHUNK) {
+            const size_t n{std::min(SHORTID_CHUNK, pool->txns_randomized.size() - i)};
+            for (size_t j = 0; j < n; j++) wtxids[j] = &pool->txns_randomized[i + j]->GetWitnessHash().ToUint256();
+            cmpctblock.GetShortIDs(Span{wtxids}.first(n), shortids.data());
+            chunk_pos = 0;
+        }
+        uint64_t shortid = shortids[chunk_pos++];
         std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
         if (idit != shorttxids.end()) {
             if (!have_txn[idit->second]) {
@@ -133,11 +157,19 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     }
     }
 
+    std::vector<const uint256*> extra_wtxids;
+    extra_wtxids.reserve(extra_txn.size());
+    for (const auto& tx : extra_txn) {
+        if (tx != nullptr) extra_wtxids.push_back(&tx->GetWitnessHash().ToUint256());
+    }
+    std::vector<uint64_t> extra_shortids(extra_wtxids.size());
+    cmpctblock.GetShortIDs(extra_wtxids, extra_shortids.data());
+    size_t extra_pos{0};
     for (size_t i = 0; i < extra_txn.size(); i++) {
         if (extra_txn[i] == nullptr) {
             continue;
         }
-        uint64_t shortid = cmpctblock.GetShortID(extra_txn[i]->GetWitnessHash());
+        uint64_t shortid = extra_shortids[extra_pos++];
         std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
         if (idit != shorttxids.end()) {
             if (!have_txn[idit->second]) {
@@ -226,3 +258,8 @@ ReadStatus PartiallyDownloadedBlock::FillBlock(CBlock& block, const std::vector<
 
     return READ_STATUS_OK;
 }
+
+size_t PartiallyDownloadedBlock::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(txn_available);
+}
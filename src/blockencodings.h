@@ -117,6 +117,8 @@ public:
     CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce);
 
     uint64_t GetShortID(const Wtxid& wtxid) const;
+    /** Compute the short IDs of several wtxids at once: out[i] = GetShortID(*wtxids[i]). */
+    void GetShortIDs(Span<const uint256* const> wtxids, uint64_t* out) const;
 
     size_t BlockTxCount() const { return shorttxids.size() + prefilledtxn.size(); }
 
@@ -150,6 +152,9 @@ public:
     ReadStatus InitData(const CBlockHeaderAndShortTxIDs& cmpctblock, const std::vector<CTransactionRef>& extra_txn);
     bool IsTxAvailable(size_t index) const;
     ReadStatus FillBlock(CBlock& block, const std::vector<CTransactionRef>& vtx_missing);
+
+    //! Memory used by the transaction slots, in bytes. The transactions in them are mostly shared with the mempool, so are not counted.
+    size_t DynamicMemoryUsage() const;
 };
 
 #endif // BITCOIN_BLOCKENCODINGS_H
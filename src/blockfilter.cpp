@@ -32,10 +32,16 @@ uint64_t GCSFilter::HashToRange(const Element& element) const
 
 std::vector<uint64_t> GCSFilter::BuildHashedSet(const ElementSet& elements) const
 {
-    std::vector<uint64_t> hashed_elements;
-    hashed_elements.reserve(elements.size());
+    std::vector<Span<const unsigned char>> data;
+    data.reserve(elements.size());
     for (const Element& element : elements) {
-        hashed_elements.push_back(HashToRange(element));
+        data.emplace_back(element);
+    }
+    // Most elements are short scripts, which SipHashMany hashes several at a time.
+    std::vector<uint64_t> hashed_elements(data.size());
+    SipHashMany(m_params.m_siphash_k0, m_params.m_siphash_k1, data, hashed_elements.data());
+    for (uint64_t& hash : hashed_elements) {
+        hash = FastRange64(hash, m_F);
     }
     std::sort(hashed_elements.begin(), hashed_elements.end());
     return hashed_elements;
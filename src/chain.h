@@ -393,16 +393,15 @@ public:
         if (obj.nStatus & BLOCK_HAVE_DATA) READWRITE(VARINT(obj.nDataPos));
         if (obj.nStatus & BLOCK_HAVE_UNDO) READWRITE(VARINT(obj.nUndoPos));
 
-        // block header
-        READWRITE(obj.nVersion);
-        READWRITE(obj.hashPrev);
-        READWRITE(obj.hashMerkleRoot);
-        READWRITE(obj.nTime);
-        READWRITE(obj.nBits);
-        READWRITE(obj.nNonce);
+        // block header, (un)serialized in one go as a fixed-layout CBlockHeader
+        CBlockHeader header;
+        SER_WRITE(obj, header = obj.GetDiskBlockHeader());
+        READWRITE(header);
+        SER_READ(obj, obj.SetDiskBlockHeader(header));
     }
 
-    uint256 ConstructBlockHash() const
+    //! The block header, with hashPrev as its previous block hash.
+    CBlockHeader GetDiskBlockHeader() const
     {
         CBlockHeader block;
         block.nVersion = nVersion;
@@ -411,7 +410,22 @@ public:
         block.nTime = nTime;
         block.nBits = nBits;
         block.nNonce = nNonce;
-        return block.GetHash();
+        return block;
+    }
+
+    void SetDiskBlockHeader(const CBlockHeader& block)
+    {
+        nVersion = block.nVersion;
+        hashPrev = block.hashPrevBlock;
+        hashMerkleRoot = block.hashMerkleRoot;
+        nTime = block.nTime;
+        nBits = block.nBits;
+        nNonce = block.nNonce;
+    }
+
+    uint256 ConstructBlockHash() const
+    {
+        return GetDiskBlockHeader().GetHash();
     }
 
     uint256 GetBlockHash() = delete;
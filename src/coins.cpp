@@ -7,8 +7,14 @@
 #include <consensus/consensus.h>
 #include <logging.h>
 #include <random.h>
+#include <util/metrics.h>
 #include <util/trace.h>
 
+#include <array>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
 TRACEPOINT_SEMAPHORE(utxocache, add);
 TRACEPOINT_SEMAPHORE(utxocache, spent);
 TRACEPOINT_SEMAPHORE(utxocache, uncache);
@@ -34,26 +40,120 @@ bool CCoinsViewBacked::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &h
 std::unique_ptr<CCoinsViewCursor> CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 size_t CCoinsViewBacked::EstimateSize() const { return base->EstimateSize(); }
 
-CCoinsViewCache::CCoinsViewCache(CCoinsView* baseIn, bool deterministic) :
-    CCoinsViewBacked(baseIn), m_deterministic(deterministic),
-    cacheCoins(0, SaltedOutpointHasher(/*deterministic=*/deterministic), CCoinsMap::key_equal{}, &m_cache_coins_memory_resource)
+void CCoinsMap::EraseBucket(size_t bucket) noexcept
+{
+    const uint32_t idx{m_buckets[bucket].entry};
+    for (size_t next{NextBucket(bucket)}; m_buckets[next].dist_and_fingerprint >= 2 * DIST_INC; next = NextBucket(next)) {
+        m_buckets[bucket] = {m_buckets[next].dist_and_fingerprint - DIST_INC, m_buckets[next].entry};
+        bucket = next;
+    }
+    m_buckets[bucket] = {};
+    --m_size;
+    CoinsCachePair& pair{At(idx)};
+    SetClean(pair);
+    std::destroy_at(&pair);
+    std::memcpy(SlotData(idx), &m_free_slot, sizeof(m_free_slot));
+    m_free_slot = idx;
+}
+
+uint32_t CCoinsMap::AllocateSlot()
+{
+    if (m_free_slot != NO_ENTRY) {
+        const uint32_t idx{m_free_slot};
+        std::memcpy(&m_free_slot, SlotData(idx), sizeof(m_free_slot));
+        return idx;
+    }
+    if (m_used_slots == m_chunks.size() * ENTRIES_PER_CHUNK) {
+        if (m_used_slots > NO_ENTRY - ENTRIES_PER_CHUNK) throw std::length_error("CCoinsMap: too many entries");
+        m_chunks.emplace_back(new Slot[ENTRIES_PER_CHUNK]);
+    }
+    return m_used_slots++;
+}
+
+void CCoinsMap::Rehash(size_t num_buckets)
+{
+    std::vector<Bucket> buckets(num_buckets);
+    std::swap(m_buckets, buckets);
+    m_shift = std::numeric_limits<size_t>::digits - std::countr_zero(num_buckets);
+    m_max_size = num_buckets * 4 / 5;
+
+    // Hash the keys in batches, so several SipHashes run in parallel lanes.
+    static constexpr size_t BATCH{64};
+    std::array<COutPoint, BATCH> keys;
+    std::array<uint32_t, BATCH> entries;
+    std::array<size_t, BATCH> hashes;
+    size_t count{0};
+    const auto insert_batch{[&] {
+        m_hasher.HashMany(Span{keys}.first(count), hashes.data());
+        for (size_t i = 0; i < count; ++i) InsertUnique(hashes[i], entries[i]);
+        count = 0;
+    }};
+    for (const Bucket& b : buckets) {
+        if (b.dist_and_fingerprint == 0) continue;
+        keys[count] = At(b.entry).first;
+        entries[count] = b.entry;
+        if (++count == BATCH) insert_batch();
+    }
+    insert_batch();
+}
+
+void CCoinsMap::DestroyEntries() noexcept
+{
+    for (const Bucket& b : m_buckets) {
+        if (b.dist_and_fingerprint != 0) std::destroy_at(&At(b.entry));
+    }
+}
+
+void CCoinsMap::clear() noexcept
+{
+    DestroyEntries();
+    std::fill(m_buckets.begin(), m_buckets.end(), Bucket{});
+    m_size = 0;
+    m_used_slots = 0;
+    m_free_slot = NO_ENTRY;
+    m_flagged.clear();
+}
+
+void CCoinsMap::reserve(size_t count)
+{
+    size_t num_buckets{std::max(MIN_BUCKETS, m_buckets.size())};
+    while (num_buckets * 4 / 5 < count) num_buckets *= 2;
+    if (num_buckets > m_buckets.size()) Rehash(num_buckets);
+    while (m_chunks.size() * ENTRIES_PER_CHUNK < count) {
+        m_chunks.emplace_back(new Slot[ENTRIES_PER_CHUNK]);
+    }
+}
+
+size_t CCoinsMap::DynamicMemoryUsage() const
 {
-    m_sentinel.second.SelfRef(m_sentinel);
+    return memusage::DynamicUsage(m_buckets) + memusage::DynamicUsage(m_flagged) + memusage::DynamicUsage(m_chunks) +
+           m_chunks.size() * memusage::MallocUsage(ENTRIES_PER_CHUNK * sizeof(Slot));
 }
 
+CCoinsViewCache::CCoinsViewCache(CCoinsView* baseIn, bool deterministic) :
+    CCoinsViewBacked(baseIn), m_deterministic(deterministic),
+    cacheCoins(SaltedOutpointHasher(/*deterministic=*/deterministic))
+{}
+
 size_t CCoinsViewCache::DynamicMemoryUsage() const {
-    return memusage::DynamicUsage(cacheCoins) + cachedCoinsUsage;
+    return cacheCoins.DynamicMemoryUsage() + cachedCoinsUsage;
 }
 
 CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint &outpoint) const {
-    const auto [ret, inserted] = cacheCoins.try_emplace(outpoint);
+    return FetchCoin(outpoint, cacheCoins.hash_function()(outpoint));
+}
+
+CCoinsMap::iterator CCoinsViewCache::FetchCoin(const COutPoint& outpoint, size_t hash) const
+{
+    const auto [ret, inserted] = cacheCoins.try_emplace_hashed(hash, outpoint);
+    if (metrics::Counter* counter{inserted ? m_miss_counter : m_hit_counter}) counter->Inc();
     if (inserted) {
         if (auto coin{base->GetCoin(outpoint)}) {
             ret->second.coin = std::move(*coin);
             cachedCoinsUsage += ret->second.coin.DynamicMemoryUsage();
             if (ret->second.coin.IsSpent()) { // TODO GetCoin cannot return spent coins
                 // The parent only has an empty entry for this outpoint; we can consider our version as fresh.
-                CCoinsCacheEntry::SetFresh(*ret, m_sentinel);
+                cacheCoins.SetFresh(ret);
             }
         } else {
             cacheCoins.erase(ret);
@@ -72,9 +172,7 @@ std::optional<Coin> CCoinsViewCache::GetCoin(const COutPoint& outpoint) const
 void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possible_overwrite) {
     assert(!coin.IsSpent());
     if (coin.out.scriptPubKey.IsUnspendable()) return;
-    CCoinsMap::iterator it;
-    bool inserted;
-    std::tie(it, inserted) = cacheCoins.emplace(std::piecewise_construct, std::forward_as_tuple(outpoint), std::tuple<>());
+    auto [it, inserted] = cacheCoins.try_emplace(outpoint);
     bool fresh = false;
     if (!inserted) {
         cachedCoinsUsage -= it->second.coin.DynamicMemoryUsage();
@@ -99,8 +197,8 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
         fresh = !it->second.IsDirty();
     }
     it->second.coin = std::move(coin);
-    CCoinsCacheEntry::SetDirty(*it, m_sentinel);
-    if (fresh) CCoinsCacheEntry::SetFresh(*it, m_sentinel);
+    cacheCoins.SetDirty(it);
+    if (fresh) cacheCoins.SetFresh(it);
     cachedCoinsUsage += it->second.coin.DynamicMemoryUsage();
     TRACEPOINT(utxocache, add,
            outpoint.hash.data(),
@@ -113,7 +211,7 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, Coin&& coin, bool possi
 void CCoinsViewCache::EmplaceCoinInternalDANGER(COutPoint&& outpoint, Coin&& coin) {
     cachedCoinsUsage += coin.DynamicMemoryUsage();
     auto [it, inserted] = cacheCoins.try_emplace(std::move(outpoint), std::move(coin));
-    if (inserted) CCoinsCacheEntry::SetDirty(*it, m_sentinel);
+    if (inserted) cacheCoins.SetDirty(it);
 }
 
 void AddCoins(CCoinsViewCache& cache, const CTransaction &tx, int nHeight, bool check_for_overwrite) {
@@ -143,7 +241,7 @@ bool CCoinsViewCache::SpendCoin(const COutPoint &outpoint, Coin* moveout) {
     if (it->second.IsFresh()) {
         cacheCoins.erase(it);
     } else {
-        CCoinsCacheEntry::SetDirty(*it, m_sentinel);
+        cacheCoins.SetDirty(it);
         it->second.coin.Clear();
     }
     return true;
@@ -203,11 +301,11 @@ bool CCoinsViewCache::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &ha
                     entry.coin = it->second.coin;
                 }
                 cachedCoinsUsage += entry.coin.DynamicMemoryUsage();
-                CCoinsCacheEntry::SetDirty(*itUs, m_sentinel);
+                cacheCoins.SetDirty(itUs);
                 // We can mark it FRESH in the parent if it was FRESH in the child
                 // Otherwise it might have just been flushed from the parent's cache
                 // and already exist in the grandparent
-                if (it->second.IsFresh()) CCoinsCacheEntry::SetFresh(*itUs, m_sentinel);
+                if (it->second.IsFresh()) cacheCoins.SetFresh(itUs);
             }
         } else {
             // Found the entry in the parent cache
@@ -235,7 +333,7 @@ bool CCoinsViewCache::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &ha
                     itUs->second.coin = it->second.coin;
                 }
                 cachedCoinsUsage += itUs->second.coin.DynamicMemoryUsage();
-                CCoinsCacheEntry::SetDirty(*itUs, m_sentinel);
+                cacheCoins.SetDirty(itUs);
                 // NOTE: It isn't safe to mark the coin as FRESH in the parent
                 // cache. If it already existed and was spent in the parent
                 // cache then marking it FRESH would prevent that spentness
@@ -248,7 +346,7 @@ bool CCoinsViewCache::BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &ha
 }
 
 bool CCoinsViewCache::Flush() {
-    auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, m_sentinel, cacheCoins, /*will_erase=*/true)};
+    auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, cacheCoins, /*will_erase=*/true)};
     bool fOk = base->BatchWrite(cursor, hashBlock);
     if (fOk) {
         cacheCoins.clear();
@@ -260,10 +358,10 @@ bool CCoinsViewCache::Flush() {
 
 bool CCoinsViewCache::Sync()
 {
-    auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, m_sentinel, cacheCoins, /*will_erase=*/false)};
+    auto cursor{CoinsViewCacheCursor(cachedCoinsUsage, cacheCoins, /*will_erase=*/false)};
     bool fOk = base->BatchWrite(cursor, hashBlock);
     if (fOk) {
-        if (m_sentinel.second.Next() != &m_sentinel) {
+        if (cacheCoins.NumFlagged() != 0) {
             /* BatchWrite must clear flags of all entries */
             throw std::logic_error("Not all unspent flagged entries were cleared");
         }
@@ -290,12 +388,33 @@ unsigned int CCoinsViewCache::GetCacheSize() const {
     return cacheCoins.size();
 }
 
+std::vector<std::pair<COutPoint, Coin>> CCoinsViewCache::GetDirtyCoins() const
+{
+    std::vector<std::pair<COutPoint, Coin>> dirty;
+    dirty.reserve(cacheCoins.NumFlagged());
+    for (size_t pos = 0; pos < cacheCoins.NumFlagged(); ++pos) {
+        const CoinsCachePair& entry{cacheCoins.Flagged(pos)};
+        if (entry.second.IsDirty()) dirty.emplace_back(entry.first, entry.second.coin);
+    }
+    return dirty;
+}
+
 bool CCoinsViewCache::HaveInputs(const CTransaction& tx) const
 {
     if (!tx.IsCoinBase()) {
-        for (unsigned int i = 0; i < tx.vin.size(); i++) {
-            if (!HaveCoin(tx.vin[i].prevout)) {
-                return false;
+        // Hash the prevouts in batches, so several SipHashes run in parallel lanes.
+        static constexpr size_t BATCH{16};
+        std::array<COutPoint, BATCH> prevouts;
+        std::array<size_t, BATCH> hashes;
+        for (size_t begin = 0; begin < tx.vin.size(); begin += BATCH) {
+            const size_t count{std::min(BATCH, tx.vin.size() - begin)};
+            for (size_t i = 0; i < count; ++i) prevouts[i] = tx.vin[begin + i].prevout;
+            cacheCoins.hash_function().HashMany(Span{prevouts}.first(count), hashes.data());
+            for (size_t i = 0; i < count; ++i) {
+                const auto it{FetchCoin(prevouts[i], hashes[i])};
+                if (it == cacheCoins.end() || it->second.coin.IsSpent()) {
+                    return false;
+                }
             }
         }
     }
@@ -307,9 +426,7 @@ void CCoinsViewCache::ReallocateCache()
     // Cache should be empty when we're calling this.
     assert(cacheCoins.size() == 0);
     cacheCoins.~CCoinsMap();
-    m_cache_coins_memory_resource.~CCoinsMapMemoryResource();
-    ::new (&m_cache_coins_memory_resource) CCoinsMapMemoryResource{};
-    ::new (&cacheCoins) CCoinsMap{0, SaltedOutpointHasher{/*deterministic=*/m_deterministic}, CCoinsMap::key_equal{}, &m_cache_coins_memory_resource};
+    ::new (&cacheCoins) CCoinsMap{SaltedOutpointHasher{/*deterministic=*/m_deterministic}};
 }
 
 void CCoinsViewCache::SanityCheck() const
@@ -327,21 +444,20 @@ void CCoinsViewCache::SanityCheck() const
         // Recompute cachedCoinsUsage.
         recomputed_usage += entry.coin.DynamicMemoryUsage();
 
-        // Count the number of entries we expect in the linked list.
+        // Count the number of entries we expect in the flagged entry index.
         if (entry.IsDirty() || entry.IsFresh()) ++count_flagged;
     }
-    // Iterate over the linked list of flagged entries.
-    size_t count_linked = 0;
-    for (auto it = m_sentinel.second.Next(); it != &m_sentinel; it = it->second.Next()) {
-        // Verify linked list integrity.
-        assert(it->second.Next()->second.Prev() == it);
-        assert(it->second.Prev()->second.Next() == it);
+    // Iterate over the index of flagged entries.
+    for (size_t pos = 0; pos < cacheCoins.NumFlagged(); ++pos) {
+        const CoinsCachePair& pair{cacheCoins.Flagged(pos)};
+        // Verify index integrity.
+        assert(cacheCoins.FlaggedPos(pair) == pos);
+        assert(cacheCoins.find(pair.first) != cacheCoins.end());
+        assert(&*cacheCoins.find(pair.first) == &pair);
         // Verify they are actually flagged.
-        assert(it->second.IsDirty() || it->second.IsFresh());
-        // Count the number of entries actually in the list.
-        ++count_linked;
+        assert(pair.second.IsDirty() || pair.second.IsFresh());
     }
-    assert(count_linked == count_flagged);
+    assert(cacheCoins.NumFlagged() == count_flagged);
     assert(recomputed_usage == cachedCoinsUsage);
 }
 
@@ -11,7 +11,6 @@
 #include <memusage.h>
 #include <primitives/transaction.h>
 #include <serialize.h>
-#include <support/allocators/pool.h>
 #include <uint256.h>
 #include <util/check.h>
 #include <util/hasher.h>
@@ -19,8 +18,21 @@
 #include <assert.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <functional>
-#include <unordered_map>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+class Counter;
+} // namespace metrics
 
 /**
  * A UTXO entry.
@@ -107,43 +119,6 @@ using CoinsCachePair = std::pair<const COutPoint, CCoinsCacheEntry>;
  */
 struct CCoinsCacheEntry
 {
-private:
-    /**
-     * These are used to create a doubly linked list of flagged entries.
-     * They are set in SetDirty, SetFresh, and unset in SetClean.
-     * A flagged entry is any entry that is either DIRTY, FRESH, or both.
-     *
-     * DIRTY entries are tracked so that only modified entries can be passed to
-     * the parent cache for batch writing. This is a performance optimization
-     * compared to giving all entries in the cache to the parent and having the
-     * parent scan for only modified entries.
-     *
-     * FRESH-but-not-DIRTY coins can not occur in practice, since that would
-     * mean a spent coin exists in the parent CCoinsView and not in the child
-     * CCoinsViewCache. Nevertheless, if a spent coin is retrieved from the
-     * parent cache, the FRESH-but-not-DIRTY coin will be tracked by the linked
-     * list and deleted when Sync or Flush is called on the CCoinsViewCache.
-     */
-    CoinsCachePair* m_prev{nullptr};
-    CoinsCachePair* m_next{nullptr};
-    uint8_t m_flags{0};
-
-    //! Adding a flag requires a reference to the sentinel of the flagged pair linked list.
-    static void AddFlags(uint8_t flags, CoinsCachePair& pair, CoinsCachePair& sentinel) noexcept
-    {
-        Assume(flags & (DIRTY | FRESH));
-        if (!pair.second.m_flags) {
-            Assume(!pair.second.m_prev && !pair.second.m_next);
-            pair.second.m_prev = sentinel.second.m_prev;
-            pair.second.m_next = &sentinel;
-            sentinel.second.m_prev = &pair;
-            pair.second.m_prev->second.m_next = &pair;
-        }
-        Assume(pair.second.m_prev && pair.second.m_next);
-        pair.second.m_flags |= flags;
-    }
-
-public:
     Coin coin; // The actual cached data.
 
     enum Flags {
@@ -169,66 +144,288 @@ public:
 
     CCoinsCacheEntry() noexcept = default;
     explicit CCoinsCacheEntry(Coin&& coin_) noexcept : coin(std::move(coin_)) {}
-    ~CCoinsCacheEntry()
+
+    bool IsDirty() const noexcept { return m_flags & DIRTY; }
+    bool IsFresh() const noexcept { return m_flags & FRESH; }
+
+private:
+    friend class CCoinsMap;
+
+    /**
+     * Flags are set and cleared through the CCoinsMap holding the entry, which
+     * keeps an index of flagged entries. A flagged entry is any entry that is
+     * either DIRTY, FRESH, or both; m_flagged_pos is its position in the index.
+     *
+     * DIRTY entries are tracked so that only modified entries can be passed to
+     * the parent cache for batch writing. This is a performance optimization
+     * compared to giving all entries in the cache to the parent and having the
+     * parent scan for only modified entries.
+     *
+     * FRESH-but-not-DIRTY coins can not occur in practice, since that would
+     * mean a spent coin exists in the parent CCoinsView and not in the child
+     * CCoinsViewCache. Nevertheless, if a spent coin is retrieved from the
+     * parent cache, the FRESH-but-not-DIRTY coin will be tracked by the index
+     * and deleted when Sync or Flush is called on the CCoinsViewCache.
+     */
+    uint32_t m_flagged_pos{0};
+    uint8_t m_flags{0};
+};
+
+/**
+ * Open-addressing hash map from outpoints to cache entries.
+ *
+ * The bucket array only holds an 8-bit hash fingerprint, the probe distance
+ * (for robin hood hashing) and the index of the entry, so a lookup touches a
+ * bucket cache line and, usually, only the entry it is looking for. Entries
+ * are stored in fixed-size chunks rather than one allocation per coin, and
+ * their addresses are stable until they are erased; erased slots are reused.
+ *
+ * Instead of linking flagged entries into a list through pointers stored in
+ * every entry, the map keeps a separate index of flagged entries, which is
+ * what CoinsViewCacheCursor iterates.
+ *
+ * Iterators are invalidated by any insertion or erasure. References to an
+ * entry are only invalidated by erasing that entry, or by clear().
+ */
+class CCoinsMap
+{
+    struct Bucket {
+        //! Probe distance plus one in the upper 24 bits, hash fingerprint in the lower 8. Zero if empty.
+        uint32_t dist_and_fingerprint{0};
+        uint32_t entry{0};
+    };
+
+    struct alignas(CoinsCachePair) Slot {
+        std::byte data[sizeof(CoinsCachePair)];
+    };
+
+    static constexpr uint32_t DIST_INC{1 << 8};
+    //! Entries are allocated in chunks of (at most) 256 KiB.
+    static constexpr size_t ENTRIES_PER_CHUNK{(256 << 10) / sizeof(Slot)};
+    static constexpr uint32_t NO_ENTRY{std::numeric_limits<uint32_t>::max()};
+    static constexpr size_t MIN_BUCKETS{32};
+
+    SaltedOutpointHasher m_hasher;
+    std::vector<Bucket> m_buckets;
+    //! The bucket of a hash is given by its top bits: hash >> m_shift.
+    int m_shift{std::numeric_limits<size_t>::digits};
+    size_t m_size{0};
+    //! Grow the bucket array when inserting beyond this many entries (80% load).
+    size_t m_max_size{0};
+
+    std::vector<std::unique_ptr<Slot[]>> m_chunks;
+    //! Number of slots ever handed out since the last clear().
+    uint32_t m_used_slots{0};
+    //! Head of the list of erased slots, linked through the slots themselves.
+    uint32_t m_free_slot{NO_ENTRY};
+
+    //! Indices of all flagged (DIRTY and/or FRESH) entries.
+    std::vector<uint32_t> m_flagged;
+
+    std::byte* SlotData(uint32_t idx) const noexcept { return m_chunks[idx / ENTRIES_PER_CHUNK][idx % ENTRIES_PER_CHUNK].data; }
+    CoinsCachePair& At(uint32_t idx) const noexcept { return *std::launder(reinterpret_cast<CoinsCachePair*>(SlotData(idx))); }
+
+    size_t NextBucket(size_t bucket) const noexcept { return (bucket + 1) & (m_buckets.size() - 1); }
+
+    //! Return the bucket holding key, or m_buckets.size() if it is not in the map.
+    size_t FindBucket(const COutPoint& key) const noexcept
     {
-        SetClean();
+        if (m_size == 0) return m_buckets.size();
+        const size_t hash{m_hasher(key)};
+        uint32_t dist_and_fingerprint{DIST_INC | uint32_t(hash & 0xff)};
+        size_t bucket{hash >> m_shift};
+        while (true) {
+            const Bucket& b{m_buckets[bucket]};
+            if (b.dist_and_fingerprint == dist_and_fingerprint && At(b.entry).first == key) return bucket;
+            // Robin hood invariant: the key would have displaced any entry closer to its home bucket.
+            if (b.dist_and_fingerprint < dist_and_fingerprint) return m_buckets.size();
+            dist_and_fingerprint += DIST_INC;
+            bucket = NextBucket(bucket);
+        }
     }
 
-    static void SetDirty(CoinsCachePair& pair, CoinsCachePair& sentinel) noexcept { AddFlags(DIRTY, pair, sentinel); }
-    static void SetFresh(CoinsCachePair& pair, CoinsCachePair& sentinel) noexcept { AddFlags(FRESH, pair, sentinel); }
+    //! Store b at bucket, moving the entries from there on one bucket further.
+    void PlaceAndShiftUp(Bucket b, size_t bucket) noexcept
+    {
+        while (m_buckets[bucket].dist_and_fingerprint != 0) {
+            std::swap(b, m_buckets[bucket]);
+            b.dist_and_fingerprint += DIST_INC;
+            bucket = NextBucket(bucket);
+        }
+        m_buckets[bucket] = b;
+    }
 
-    void SetClean() noexcept
+    //! Remove the entry at bucket, moving the entries after it back.
+    void EraseBucket(size_t bucket) noexcept;
+    //! Reserve a slot for a new entry.
+    uint32_t AllocateSlot();
+    //! Rehash into a bucket array of the given size (a power of two).
+    void Rehash(size_t num_buckets);
+    //! Insert an entry known not to be in the map yet.
+    void InsertUnique(size_t hash, uint32_t idx) noexcept
     {
-        if (!m_flags) return;
-        m_next->second.m_prev = m_prev;
-        m_prev->second.m_next = m_next;
-        m_flags = 0;
-        m_prev = m_next = nullptr;
+        uint32_t dist_and_fingerprint{DIST_INC | uint32_t(hash & 0xff)};
+        size_t bucket{hash >> m_shift};
+        while (dist_and_fingerprint <= m_buckets[bucket].dist_and_fingerprint) {
+            dist_and_fingerprint += DIST_INC;
+            bucket = NextBucket(bucket);
+        }
+        PlaceAndShiftUp({dist_and_fingerprint, idx}, bucket);
     }
-    bool IsDirty() const noexcept { return m_flags & DIRTY; }
-    bool IsFresh() const noexcept { return m_flags & FRESH; }
+    void DestroyEntries() noexcept;
 
-    //! Only call Next when this entry is DIRTY, FRESH, or both
-    CoinsCachePair* Next() const noexcept
+    void AddFlags(uint8_t flags, uint32_t idx)
     {
-        Assume(m_flags);
-        return m_next;
+        Assume(flags & (CCoinsCacheEntry::DIRTY | CCoinsCacheEntry::FRESH));
+        CCoinsCacheEntry& entry{At(idx).second};
+        if (!entry.m_flags) {
+            entry.m_flagged_pos = m_flagged.size();
+            m_flagged.push_back(idx);
+        }
+        entry.m_flags |= flags;
     }
 
-    //! Only call Prev when this entry is DIRTY, FRESH, or both
-    CoinsCachePair* Prev() const noexcept
+    template <bool Const>
+    class Iter
     {
-        Assume(m_flags);
-        return m_prev;
+        friend class CCoinsMap;
+        template <bool>
+        friend class Iter;
+        using Map = std::conditional_t<Const, const CCoinsMap, CCoinsMap>;
+        Map* m_map{nullptr};
+        size_t m_bucket{0};
+
+        Iter(Map* map, size_t bucket) noexcept : m_map{map}, m_bucket{bucket} {}
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = CoinsCachePair;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const CoinsCachePair*, CoinsCachePair*>;
+        using reference = std::conditional_t<Const, const CoinsCachePair&, CoinsCachePair&>;
+
+        Iter() noexcept = default;
+        operator Iter<true>() const noexcept requires(!Const) { return {m_map, m_bucket}; }
+
+        reference operator*() const noexcept { return m_map->At(m_map->m_buckets[m_bucket].entry); }
+        pointer operator->() const noexcept { return &**this; }
+        Iter& operator++() noexcept
+        {
+            do {
+                ++m_bucket;
+            } while (m_bucket < m_map->m_buckets.size() && m_map->m_buckets[m_bucket].dist_and_fingerprint == 0);
+            return *this;
+        }
+        Iter operator++(int) noexcept
+        {
+            Iter ret{*this};
+            ++*this;
+            return ret;
+        }
+        friend bool operator==(const Iter& a, const Iter& b) noexcept { return a.m_bucket == b.m_bucket && a.m_map == b.m_map; }
+    };
+
+public:
+    using key_type = COutPoint;
+    using mapped_type = CCoinsCacheEntry;
+    using value_type = CoinsCachePair;
+    using hasher = SaltedOutpointHasher;
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+    explicit CCoinsMap(const SaltedOutpointHasher& hasher = SaltedOutpointHasher{}) noexcept : m_hasher{hasher} {}
+    ~CCoinsMap() { DestroyEntries(); }
+
+    CCoinsMap(const CCoinsMap&) = delete;
+    CCoinsMap& operator=(const CCoinsMap&) = delete;
+
+    iterator begin() noexcept { return ++iterator{this, size_t(-1)}; }
+    const_iterator begin() const noexcept { return ++const_iterator{this, size_t(-1)}; }
+    iterator end() noexcept { return {this, m_buckets.size()}; }
+    const_iterator end() const noexcept { return {this, m_buckets.size()}; }
+
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+    iterator find(const COutPoint& key) noexcept { return {this, FindBucket(key)}; }
+    const_iterator find(const COutPoint& key) const noexcept { return {this, FindBucket(key)}; }
+
+    const SaltedOutpointHasher& hash_function() const noexcept { return m_hasher; }
+
+    /** Insert an entry constructed from args, unless key is already present. */
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        const size_t hash{m_hasher(key)};
+        return try_emplace_hashed(hash, std::forward<K>(key), std::forward<Args>(args)...);
     }
 
-    //! Only use this for initializing the linked list sentinel
-    void SelfRef(CoinsCachePair& pair) noexcept
+    /** Like try_emplace, for a key whose hash_function() value is already known. */
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> try_emplace_hashed(size_t hash, K&& key, Args&&... args)
     {
-        Assume(&pair.second == this);
-        m_prev = &pair;
-        m_next = &pair;
-        // Set sentinel to DIRTY so we can call Next on it
-        m_flags = DIRTY;
+        if (m_size >= m_max_size) Rehash(std::max(MIN_BUCKETS, m_buckets.size() * 2));
+        uint32_t dist_and_fingerprint{DIST_INC | uint32_t(hash & 0xff)};
+        size_t bucket{hash >> m_shift};
+        while (dist_and_fingerprint <= m_buckets[bucket].dist_and_fingerprint) {
+            if (dist_and_fingerprint == m_buckets[bucket].dist_and_fingerprint && At(m_buckets[bucket].entry).first == key) {
+                return {{this, bucket}, false};
+            }
+            dist_and_fingerprint += DIST_INC;
+            bucket = NextBucket(bucket);
+        }
+        const uint32_t idx{AllocateSlot()};
+        ::new (SlotData(idx)) CoinsCachePair(std::piecewise_construct,
+                                             std::forward_as_tuple(std::forward<K>(key)),
+                                             std::forward_as_tuple(std::forward<Args>(args)...));
+        PlaceAndShiftUp({dist_and_fingerprint, idx}, bucket);
+        ++m_size;
+        return {{this, bucket}, true};
     }
-};
 
-/**
- * PoolAllocator's MAX_BLOCK_SIZE_BYTES parameter here uses sizeof the data, and adds the size
- * of 4 pointers. We do not know the exact node size used in the std::unordered_node implementation
- * because it is implementation defined. Most implementations have an overhead of 1 or 2 pointers,
- * so nodes can be connected in a linked list, and in some cases the hash value is stored as well.
- * Using an additional sizeof(void*)*4 for MAX_BLOCK_SIZE_BYTES should thus be sufficient so that
- * all implementations can allocate the nodes from the PoolAllocator.
- */
-using CCoinsMap = std::unordered_map<COutPoint,
-                                     CCoinsCacheEntry,
-                                     SaltedOutpointHasher,
-                                     std::equal_to<COutPoint>,
-                                     PoolAllocator<CoinsCachePair,
-                                                   sizeof(CoinsCachePair) + sizeof(void*) * 4>>;
+    void erase(const_iterator it) noexcept { EraseBucket(it.m_bucket); }
+    size_t erase(const COutPoint& key) noexcept
+    {
+        const size_t bucket{FindBucket(key)};
+        if (bucket == m_buckets.size()) return 0;
+        EraseBucket(bucket);
+        return 1;
+    }
+
+    //! Remove all entries, keeping the allocated memory for reuse.
+    void clear() noexcept;
+    //! Allocate enough buckets and slots for count entries.
+    void reserve(size_t count);
+
+    size_t DynamicMemoryUsage() const;
+
+    //! Mark an entry DIRTY, adding it to the flagged entry index if it wasn't flagged yet.
+    void SetDirty(iterator it) { AddFlags(CCoinsCacheEntry::DIRTY, m_buckets[it.m_bucket].entry); }
+    //! Mark an entry FRESH, adding it to the flagged entry index if it wasn't flagged yet.
+    void SetFresh(iterator it) { AddFlags(CCoinsCacheEntry::FRESH, m_buckets[it.m_bucket].entry); }
+    //! Clear the flags of an entry, removing it from the flagged entry index.
+    void SetClean(CoinsCachePair& pair) noexcept
+    {
+        CCoinsCacheEntry& entry{pair.second};
+        if (!entry.m_flags) return;
+        const uint32_t last{m_flagged.back()};
+        m_flagged[entry.m_flagged_pos] = last;
+        At(last).second.m_flagged_pos = entry.m_flagged_pos;
+        m_flagged.pop_back();
+        entry.m_flags = 0;
+    }
 
-using CCoinsMapMemoryResource = CCoinsMap::allocator_type::ResourceType;
+    //! Number of entries that are DIRTY, FRESH, or both.
+    size_t NumFlagged() const noexcept { return m_flagged.size(); }
+    //! Return the flagged entry at position pos of the index (pos < NumFlagged()).
+    CoinsCachePair& Flagged(size_t pos) const noexcept { return At(m_flagged[pos]); }
+    //! Return the position of a flagged entry in the index.
+    size_t FlaggedPos(const CoinsCachePair& pair) const noexcept
+    {
+        Assume(pair.second.m_flags);
+        return pair.second.m_flagged_pos;
+    }
+};
 
 /** Cursor for iterating over CoinsView state */
 class CCoinsViewCursor
@@ -250,7 +447,7 @@ private:
 };
 
 /**
- * Cursor for iterating over the linked list of flagged entries in CCoinsViewCache.
+ * Cursor for iterating over the flagged entries in CCoinsViewCache.
  *
  * This is a helper struct to encapsulate the diverging logic between a non-erasing
  * CCoinsViewCache::Sync and an erasing CCoinsViewCache::Flush. This allows the receiver
@@ -265,25 +462,22 @@ private:
 struct CoinsViewCacheCursor
 {
     //! If will_erase is not set, iterating through the cursor will erase spent coins from the map,
-    //! and other coins will be unflagged (removing them from the linked list).
-    //! If will_erase is set, the underlying map and linked list will not be modified,
+    //! and other coins will be unflagged (removing them from the flagged entry index).
+    //! If will_erase is set, the underlying map and index will not be modified,
     //! as the caller is expected to wipe the entire map anyway.
     //! This is an optimization compared to erasing all entries as the cursor iterates them when will_erase is set.
-    //! Calling CCoinsMap::clear() afterwards is faster because a CoinsCachePair cannot be coerced back into a
-    //! CCoinsMap::iterator to be erased, and must therefore be looked up again by key in the CCoinsMap before being erased.
     CoinsViewCacheCursor(size_t& usage LIFETIMEBOUND,
-                        CoinsCachePair& sentinel LIFETIMEBOUND,
                         CCoinsMap& map LIFETIMEBOUND,
                         bool will_erase) noexcept
-        : m_usage(usage), m_sentinel(sentinel), m_map(map), m_will_erase(will_erase) {}
+        : m_usage(usage), m_map(map), m_will_erase(will_erase) {}
 
-    inline CoinsCachePair* Begin() const noexcept { return m_sentinel.second.Next(); }
-    inline CoinsCachePair* End() const noexcept { return &m_sentinel; }
+    inline CoinsCachePair* Begin() const noexcept { return Before(m_map.NumFlagged()); }
+    inline CoinsCachePair* End() const noexcept { return nullptr; }
 
     //! Return the next entry after current, possibly erasing current
     inline CoinsCachePair* NextAndMaybeErase(CoinsCachePair& current) noexcept
     {
-        const auto next_entry{current.second.Next()};
+        const auto next_entry{Before(m_map.FlaggedPos(current))};
         // If we are not going to erase the cache, we must still erase spent entries.
         // Otherwise, clear the state of the entry.
         if (!m_will_erase) {
@@ -291,7 +485,7 @@ struct CoinsViewCacheCursor
                 m_usage -= current.second.coin.DynamicMemoryUsage();
                 m_map.erase(current.first);
             } else {
-                current.second.SetClean();
+                m_map.SetClean(current);
             }
         }
         return next_entry;
@@ -299,8 +493,11 @@ struct CoinsViewCacheCursor
 
     inline bool WillErase(CoinsCachePair& current) const noexcept { return m_will_erase || current.second.coin.IsSpent(); }
 private:
+    //! The index is walked from the back, so that unflagging the current entry
+    //! never moves an entry that is yet to be visited.
+    inline CoinsCachePair* Before(size_t pos) const noexcept { return pos ? &m_map.Flagged(pos - 1) : nullptr; }
+
     size_t& m_usage;
-    CoinsCachePair& m_sentinel;
     CCoinsMap& m_map;
     bool m_will_erase;
 };
@@ -363,6 +560,9 @@ class CCoinsViewCache : public CCoinsViewBacked
 {
 private:
     const bool m_deterministic;
+    //! Optional counters of lookups served from this cache and passed on to the base.
+    metrics::Counter* m_hit_counter{nullptr};
+    metrics::Counter* m_miss_counter{nullptr};
 
 protected:
     /**
@@ -370,9 +570,6 @@ protected:
      * declared as "const".
      */
     mutable uint256 hashBlock;
-    mutable CCoinsMapMemoryResource m_cache_coins_memory_resource{};
-    /* The starting sentinel of the flagged entry circular doubly linked list. */
-    mutable CoinsCachePair m_sentinel;
     mutable CCoinsMap cacheCoins;
 
     /* Cached dynamic memory usage for the inner Coin objects. */
@@ -386,6 +583,13 @@ public:
      */
     CCoinsViewCache(const CCoinsViewCache &) = delete;
 
+    //! Count cache hits and misses in the given metrics (pass nullptr to stop counting).
+    void SetLookupCounters(metrics::Counter* hits, metrics::Counter* misses)
+    {
+        m_hit_counter = hits;
+        m_miss_counter = misses;
+    }
+
     // Standard CCoinsView methods
     std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
     bool HaveCoin(const COutPoint &outpoint) const override;
@@ -466,14 +670,21 @@ public:
     //! Calculate the size of the cache (in bytes)
     size_t DynamicMemoryUsage() const;
 
+    /**
+     * Copy out the changes this cache holds relative to its backing view: all
+     * DIRTY entries, spent ones (which stand for deletions) included. Runs in
+     * time proportional to the number of flagged entries, not the cache size.
+     */
+    std::vector<std::pair<COutPoint, Coin>> GetDirtyCoins() const;
+    //! Number of flagged entries, an upper bound on the size of GetDirtyCoins().
+    size_t GetDirtyCount() const { return cacheCoins.NumFlagged(); }
+
     //! Check whether all prevouts of the transaction are present in the UTXO set represented by this view
     bool HaveInputs(const CTransaction& tx) const;
 
     //! Force a reallocation of the cache map. This is required when downsizing
-    //! the cache because the map's allocator may be hanging onto a lot of
-    //! memory despite having called .clear().
-    //!
-    //! See: https://stackoverflow.com/questions/42114044/how-to-release-unordered-map-memory
+    //! the cache because the map keeps its buckets and entry chunks allocated
+    //! after .clear().
     void ReallocateCache();
 
     //! Run an internal sanity check on the cache data structure. */
@@ -485,6 +696,8 @@ private:
      * memory usage.
      */
     CCoinsMap::iterator FetchCoin(const COutPoint &outpoint) const;
+    //! FetchCoin, given the hash of outpoint under cacheCoins.hash_function().
+    CCoinsMap::iterator FetchCoin(const COutPoint& outpoint, size_t hash) const;
 };
 
 //! Utility function to add all of a transaction's outputs to a cache.
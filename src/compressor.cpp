@@ -146,10 +146,10 @@ bool DecompressScript(CScript& script, unsigned int nSize, const CompressedScrip
 // * if e==9, we only know the resulting number is not zero, so output 1 + 10*(n - 1) + 9
 // (this is decodable, as d is in [1-9] and e is in [0-9])
 
-uint64_t CompressAmount(uint64_t n)
+namespace {
+/** CompressAmount(n) = 1 + 10*y + e for a non-zero n, as the pair (y, e). Unlike the compressed amount, y always fits in 64 bits. */
+std::pair<uint64_t, int> CompressAmountParts(uint64_t n)
 {
-    if (n == 0)
-        return 0;
     int e = 0;
     while (((n % 10) == 0) && e < 9) {
         n /= 10;
@@ -159,21 +159,15 @@ uint64_t CompressAmount(uint64_t n)
         int d = (n % 10);
         assert(d >= 1 && d <= 9);
         n /= 10;
-        return 1 + (n*9 + d - 1)*10 + e;
+        return {n*9 + d - 1, e};
     } else {
-        return 1 + (n - 1)*10 + 9;
+        return {n - 1, 9};
     }
 }
 
-uint64_t DecompressAmount(uint64_t x)
+/** Inverse of CompressAmountParts: the amount compressed to 1 + 10*x + e. */
+uint64_t DecompressAmountParts(uint64_t x, int e)
 {
-    // x = 0  OR  x = 1+10*(9*n + d - 1) + e  OR  x = 1+10*(n - 1) + 9
-    if (x == 0)
-        return 0;
-    x--;
-    // x = 10*(9*n + d - 1) + e
-    int e = x % 10;
-    x /= 10;
     uint64_t n = 0;
     if (e < 9) {
         // x = 9*n + d - 1
@@ -190,3 +184,46 @@ uint64_t DecompressAmount(uint64_t x)
     }
     return n;
 }
+} // namespace
+
+uint64_t CompressAmount(uint64_t n)
+{
+    if (n == 0)
+        return 0;
+    const auto [y, e]{CompressAmountParts(n)};
+    return 1 + y*10 + e;
+}
+
+uint64_t DecompressAmount(uint64_t x)
+{
+    // x = 0  OR  x = 1+10*(9*n + d - 1) + e  OR  x = 1+10*(n - 1) + 9
+    if (x == 0)
+        return 0;
+    x--;
+    // x = 10*(9*n + d - 1) + e
+    return DecompressAmountParts(x / 10, x % 10);
+}
+
+std::pair<uint64_t, uint8_t> CompressAmountSplit(uint64_t n)
+{
+    if (n == 0) return {0, 0};
+    // x = 1 + 10*y + e = 128*(5*(y / 64)) + (10*(y % 64) + 1 + e)
+    const auto [y, e]{CompressAmountParts(n)};
+    const uint64_t rest{10 * (y % 64) + 1 + e};
+    return {5 * (y / 64) + rest / 128, rest % 128};
+}
+
+uint64_t DecompressAmountSplit(uint64_t high, uint8_t low)
+{
+    // x = 128*high + low = 640*a + s
+    uint64_t a{high / 5};
+    uint64_t s{(high % 5) * 128 + low};
+    if (a == 0 && s == 0) return 0;
+    if (s == 0) {
+        --a;
+        s = 640;
+    }
+    // x - 1 = 640*a + s - 1 = 10*(64*a + (s - 1) / 10) + (s - 1) % 10
+    --s;
+    return DecompressAmountParts(64 * a + s / 10, s % 10);
+}
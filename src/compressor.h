@@ -13,6 +13,11 @@
 #include <serialize.h>
 #include <span.h>
 
+#include <cstdint>
+#include <ios>
+#include <limits>
+#include <utility>
+
 /**
  * This saves us from making many heap allocations when serializing
  * and deserializing compressed scripts.
@@ -41,6 +46,16 @@ uint64_t CompressAmount(uint64_t nAmount);
 
 uint64_t DecompressAmount(uint64_t nAmount);
 
+/**
+ * CompressAmount(nAmount) split into its high bits (x >> 7) and its low 7 bits
+ * (x & 0x7F). The compressed form of amounts above 2^64 / 9, which are below
+ * MAX_MONEY, needs up to 67 bits; CompressAmount overflows for them, but this
+ * does not.
+ */
+std::pair<uint64_t, uint8_t> CompressAmountSplit(uint64_t nAmount);
+/** Inverse of CompressAmountSplit. */
+uint64_t DecompressAmountSplit(uint64_t high, uint8_t low);
+
 /** Compact serializer for scripts.
  *
  *  It detects common cases and encodes them much more efficiently.
@@ -98,15 +113,40 @@ struct ScriptCompression
 
 struct AmountCompression
 {
+    // The VARINT of the compressed amount x is written as the VARINT of its high
+    // bits, with a continuation mark on every byte, followed by its low 7 bits.
+    // This is the same encoding as VARINT(CompressAmount(val)), but also works
+    // when x does not fit in 64 bits.
     template<typename Stream, typename I> void Ser(Stream& s, I val)
     {
-        s << VARINT(CompressAmount(val));
+        const auto [high, low]{CompressAmountSplit(val)};
+        if (high > 0) {
+            unsigned char tmp[(sizeof(high) * 8 + 6) / 7];
+            int len{0};
+            uint64_t n{high - 1};
+            while (true) {
+                tmp[len] = (n & 0x7F) | 0x80;
+                if (n <= 0x7F) break;
+                n = (n >> 7) - 1;
+                len++;
+            }
+            do {
+                ser_writedata8(s, tmp[len]);
+            } while (len--);
+        }
+        ser_writedata8(s, low);
     }
     template<typename Stream, typename I> void Unser(Stream& s, I& val)
     {
-        uint64_t v;
-        s >> VARINT(v);
-        val = DecompressAmount(v);
+        uint64_t high{0};
+        uint8_t byte;
+        while ((byte = ser_readdata8(s)) & 0x80) {
+            if (high > (std::numeric_limits<uint64_t>::max() >> 7) - 1) {
+                throw std::ios_base::failure("AmountCompression: size too large");
+            }
+            high = ((high << 7) | (byte & 0x7F)) + 1;
+        }
+        val = DecompressAmountSplit(high, byte);
     }
 };
 
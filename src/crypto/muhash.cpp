@@ -5,8 +5,10 @@
 
 #include <crypto/muhash.h>
 
+#include <compat/cpuid.h>
 #include <crypto/chacha20.h>
 #include <crypto/common.h>
+#include <crypto/sha256.h>
 #include <hash.h>
 #include <util/check.h>
 
@@ -14,6 +16,7 @@
 #include <cassert>
 #include <cstdio>
 #include <limits>
+#include <vector>
 
 namespace {
 
@@ -110,6 +113,84 @@ inline void addnextract2(limb_t& c0, limb_t& c1, const limb_t& a, limb_t& n)
     c1 = c2;
 }
 
+/** Compute the full 2*LIMBS limb product r = a * b, one row of b per limb of a. */
+void MulFullGeneric(limb_t* r, const limb_t* a, const limb_t* b)
+{
+    limb_t c = 0;
+    for (int j = 0; j < LIMBS; ++j) {
+        double_limb_t t = (double_limb_t)a[0] * b[j] + c;
+        r[j] = t;
+        c = t >> LIMB_SIZE;
+    }
+    r[LIMBS] = c;
+    for (int i = 1; i < LIMBS; ++i) {
+        c = 0;
+        for (int j = 0; j < LIMBS; ++j) {
+            // Cannot overflow: (2^n - 1)^2 + 2 * (2^n - 1) = 2^2n - 1.
+            double_limb_t t = (double_limb_t)a[i] * b[j] + r[i + j] + c;
+            r[i + j] = t;
+            c = t >> LIMB_SIZE;
+        }
+        r[i + LIMBS] = c;
+    }
+}
+
+#if defined(__x86_64__) || defined(__amd64__)
+static_assert(LIMB_SIZE == 64 && LIMBS == 48, "MulFullMulxAdx assumes 48 64-bit limbs");
+
+/** One step of a row: [r[j], hi] = a_i * b[j] + r[j] + hi, with the additions of the
+ *  low and high halves of the products done in two independent carry chains (CF and OF). */
+#define MULX_ADX_STEP(j) \
+    "mulx " #j "*8(%[b]), %%r10, %%r11\n" \
+    "adcx " #j "*8(%[r]), %%r10\n" \
+    "adox %%r9, %%r10\n" \
+    "movq %%r10, " #j "*8(%[r])\n" \
+    "movq %%r11, %%r9\n"
+#define MULX_ADX_STEP8(j0, j1, j2, j3, j4, j5, j6, j7) \
+    MULX_ADX_STEP(j0) MULX_ADX_STEP(j1) MULX_ADX_STEP(j2) MULX_ADX_STEP(j3) \
+    MULX_ADX_STEP(j4) MULX_ADX_STEP(j5) MULX_ADX_STEP(j6) MULX_ADX_STEP(j7)
+
+/** Same as MulFullGeneric, using the BMI2 mulx and ADX adcx/adox instructions. */
+void MulFullMulxAdx(limb_t* r, const limb_t* a, const limb_t* b)
+{
+    for (int j = 0; j < LIMBS; ++j) r[j] = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        __asm__ __volatile__(
+            "xorl %%r9d, %%r9d\n"
+            "xorl %%r8d, %%r8d\n" // Also clears CF and OF.
+            MULX_ADX_STEP8(0, 1, 2, 3, 4, 5, 6, 7)
+            MULX_ADX_STEP8(8, 9, 10, 11, 12, 13, 14, 15)
+            MULX_ADX_STEP8(16, 17, 18, 19, 20, 21, 22, 23)
+            MULX_ADX_STEP8(24, 25, 26, 27, 28, 29, 30, 31)
+            MULX_ADX_STEP8(32, 33, 34, 35, 36, 37, 38, 39)
+            MULX_ADX_STEP8(40, 41, 42, 43, 44, 45, 46, 47)
+            "adcx %%r8, %%r9\n"
+            "adox %%r8, %%r9\n"
+            "movq %%r9, 48*8(%[r])\n"
+            :
+            : "d"(a[i]), [b] "r"(b), [r] "r"(r + i)
+            : "r8", "r9", "r10", "r11", "cc", "memory");
+    }
+}
+
+#undef MULX_ADX_STEP8
+#undef MULX_ADX_STEP
+#endif
+
+/** Full product function used by Num3072::Multiply(). If nullptr, the interleaved
+ *  multiplication is used instead. */
+typedef void (*MulFullType)(limb_t* r, const limb_t* a, const limb_t* b);
+MulFullType MulFull = MulFullGeneric;
+
+/** Expand a 32-byte hash into a Num3072 using ChaCha20. */
+Num3072 HashToNum3072(Span<const std::byte> hash)
+{
+    unsigned char tmp[Num3072::BYTE_SIZE];
+    static_assert(sizeof(tmp) % ChaCha20Aligned::BLOCKLEN == 0);
+    ChaCha20Aligned{hash}.Keystream(MakeWritableByteSpan(tmp));
+    return Num3072{tmp};
+}
+
 } // namespace
 
 /** Indicates whether d is larger than the modulus. */
@@ -454,6 +535,42 @@ Num3072 Num3072::GetInverse() const
 }
 
 void Num3072::Multiply(const Num3072& a)
+{
+    if (!MulFull) {
+        MultiplyInterleaved(a);
+        return;
+    }
+    limb_t product[2 * LIMBS];
+    MulFull(product, this->limbs, a.limbs);
+    ReduceProduct(product);
+}
+
+void Num3072::ReduceProduct(const limb_t (&product)[2 * LIMBS])
+{
+    /* Fold the upper half into the lower half, as 2^3072 = MAX_PRIME_DIFF (mod modulus). */
+    limb_t c = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        double_limb_t t = (double_limb_t)product[LIMBS + i] * MAX_PRIME_DIFF + product[i] + c;
+        this->limbs[i] = t;
+        c = t >> LIMB_SIZE;
+    }
+
+    /* The carry c is at most MAX_PRIME_DIFF; fold it in the same way. */
+    double_limb_t t = (double_limb_t)c * MAX_PRIME_DIFF;
+    for (int i = 0; i < LIMBS; ++i) {
+        t += this->limbs[i];
+        this->limbs[i] = t;
+        t >>= LIMB_SIZE;
+    }
+
+    /* If that wrapped around 2^3072, the remainder is small, and a single
+     * reduction brings it below the modulus. Otherwise the result may still
+     * exceed the modulus. */
+    if (t) this->FullReduce();
+    if (this->IsOverflow()) this->FullReduce();
+}
+
+void Num3072::MultiplyInterleaved(const Num3072& a)
 {
     limb_t c0 = 0, c1 = 0, c2 = 0;
     Num3072 tmp;
@@ -533,15 +650,47 @@ void Num3072::ToBytes(unsigned char (&out)[BYTE_SIZE]) {
     }
 }
 
-Num3072 MuHash3072::ToNum3072(Span<const unsigned char> in) {
-    unsigned char tmp[Num3072::BYTE_SIZE];
+std::string Num3072AutoDetect(muhash_implementation::UseImplementation use_implementation)
+{
+    std::string ret = "standard";
+    MulFull = nullptr;
 
+    if (use_implementation & muhash_implementation::USE_SOLINAS) {
+        MulFull = MulFullGeneric;
+        ret = "solinas";
+    }
+
+#if defined(HAVE_GETCPUID) && (defined(__x86_64__) || defined(__amd64__))
+    if (use_implementation & muhash_implementation::USE_MULX_ADX) {
+        uint32_t eax, ebx, ecx, edx;
+        GetCPUID(0, 0, eax, ebx, ecx, edx);
+        if (eax >= 7) {
+            GetCPUID(7, 0, eax, ebx, ecx, edx);
+            const bool have_bmi2 = (ebx >> 8) & 1;
+            const bool have_adx = (ebx >> 19) & 1;
+            if (have_bmi2 && have_adx) {
+                MulFull = MulFullMulxAdx;
+                ret = "solinas(mulx,adx)";
+            }
+        }
+    }
+#endif
+
+    return ret;
+}
+
+Num3072 MuHash3072::ToNum3072(Span<const unsigned char> in) {
     uint256 hashed_in{(HashWriter{} << in).GetSHA256()};
-    static_assert(sizeof(tmp) % ChaCha20Aligned::BLOCKLEN == 0);
-    ChaCha20Aligned{MakeByteSpan(hashed_in)}.Keystream(MakeWritableByteSpan(tmp));
-    Num3072 out{tmp};
+    return HashToNum3072(MakeByteSpan(hashed_in));
+}
 
-    return out;
+void MuHash3072::MultiplyMany(Num3072& acc, Span<const Span<const unsigned char>> in)
+{
+    std::vector<unsigned char> hashes(in.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Many(hashes.data(), in);
+    for (size_t i = 0; i < in.size(); ++i) {
+        acc.Multiply(HashToNum3072(MakeByteSpan(Span{hashes}.subspan(i * CSHA256::OUTPUT_SIZE, CSHA256::OUTPUT_SIZE))));
+    }
 }
 
 MuHash3072::MuHash3072(Span<const unsigned char> in) noexcept
@@ -583,3 +732,15 @@ MuHash3072& MuHash3072::Remove(Span<const unsigned char> in) noexcept {
     m_denominator.Multiply(ToNum3072(in));
     return *this;
 }
+
+MuHash3072& MuHash3072::InsertMany(Span<const Span<const unsigned char>> in) noexcept
+{
+    MultiplyMany(m_numerator, in);
+    return *this;
+}
+
+MuHash3072& MuHash3072::RemoveMany(Span<const Span<const unsigned char>> in) noexcept
+{
+    MultiplyMany(m_denominator, in);
+    return *this;
+}
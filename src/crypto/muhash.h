@@ -10,6 +10,7 @@
 #include <uint256.h>
 
 #include <stdint.h>
+#include <string>
 
 class Num3072
 {
@@ -52,6 +53,11 @@ public:
     // Hard coded values in MuHash3072 constructor and Finalize
     static_assert(sizeof(limb_t) == 4 || sizeof(limb_t) == 8, "bad size for limb_t");
 
+private:
+    void MultiplyInterleaved(const Num3072& a);
+    void ReduceProduct(const limb_t (&product)[2 * LIMBS]);
+
+public:
     void Multiply(const Num3072& a);
     void Divide(const Num3072& a);
     void SetToOne();
@@ -68,6 +74,24 @@ public:
     }
 };
 
+namespace muhash_implementation {
+enum UseImplementation : uint8_t {
+    /** Product and reduction interleaved limb by limb. */
+    STANDARD = 0,
+    /** Full product first, then a reduction exploiting the 2^3072 - 1103717 form of the modulus. */
+    USE_SOLINAS = 1 << 0,
+    /** As USE_SOLINAS, computing the product with the x86-64 BMI2 and ADX instructions. */
+    USE_MULX_ADX = 1 << 1,
+    USE_ALL = USE_SOLINAS | USE_MULX_ADX,
+};
+}
+
+/** Autodetect the best available Num3072 multiplication implementation.
+ *  Returns the name of the implementation. Until this is called, the
+ *  portable USE_SOLINAS implementation is used.
+ */
+std::string Num3072AutoDetect(muhash_implementation::UseImplementation use_implementation = muhash_implementation::USE_ALL);
+
 /** A class representing MuHash sets
  *
  * MuHash is a hashing algorithm that supports adding set elements in any
@@ -104,6 +128,7 @@ private:
     Num3072 m_denominator;
 
     Num3072 ToNum3072(Span<const unsigned char> in);
+    static void MultiplyMany(Num3072& acc, Span<const Span<const unsigned char>> in);
 
 public:
     /* The empty set. */
@@ -118,6 +143,14 @@ public:
     /* Remove a single piece of data from the set. */
     MuHash3072& Remove(Span<const unsigned char> in) noexcept;
 
+    /* Insert several pieces of data into the set. Equivalent to calling
+     * Insert() for each of them, but their hashes are computed in parallel
+     * lanes when a multi-buffer SHA256 implementation is available. */
+    MuHash3072& InsertMany(Span<const Span<const unsigned char>> in) noexcept;
+
+    /* Remove several pieces of data from the set, see InsertMany(). */
+    MuHash3072& RemoveMany(Span<const Span<const unsigned char>> in) noexcept;
+
     /* Multiply (resulting in a hash for the union of the sets) */
     MuHash3072& operator*=(const MuHash3072& mul) noexcept;
 
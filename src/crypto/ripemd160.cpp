@@ -4,10 +4,19 @@
 
 #include <crypto/ripemd160.h>
 
+#include <compat/cpuid.h>
 #include <crypto/common.h>
+#include <crypto/sha256.h>
 
 #include <string.h>
 
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+namespace ripemd160_avx2
+{
+void Hash_8way_32(unsigned char* out, const unsigned char* in);
+}
+#endif
+
 // Internal implementation code.
 namespace
 {
@@ -290,3 +299,23 @@ CRIPEMD160& CRIPEMD160::Reset()
     ripemd160::Initialize(s);
     return *this;
 }
+
+void RIPEMD160_32Many(unsigned char* output, const unsigned char* input, size_t count)
+{
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    if (GetSIMDSupport().avx2) {
+        while (count >= 8) {
+            ripemd160_avx2::Hash_8way_32(output, input);
+            output += 8 * CRIPEMD160::OUTPUT_SIZE;
+            input += 8 * 32;
+            count -= 8;
+        }
+    }
+#endif
+    while (count) {
+        CRIPEMD160().Write(input, 32).Finalize(output);
+        output += CRIPEMD160::OUTPUT_SIZE;
+        input += 32;
+        --count;
+    }
+}
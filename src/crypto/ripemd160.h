@@ -25,4 +25,11 @@ public:
     CRIPEMD160& Reset();
 };
 
+/** Compute the RIPEMD-160 of each of count consecutive 32-byte messages, as in
+ *  the outer step of Hash160. Several are hashed at once when SIMD is available.
+ *  output:  pointer to a count*20 byte output buffer
+ *  input:   pointer to a count*32 byte input buffer
+ */
+void RIPEMD160_32Many(unsigned char* output, const unsigned char* input, size_t count);
+
 #endif // BITCOIN_CRYPTO_RIPEMD160_H
@@ -34,6 +34,8 @@
 #include <string.h>
 #include <openssl/sha.h>
 
+#include <atomic>
+
 #if defined(USE_SSE2) && !defined(USE_SSE2_ALWAYS)
 #ifdef _MSC_VER
 // MSVC 64bit is unable to use inline asm
@@ -326,8 +328,16 @@ std::string scrypt_detect_sse2()
 }
 #endif
 
+static std::atomic<uint64_t> g_scrypt_count{0};
+
 void scrypt_1024_1_1_256(const char *input, char *output)
 {
 	char scratchpad[SCRYPT_SCRATCHPAD_SIZE];
     scrypt_1024_1_1_256_sp(input, output, scratchpad);
+    g_scrypt_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t scrypt_1024_1_1_256_count()
+{
+    return g_scrypt_count.load(std::memory_order_relaxed);
 }
@@ -7,6 +7,8 @@
 static const int SCRYPT_SCRATCHPAD_SIZE = 131072 + 63;
 
 void scrypt_1024_1_1_256(const char *input, char *output);
+/** Number of scrypt_1024_1_1_256() hashes computed since startup. */
+uint64_t scrypt_1024_1_1_256_count();
 void scrypt_1024_1_1_256_sp_generic(const char *input, char *output, char *scratchpad);
 
 #if defined(USE_SSE2)
@@ -11,9 +11,9 @@
 #include <cassert>
 #include <cstring>
 
-#if !defined(DISABLE_OPTIMIZED_SHA256)
 #include <compat/cpuid.h>
 
+#if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(__linux__) && defined(ENABLE_ARM_SHANI)
 #include <sys/auxv.h>
 #include <asm/hwcap.h>
@@ -41,14 +41,31 @@ namespace sha256d64_avx2
 void Transform_8way(unsigned char* out, const unsigned char* in);
 }
 
+namespace sha256_avx2
+{
+void Transform_8way(uint32_t* s, const unsigned char* const* chunks);
+}
+
 namespace sha256d64_x86_shani
 {
 void Transform_2way(unsigned char* out, const unsigned char* in);
+void Transform_4way(unsigned char* out, const unsigned char* in);
+}
+
+namespace sha256d64_avx512
+{
+void Transform_16way(unsigned char* out, const unsigned char* in);
+}
+
+namespace sha256_avx512
+{
+void Transform_16way(uint32_t* s, const unsigned char* const* chunks);
 }
 
 namespace sha256_x86_shani
 {
 void Transform(uint32_t* s, const unsigned char* chunk, size_t blocks);
+void Transform_2way(uint32_t* s, const unsigned char* const* chunks);
 }
 
 namespace sha256_arm_shani
@@ -439,6 +456,7 @@ void TransformD64(unsigned char* out, const unsigned char* in)
 
 typedef void (*TransformType)(uint32_t*, const unsigned char*, size_t);
 typedef void (*TransformD64Type)(unsigned char*, const unsigned char*);
+typedef void (*TransformMultiType)(uint32_t*, const unsigned char* const*);
 
 template<TransformType tr>
 void TransformD64Wrapper(unsigned char* out, const unsigned char* in)
@@ -484,6 +502,10 @@ TransformD64Type TransformD64 = sha256::TransformD64;
 TransformD64Type TransformD64_2way = nullptr;
 TransformD64Type TransformD64_4way = nullptr;
 TransformD64Type TransformD64_8way = nullptr;
+TransformD64Type TransformD64_16way = nullptr;
+//! Multi-buffer transform of TransformMulti_lanes independent states, or nullptr.
+TransformMultiType TransformMulti = nullptr;
+size_t TransformMulti_lanes = 0;
 
 bool SelfTest() {
     // Input state (equal to the initial SHA256 state)
@@ -567,21 +589,59 @@ bool SelfTest() {
         if (!std::equal(out, out + 256, result_d64)) return false;
     }
 
+    // Test TransformD64_16way, if available, on the 8 messages twice over.
+    if (TransformD64_16way) {
+        unsigned char in[1024];
+        unsigned char out[512];
+        std::copy(data + 1, data + 513, in);
+        std::copy(data + 1, data + 513, in + 512);
+        TransformD64_16way(out, in);
+        if (!std::equal(out, out + 256, result_d64) || !std::equal(out + 256, out + 512, result_d64)) return false;
+    }
+
+    // Test TransformMulti, if available: lane i starts from the state after i
+    // blocks and transforms block i, which must give the state after i + 1.
+    if (TransformMulti) {
+        uint32_t states[8 * 16];
+        const unsigned char* chunks[16];
+        for (size_t i = 0; i < TransformMulti_lanes; ++i) {
+            std::copy(result[i % 8], result[i % 8] + 8, states + 8 * i);
+            chunks[i] = data + 1 + 64 * (i % 8);
+        }
+        TransformMulti(states, chunks);
+        for (size_t i = 0; i < TransformMulti_lanes; ++i) {
+            if (!std::equal(states + 8 * i, states + 8 * i + 8, result[i % 8 + 1])) return false;
+        }
+    }
+
     return true;
 }
 
-#if !defined(DISABLE_OPTIMIZED_SHA256)
-#if (defined(__x86_64__) || defined(__amd64__) || defined(__i386__))
-/** Check whether the OS has enabled AVX registers. */
-bool AVXEnabled()
+} // namespace
+
+const SIMDSupport& GetSIMDSupport()
 {
-    uint32_t a, d;
-    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
-    return (a & 6) == 6;
-}
+    static const SIMDSupport support{[] {
+        SIMDSupport ret;
+#if defined(HAVE_GETCPUID)
+        uint32_t eax, ebx, ecx, edx;
+        GetCPUID(0, 0, eax, ebx, ecx, edx);
+        const uint32_t max_leaf{eax};
+        GetCPUID(1, 0, eax, ebx, ecx, edx);
+        // AVX needs XSAVE, and the OS must have enabled the XMM and YMM registers.
+        if (max_leaf < 7 || !((ecx >> 27) & 1) || !((ecx >> 28) & 1)) return ret;
+        uint32_t xcr0, xcr0_hi;
+        __asm__("xgetbv" : "=a"(xcr0), "=d"(xcr0_hi) : "c"(0));
+        if ((xcr0 & 6) != 6) return ret;
+        GetCPUID(7, 0, eax, ebx, ecx, edx);
+        ret.avx2 = (ebx >> 5) & 1;
+        // AVX-512 additionally needs the opmask and upper ZMM registers.
+        ret.avx512 = ((ebx >> 16) & 1) && (xcr0 & 0xe6) == 0xe6;
 #endif
-#endif // DISABLE_OPTIMIZED_SHA256
-} // namespace
+        return ret;
+    }()};
+    return support;
+}
 
 
 std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implementation)
@@ -592,30 +652,29 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     TransformD64_2way = nullptr;
     TransformD64_4way = nullptr;
     TransformD64_8way = nullptr;
+    TransformD64_16way = nullptr;
+    TransformMulti = nullptr;
+    TransformMulti_lanes = 0;
 
 #if !defined(DISABLE_OPTIMIZED_SHA256)
 #if defined(HAVE_GETCPUID)
     bool have_sse4 = false;
-    bool have_xsave = false;
-    bool have_avx = false;
     [[maybe_unused]] bool have_avx2 = false;
+    [[maybe_unused]] bool have_avx512 = false;
     [[maybe_unused]] bool have_x86_shani = false;
-    [[maybe_unused]] bool enabled_avx = false;
 
     uint32_t eax, ebx, ecx, edx;
     GetCPUID(1, 0, eax, ebx, ecx, edx);
     if (use_implementation & sha256_implementation::USE_SSE4) {
         have_sse4 = (ecx >> 19) & 1;
     }
-    have_xsave = (ecx >> 27) & 1;
-    have_avx = (ecx >> 28) & 1;
-    if (have_xsave && have_avx) {
-        enabled_avx = AVXEnabled();
-    }
     if (have_sse4) {
         GetCPUID(7, 0, eax, ebx, ecx, edx);
         if (use_implementation & sha256_implementation::USE_AVX2) {
-            have_avx2 = (ebx >> 5) & 1;
+            have_avx2 = GetSIMDSupport().avx2;
+        }
+        if (use_implementation & sha256_implementation::USE_AVX512) {
+            have_avx512 = GetSIMDSupport().avx512;
         }
         if (use_implementation & sha256_implementation::USE_SHANI) {
             have_x86_shani = (ebx >> 29) & 1;
@@ -627,7 +686,10 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
         Transform = sha256_x86_shani::Transform;
         TransformD64 = TransformD64Wrapper<sha256_x86_shani::Transform>;
         TransformD64_2way = sha256d64_x86_shani::Transform_2way;
-        ret = "x86_shani(1way,2way)";
+        TransformD64_4way = sha256d64_x86_shani::Transform_4way;
+        TransformMulti = sha256_x86_shani::Transform_2way;
+        TransformMulti_lanes = 2;
+        ret = "x86_shani(1way,2way,4way)";
         have_sse4 = false; // Disable SSE4/AVX2;
         have_avx2 = false;
     }
@@ -646,11 +708,22 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
     }
 
 #if defined(ENABLE_AVX2)
-    if (have_avx2 && have_avx && enabled_avx) {
+    if (have_avx2) {
         TransformD64_8way = sha256d64_avx2::Transform_8way;
+        TransformMulti = sha256_avx2::Transform_8way;
+        TransformMulti_lanes = 8;
         ret += ",avx2(8way)";
     }
 #endif
+
+#if defined(ENABLE_AVX512)
+    if (have_avx512) {
+        TransformD64_16way = sha256d64_avx512::Transform_16way;
+        TransformMulti = sha256_avx512::Transform_16way;
+        TransformMulti_lanes = 16;
+        ret += ",avx512(16way)";
+    }
+#endif
 #endif // defined(HAVE_GETCPUID)
 
 #if defined(ENABLE_ARM_SHANI)
@@ -750,6 +823,14 @@ CSHA256& CSHA256::Reset()
 
 void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
 {
+    if (TransformD64_16way) {
+        while (blocks >= 16) {
+            TransformD64_16way(out, in);
+            out += 512;
+            in += 1024;
+            blocks -= 16;
+        }
+    }
     if (TransformD64_8way) {
         while (blocks >= 8) {
             TransformD64_8way(out, in);
@@ -781,3 +862,138 @@ void SHA256D64(unsigned char* out, const unsigned char* in, size_t blocks)
         --blocks;
     }
 }
+
+namespace {
+/** Progress of one message through a lane of SHA256DMany(). */
+struct MultiLane {
+    //! Remaining full 64-byte blocks of the message, read in place.
+    const unsigned char* data;
+    size_t blocks;
+    //! Remaining blocks of the copied message tail plus padding.
+    const unsigned char* tail;
+    size_t tail_blocks;
+    //! Which message this is, and whether we are in the outer hash of the double-SHA256.
+    size_t index;
+    bool outer;
+    unsigned char pad[128];
+
+    void Start(const unsigned char* msg, size_t len, uint32_t* s)
+    {
+        data = msg;
+        blocks = len / 64;
+        const size_t rem{len % 64};
+        if (rem) std::memcpy(pad, msg + 64 * blocks, rem);
+        pad[rem] = 0x80;
+        tail_blocks = rem < 56 ? 1 : 2;
+        std::memset(pad + rem + 1, 0, 64 * tail_blocks - rem - 9);
+        WriteBE64(pad + 64 * tail_blocks - 8, uint64_t(len) << 3);
+        tail = pad;
+        sha256::Initialize(s);
+    }
+
+    const unsigned char* Next() const { return blocks ? data : tail; }
+
+    /** Step past the chunk that was just transformed. Returns true once the hash is complete. */
+    bool Advance()
+    {
+        if (blocks) {
+            data += 64;
+            --blocks;
+        } else {
+            tail += 64;
+            --tail_blocks;
+        }
+        return blocks == 0 && tail_blocks == 0;
+    }
+
+    /** Called when a hash completes: start the outer hash, or emit the result. Returns true when done. */
+    bool Finish(uint32_t* s, unsigned char* output)
+    {
+        unsigned char digest[32];
+        for (int i = 0; i < 8; ++i) WriteBE32(digest + 4 * i, s[i]);
+        if (outer) {
+            std::memcpy(output + 32 * index, digest, 32);
+            return true;
+        }
+        outer = true;
+        Start(digest, sizeof(digest), s);
+        return false;
+    }
+};
+
+constexpr size_t MAX_MULTI_LANES{16};
+
+/** Shared driver of SHA256Many() and SHA256DMany(). */
+void SHA256MultiBuffer(unsigned char* output, Span<const Span<const unsigned char>> inputs, bool double_hash)
+{
+    const size_t lanes{TransformMulti ? TransformMulti_lanes : 0};
+    if (lanes == 0) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (!double_hash) {
+                CSHA256().Write(inputs[i].data(), inputs[i].size()).Finalize(output + 32 * i);
+                continue;
+            }
+            unsigned char digest[CSHA256::OUTPUT_SIZE];
+            CSHA256().Write(inputs[i].data(), inputs[i].size()).Finalize(digest);
+            CSHA256().Write(digest, sizeof(digest)).Finalize(output + 32 * i);
+        }
+        return;
+    }
+    assert(lanes <= MAX_MULTI_LANES);
+
+    static const unsigned char idle_chunk[64]{};
+    uint32_t states[8 * MAX_MULTI_LANES];
+    MultiLane lane[MAX_MULTI_LANES];
+    bool busy[MAX_MULTI_LANES]{};
+    const unsigned char* chunks[MAX_MULTI_LANES];
+    size_t next{0};
+    size_t active{0};
+
+    const auto start_next{[&](size_t l) {
+        busy[l] = next < inputs.size();
+        if (!busy[l]) return;
+        lane[l].index = next;
+        lane[l].outer = !double_hash;
+        lane[l].Start(inputs[next].data(), inputs[next].size(), states + 8 * l);
+        ++next;
+        ++active;
+    }};
+    for (size_t l = 0; l < lanes; ++l) start_next(l);
+
+    while (active) {
+        // Once few lanes are left, the single-stream transform is cheaper than
+        // running the multi-buffer kernel mostly empty.
+        if (next == inputs.size() && active <= std::max<size_t>(1, lanes / 4)) {
+            for (size_t l = 0; l < lanes; ++l) {
+                if (!busy[l]) continue;
+                uint32_t* s{states + 8 * l};
+                do {
+                    Transform(s, lane[l].data, lane[l].blocks);
+                    Transform(s, lane[l].tail, lane[l].tail_blocks);
+                } while (!lane[l].Finish(s, output));
+            }
+            return;
+        }
+        for (size_t l = 0; l < lanes; ++l) {
+            chunks[l] = busy[l] ? lane[l].Next() : idle_chunk;
+        }
+        TransformMulti(states, chunks);
+        for (size_t l = 0; l < lanes; ++l) {
+            if (busy[l] && lane[l].Advance() && lane[l].Finish(states + 8 * l, output)) {
+                --active;
+                start_next(l);
+            }
+        }
+    }
+}
+} // namespace
+
+void SHA256Many(unsigned char* output, Span<const Span<const unsigned char>> inputs)
+{
+    SHA256MultiBuffer(output, inputs, /*double_hash=*/false);
+}
+
+void SHA256DMany(unsigned char* output, Span<const Span<const unsigned char>> inputs)
+{
+    SHA256MultiBuffer(output, inputs, /*double_hash=*/true);
+}
@@ -5,6 +5,8 @@
 #ifndef BITCOIN_CRYPTO_SHA256_H
 #define BITCOIN_CRYPTO_SHA256_H
 
+#include <span.h>
+
 #include <cstdlib>
 #include <stdint.h>
 #include <string>
@@ -32,12 +34,25 @@ enum UseImplementation : uint8_t {
     USE_SSE4 = 1 << 0,
     USE_AVX2 = 1 << 1,
     USE_SHANI = 1 << 2,
+    USE_AVX512 = 1 << 3,
     USE_SSE4_AND_AVX2 = USE_SSE4 | USE_AVX2,
     USE_SSE4_AND_SHANI = USE_SSE4 | USE_SHANI,
-    USE_ALL = USE_SSE4 | USE_AVX2 | USE_SHANI,
+    USE_SSE4_AND_AVX512 = USE_SSE4 | USE_AVX2 | USE_AVX512,
+    USE_ALL = USE_SSE4 | USE_AVX2 | USE_SHANI | USE_AVX512,
 };
 }
 
+/** Vector extensions that the CPU supports and the OS has enabled. */
+struct SIMDSupport {
+    bool avx2{false};
+    bool avx512{false};
+};
+
+/** Detect the vector extensions the multi-lane hash implementations can use.
+ *  Checked once, on first use.
+ */
+const SIMDSupport& GetSIMDSupport();
+
 /** Autodetect the best available SHA256 implementation.
  *  Returns the name of the implementation.
  */
@@ -50,4 +65,15 @@ std::string SHA256AutoDetect(sha256_implementation::UseImplementation use_implem
  */
 void SHA256D64(unsigned char* output, const unsigned char* input, size_t blocks);
 
+/** Compute the double-SHA256 of each of a list of messages of arbitrary
+ *  length. When a multi-buffer implementation is available, several messages
+ *  are hashed in parallel, one per lane.
+ *  output:  pointer to an inputs.size()*32 byte output buffer
+ *  inputs:  the messages
+ */
+void SHA256DMany(unsigned char* output, Span<const Span<const unsigned char>> inputs);
+
+/** Like SHA256DMany(), but a single SHA256 of each message. */
+void SHA256Many(unsigned char* output, Span<const Span<const unsigned char>> inputs);
+
 #endif // BITCOIN_CRYPTO_SHA256_H
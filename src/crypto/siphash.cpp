@@ -5,7 +5,25 @@
 
 #include <crypto/siphash.h>
 
+#include <compat/cpuid.h>
+#include <crypto/common.h>
+#include <crypto/sha256.h>
+
+#include <array>
 #include <bit>
+#include <cassert>
+#include <vector>
+
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+namespace siphash_avx2 {
+void Hash_4way(uint64_t k0, uint64_t k1, const uint64_t* words, size_t num_words, uint64_t* out);
+}
+#endif
+#if defined(ENABLE_AVX512) && defined(HAVE_GETCPUID)
+namespace siphash_avx512 {
+void Hash_8way(uint64_t k0, uint64_t k1, const uint64_t* words, size_t num_words, uint64_t* out);
+}
+#endif
 
 #define SIPROUND do { \
     v0 += v1; v1 = std::rotl(v1, 13); v1 ^= v0; \
@@ -173,3 +191,103 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+namespace {
+
+/** Messages of up to this many words (including the final length word) are hashed in parallel lanes. */
+constexpr size_t MAX_MULTI_WORDS{8};
+constexpr size_t MAX_LANES{8};
+
+/** The number of messages hashed in parallel: 8 with AVX-512, 4 with AVX2, 1 otherwise. */
+size_t Lanes()
+{
+#if defined(ENABLE_AVX512) && defined(HAVE_GETCPUID)
+    if (GetSIMDSupport().avx512) return 8;
+#endif
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+    if (GetSIMDSupport().avx2) return 4;
+#endif
+    return 1;
+}
+
+/** Hash messages of num_words words each (the last one holding the length byte) in
+ *  groups of Lanes(). Message i is given by get_word(i, j) for j in [0, num_words).
+ *  Returns how many of the count messages were hashed; the caller hashes the rest. */
+template <typename F>
+size_t HashGroups(uint64_t k0, uint64_t k1, size_t count, size_t num_words, F get_word, uint64_t* out)
+{
+    const size_t lanes{Lanes()};
+    if (lanes == 1) return 0;
+    assert(num_words <= MAX_MULTI_WORDS);
+    std::array<uint64_t, MAX_LANES * MAX_MULTI_WORDS> words;
+    size_t done{0};
+    for (; done + lanes <= count; done += lanes) {
+        for (size_t j = 0; j < num_words; ++j) {
+            for (size_t lane = 0; lane < lanes; ++lane) words[j * lanes + lane] = get_word(done + lane, j);
+        }
+#if defined(ENABLE_AVX512) && defined(HAVE_GETCPUID)
+        if (lanes == 8) {
+            siphash_avx512::Hash_8way(k0, k1, words.data(), num_words, out + done);
+            continue;
+        }
+#endif
+#if defined(ENABLE_AVX2) && defined(HAVE_GETCPUID)
+        siphash_avx2::Hash_4way(k0, k1, words.data(), num_words, out + done);
+#endif
+    }
+    return done;
+}
+
+} // namespace
+
+void SipHashUint256Many(uint64_t k0, uint64_t k1, Span<const uint256* const> vals, uint64_t* out)
+{
+    const auto get_word{[&](size_t i, size_t j) { return j < 4 ? vals[i]->GetUint64(j) : uint64_t{4} << 59; }};
+    for (size_t i = HashGroups(k0, k1, vals.size(), 5, get_word, out); i < vals.size(); ++i) {
+        out[i] = SipHashUint256(k0, k1, *vals[i]);
+    }
+}
+
+void SipHashUint256ExtraMany(uint64_t k0, uint64_t k1, Span<const uint256* const> vals, Span<const uint32_t> extras, uint64_t* out)
+{
+    assert(vals.size() == extras.size());
+    const auto get_word{[&](size_t i, size_t j) { return j < 4 ? vals[i]->GetUint64(j) : (uint64_t{36} << 56) | extras[i]; }};
+    for (size_t i = HashGroups(k0, k1, vals.size(), 5, get_word, out); i < vals.size(); ++i) {
+        out[i] = SipHashUint256Extra(k0, k1, *vals[i], extras[i]);
+    }
+}
+
+void SipHashMany(uint64_t k0, uint64_t k1, Span<const Span<const unsigned char>> data, uint64_t* out)
+{
+    // Messages can only share lanes if they have the same number of words, so
+    // group them by that first. Longer messages are hashed one at a time.
+    std::array<std::vector<size_t>, MAX_MULTI_WORDS + 1> groups;
+    for (size_t i = 0; i < data.size(); ++i) {
+        const size_t num_words{data[i].size() / 8 + 1};
+        if (Lanes() > 1 && num_words <= MAX_MULTI_WORDS) {
+            groups[num_words].push_back(i);
+        } else {
+            out[i] = CSipHasher(k0, k1).Write(data[i]).Finalize();
+        }
+    }
+    std::array<uint64_t, MAX_LANES> group_out;
+    for (size_t num_words = 1; num_words <= MAX_MULTI_WORDS; ++num_words) {
+        const std::vector<size_t>& group{groups[num_words]};
+        const auto get_word{[&](size_t i, size_t j) {
+            const Span<const unsigned char> msg{data[group[i]]};
+            if (j + 1 < num_words) return ReadLE64(msg.data() + 8 * j);
+            uint64_t last{uint64_t{msg.size()} << 56};
+            for (size_t k = 8 * j; k < msg.size(); ++k) last |= uint64_t{msg[k]} << (8 * (k % 8));
+            return last;
+        }};
+        // Hash one set of lanes at a time, to scatter the results back.
+        size_t done{0};
+        for (; done + Lanes() <= group.size(); done += Lanes()) {
+            HashGroups(k0, k1, Lanes(), num_words, [&](size_t i, size_t j) { return get_word(done + i, j); }, group_out.data());
+            for (size_t i = 0; i < Lanes(); ++i) out[group[done + i]] = group_out[i];
+        }
+        for (; done < group.size(); ++done) {
+            out[group[done]] = CSipHasher(k0, k1).Write(data[group[done]]).Finalize();
+        }
+    }
+}
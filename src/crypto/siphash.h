@@ -46,4 +46,15 @@ public:
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
 
+/** Batched versions of the above, all with the same key. Depending on the CPU,
+ *  4 (AVX2) or 8 (AVX-512) messages are hashed in parallel.
+ *
+ *  SipHashUint256Many:      out[i] = SipHashUint256(k0, k1, *vals[i])
+ *  SipHashUint256ExtraMany: out[i] = SipHashUint256Extra(k0, k1, *vals[i], extras[i])
+ *  SipHashMany:             out[i] = CSipHasher(k0, k1).Write(data[i]).Finalize()
+ */
+void SipHashUint256Many(uint64_t k0, uint64_t k1, Span<const uint256* const> vals, uint64_t* out);
+void SipHashUint256ExtraMany(uint64_t k0, uint64_t k1, Span<const uint256* const> vals, Span<const uint32_t> extras, uint64_t* out);
+void SipHashMany(uint64_t k0, uint64_t k1, Span<const Span<const unsigned char>> data, uint64_t* out);
+
 #endif // BITCOIN_CRYPTO_SIPHASH_H
@@ -0,0 +1,71 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef ENABLE_AVX2
+
+#include <stddef.h>
+#include <stdint.h>
+#include <immintrin.h>
+
+#include <attributes.h>
+
+namespace siphash_avx2 {
+namespace {
+
+__m256i inline K(uint64_t x) { return _mm256_set1_epi64x(x); }
+
+__m256i inline Add(__m256i x, __m256i y) { return _mm256_add_epi64(x, y); }
+__m256i inline Xor(__m256i x, __m256i y) { return _mm256_xor_si256(x, y); }
+
+template <int n>
+__m256i inline Rotl(__m256i x) { return _mm256_or_si256(_mm256_slli_epi64(x, n), _mm256_srli_epi64(x, 64 - n)); }
+/** Rotations by multiples of 16 bits are a single shuffle. */
+template <>
+__m256i inline Rotl<16>(__m256i x)
+{
+    const __m256i rot16 = _mm256_setr_epi8(6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13,
+                                           6, 7, 0, 1, 2, 3, 4, 5, 14, 15, 8, 9, 10, 11, 12, 13);
+    return _mm256_shuffle_epi8(x, rot16);
+}
+template <>
+__m256i inline Rotl<32>(__m256i x) { return _mm256_shuffle_epi32(x, 0xb1); }
+
+void ALWAYS_INLINE SipRound(__m256i& v0, __m256i& v1, __m256i& v2, __m256i& v3)
+{
+    v0 = Add(v0, v1); v1 = Rotl<13>(v1); v1 = Xor(v1, v0);
+    v0 = Rotl<32>(v0);
+    v2 = Add(v2, v3); v3 = Rotl<16>(v3); v3 = Xor(v3, v2);
+    v0 = Add(v0, v3); v3 = Rotl<21>(v3); v3 = Xor(v3, v0);
+    v2 = Add(v2, v1); v1 = Rotl<17>(v1); v1 = Xor(v1, v2);
+    v2 = Rotl<32>(v2);
+}
+
+} // namespace
+
+void Hash_4way(uint64_t k0, uint64_t k1, const uint64_t* words, size_t num_words, uint64_t* out)
+{
+    __m256i v0 = K(0x736f6d6570736575ULL ^ k0);
+    __m256i v1 = K(0x646f72616e646f6dULL ^ k1);
+    __m256i v2 = K(0x6c7967656e657261ULL ^ k0);
+    __m256i v3 = K(0x7465646279746573ULL ^ k1);
+
+    for (size_t i = 0; i < num_words; ++i) {
+        const __m256i m = _mm256_loadu_si256((const __m256i*)(words + 4 * i));
+        v3 = Xor(v3, m);
+        SipRound(v0, v1, v2, v3);
+        SipRound(v0, v1, v2, v3);
+        v0 = Xor(v0, m);
+    }
+
+    v2 = Xor(v2, K(0xFF));
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    SipRound(v0, v1, v2, v3);
+    _mm256_storeu_si256((__m256i*)out, Xor(Xor(v0, v1), Xor(v2, v3)));
+}
+
+} // namespace siphash_avx2
+
+#endif
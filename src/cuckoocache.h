@@ -482,6 +482,14 @@ public:
             }
         return false;
     }
+
+    /** memory_usage returns the approximate number of bytes allocated for the
+     * table and the collection and epoch flags. It does not change after setup.
+     */
+    size_t memory_usage() const
+    {
+        return table.capacity() * sizeof(Element) + (size + 7) / 8 + (epoch_flags.capacity() + 7) / 8;
+    }
 };
 } // namespace CuckooCache
 
@@ -337,11 +337,37 @@ std::vector<unsigned char> CDBWrapper::CreateObfuscateKey() const
     return ret;
 }
 
-std::optional<std::string> CDBWrapper::ReadImpl(Span<const std::byte> key) const
+struct CDBSnapshot::SnapshotImpl {
+    const leveldb::Snapshot* const snapshot;
+
+    explicit SnapshotImpl(const leveldb::Snapshot* _snapshot) : snapshot{_snapshot} {}
+};
+
+CDBSnapshot::CDBSnapshot(const CDBWrapper& parent, std::unique_ptr<SnapshotImpl> impl) : m_parent{parent},
+                                                                                       m_impl_snapshot{std::move(impl)} {}
+
+CDBSnapshot::~CDBSnapshot()
+{
+    m_parent.DBContext().pdb->ReleaseSnapshot(m_impl_snapshot->snapshot);
+}
+
+std::unique_ptr<CDBSnapshot> CDBWrapper::GetSnapshot() const
+{
+    return std::make_unique<CDBSnapshot>(*this, std::make_unique<CDBSnapshot::SnapshotImpl>(DBContext().pdb->GetSnapshot()));
+}
+
+/** Apply a snapshot, if any, to a copy of the given read options. */
+static leveldb::ReadOptions WithSnapshot(leveldb::ReadOptions options, const CDBSnapshot* snapshot)
+{
+    if (snapshot) options.snapshot = snapshot->Impl().snapshot;
+    return options;
+}
+
+std::optional<std::string> CDBWrapper::ReadImpl(Span<const std::byte> key, const CDBSnapshot* snapshot) const
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
     std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
+    leveldb::Status status = DBContext().pdb->Get(WithSnapshot(DBContext().readoptions, snapshot), slKey, &strValue);
     if (!status.ok()) {
         if (status.IsNotFound())
             return std::nullopt;
@@ -351,12 +377,12 @@ std::optional<std::string> CDBWrapper::ReadImpl(Span<const std::byte> key) const
     return strValue;
 }
 
-bool CDBWrapper::ExistsImpl(Span<const std::byte> key) const
+bool CDBWrapper::ExistsImpl(Span<const std::byte> key, const CDBSnapshot* snapshot) const
 {
     leveldb::Slice slKey(CharCast(key.data()), key.size());
 
     std::string strValue;
-    leveldb::Status status = DBContext().pdb->Get(DBContext().readoptions, slKey, &strValue);
+    leveldb::Status status = DBContext().pdb->Get(WithSnapshot(DBContext().readoptions, snapshot), slKey, &strValue);
     if (!status.ok()) {
         if (status.IsNotFound())
             return false;
@@ -392,9 +418,9 @@ struct CDBIterator::IteratorImpl {
 CDBIterator::CDBIterator(const CDBWrapper& _parent, std::unique_ptr<IteratorImpl> _piter) : parent(_parent),
                                                                                             m_impl_iter(std::move(_piter)) {}
 
-CDBIterator* CDBWrapper::NewIterator()
+CDBIterator* CDBWrapper::NewIterator(const CDBSnapshot* snapshot) const
 {
-    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(DBContext().iteroptions))};
+    return new CDBIterator{*this, std::make_unique<CDBIterator::IteratorImpl>(DBContext().pdb->NewIterator(WithSnapshot(DBContext().iteroptions, snapshot)))};
 }
 
 void CDBIterator::SeekImpl(Span<const std::byte> key)
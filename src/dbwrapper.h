@@ -179,10 +179,12 @@ public:
 };
 
 struct LevelDBContext;
+class CDBSnapshot;
 
 class CDBWrapper
 {
     friend const std::vector<unsigned char>& dbwrapper_private::GetObfuscateKey(const CDBWrapper &w);
+    friend class CDBSnapshot;
 private:
     //! holds all leveldb-specific fields of this class
     std::unique_ptr<LevelDBContext> m_db_context;
@@ -207,8 +209,8 @@ private:
     //! whether or not the database resides in memory
     bool m_is_memory;
 
-    std::optional<std::string> ReadImpl(Span<const std::byte> key) const;
-    bool ExistsImpl(Span<const std::byte> key) const;
+    std::optional<std::string> ReadImpl(Span<const std::byte> key, const CDBSnapshot* snapshot) const;
+    bool ExistsImpl(Span<const std::byte> key, const CDBSnapshot* snapshot) const;
     size_t EstimateSizeImpl(Span<const std::byte> key1, Span<const std::byte> key2) const;
     auto& DBContext() const LIFETIMEBOUND { return *Assert(m_db_context); }
 
@@ -219,13 +221,14 @@ public:
     CDBWrapper(const CDBWrapper&) = delete;
     CDBWrapper& operator=(const CDBWrapper&) = delete;
 
+    /** Read the value stored at key, as of the given snapshot if one is passed. */
     template <typename K, typename V>
-    bool Read(const K& key, V& value) const
+    bool Read(const K& key, V& value, const CDBSnapshot* snapshot = nullptr) const
     {
         DataStream ssKey{};
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
-        std::optional<std::string> strValue{ReadImpl(ssKey)};
+        std::optional<std::string> strValue{ReadImpl(ssKey, snapshot)};
         if (!strValue) {
             return false;
         }
@@ -256,12 +259,12 @@ public:
     }
 
     template <typename K>
-    bool Exists(const K& key) const
+    bool Exists(const K& key, const CDBSnapshot* snapshot = nullptr) const
     {
         DataStream ssKey{};
         ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
         ssKey << key;
-        return ExistsImpl(ssKey);
+        return ExistsImpl(ssKey, snapshot);
     }
 
     template <typename K>
@@ -277,7 +280,15 @@ public:
     // Get an estimate of LevelDB memory usage (in bytes).
     size_t DynamicMemoryUsage() const;
 
-    CDBIterator* NewIterator();
+    /** Return an iterator over the database, or over the given snapshot of it. */
+    CDBIterator* NewIterator(const CDBSnapshot* snapshot = nullptr) const;
+
+    /**
+     * Take a consistent, read-only snapshot of the current database state.
+     * Reads through it are not affected by later writes, and need no external
+     * locking. The snapshot must not outlive this CDBWrapper.
+     */
+    std::unique_ptr<CDBSnapshot> GetSnapshot() const;
 
     /**
      * Return true if the database managed by this class contains no entries.
@@ -296,4 +307,32 @@ public:
     }
 };
 
+/** A read-only, point-in-time view of a CDBWrapper. @see CDBWrapper::GetSnapshot() */
+class CDBSnapshot
+{
+public:
+    struct SnapshotImpl;
+
+private:
+    const CDBWrapper& m_parent;
+    const std::unique_ptr<SnapshotImpl> m_impl_snapshot;
+
+public:
+    CDBSnapshot(const CDBWrapper& parent, std::unique_ptr<SnapshotImpl> impl);
+    ~CDBSnapshot();
+
+    CDBSnapshot(const CDBSnapshot&) = delete;
+    CDBSnapshot& operator=(const CDBSnapshot&) = delete;
+
+    const SnapshotImpl& Impl() const { return *m_impl_snapshot; }
+
+    template <typename K, typename V>
+    bool Read(const K& key, V& value) const { return m_parent.Read(key, value, this); }
+
+    template <typename K>
+    bool Exists(const K& key) const { return m_parent.Exists(key, this); }
+
+    CDBIterator* NewIterator() const { return m_parent.NewIterator(this); }
+};
+
 #endif // BITCOIN_DBWRAPPER_H
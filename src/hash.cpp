@@ -76,6 +76,20 @@ void BIP32Hash(const ChainCode &chainCode, unsigned int nChild, unsigned char he
     CHMAC_SHA512(chainCode.begin(), chainCode.size()).Write(&header, 1).Write(data, 32).Write(num, 4).Finalize(output);
 }
 
+std::vector<uint160> Hash160Many(Span<const Span<const unsigned char>> inputs)
+{
+    std::vector<unsigned char> digests(inputs.size() * CSHA256::OUTPUT_SIZE);
+    SHA256Many(digests.data(), inputs);
+    std::vector<unsigned char> hashes(inputs.size() * CRIPEMD160::OUTPUT_SIZE);
+    RIPEMD160_32Many(hashes.data(), digests.data(), inputs.size());
+    std::vector<uint160> result;
+    result.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        result.emplace_back(Span{hashes}.subspan(i * CRIPEMD160::OUTPUT_SIZE, CRIPEMD160::OUTPUT_SIZE));
+    }
+    return result;
+}
+
 uint256 SHA256Uint256(const uint256& input)
 {
     uint256 result;
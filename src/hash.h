@@ -97,6 +97,11 @@ inline uint160 Hash160(const T1& in1)
     return result;
 }
 
+/** Compute the 160-bit hash of each of a list of byte strings, such as public
+ *  keys. Equivalent to calling Hash160() on each, but both the SHA-256 and the
+ *  RIPEMD-160 step process several inputs at once where SIMD is available. */
+std::vector<uint160> Hash160Many(Span<const Span<const unsigned char>> inputs);
+
 /** A writer stream (for serialization) that computes a 256-bit hash. */
 class HashWriter
 {
@@ -14,9 +14,12 @@
 #include <rpc/protocol.h> // For HTTP status codes
 #include <sync.h>
 #include <util/check.h>
+#include <util/metrics.h>
 #include <util/signalinterrupt.h>
 #include <util/strencodings.h>
 #include <util/threadnames.h>
+#include <util/time.h>
+#include <util/trace.h>
 #include <util/translation.h>
 
 #include <condition_variable>
@@ -67,6 +70,11 @@ private:
     HTTPRequestHandler func;
 };
 
+TRACEPOINT_SEMAPHORE(http, request_received);
+TRACEPOINT_SEMAPHORE(http, request_completed);
+
+static metrics::Gauge g_http_queue_depth{"atcoin_http_work_queue_depth", "HTTP requests waiting for a worker thread"};
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
  */
@@ -95,6 +103,7 @@ public:
             return false;
         }
         queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        g_http_queue_depth.Add(1);
         cond.notify_one();
         return true;
     }
@@ -111,6 +120,7 @@ public:
                     break;
                 i = std::move(queue.front());
                 queue.pop_front();
+                g_http_queue_depth.Add(-1);
             }
             (*i)();
         }
@@ -323,6 +333,12 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
         }
     }
 
+    TRACEPOINT(http, request_received,
+        RequestMethodString(hreq->GetRequestMethod()).c_str(),
+        strURI.c_str(),
+        hreq->GetPeer().ToStringAddrPort().c_str(),
+        g_http_queue_depth.Get());
+
     // Dispatch to worker thread
     if (i != iend) {
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
@@ -594,6 +610,7 @@ void HTTPEvent::trigger(struct timeval* tv)
 HTTPRequest::HTTPRequest(struct evhttp_request* _req, const util::SignalInterrupt& interrupt, bool _replySent)
     : req(_req), m_interrupt(interrupt), replySent(_replySent)
 {
+    if (TRACEPOINT_ACTIVE(http, request_completed)) m_received_at = SteadyClock::now();
 }
 
 HTTPRequest::~HTTPRequest()
@@ -659,6 +676,12 @@ void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
     struct evbuffer* evb = evhttp_request_get_output_buffer(req);
     assert(evb);
     evbuffer_add(evb, reply.data(), reply.size());
+    TRACEPOINT(http, request_completed,
+        RequestMethodString(GetRequestMethod()).c_str(),
+        GetURI().c_str(),
+        nStatus,
+        reply.size(),
+        m_received_at == SteadyClock::time_point{} ? int64_t{0} : int64_t{Ticks<std::chrono::microseconds>(SteadyClock::now() - m_received_at)});
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
@@ -775,3 +798,24 @@ void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
         pathHandlers.erase(i);
     }
 }
+
+static bool HTTPReq_Metrics(HTTPRequest* req, const std::string&)
+{
+    if (req->GetRequestMethod() != HTTPRequest::GET) {
+        req->WriteReply(HTTP_BAD_METHOD, "Only GET is supported");
+        return false;
+    }
+    req->WriteHeader("Content-Type", "text/plain; version=0.0.4; charset=utf-8");
+    req->WriteReply(HTTP_OK, metrics::GetRegistry().Render());
+    return true;
+}
+
+void StartHTTPMetrics()
+{
+    RegisterHTTPHandler("/metrics", /*exactMatch=*/true, HTTPReq_Metrics);
+}
+
+void StopHTTPMetrics()
+{
+    UnregisterHTTPHandler("/metrics", /*exactMatch=*/true);
+}
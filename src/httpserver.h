@@ -5,6 +5,8 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <util/time.h>
+
 #include <functional>
 #include <optional>
 #include <span>
@@ -59,6 +61,13 @@ void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPR
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
+/** Serve the process metrics at /metrics, in the Prometheus text format.
+ * Rendering only reads atomics and never takes cs_main.
+ */
+void StartHTTPMetrics();
+/** Stop serving /metrics */
+void StopHTTPMetrics();
+
 /** Return evhttp event base. This can be used by submodules to
  * queue timers or custom events.
  */
@@ -73,6 +82,8 @@ private:
     struct evhttp_request* req;
     const util::SignalInterrupt& m_interrupt;
     bool replySent;
+    //! Only set while the http:request_completed tracepoint is in use.
+    SteadyClock::time_point m_received_at;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
@@ -16,9 +16,12 @@
 #include <tinyformat.h>
 #include <util/string.h>
 #include <util/thread.h>
+#include <util/time.h>
+#include <util/trace.h>
 #include <util/translation.h>
 #include <validation.h> // For g_chainman
 
+#include <algorithm>
 #include <string>
 #include <utility>
 
@@ -27,6 +30,9 @@ constexpr uint8_t DB_BEST_BLOCK{'B'};
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
 
+TRACEPOINT_SEMAPHORE(index, block_indexed);
+TRACEPOINT_SEMAPHORE(index, sync_finished);
+
 template <typename... Args>
 void BaseIndex::FatalErrorf(util::ConstevalFormatString<sizeof...(Args)> fmt, const Args&... args)
 {
@@ -68,7 +74,13 @@ void BaseIndex::DB::WriteBestBlock(CDBBatch& batch, const CBlockLocator& locator
 }
 
 BaseIndex::BaseIndex(std::unique_ptr<interfaces::Chain> chain, std::string name)
-    : m_chain{std::move(chain)}, m_name{std::move(name)} {}
+    : m_chain{std::move(chain)}, m_name{std::move(name)},
+      m_lag_metric{"atcoin_index_lag_blocks", "Number of blocks an index is behind the chain tip", metrics::Metric::Type::GAUGE,
+                   [this] {
+                       const CBlockIndex* best_block{m_best_block_index.load()};
+                       return std::max(0, m_chain_height.load() - (best_block ? best_block->nHeight : -1));
+                   },
+                   strprintf("index=\"%s\"", m_name)} {}
 
 BaseIndex::~BaseIndex()
 {
@@ -159,7 +171,7 @@ void BaseIndex::Sync()
                 return;
             }
 
-            const CBlockIndex* pindex_next = WITH_LOCK(cs_main, return NextSyncBlock(pindex, m_chainstate->m_chain));
+            const CBlockIndex* pindex_next = WITH_LOCK(cs_main, m_chain_height = m_chainstate->m_chain.Height(); return NextSyncBlock(pindex, m_chainstate->m_chain));
             // If pindex_next is null, it means pindex is the chain tip, so
             // commit data indexed so far.
             if (!pindex_next) {
@@ -176,6 +188,9 @@ void BaseIndex::Sync()
                 pindex_next = NextSyncBlock(pindex, m_chainstate->m_chain);
                 if (!pindex_next) {
                     m_synced = true;
+                    TRACEPOINT(index, sync_finished,
+                        GetName().c_str(),
+                        pindex ? pindex->nHeight : -1);
                     break;
                 }
             }
@@ -185,10 +200,10 @@ void BaseIndex::Sync()
             }
             pindex = pindex_next;
 
-
+            const auto time_start{TRACEPOINT_ACTIVE(index, block_indexed) ? SteadyClock::now() : SteadyClock::time_point{}};
             CBlock block;
             interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!m_chainstate->m_blockman.ReadBlock(block, *pindex)) {
+            if (!m_chainstate->m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
                 FatalErrorf("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
@@ -202,6 +217,12 @@ void BaseIndex::Sync()
             }
 
             auto current_time{std::chrono::steady_clock::now()};
+            TRACEPOINT(index, block_indexed,
+                GetName().c_str(),
+                pindex->nHeight,
+                m_chain_height.load(),
+                int64_t{Ticks<std::chrono::microseconds>(current_time - time_start)},
+                false);
             if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
                 LogPrintf("Syncing %s with block chain from height %d\n",
                           GetName(), pindex->nHeight);
@@ -279,6 +300,7 @@ void BaseIndex::BlockConnected(ChainstateRole role, const std::shared_ptr<const
     if (role == ChainstateRole::ASSUMEDVALID) {
         return;
     }
+    m_chain_height = pindex->nHeight;
 
     // Ignore BlockConnected signals until we have fully indexed the chain.
     if (!m_synced) {
@@ -311,8 +333,15 @@ void BaseIndex::BlockConnected(ChainstateRole role, const std::shared_ptr<const
             return;
         }
     }
+    const auto time_start{TRACEPOINT_ACTIVE(index, block_indexed) ? SteadyClock::now() : SteadyClock::time_point{}};
     interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex, block.get());
     if (CustomAppend(block_info)) {
+        TRACEPOINT(index, block_indexed,
+            GetName().c_str(),
+            pindex->nHeight,
+            m_chain_height.load(),
+            int64_t{Ticks<std::chrono::microseconds>(SteadyClock::now() - time_start)},
+            true);
         // Setting the best block index is intentionally the last step of this
         // function, so BlockUntilSyncedToCurrentChain callers waiting for the
         // best block index to be updated can rely on the block being fully
@@ -433,6 +462,11 @@ IndexSummary BaseIndex::GetSummary() const
     return summary;
 }
 
+size_t BaseIndex::DynamicMemoryUsage() const
+{
+    return GetDB().DynamicMemoryUsage();
+}
+
 void BaseIndex::SetBestBlockIndex(const CBlockIndex* block)
 {
     assert(!m_chainstate->m_blockman.IsPruneMode() || AllowPrune());
@@ -8,6 +8,7 @@
 #include <dbwrapper.h>
 #include <interfaces/chain.h>
 #include <interfaces/types.h>
+#include <util/metrics.h>
 #include <util/string.h>
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
@@ -77,6 +78,9 @@ private:
     /// The last block in the chain that the index is in sync with.
     std::atomic<const CBlockIndex*> m_best_block_index{nullptr};
 
+    /// Height of the most recent chain tip the index has seen, for the lag metric.
+    std::atomic<int> m_chain_height{-1};
+
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
@@ -103,10 +107,19 @@ protected:
     Chainstate* m_chainstate{nullptr};
     const std::string m_name;
 
+private:
+    /// Number of blocks the index is behind the chain tip. Declared last, so it is
+    /// unregistered before the state it reads is destroyed.
+    metrics::Callback m_lag_metric;
+
+protected:
+
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override;
 
     void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override;
 
+    std::string ValidationInterfaceName() const override { return m_name; }
+
     /// Initialize internal state from the database and block index.
     [[nodiscard]] virtual bool CustomInit(const std::optional<interfaces::BlockRef>& block) { return true; }
 
@@ -162,6 +175,9 @@ public:
 
     /// Get a summary of the index and its state.
     IndexSummary GetSummary() const;
+
+    /// Get an estimate of the memory used by the index database, in bytes.
+    size_t DynamicMemoryUsage() const;
 };
 
 #endif // BITCOIN_INDEX_BASE_H
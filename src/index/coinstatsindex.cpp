@@ -17,6 +17,7 @@
 
 using kernel::ApplyCoinHash;
 using kernel::CCoinsStats;
+using kernel::CoinHashBatch;
 using kernel::GetBogoSize;
 using kernel::RemoveCoinHash;
 
@@ -144,8 +145,10 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
             }
         }
 
-        // Add the new utxos created from the block
+        // Add the new utxos created from the block. The coins are hashed
+        // into the MuHash in batches after the loop.
         assert(block.data);
+        CoinHashBatch created, spent;
         for (size_t i = 0; i < block.data->vtx.size(); ++i) {
             const auto& tx{block.data->vtx.at(i)};
 
@@ -168,7 +171,7 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                     continue;
                 }
 
-                ApplyCoinHash(m_muhash, outpoint, coin);
+                created.Add(outpoint, coin);
 
                 if (tx->IsCoinBase()) {
                     m_total_coinbase_amount += coin.out.nValue;
@@ -189,7 +192,7 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                     Coin coin{tx_undo.vprevout[j]};
                     COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
 
-                    RemoveCoinHash(m_muhash, outpoint, coin);
+                    spent.Add(outpoint, coin);
 
                     m_total_prevout_spent_amount += coin.out.nValue;
 
@@ -199,6 +202,8 @@ bool CoinStatsIndex::CustomAppend(const interfaces::BlockInfo& block)
                 }
             }
         }
+        ApplyCoinHash(m_muhash, created);
+        RemoveCoinHash(m_muhash, spent);
     } else {
         // genesis block
         m_total_unspendable_amount += block_subsidy;
@@ -287,7 +292,7 @@ bool CoinStatsIndex::CustomRewind(const interfaces::BlockRef& current_tip, const
         do {
             CBlock block;
 
-            if (!m_chainstate->m_blockman.ReadBlock(block, *iter_tip)) {
+            if (!m_chainstate->m_blockman.ReadBlock(block, *iter_tip, /*use_arena=*/true)) {
                 LogError("%s: Failed to read block %s from disk\n",
                              __func__, iter_tip->GetBlockHash().ToString());
                 return false;
@@ -437,6 +442,7 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
     }
 
     // Remove the new UTXOs that were created from the block
+    CoinHashBatch created, spent;
     for (size_t i = 0; i < block.vtx.size(); ++i) {
         const auto& tx{block.vtx.at(i)};
 
@@ -452,7 +458,7 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
                 continue;
             }
 
-            RemoveCoinHash(m_muhash, outpoint, coin);
+            created.Add(outpoint, coin);
 
             if (tx->IsCoinBase()) {
                 m_total_coinbase_amount -= coin.out.nValue;
@@ -473,7 +479,7 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
                 Coin coin{tx_undo.vprevout[j]};
                 COutPoint outpoint{tx->vin[j].prevout.hash, tx->vin[j].prevout.n};
 
-                ApplyCoinHash(m_muhash, outpoint, coin);
+                spent.Add(outpoint, coin);
 
                 m_total_prevout_spent_amount -= coin.out.nValue;
 
@@ -483,6 +489,8 @@ bool CoinStatsIndex::ReverseBlock(const CBlock& block, const CBlockIndex* pindex
             }
         }
     }
+    RemoveCoinHash(m_muhash, created);
+    ApplyCoinHash(m_muhash, spent);
 
     const CAmount unclaimed_rewards{(m_total_new_outputs_ex_coinbase_amount + m_total_coinbase_amount + m_total_unspendable_amount) - (m_total_prevout_spent_amount + m_total_subsidy)};
     m_total_unspendable_amount -= unclaimed_rewards;
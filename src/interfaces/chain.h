@@ -321,6 +321,12 @@ public:
         virtual void transactionAddedToMempool(const CTransactionRef& tx) {}
         virtual void transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason) {}
         virtual void blockConnected(ChainstateRole role, const BlockInfo& block) {}
+        //! Several consecutive blocks were connected. Sent instead of individual
+        //! blockConnected notifications while the client is catching up.
+        virtual void blocksConnected(ChainstateRole role, const std::vector<BlockInfo>& blocks)
+        {
+            for (const BlockInfo& block : blocks) blockConnected(role, block);
+        }
         virtual void blockDisconnected(const BlockInfo& block) {}
         virtual void updatedBlockTip() {}
         virtual void chainStateFlushed(ChainstateRole role, const CBlockLocator& locator) {}
@@ -418,6 +424,9 @@ public:
 
     //! Mock the scheduler to fast forward in time.
     virtual void schedulerMockForward(std::chrono::seconds delta_seconds) = 0;
+
+    //! Get an estimate of the memory used by the client, in bytes.
+    virtual size_t getMemoryUsage() = 0;
 };
 
 //! Return implementation of Chain interface.
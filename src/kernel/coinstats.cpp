@@ -29,6 +29,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace kernel {
 
@@ -74,6 +75,35 @@ void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& c
     muhash.Remove(MakeUCharSpan(ss));
 }
 
+void CoinHashBatch::Add(const COutPoint& outpoint, const Coin& coin)
+{
+    VectorWriter writer{m_data, m_data.size()};
+    TxOutSer(writer, outpoint, coin);
+    m_ends.push_back(m_data.size());
+}
+
+std::vector<Span<const unsigned char>> CoinHashBatch::Coins() const
+{
+    std::vector<Span<const unsigned char>> coins;
+    coins.reserve(m_ends.size());
+    size_t begin{0};
+    for (const size_t end : m_ends) {
+        coins.push_back(Span{m_data}.subspan(begin, end - begin));
+        begin = end;
+    }
+    return coins;
+}
+
+void ApplyCoinHash(MuHash3072& muhash, const CoinHashBatch& batch)
+{
+    muhash.InsertMany(batch.Coins());
+}
+
+void RemoveCoinHash(MuHash3072& muhash, const CoinHashBatch& batch)
+{
+    muhash.RemoveMany(batch.Coins());
+}
+
 static void ApplyCoinHash(std::nullptr_t, const COutPoint& outpoint, const Coin& coin) {}
 
 //! Warning: be very careful when changing this! assumeutxo and UTXO snapshot
@@ -7,12 +7,15 @@
 
 #include <consensus/amount.h>
 #include <crypto/muhash.h>
+#include <span.h>
 #include <streams.h>
 #include <uint256.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <vector>
 
 class CCoinsView;
 class Coin;
@@ -76,6 +79,20 @@ uint64_t GetBogoSize(const CScript& script_pub_key);
 void ApplyCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 void RemoveCoinHash(MuHash3072& muhash, const COutPoint& outpoint, const Coin& coin);
 
+/** Coins serialized as for ApplyCoinHash(), so that they can be hashed in one batch. */
+class CoinHashBatch
+{
+    std::vector<unsigned char> m_data;
+    std::vector<size_t> m_ends;
+
+public:
+    void Add(const COutPoint& outpoint, const Coin& coin);
+    std::vector<Span<const unsigned char>> Coins() const;
+};
+
+void ApplyCoinHash(MuHash3072& muhash, const CoinHashBatch& batch);
+void RemoveCoinHash(MuHash3072& muhash, const CoinHashBatch& batch);
+
 std::optional<CCoinsStats> ComputeUTXOStats(CoinStatsHashType hash_type, CCoinsView* view, node::BlockManager& blockman, const std::function<void()>& interruption_point = {});
 } // namespace kernel
 
@@ -4,6 +4,7 @@
 
 #include <kernel/context.h>
 
+#include <crypto/muhash.h>
 #include <crypto/sha256.h>
 #include <logging.h>
 #include <random.h>
@@ -18,6 +19,8 @@ Context::Context()
     std::call_once(globals_initialized, []() {
         std::string sha256_algo = SHA256AutoDetect();
         LogInfo("Using the '%s' SHA256 implementation\n", sha256_algo);
+        std::string muhash_algo = Num3072AutoDetect();
+        LogInfo("Using the '%s' MuHash multiplication implementation\n", muhash_algo);
         RandomInit();
     });
 }
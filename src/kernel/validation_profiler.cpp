@@ -0,0 +1,88 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <kernel/validation_profiler.h>
+
+#include <tinyformat.h>
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace kernel {
+
+std::string_view ValidationStageName(ValidationStage stage)
+{
+    switch (stage) {
+    case ValidationStage::HEADER_CHECK: return "header_check";
+    case ValidationStage::READ: return "read";
+    case ValidationStage::CHECK: return "check";
+    case ValidationStage::FORKS: return "forks";
+    case ValidationStage::UTXO_FETCH: return "utxo_fetch";
+    case ValidationStage::SCRIPT_CHECK: return "script_check";
+    case ValidationStage::UNDO_WRITE: return "undo_write";
+    case ValidationStage::INDEX: return "index";
+    case ValidationStage::FLUSH: return "flush";
+    case ValidationStage::CHAINSTATE_WRITE: return "chainstate_write";
+    case ValidationStage::POSTPROCESS: return "postprocess";
+    case ValidationStage::NOTIFY: return "notify";
+    case ValidationStage::TOTAL: return "total";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+ValidationProfiler::ValidationProfiler(size_t history, metrics::Registry& registry)
+    : m_history_size{history}
+{
+    // 10us to ~84s, doubling, so quantiles are accurate to a factor of two.
+    const auto bounds{metrics::ExponentialBuckets(/*start=*/10, /*factor=*/2, /*count=*/24)};
+    for (size_t i = 0; i < NUM_VALIDATION_STAGES; ++i) {
+        m_histograms[i] = std::make_unique<metrics::Histogram>(
+            "atcoin_block_connect_seconds", "Time spent in each stage of connecting a block to the chain", bounds, /*scale=*/1e-6,
+            strprintf("stage=\"%s\"", ValidationStageName(ValidationStage(i))), registry);
+    }
+}
+
+void ValidationProfiler::BeginBlock()
+{
+    LOCK(m_mutex);
+    m_current = {};
+}
+
+void ValidationProfiler::Record(ValidationStage stage, SteadyClock::duration duration)
+{
+    const auto micros{std::max(std::chrono::microseconds{0}, std::chrono::duration_cast<std::chrono::microseconds>(duration))};
+    m_histograms[size_t(stage)]->Observe(micros.count());
+    LOCK(m_mutex);
+    m_current.stages[size_t(stage)] += micros;
+}
+
+void ValidationProfiler::EndBlock(const uint256& hash, int height, size_t tx_count)
+{
+    LOCK(m_mutex);
+    if (m_history_size == 0) return;
+    m_current.hash = hash;
+    m_current.height = height;
+    m_current.tx_count = tx_count;
+    if (m_history.size() == m_history_size) m_history.pop_front();
+    m_history.push_back(std::exchange(m_current, {}));
+}
+
+void ValidationProfiler::RecordEnded(const uint256& hash, ValidationStage stage, SteadyClock::duration duration)
+{
+    const auto micros{std::max(std::chrono::microseconds{0}, std::chrono::duration_cast<std::chrono::microseconds>(duration))};
+    m_histograms[size_t(stage)]->Observe(micros.count());
+    LOCK(m_mutex);
+    // The block was ended recently, so search from the back.
+    const auto it{std::find_if(m_history.rbegin(), m_history.rend(), [&](const BlockProfile& profile) { return profile.hash == hash; })};
+    if (it != m_history.rend()) it->stages[size_t(stage)] += micros;
+}
+
+std::vector<BlockProfile> ValidationProfiler::GetHistory() const
+{
+    LOCK(m_mutex);
+    return {m_history.begin(), m_history.end()};
+}
+
+} // namespace kernel
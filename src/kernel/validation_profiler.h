@@ -0,0 +1,93 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_KERNEL_VALIDATION_PROFILER_H
+#define BITCOIN_KERNEL_VALIDATION_PROFILER_H
+
+#include <sync.h>
+#include <uint256.h>
+#include <util/metrics.h>
+#include <util/time.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace kernel {
+
+/** Stages of validating and connecting a block, in the order they run. */
+enum class ValidationStage : uint8_t {
+    HEADER_CHECK,     //!< Context-free header checks, including proof of work, when the header is first seen.
+    READ,             //!< Reading the block from disk, if it was not passed in.
+    CHECK,            //!< CheckBlock().
+    FORKS,            //!< BIP30 and the other checks that depend on deployments.
+    UTXO_FETCH,       //!< Fetching and spending the inputs, and queueing the script checks.
+    SCRIPT_CHECK,     //!< Waiting for the parallel script checks.
+    UNDO_WRITE,       //!< Writing the undo data.
+    INDEX,            //!< Updating the block index.
+    FLUSH,            //!< Flushing the block's coins into the coins tip.
+    CHAINSTATE_WRITE, //!< Writing the chainstate to disk, if needed.
+    POSTPROCESS,      //!< Updating the mempool and the chain tip.
+    NOTIFY,           //!< Queueing the validation interface notifications.
+    TOTAL,            //!< Everything from READ to POSTPROCESS.
+};
+
+inline constexpr size_t NUM_VALIDATION_STAGES{size_t(ValidationStage::TOTAL) + 1};
+
+std::string_view ValidationStageName(ValidationStage stage);
+
+/** Stage durations of one connected block. */
+struct BlockProfile {
+    uint256 hash;
+    int height{-1};
+    size_t tx_count{0};
+    std::array<std::chrono::microseconds, NUM_VALIDATION_STAGES> stages{};
+};
+
+/**
+ * Records how long each stage of connecting a block takes. Every duration is
+ * added to a per-stage histogram, which is also exported as the
+ * atcoin_block_connect_seconds metric, and to the profile of the block being
+ * connected. The profiles of the last blocks are kept in a ring buffer.
+ *
+ * HEADER_CHECK happens when a header is accepted, which is independent of
+ * connecting blocks, so it only shows up in the histograms.
+ */
+class ValidationProfiler
+{
+public:
+    static constexpr size_t DEFAULT_HISTORY{144};
+
+    explicit ValidationProfiler(size_t history = DEFAULT_HISTORY, metrics::Registry& registry = metrics::GetRegistry());
+
+    //! Start the profile of a new block, discarding any unfinished one.
+    void BeginBlock() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Record(ValidationStage stage, SteadyClock::duration duration) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Add the profile of the current block to the history.
+    void EndBlock(const uint256& hash, int height, size_t tx_count) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    //! Record a stage of a block that has already been ended, such as its notifications.
+    void RecordEnded(const uint256& hash, ValidationStage stage, SteadyClock::duration duration) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Durations in microseconds.
+    const metrics::Histogram& GetHistogram(ValidationStage stage) const { return *m_histograms[size_t(stage)]; }
+    //! Profiles of the last blocks, oldest first.
+    std::vector<BlockProfile> GetHistory() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    std::array<std::unique_ptr<metrics::Histogram>, NUM_VALIDATION_STAGES> m_histograms;
+    const size_t m_history_size;
+
+    mutable Mutex m_mutex;
+    BlockProfile m_current GUARDED_BY(m_mutex);
+    std::deque<BlockProfile> m_history GUARDED_BY(m_mutex);
+};
+
+} // namespace kernel
+
+#endif // BITCOIN_KERNEL_VALIDATION_PROFILER_H
@@ -11,9 +11,13 @@
 #include <util/threadnames.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <array>
+#include <bit>
+#include <condition_variable>
 #include <map>
 #include <optional>
+#include <thread>
 
 using util::Join;
 using util::RemovePrefixView;
@@ -95,6 +99,7 @@ bool BCLog::Logger::StartLogging()
 
 void BCLog::Logger::DisconnectTestLogger()
 {
+    StopAsyncLogging();
     StdLockGuard scoped_lock(m_cs);
     m_buffering = true;
     if (m_fileout != nullptr) fclose(m_fileout);
@@ -384,8 +389,206 @@ void BCLog::Logger::FormatLogStrInPlace(std::string& str, BCLog::LogFlags catego
     str.insert(0, LogTimestampStr(now, mocktime));
 }
 
+/**
+ * Bounded queue of log lines and the thread that writes them out.
+ *
+ * The queue is Dmitry Vyukov's bounded MPMC queue with a single consumer:
+ * every slot carries a sequence number, so a producer claims a slot with one
+ * compare-and-swap on the enqueue position and publishes it with a single
+ * store, without ever waiting for the writer. When the queue is full the line
+ * is dropped and counted instead. The writer only sleeps when the queue is
+ * empty; producers take m_mutex to wake it only when it does.
+ */
+class BCLog::Logger::AsyncWriter
+{
+    struct Slot {
+        std::atomic<size_t> seq;
+        BufferedLog log;
+    };
+
+    //! Lines written in one go, under one acquisition of the logger's m_cs.
+    static constexpr size_t MAX_BATCH{256};
+
+    Logger& m_logger;
+    const size_t m_mask;
+    const std::unique_ptr<Slot[]> m_slots;
+
+    alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+    //! Lines dropped since the writer last reported them.
+    std::atomic<uint64_t> m_dropped{0};
+
+    alignas(64) size_t m_dequeue_pos{0}; //!< Only used by the writer.
+    std::atomic<bool> m_idle{false};
+
+    StdMutex m_mutex;
+    std::condition_variable m_cv;         //!< Wakes the writer.
+    std::condition_variable m_flushed_cv; //!< Signals progress of m_written.
+    bool m_stop GUARDED_BY(m_mutex){false};
+    size_t m_written GUARDED_BY(m_mutex){0};
+
+    std::thread m_thread;
+
+    bool Ready() const
+    {
+        return m_slots[m_dequeue_pos & m_mask].seq.load() == m_dequeue_pos + 1;
+    }
+
+    bool Pop(BufferedLog& log)
+    {
+        if (!Ready()) return false;
+        Slot& slot{m_slots[m_dequeue_pos & m_mask]};
+        log = std::move(slot.log);
+        slot.seq.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+        ++m_dequeue_pos;
+        return true;
+    }
+
+    void Run()
+    {
+        util::ThreadRename("logger");
+        std::vector<std::string> lines;
+        BufferedLog log;
+        while (true) {
+            if (const uint64_t dropped{m_dropped.exchange(0, std::memory_order_relaxed)}) {
+                std::string str{strprintf("Asynchronous log queue overflowed, %d log lines dropped.\n", dropped)};
+                m_logger.FormatLogStrInPlace(str, BCLog::ALL, Level::Warning, __FILE__, __LINE__, __func__, util::ThreadGetInternalName(), SystemClock::now(), GetMockTime());
+                lines.push_back(std::move(str));
+            }
+            while (lines.size() < MAX_BATCH && Pop(log)) {
+                std::string str{LogEscapeMessage(log.str)};
+                m_logger.FormatLogStrInPlace(str, log.category, log.level, log.source_file, log.source_line, log.logging_function, log.threadname, log.now, log.mocktime);
+                lines.push_back(std::move(str));
+            }
+            if (!lines.empty()) {
+                {
+                    StdLockGuard scoped_lock(m_logger.m_cs);
+                    for (const auto& str : lines) m_logger.WriteStr_(str);
+                    if (m_logger.m_print_to_console) fflush(stdout);
+                }
+                lines.clear();
+                {
+                    StdLockGuard lock(m_mutex);
+                    m_written = m_dequeue_pos;
+                }
+                m_flushed_cv.notify_all();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            // Sequentially consistent, like the publishing store and the load
+            // of m_idle in Push(): either the producer sees the writer idle
+            // and wakes it, or the writer sees the new line.
+            m_idle.store(true);
+            m_cv.wait(lock, [&] { return m_stop || Ready() || m_dropped.load(std::memory_order_relaxed) > 0; });
+            m_idle.store(false, std::memory_order_relaxed);
+            if (m_stop && !Ready() && m_dropped.load(std::memory_order_relaxed) == 0) break;
+        }
+    }
+
+public:
+    AsyncWriter(Logger& logger, size_t capacity)
+        : m_logger{logger},
+          m_mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1},
+          m_slots{std::make_unique<Slot[]>(m_mask + 1)}
+    {
+        for (size_t i = 0; i <= m_mask; ++i) m_slots[i].seq.store(i, std::memory_order_relaxed);
+        m_thread = std::thread{[this] { Run(); }};
+    }
+
+    ~AsyncWriter()
+    {
+        {
+            StdLockGuard lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+    }
+
+    void Push(BufferedLog&& log)
+    {
+        size_t pos{m_enqueue_pos.load(std::memory_order_relaxed)};
+        Slot* slot;
+        while (true) {
+            slot = &m_slots[pos & m_mask];
+            const auto diff{static_cast<std::make_signed_t<size_t>>(slot->seq.load(std::memory_order_acquire) - pos)};
+            if (diff == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                // The slot still holds a line from the previous lap: full.
+                m_dropped.fetch_add(1, std::memory_order_relaxed);
+                m_logger.m_async_lines_dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->log = std::move(log);
+        slot->seq.store(pos + 1);
+
+        if (m_idle.load()) {
+            // Taking the mutex orders the wakeup after the writer started waiting.
+            { StdLockGuard lock(m_mutex); }
+            m_cv.notify_one();
+        }
+    }
+
+    void Flush()
+    {
+        const size_t target{m_enqueue_pos.load()};
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_flushed_cv.wait(lock, [&]() NO_THREAD_SAFETY_ANALYSIS { return m_written >= target; });
+    }
+};
+
+void BCLog::Logger::StartAsyncLogging(size_t capacity)
+{
+    {
+        StdLockGuard scoped_lock(m_cs);
+        assert(!m_buffering);
+        if (!m_print_to_console && !m_print_to_file && m_print_callbacks.empty()) return;
+    }
+    assert(m_async.load() == nullptr);
+    m_async.store(new AsyncWriter(*this, capacity));
+}
+
+void BCLog::Logger::FlushAsyncLogging()
+{
+    ++m_async_users;
+    if (AsyncWriter* async{m_async.load()}) async->Flush();
+    --m_async_users;
+}
+
+void BCLog::Logger::StopAsyncLogging()
+{
+    AsyncWriter* async{m_async.exchange(nullptr)};
+    if (!async) return;
+    // Callers that loaded the writer before it was unset may still be pushing to it.
+    while (m_async_users.load() != 0) std::this_thread::yield();
+    delete async; // writes out the remaining lines
+}
+
 void BCLog::Logger::LogPrintStr(std::string_view str, std::string_view logging_function, std::string_view source_file, int source_line, BCLog::LogFlags category, BCLog::Level level)
 {
+    if (m_async.load(std::memory_order_relaxed)) {
+        ++m_async_users;
+        if (AsyncWriter* async{m_async.load()}) {
+            async->Push(BufferedLog{
+                .now=SystemClock::now(),
+                .mocktime=GetMockTime(),
+                .str=std::string(str),
+                .logging_function=std::string(logging_function),
+                .source_file=std::string(source_file),
+                .threadname=util::ThreadGetInternalName(),
+                .source_line=source_line,
+                .category=category,
+                .level=level,
+            });
+            --m_async_users;
+            return;
+        }
+        --m_async_users;
+    }
     StdLockGuard scoped_lock(m_cs);
     return LogPrintStr_(str, logging_function, source_file, source_line, category, level);
 }
@@ -426,13 +629,18 @@ void BCLog::Logger::LogPrintStr_(std::string_view str, std::string_view logging_
 
     FormatLogStrInPlace(str_prefixed, category, level, source_file, source_line, logging_function, util::ThreadGetInternalName(), SystemClock::now(), GetMockTime());
 
+    WriteStr_(str_prefixed);
+    if (m_print_to_console) fflush(stdout);
+}
+
+void BCLog::Logger::WriteStr_(const std::string& str)
+{
     if (m_print_to_console) {
         // print to console
-        fwrite(str_prefixed.data(), 1, str_prefixed.size(), stdout);
-        fflush(stdout);
+        fwrite(str.data(), 1, str.size(), stdout);
     }
     for (const auto& cb : m_print_callbacks) {
-        cb(str_prefixed);
+        cb(str);
     }
     if (m_print_to_file) {
         assert(m_fileout != nullptr);
@@ -447,7 +655,7 @@ void BCLog::Logger::LogPrintStr_(std::string_view str, std::string_view logging_
                 m_fileout = new_fileout;
             }
         }
-        FileWriteStr(str_prefixed, m_fileout);
+        FileWriteStr(str, m_fileout);
     }
 }
 
@@ -27,6 +27,7 @@ static const bool DEFAULT_LOGTIMESTAMPS = true;
 static const bool DEFAULT_LOGTHREADNAMES = false;
 static const bool DEFAULT_LOGSOURCELOCATIONS = false;
 static constexpr bool DEFAULT_LOGLEVELALWAYS = false;
+static constexpr bool DEFAULT_LOGASYNC{false};
 extern const char * const DEFAULT_DEBUGLOGFILE;
 
 extern bool fLogIPs;
@@ -82,6 +83,7 @@ namespace BCLog {
     };
     constexpr auto DEFAULT_LOG_LEVEL{Level::Debug};
     constexpr size_t DEFAULT_MAX_LOG_BUFFER{1'000'000}; // buffer up to 1MB of log data prior to StartLogging
+    constexpr size_t DEFAULT_ASYNC_LOG_CAPACITY{1 << 16}; // log lines queued for the background writer
 
     class Logger
     {
@@ -96,6 +98,8 @@ namespace BCLog {
         };
 
     private:
+        class AsyncWriter;
+
         mutable StdMutex m_cs; // Can not use Mutex from sync.h because in debug mode it would cause a deadlock when a potential deadlock was detected
 
         FILE* m_fileout GUARDED_BY(m_cs) = nullptr;
@@ -119,6 +123,15 @@ namespace BCLog {
 
         std::string LogTimestampStr(SystemClock::time_point now, std::chrono::seconds mocktime) const;
 
+        /**
+         * Background writer, set between StartAsyncLogging() and
+         * StopAsyncLogging(). Callers that see it only count themselves in
+         * m_async_users, so stopping can wait for them without a lock.
+         */
+        std::atomic<AsyncWriter*> m_async{nullptr};
+        std::atomic<uint32_t> m_async_users{0};
+        std::atomic<uint64_t> m_async_lines_dropped{0};
+
         /** Slots that connect to the print signal */
         std::list<std::function<void(const std::string&)>> m_print_callbacks GUARDED_BY(m_cs) {};
 
@@ -126,6 +139,9 @@ namespace BCLog {
         void LogPrintStr_(std::string_view str, std::string_view logging_function, std::string_view source_file, int source_line, BCLog::LogFlags category, BCLog::Level level)
             EXCLUSIVE_LOCKS_REQUIRED(m_cs);
 
+        /** Write a formatted log line to all outputs, without flushing the console (internal) */
+        void WriteStr_(const std::string& str) EXCLUSIVE_LOCKS_REQUIRED(m_cs);
+
         std::string GetLogPrefix(LogFlags category, Level level) const;
 
     public:
@@ -148,6 +164,8 @@ namespace BCLog {
         /** Returns whether logs will be written to any output */
         bool Enabled() const EXCLUSIVE_LOCKS_REQUIRED(!m_cs)
         {
+            // Asynchronous logging is only started with an output to write to.
+            if (m_async.load(std::memory_order_relaxed)) return true;
             StdLockGuard scoped_lock(m_cs);
             return m_buffering || m_print_to_console || m_print_to_file || !m_print_callbacks.empty();
         }
@@ -180,6 +198,21 @@ namespace BCLog {
          */
         void DisableLogging() EXCLUSIVE_LOCKS_REQUIRED(!m_cs);
 
+        /**
+         * Hand log lines to a background thread instead of writing them on the
+         * calling thread. Callers only take the timestamp and copy the line into
+         * a bounded lock-free queue of capacity lines (rounded up to a power of
+         * two); lines that don't fit are dropped, and the number dropped is
+         * logged once there is room again. Must be called after StartLogging().
+         */
+        void StartAsyncLogging(size_t capacity = DEFAULT_ASYNC_LOG_CAPACITY) EXCLUSIVE_LOCKS_REQUIRED(!m_cs);
+        /** Wait until the lines logged before this call have been written. */
+        void FlushAsyncLogging();
+        /** Write out the queued lines and go back to logging synchronously. */
+        void StopAsyncLogging() EXCLUSIVE_LOCKS_REQUIRED(!m_cs);
+        /** Total number of lines dropped because the asynchronous queue was full. */
+        uint64_t AsyncLinesDropped() const { return m_async_lines_dropped.load(std::memory_order_relaxed); }
+
         void ShrinkDebugFile();
 
         std::unordered_map<LogFlags, Level> CategoryLevels() const EXCLUSIVE_LOCKS_REQUIRED(!m_cs)
@@ -114,6 +114,28 @@ static const uint64_t SELECT_TIMEOUT_MILLISECONDS = 50;
 
 const std::string NET_MESSAGE_TYPE_OTHER = "*other*";
 
+NetMessageMetrics::NetMessageMetrics(const std::string& msg_type)
+    : recv_bytes{"atcoin_net_received_bytes_total", "Bytes received from peers, by message type", strprintf("type=\"%s\"", msg_type)},
+      sent_bytes{"atcoin_net_sent_bytes_total", "Bytes sent to peers, by message type", strprintf("type=\"%s\"", msg_type)},
+      processed{"atcoin_net_messages_processed_total", "Messages processed, by message type", strprintf("type=\"%s\"", msg_type)},
+      process_time{"atcoin_net_message_process_seconds_total", "Time spent processing messages, by message type", strprintf("type=\"%s\"", msg_type), /*scale=*/1e-6}
+{
+}
+
+NetMessageMetrics& GetNetMessageMetrics(const std::string& msg_type)
+{
+    // Built once and never modified afterwards, so lookups need no lock.
+    static const auto all_metrics{[] {
+        std::map<std::string, std::unique_ptr<NetMessageMetrics>> all;
+        for (const std::string& type : ALL_NET_MESSAGE_TYPES) all.emplace(type, std::make_unique<NetMessageMetrics>(type));
+        all.emplace(NET_MESSAGE_TYPE_OTHER, std::make_unique<NetMessageMetrics>(NET_MESSAGE_TYPE_OTHER));
+        return all;
+    }()};
+    auto it{all_metrics.find(msg_type)};
+    if (it == all_metrics.end()) it = all_metrics.find(NET_MESSAGE_TYPE_OTHER);
+    return *it->second;
+}
+
 static const uint64_t RANDOMIZER_ID_NETGROUP = 0x6c0edd8036ef4036ULL; // SHA256("netgroup")[0:8]
 static const uint64_t RANDOMIZER_ID_LOCALHOSTNONCE = 0xd93e69e2bbfa5735ULL; // SHA256("localhostnonce")[0:8]
 static const uint64_t RANDOMIZER_ID_ADDRCACHE = 0x1cf2e4ddd306dda9ULL; // SHA256("addrcache")[0:8]
@@ -686,6 +708,7 @@ bool CNode::ReceiveMsgBytes(Span<const uint8_t> msg_bytes, bool& complete)
                 // Message deserialization failed. Drop the message but don't disconnect the peer.
                 // store the size of the corrupt message
                 mapRecvBytesPerMsgType.at(NET_MESSAGE_TYPE_OTHER) += msg.m_raw_message_size;
+                GetNetMessageMetrics(NET_MESSAGE_TYPE_OTHER).recv_bytes.Inc(msg.m_raw_message_size);
                 continue;
             }
 
@@ -697,6 +720,7 @@ bool CNode::ReceiveMsgBytes(Span<const uint8_t> msg_bytes, bool& complete)
             }
             assert(i != mapRecvBytesPerMsgType.end());
             i->second += msg.m_raw_message_size;
+            GetNetMessageMetrics(i->first).recv_bytes.Inc(msg.m_raw_message_size);
 
             // push the message to the process queue,
             vRecvMsg.push_back(std::move(msg));
@@ -1648,6 +1672,7 @@ std::pair<size_t, bool> CConnman::SocketSendData(CNode& node) const
             // Update statistics per message type.
             if (!msg_type.empty()) { // don't report v2 handshake bytes for now
                 node.AccountForSentBytes(msg_type, nBytes);
+                GetNetMessageMetrics(msg_type).sent_bytes.Inc(nBytes);
             }
             nSentSize += nBytes;
             if ((size_t)nBytes != data.size()) {
@@ -3387,12 +3412,12 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
     }
 
     // Dump network addresses
-    scheduler.scheduleEvery([this] { DumpAddresses(); }, DUMP_PEERS_INTERVAL);
+    scheduler.scheduleEvery([this] { DumpAddresses(); }, DUMP_PEERS_INTERVAL, "peers_dump");
 
     // Run the ASMap Health check once and then schedule it to run every 24h.
     if (m_netgroupman.UsingASMap()) {
         ASMapHealthCheck();
-        scheduler.scheduleEvery([this] { ASMapHealthCheck(); }, ASMAP_HEALTH_CHECK_INTERVAL);
+        scheduler.scheduleEvery([this] { ASMapHealthCheck(); }, ASMAP_HEALTH_CHECK_INTERVAL, "asmap_health_check");
     }
 
     return true;
@@ -30,6 +30,7 @@
 #include <sync.h>
 #include <uint256.h>
 #include <util/check.h>
+#include <util/metrics.h>
 #include <util/sock.h>
 #include <util/threadinterrupt.h>
 
@@ -182,6 +183,20 @@ extern std::map<CNetAddr, LocalServiceInfo> mapLocalHost GUARDED_BY(g_maplocalho
 extern const std::string NET_MESSAGE_TYPE_OTHER;
 using mapMsgTypeSize = std::map</* message type */ std::string, /* total bytes */ uint64_t>;
 
+/** Process-wide traffic and processing time of one message type, summed over all peers. */
+struct NetMessageMetrics {
+    metrics::Counter recv_bytes;
+    metrics::Counter sent_bytes;
+    metrics::Counter processed;
+    //! Time spent in ProcessMessage, in microseconds.
+    metrics::Counter process_time;
+
+    explicit NetMessageMetrics(const std::string& msg_type);
+};
+
+//! Metrics of the given message type. Unknown types share those of NET_MESSAGE_TYPE_OTHER.
+NetMessageMetrics& GetNetMessageMetrics(const std::string& msg_type);
+
 class CNodeStats
 {
 public:
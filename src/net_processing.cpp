@@ -13,6 +13,7 @@
 #include <chainparams.h>
 #include <consensus/amount.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <deploymentstatus.h>
 #include <hash.h>
 #include <headerssync.h>
@@ -20,6 +21,7 @@
 #include <kernel/chain.h>
 #include <kernel/mempool_entry.h>
 #include <logging.h>
+#include <memusage.h>
 #include <merkleblock.h>
 #include <netbase.h>
 #include <netmessagemaker.h>
@@ -60,6 +62,10 @@ using namespace util::hex_literals;
 
 TRACEPOINT_SEMAPHORE(net, inbound_message);
 TRACEPOINT_SEMAPHORE(net, misbehaving_connection);
+TRACEPOINT_SEMAPHORE(net, headers_pow_checked);
+TRACEPOINT_SEMAPHORE(net, block_requested);
+TRACEPOINT_SEMAPHORE(net, block_received);
+TRACEPOINT_SEMAPHORE(net, compact_block_reconstruction);
 
 /** Headers download timeout.
  *  Timeout = base + per_header * (expected number of headers) */
@@ -175,6 +181,8 @@ struct QueuedBlock {
     const CBlockIndex* pindex;
     /** Optional, used for CMPCTBLOCK downloads */
     std::unique_ptr<PartiallyDownloadedBlock> partialBlock;
+    /** When the block was requested, only set while the net:block_received tracepoint is in use. */
+    SteadyClock::time_point requested_at{};
 };
 
 /**
@@ -488,6 +496,7 @@ public:
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_most_recent_block_mutex);
+    std::string ValidationInterfaceName() const override { return "peerman"; }
 
     /** Implement NetEventsInterface */
     void InitializeNode(const CNode& node, ServiceFlags our_services) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_tx_download_mutex);
@@ -506,6 +515,7 @@ public:
     bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() override EXCLUSIVE_LOCKS_REQUIRED(!m_tx_download_mutex);
     PeerManagerInfo GetInfo() const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
+    PeerManagerMemoryUsage GetMemoryUsage() override EXCLUSIVE_LOCKS_REQUIRED(!m_tx_download_mutex);
     void SendPings() override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void RelayTransaction(const uint256& txid, const uint256& wtxid) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void SetBestBlock(int height, std::chrono::seconds time) override
@@ -954,6 +964,8 @@ private:
     std::vector<CTransactionRef> vExtraTxnForCompact GUARDED_BY(g_msgproc_mutex);
     /** Offset into vExtraTxnForCompact to insert the next tx */
     size_t vExtraTxnForCompactIt GUARDED_BY(g_msgproc_mutex) = 0;
+    /** Memory used by vExtraTxnForCompact, kept up to date so it can be read without g_msgproc_mutex */
+    std::atomic<size_t> m_extra_txn_for_compact_usage{0};
 
     /** Check whether the last unknown block a peer advertised is not yet known. */
     void ProcessBlockAvailability(NodeId nodeid) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -1215,6 +1227,14 @@ bool PeerManagerImpl::BlockRequested(NodeId nodeid, const CBlockIndex& block, st
     if (pit) {
         *pit = &itInFlight->second.second;
     }
+    if (TRACEPOINT_ACTIVE(net, block_received)) it->requested_at = SteadyClock::now();
+    TRACEPOINT(net, block_requested,
+        nodeid,
+        hash.data(),
+        block.nHeight,
+        pit != nullptr,
+        state->vBlocksInFlight.size()
+    );
     return true;
 }
 
@@ -1561,7 +1581,7 @@ void PeerManagerImpl::ReattemptInitialBroadcast(CScheduler& scheduler)
     // Schedule next run for 10-15 minutes in the future.
     // We add randomness on every cycle to avoid the possibility of P2P fingerprinting.
     const auto delta = 10min + FastRandomContext().randrange<std::chrono::milliseconds>(5min);
-    scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
+    scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta, "initial_broadcast");
 }
 
 void PeerManagerImpl::FinalizeNode(const CNode& node)
@@ -1741,12 +1761,30 @@ void PeerManagerImpl::AddToCompactExtraTransactions(const CTransactionRef& tx)
 {
     if (m_opts.max_extra_txs <= 0)
         return;
-    if (!vExtraTxnForCompact.size())
+    if (!vExtraTxnForCompact.size()) {
         vExtraTxnForCompact.resize(m_opts.max_extra_txs);
-    vExtraTxnForCompact[vExtraTxnForCompactIt] = tx;
+        m_extra_txn_for_compact_usage += memusage::DynamicUsage(vExtraTxnForCompact);
+    }
+    CTransactionRef& slot{vExtraTxnForCompact[vExtraTxnForCompactIt]};
+    m_extra_txn_for_compact_usage += RecursiveDynamicUsage(tx);
+    m_extra_txn_for_compact_usage -= RecursiveDynamicUsage(slot);
+    slot = tx;
     vExtraTxnForCompactIt = (vExtraTxnForCompactIt + 1) % m_opts.max_extra_txs;
 }
 
+PeerManagerMemoryUsage PeerManagerImpl::GetMemoryUsage()
+{
+    PeerManagerMemoryUsage usage;
+    usage.orphanage = WITH_LOCK(m_tx_download_mutex, return m_txdownloadman.OrphanageMemoryUsage());
+    usage.compact_blocks = m_extra_txn_for_compact_usage;
+    LOCK(cs_main);
+    for (const auto& [hash, peer_and_block] : mapBlocksInFlight) {
+        const QueuedBlock& queued{*peer_and_block.second};
+        if (queued.partialBlock) usage.compact_blocks += memusage::MallocUsage(sizeof(PartiallyDownloadedBlock)) + queued.partialBlock->DynamicMemoryUsage();
+    }
+    return usage;
+}
+
 void PeerManagerImpl::Misbehaving(Peer& peer, const std::string& message)
 {
     LOCK(peer.m_misbehavior_mutex);
@@ -1913,11 +1951,11 @@ void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
     // combine them in one function and schedule at the quicker (peer-eviction)
     // timer.
     static_assert(EXTRA_PEER_CHECK_INTERVAL < STALE_CHECK_INTERVAL, "peer eviction timer should be less than stale tip check timer");
-    scheduler.scheduleEvery([this] { this->CheckForStaleTipAndEvictPeers(); }, std::chrono::seconds{EXTRA_PEER_CHECK_INTERVAL});
+    scheduler.scheduleEvery([this] { this->CheckForStaleTipAndEvictPeers(); }, std::chrono::seconds{EXTRA_PEER_CHECK_INTERVAL}, "stale_tip_check");
 
     // schedule next run for 10-15 minutes in the future
     const auto delta = 10min + FastRandomContext().randrange<std::chrono::milliseconds>(5min);
-    scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta);
+    scheduler.scheduleFromNow([&] { ReattemptInitialBroadcast(scheduler); }, delta, "initial_broadcast");
 }
 
 void PeerManagerImpl::ActiveTipChange(const CBlockIndex& new_tip, bool is_ibd)
@@ -2476,7 +2514,15 @@ void PeerManagerImpl::SendBlockTransactions(CNode& pfrom, Peer& peer, const CBlo
 bool PeerManagerImpl::CheckHeadersPoW(const std::vector<CBlockHeader>& headers, const Consensus::Params& consensusParams, Peer& peer)
 {
     // Do these headers have proof-of-work matching what's claimed?
-    if (!HasValidProofOfWork(headers, consensusParams)) {
+    const auto time_start{TRACEPOINT_ACTIVE(net, headers_pow_checked) ? SteadyClock::now() : SteadyClock::time_point{}};
+    const bool valid_pow{HasValidProofOfWork(headers, consensusParams)};
+    TRACEPOINT(net, headers_pow_checked,
+        peer.m_id,
+        headers.size(),
+        Ticks<std::chrono::nanoseconds>(SteadyClock::now() - time_start),
+        valid_pow
+    );
+    if (!valid_pow) {
         Misbehaving(peer, "header with invalid proof of work");
         return false;
     }
@@ -3316,6 +3362,14 @@ void PeerManagerImpl::ProcessCompactBlockTxns(CNode& pfrom, Peer& peer, const Bl
 
         PartiallyDownloadedBlock& partialBlock = *range_flight.first->second.second->partialBlock;
         ReadStatus status = partialBlock.FillBlock(*pblock, block_transactions.txn);
+        TRACEPOINT(net, compact_block_reconstruction,
+            pfrom.GetId(),
+            block_transactions.blockhash.data(),
+            NetMsgType::BLOCKTXN,
+            int32_t(status),
+            pblock->vtx.size(),
+            block_transactions.txn.size()
+        );
         if (status == READ_STATUS_INVALID) {
             RemoveBlockRequest(block_transactions.blockhash, pfrom.GetId()); // Reset in-flight state in case Misbehaving does not result in a disconnect
             Misbehaving(peer, "invalid compact block/non-matching block transactions");
@@ -4407,6 +4461,16 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
                 PartiallyDownloadedBlock& partialBlock = *(*queuedBlockIt)->partialBlock;
                 ReadStatus status = partialBlock.InitData(cmpctblock, vExtraTxnForCompact);
+                if (status != READ_STATUS_OK) {
+                    TRACEPOINT(net, compact_block_reconstruction,
+                        pfrom.GetId(),
+                        blockhash.data(),
+                        NetMsgType::CMPCTBLOCK,
+                        int32_t(status),
+                        cmpctblock.BlockTxCount(),
+                        size_t{0}
+                    );
+                }
                 if (status == READ_STATUS_INVALID) {
                     RemoveBlockRequest(pindex->GetBlockHash(), pfrom.GetId()); // Reset in-flight state in case Misbehaving does not result in a disconnect
                     Misbehaving(*peer, "invalid compact block");
@@ -4429,6 +4493,14 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                     if (!partialBlock.IsTxAvailable(i))
                         req.indexes.push_back(i);
                 }
+                TRACEPOINT(net, compact_block_reconstruction,
+                    pfrom.GetId(),
+                    blockhash.data(),
+                    NetMsgType::CMPCTBLOCK,
+                    int32_t(status),
+                    cmpctblock.BlockTxCount(),
+                    req.indexes.size()
+                );
                 if (req.indexes.empty()) {
                     fProcessBLOCKTXN = true;
                 } else if (first_in_flight) {
@@ -4614,6 +4686,24 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
             // Always process the block if we requested it, since we may
             // need it even when it's not a candidate for a new best tip.
             forceProcessing = IsBlockRequested(hash);
+            if (TRACEPOINT_ACTIVE(net, block_received)) {
+                // Time since the request, or zero if the block was unrequested or
+                // requested before tracing started.
+                SteadyClock::duration since_request{0};
+                for (auto [it, end] = mapBlocksInFlight.equal_range(hash); it != end; ++it) {
+                    const auto& [node_id, queued] = it->second;
+                    if (node_id == pfrom.GetId() && queued->requested_at != SteadyClock::time_point{}) {
+                        since_request = SteadyClock::now() - queued->requested_at;
+                    }
+                }
+                TRACEPOINT(net, block_received,
+                    pfrom.GetId(),
+                    hash.data(),
+                    prev_block ? prev_block->nHeight + 1 : -1,
+                    pblock->vtx.size(),
+                    Ticks<std::chrono::nanoseconds>(since_request)
+                );
+            }
             RemoveBlockRequest(hash, pfrom.GetId());
             // mapBlockSource is only used for punishing peers and setting
             // which peers send us compact blocks, so the race between here and
@@ -4987,8 +5077,12 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
         CaptureMessage(pfrom->addr, msg.m_type, MakeUCharSpan(msg.m_recv), /*is_incoming=*/true);
     }
 
+    NetMessageMetrics& msg_metrics{GetNetMessageMetrics(msg.m_type)};
+    const auto process_start{SteadyClock::now()};
     try {
         ProcessMessage(*pfrom, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        msg_metrics.processed.Inc();
+        msg_metrics.process_time.Inc(Ticks<std::chrono::microseconds>(SteadyClock::now() - process_start));
         if (interruptMsgProc) return false;
         {
             LOCK(peer->m_getdata_requests_mutex);
@@ -58,6 +58,14 @@ struct PeerManagerInfo {
     bool ignores_incoming_txs{false};
 };
 
+/** Approximate memory used by the transaction and block download state, in bytes. */
+struct PeerManagerMemoryUsage {
+    //! Orphan transactions and their indexes.
+    size_t orphanage{0};
+    //! Partially downloaded compact blocks, and the extra transactions kept to reconstruct them.
+    size_t compact_blocks{0};
+};
+
 class PeerManager : public CValidationInterface, public NetEventsInterface
 {
 public:
@@ -106,6 +114,9 @@ public:
     /** Get peer manager info. */
     virtual PeerManagerInfo GetInfo() const = 0;
 
+    /** Get an estimate of the memory used by orphans and compact block reconstruction. */
+    virtual PeerManagerMemoryUsage GetMemoryUsage() = 0;
+
     /** Relay transaction to all peers. */
     virtual void RelayTransaction(const uint256& txid, const uint256& wtxid) = 0;
 
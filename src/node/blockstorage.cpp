@@ -19,6 +19,7 @@
 #include <logging.h>
 #include <pow.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <random.h>
 #include <serialize.h>
@@ -997,23 +998,36 @@ bool BlockManager::WriteBlockUndo(const CBlockUndo& blockundo, BlockValidationSt
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos) const
+bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos, bool use_arena) const
 {
     block.SetNull();
 
-    // Open history file to read
-    AutoFile filein{OpenBlockFile(pos, true)};
-    if (filein.IsNull()) {
-        LogError("%s: OpenBlockFile failed for %s\n", __func__, pos.ToString());
-        return false;
-    }
+    if (use_arena) {
+        // Open history file to read
+        AutoFile filein{OpenBlockFile(pos, true)};
+        if (filein.IsNull()) {
+            LogError("%s: OpenBlockFile failed for %s\n", __func__, pos.ToString());
+            return false;
+        }
 
-    // Read block
-    try {
-        filein >> TX_WITH_WITNESS(block);
-    } catch (const std::exception& e) {
-        LogError("%s: Deserialize or I/O error - %s at %s\n", __func__, e.what(), pos.ToString());
-        return false;
+        // Read block
+        try {
+            UnserializeBlockInArena(filein, block, TX_WITH_WITNESS);
+        } catch (const std::exception& e) {
+            LogError("%s: Deserialize or I/O error - %s at %s\n", __func__, e.what(), pos.ToString());
+            return false;
+        }
+    } else {
+        // Read the whole record at once, so the transaction hashes can be
+        // computed in one batch after deserializing it.
+        std::vector<uint8_t> raw_block;
+        if (!ReadRawBlock(raw_block, pos)) return false;
+        try {
+            block = DeserializeBlockBatchHashed(MakeByteSpan(raw_block));
+        } catch (const std::exception& e) {
+            LogError("%s: Deserialize or I/O error - %s at %s\n", __func__, e.what(), pos.ToString());
+            return false;
+        }
     }
 
     // Check the header
@@ -1031,11 +1045,11 @@ bool BlockManager::ReadBlock(CBlock& block, const FlatFilePos& pos) const
     return true;
 }
 
-bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index) const
+bool BlockManager::ReadBlock(CBlock& block, const CBlockIndex& index, bool use_arena) const
 {
     const FlatFilePos block_pos{WITH_LOCK(cs_main, return index.GetBlockPos())};
 
-    if (!ReadBlock(block, block_pos)) {
+    if (!ReadBlock(block, block_pos, use_arena)) {
         return false;
     }
     if (block.GetHash() != index.GetBlockHash()) {
@@ -414,9 +414,13 @@ public:
      */
     void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune) const;
 
-    /** Functions for disk access for blocks */
-    bool ReadBlock(CBlock& block, const FlatFilePos& pos) const;
-    bool ReadBlock(CBlock& block, const CBlockIndex& index) const;
+    /**
+     * Functions for disk access for blocks. With use_arena, the block's
+     * transactions are allocated together (see UnserializeBlockInArena()),
+     * which is cheaper but only suitable if none of them outlives the block.
+     */
+    bool ReadBlock(CBlock& block, const FlatFilePos& pos, bool use_arena = false) const;
+    bool ReadBlock(CBlock& block, const CBlockIndex& index, bool use_arena = false) const;
     bool ReadRawBlock(std::vector<uint8_t>& block, const FlatFilePos& pos) const;
 
     bool ReadBlockUndo(CBlockUndo& blockundo, const CBlockIndex& index) const;
@@ -59,16 +59,19 @@
 #include <util/result.h>
 #include <util/signalinterrupt.h>
 #include <util/string.h>
+#include <util/time.h>
 #include <util/translation.h>
 #include <validation.h>
 #include <validationinterface.h>
 
 #include <bitcoin-build-config.h> // IWYU pragma: keep
 
+#include <algorithm>
 #include <any>
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include <boost/signals2/signal.hpp>
 
@@ -450,43 +453,103 @@ bool FillBlock(const CBlockIndex* index, const FoundBlock& block, UniqueLock<Rec
     return true;
 }
 
+//! Most blocks delivered in a single blocksConnected notification.
+static constexpr size_t MAX_BLOCKS_CONNECTED_BATCH{128};
+
+/**
+ * Forwards validation interface events to a Chain::Notifications client.
+ *
+ * While the chain tip is far behind the wall clock (initial sync, or catching
+ * up after downtime), connected blocks are held back and handed over as one
+ * blocksConnected batch, so the client can process them under a single lock.
+ * The batch grows with the estimated number of blocks still to go, and any
+ * other event flushes it first so the client sees events in the original
+ * order. ActivateBestChain follows blocks connected to the active chainstate
+ * with UpdatedBlockTip, so nothing is held back once the queue is drained.
+ */
 class NotificationsProxy : public CValidationInterface
 {
 public:
-    explicit NotificationsProxy(std::shared_ptr<Chain::Notifications> notifications)
-        : m_notifications(std::move(notifications)) {}
+    explicit NotificationsProxy(std::shared_ptr<Chain::Notifications> notifications, int64_t target_spacing)
+        : m_notifications(std::move(notifications)), m_target_spacing{target_spacing} {}
     virtual ~NotificationsProxy() = default;
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override
     {
+        FlushConnectedBlocks();
         m_notifications->transactionAddedToMempool(tx.info.m_tx);
     }
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) override
     {
+        FlushConnectedBlocks();
         m_notifications->transactionRemovedFromMempool(tx, reason);
     }
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& block, const CBlockIndex* index) override
     {
-        m_notifications->blockConnected(role, kernel::MakeBlockInfo(index, block.get()));
+        if (role == ChainstateRole::BACKGROUND) {
+            // Background chainstates are not followed by UpdatedBlockTip, so never hold their blocks back
+            FlushConnectedBlocks();
+            m_notifications->blockConnected(role, kernel::MakeBlockInfo(index, block.get()));
+            return;
+        }
+        if (role != m_pending_role) FlushConnectedBlocks();
+        m_pending_role = role;
+        m_pending_blocks.emplace_back(block, index);
+        if (m_pending_blocks.size() >= BatchSize(*index)) FlushConnectedBlocks();
     }
     void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* index) override
     {
+        FlushConnectedBlocks();
         m_notifications->blockDisconnected(kernel::MakeBlockInfo(index, block.get()));
     }
     void UpdatedBlockTip(const CBlockIndex* index, const CBlockIndex* fork_index, bool is_ibd) override
     {
+        FlushConnectedBlocks();
         m_notifications->updatedBlockTip();
     }
     void ChainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override {
+        FlushConnectedBlocks();
         m_notifications->chainStateFlushed(role, locator);
     }
+    std::string ValidationInterfaceName() const override { return "wallet"; }
     std::shared_ptr<Chain::Notifications> m_notifications;
+
+private:
+    //! Number of connected blocks to collect before notifying, based on how far behind the wall clock the block is.
+    size_t BatchSize(const CBlockIndex& index) const
+    {
+        const int64_t blocks_behind{Ticks<std::chrono::seconds>(NodeClock::now() - index.Time()) / std::max<int64_t>(m_target_spacing, 1)};
+        return std::clamp<int64_t>(blocks_behind / 16, 1, MAX_BLOCKS_CONNECTED_BATCH);
+    }
+
+    void FlushConnectedBlocks()
+    {
+        if (m_pending_blocks.empty()) return;
+        if (m_pending_blocks.size() == 1) {
+            const auto& [block, index] = m_pending_blocks.front();
+            m_notifications->blockConnected(m_pending_role, kernel::MakeBlockInfo(index, block.get()));
+        } else {
+            std::vector<interfaces::BlockInfo> infos;
+            infos.reserve(m_pending_blocks.size());
+            for (const auto& [block, index] : m_pending_blocks) {
+                infos.push_back(kernel::MakeBlockInfo(index, block.get()));
+            }
+            m_notifications->blocksConnected(m_pending_role, infos);
+        }
+        m_pending_blocks.clear();
+    }
+
+    const int64_t m_target_spacing;
+    // Validation interface callbacks for one subscriber are never run concurrently,
+    // so the pending batch needs no locking.
+    ChainstateRole m_pending_role{ChainstateRole::NORMAL};
+    std::vector<std::pair<std::shared_ptr<const CBlock>, const CBlockIndex*>> m_pending_blocks;
 };
 
 class NotificationsHandlerImpl : public Handler
 {
 public:
-    explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications)
-        : m_signals{signals}, m_proxy{std::make_shared<NotificationsProxy>(std::move(notifications))}
+    explicit NotificationsHandlerImpl(ValidationSignals& signals, std::shared_ptr<Chain::Notifications> notifications, int64_t target_spacing)
+        : m_signals{signals}, m_proxy{std::make_shared<NotificationsProxy>(std::move(notifications), target_spacing)}
     {
         m_signals.RegisterSharedValidationInterface(m_proxy);
     }
@@ -792,7 +855,7 @@ public:
     }
     std::unique_ptr<Handler> handleNotifications(std::shared_ptr<Notifications> notifications) override
     {
-        return std::make_unique<NotificationsHandlerImpl>(validation_signals(), std::move(notifications));
+        return std::make_unique<NotificationsHandlerImpl>(validation_signals(), std::move(notifications), chainman().GetConsensus().nPowTargetSpacing);
     }
     void waitForNotificationsIfTipChanged(const uint256& old_tip) override
     {
@@ -173,6 +173,9 @@ public:
 
     /** Wrapper for TxOrphanage::GetOrphanTransactions */
     std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() const;
+
+    /** Wrapper for TxOrphanage::DynamicMemoryUsage */
+    size_t OrphanageMemoryUsage() const;
 };
 } // namespace node
 #endif // BITCOIN_NODE_TXDOWNLOADMAN_H
@@ -87,6 +87,10 @@ std::vector<TxOrphanage::OrphanTxBase> TxDownloadManager::GetOrphanTransactions(
 {
     return m_impl->GetOrphanTransactions();
 }
+size_t TxDownloadManager::OrphanageMemoryUsage() const
+{
+    return m_impl->OrphanageMemoryUsage();
+}
 
 // TxDownloadManagerImpl
 void TxDownloadManagerImpl::ActiveTipChange()
@@ -591,4 +595,8 @@ std::vector<TxOrphanage::OrphanTxBase> TxDownloadManagerImpl::GetOrphanTransacti
 {
     return m_orphanage.GetOrphanTransactions();
 }
+size_t TxDownloadManagerImpl::OrphanageMemoryUsage() const
+{
+    return m_orphanage.DynamicMemoryUsage();
+}
 } // namespace node
@@ -190,6 +190,8 @@ public:
 
     std::vector<TxOrphanage::OrphanTxBase> GetOrphanTransactions() const;
 
+    size_t OrphanageMemoryUsage() const;
+
 protected:
     /** Helper for getting deduplicated vector of Txids in vin. */
     std::vector<Txid> GetUniqueParents(const CTransaction& tx);
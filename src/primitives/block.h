@@ -9,9 +9,12 @@
 
 #include <primitives/transaction.h>
 #include <serialize.h>
+#include <support/allocators/arena.h>
 #include <uint256.h>
 #include <util/time.h>
 
+#include <cstddef>
+
 /** Nodes collect new transactions into a block, hash them into a hash tree,
  * and scan through nonce values to make the block's hash satisfy proof-of-work
  * requirements.  When they solve the proof-of-work, they broadcast the block
@@ -67,6 +70,11 @@ public:
     }
 };
 
+template <>
+inline constexpr bool is_fixed_layout_serializable<CBlockHeader>{true};
+static_assert(sizeof(CBlockHeader) == 80 && offsetof(CBlockHeader, hashPrevBlock) == 4 && offsetof(CBlockHeader, hashMerkleRoot) == 36 &&
+              offsetof(CBlockHeader, nTime) == 68 && offsetof(CBlockHeader, nBits) == 72 && offsetof(CBlockHeader, nNonce) == 76);
+
 
 class CBlock : public CBlockHeader
 {
@@ -119,6 +127,39 @@ public:
     std::string ToString() const;
 };
 
+/**
+ * Deserialize a block, placing its CTransaction objects and their shared_ptr
+ * control blocks in one MonotonicArena instead of one heap allocation each.
+ * The arena is freed when the last CTransactionRef of the block is released,
+ * so any single transaction kept around pins the memory of all of them: only
+ * use this where the block's transactions do not outlive the block.
+ *
+ * Only those two allocations per transaction are saved. The input and output
+ * vectors, scripts and witnesses inside each CTransaction still come from the
+ * heap, as their types are not allocator-aware. Blocks received from peers
+ * (ConnectBlock on the ProcessNewBlock path) and mempool transactions are not
+ * deserialized through this either; it is only used for blocks re-read from
+ * disk, such as by VerifyDB, ReplayBlocks, getblock and REST.
+ */
+template <typename Stream>
+void UnserializeBlockInArena(Stream& s, CBlock& block, const TransactionSerParams& params)
+{
+    //! Per-transaction arena estimate: the object plus shared_ptr control block overhead.
+    static constexpr size_t TX_ARENA_BYTES{sizeof(CTransaction) + 32};
+
+    block.SetNull();
+    s >> AsBase<CBlockHeader>(block);
+    const uint64_t tx_count{ReadCompactSize(s)};
+    // Size the arena for the whole block up front, but don't trust the count
+    // beyond what a large block holds; the arena grows if needed.
+    const size_t expected_txs{size_t(std::min<uint64_t>(tx_count, 1 << 14))};
+    const ArenaAllocator<CTransaction> alloc{std::make_shared<MonotonicArena>(expected_txs * TX_ARENA_BYTES)};
+    block.vtx.reserve(expected_txs);
+    for (uint64_t i = 0; i < tx_count; ++i) {
+        block.vtx.push_back(std::allocate_shared<const CTransaction>(alloc, deserialize, params, s));
+    }
+}
+
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
  * The further back it is, the further before the fork it may be.
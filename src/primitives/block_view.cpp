@@ -0,0 +1,233 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block_view.h>
+
+#include <consensus/consensus.h>
+#include <crypto/common.h>
+#include <crypto/sha256.h>
+#include <hash.h>
+#include <serialize.h>
+#include <streams.h>
+
+#include <algorithm>
+#include <ios>
+
+namespace {
+/** Split off the first n bytes of data. */
+Span<const std::byte> Take(Span<const std::byte>& data, uint64_t n)
+{
+    if (n > data.size()) throw std::ios_base::failure("BlockView: end of data");
+    const Span<const std::byte> head{data.first(n)};
+    data = data.subspan(n);
+    return head;
+}
+
+uint32_t TakeLE32(Span<const std::byte>& data) { return ReadLE32(UCharCast(Take(data, 4).data())); }
+uint64_t TakeLE64(Span<const std::byte>& data) { return ReadLE64(UCharCast(Take(data, 8).data())); }
+
+/** Read a CompactSize, applying the same canonical-encoding and MAX_SIZE checks as deserialization. */
+uint64_t TakeCompactSize(Span<const std::byte>& data)
+{
+    SpanReader reader{MakeUCharSpan(data)};
+    const uint64_t n{ReadCompactSize(reader)};
+    data = data.last(reader.size());
+    return n;
+}
+
+/** Skip a length-prefixed byte string and return its contents. */
+Span<const std::byte> TakeBytes(Span<const std::byte>& data) { return Take(data, TakeCompactSize(data)); }
+} // namespace
+
+uint64_t TxView::ReadCount(Span<const std::byte>& data) { return TakeCompactSize(data); }
+
+TxInView TxView::ParseInput(Span<const std::byte>& data)
+{
+    TxInView in;
+    in.prevout.hash = Txid::FromUint256(uint256{UCharSpanCast(Take(data, uint256::size()))});
+    in.prevout.n = TakeLE32(data);
+    in.script_sig = TakeBytes(data);
+    in.sequence = TakeLE32(data);
+    return in;
+}
+
+TxOutView TxView::ParseOutput(Span<const std::byte>& data)
+{
+    TxOutView out;
+    out.value = static_cast<CAmount>(TakeLE64(data));
+    out.script_pub_key = TakeBytes(data);
+    return out;
+}
+
+TxView TxView::Parse(Span<const std::byte>& data)
+{
+    // Mirrors UnserializeTransaction() with witness serialization allowed.
+    const Span<const std::byte> start{data};
+    const auto offset{[&] { return start.size() - data.size(); }};
+    TxView tx;
+    Take(data, 4); // version
+    tx.m_io_begin = offset();
+    uint64_t input_count{TakeCompactSize(data)};
+    uint8_t flags{0};
+    bool read_outputs{true};
+    if (input_count == 0) {
+        // Either the segwit marker or a transaction without inputs; the next byte is the flag byte.
+        const size_t flags_pos{offset()};
+        flags = std::to_integer<uint8_t>(Take(data, 1)[0]);
+        if (flags != 0) {
+            tx.m_io_begin = offset();
+            input_count = TakeCompactSize(data);
+        } else {
+            // The flag byte doubles as the empty output count, so the bytes
+            // already match the non-witness serialization.
+            tx.m_outputs_begin = flags_pos;
+            read_outputs = false;
+        }
+    }
+    for (uint64_t i = 0; i < input_count; ++i) ParseInput(data);
+    uint64_t output_count{0};
+    if (read_outputs) {
+        tx.m_outputs_begin = offset();
+        output_count = TakeCompactSize(data);
+        for (uint64_t i = 0; i < output_count; ++i) ParseOutput(data);
+    }
+    tx.m_io_end = offset();
+    if (flags & 1) {
+        flags ^= 1;
+        bool has_witness{false};
+        for (uint64_t i = 0; i < input_count; ++i) {
+            const uint64_t stack_size{TakeCompactSize(data)};
+            has_witness |= stack_size != 0;
+            for (uint64_t j = 0; j < stack_size; ++j) TakeBytes(data);
+        }
+        if (!has_witness) throw std::ios_base::failure("Superfluous witness record");
+        tx.m_has_witness = true;
+    }
+    if (flags) throw std::ios_base::failure("Unknown transaction optional data");
+    Take(data, 4); // nLockTime
+    tx.m_bytes = start.first(offset());
+    tx.m_input_count = input_count;
+    tx.m_output_count = output_count;
+    return tx;
+}
+
+int32_t TxView::Version() const { return static_cast<int32_t>(ReadLE32(UCharCast(m_bytes.data()))); }
+
+uint32_t TxView::LockTime() const { return ReadLE32(UCharCast(m_bytes.last(4).data())); }
+
+Txid TxView::GetHash() const
+{
+    HashWriter hasher{};
+    hasher.write(m_bytes.first(4));
+    hasher.write(InputsAndOutputs());
+    hasher.write(m_bytes.last(4));
+    return Txid::FromUint256(hasher.GetHash());
+}
+
+Wtxid TxView::GetWitnessHash() const
+{
+    if (!m_has_witness) return Wtxid::FromUint256(GetHash().ToUint256());
+    HashWriter hasher{};
+    hasher.write(m_bytes);
+    return Wtxid::FromUint256(hasher.GetHash());
+}
+
+CTransactionRef TxView::Materialize() const
+{
+    SpanReader reader{MakeUCharSpan(m_bytes)};
+    return MakeTransactionRef(CMutableTransaction{deserialize, TX_WITH_WITNESS, reader});
+}
+
+BlockView::BlockView(Span<const std::byte> data) : m_bytes{data}
+{
+    SpanReader header_reader{MakeUCharSpan(Take(data, 80))};
+    header_reader >> m_header;
+    const uint64_t tx_count{TakeCompactSize(data)};
+    // Every transaction takes at least 10 bytes; don't trust the count for the allocation.
+    m_txs.reserve(std::min<uint64_t>(tx_count, data.size() / 10));
+    for (uint64_t i = 0; i < tx_count; ++i) m_txs.push_back(TxView::Parse(data));
+    if (!data.empty()) throw std::ios_base::failure("BlockView: trailing data");
+}
+
+size_t BlockView::GetStrippedSize() const
+{
+    size_t size{80 + GetSizeOfCompactSize(m_txs.size())};
+    for (const TxView& tx : m_txs) size += tx.GetStrippedSize();
+    return size;
+}
+
+int64_t BlockView::GetWeight() const
+{
+    return int64_t(GetStrippedSize()) * (WITNESS_SCALE_FACTOR - 1) + int64_t(GetTotalSize());
+}
+
+CBlock BlockView::Materialize() const { return DeserializeBlockBatchHashed(m_bytes); }
+
+CBlock DeserializeBlockBatchHashed(Span<const std::byte> data)
+{
+    SpanReader reader{MakeUCharSpan(data)};
+    CBlock block;
+    reader >> static_cast<CBlockHeader&>(block);
+    const uint64_t tx_count{ReadCompactSize(reader)};
+    // Every transaction takes at least 10 bytes; don't trust the count for the allocations.
+    const size_t reserve{static_cast<size_t>(std::min<uint64_t>(tx_count, data.size() / 10))};
+    std::vector<CMutableTransaction> txs;
+    std::vector<Span<const std::byte>> tx_bytes;
+    txs.reserve(reserve);
+    tx_bytes.reserve(reserve);
+    for (uint64_t i = 0; i < tx_count; ++i) {
+        const size_t begin{data.size() - reader.size()};
+        txs.emplace_back(deserialize, TX_WITH_WITNESS, reader);
+        tx_bytes.push_back(data.subspan(begin, data.size() - reader.size() - begin));
+    }
+    if (!reader.empty()) throw std::ios_base::failure("DeserializeBlockBatchHashed: trailing data");
+
+    // The txid preimage of a witness transaction leaves out the marker and flag after
+    // the version and the witnesses before the lock time. The wtxid preimage is the
+    // data as read.
+    std::vector<unsigned char> scratch;
+    std::vector<size_t> stripped_ends;
+    for (size_t i = 0; i < txs.size(); ++i) {
+        if (!txs[i].HasWitness()) continue;
+        const Span<const unsigned char> bytes{MakeUCharSpan(tx_bytes[i])};
+        size_t witness_size{0};
+        for (const CTxIn& in : txs[i].vin) {
+            witness_size += GetSizeOfCompactSize(in.scriptWitness.stack.size());
+            for (const auto& item : in.scriptWitness.stack) witness_size += GetSizeOfCompactSize(item.size()) + item.size();
+        }
+        scratch.insert(scratch.end(), bytes.begin(), bytes.begin() + 4);
+        scratch.insert(scratch.end(), bytes.begin() + 6, bytes.end() - 4 - witness_size);
+        scratch.insert(scratch.end(), bytes.end() - 4, bytes.end());
+        stripped_ends.push_back(scratch.size());
+    }
+    std::vector<Span<const unsigned char>> messages;
+    messages.reserve(txs.size() + stripped_ends.size());
+    size_t stripped_begin{0};
+    auto stripped_end{stripped_ends.begin()};
+    for (size_t i = 0; i < txs.size(); ++i) {
+        const Span<const unsigned char> bytes{MakeUCharSpan(tx_bytes[i])};
+        if (!txs[i].HasWitness()) {
+            messages.push_back(bytes);
+            continue;
+        }
+        messages.push_back(Span{scratch}.subspan(stripped_begin, *stripped_end - stripped_begin));
+        messages.push_back(bytes);
+        stripped_begin = *stripped_end++;
+    }
+    std::vector<unsigned char> hashes(messages.size() * uint256::size());
+    SHA256DMany(hashes.data(), messages);
+    size_t hash_pos{0};
+    const auto next_hash{[&] {
+        hash_pos += uint256::size();
+        return uint256{Span{hashes}.subspan(hash_pos - uint256::size(), uint256::size())};
+    }};
+
+    block.vtx.reserve(txs.size());
+    for (CMutableTransaction& tx : txs) {
+        const Txid txid{Txid::FromUint256(next_hash())};
+        const Wtxid wtxid{Wtxid::FromUint256(tx.HasWitness() ? next_hash() : txid.ToUint256())};
+        block.vtx.push_back(std::make_shared<const CTransaction>(std::move(tx), txid, wtxid));
+    }
+    return block;
+}
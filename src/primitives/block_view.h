@@ -0,0 +1,146 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PRIMITIVES_BLOCK_VIEW_H
+#define BITCOIN_PRIMITIVES_BLOCK_VIEW_H
+
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <span.h>
+#include <util/transaction_identifier.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Read-only views of serialized blocks and transactions.
+ *
+ * A view keeps byte ranges into the buffer it was parsed from instead of
+ * materializing CTransaction objects, so walking a block costs one allocation
+ * (the transaction list) rather than several per transaction. Txids and wtxids
+ * are hashed directly over the original bytes. The buffer must outlive the
+ * view. Use CBlock/CTransaction when the data is going to be validated; views
+ * only check that the data is well formed.
+ */
+
+/** An input of a TxView. */
+struct TxInView {
+    COutPoint prevout;
+    Span<const std::byte> script_sig;
+    uint32_t sequence;
+};
+
+/** An output of a TxView. */
+struct TxOutView {
+    CAmount value;
+    Span<const std::byte> script_pub_key;
+};
+
+class TxView
+{
+public:
+    /**
+     * Parse one transaction (with witness data, if present) from the front of
+     * data and advance data past it.
+     * @throws std::ios_base::failure if the data is not a well formed transaction
+     */
+    static TxView Parse(Span<const std::byte>& data);
+
+    /** The full serialization, including witness data. */
+    Span<const std::byte> Bytes() const { return m_bytes; }
+    bool HasWitness() const { return m_has_witness; }
+
+    int32_t Version() const;
+    uint32_t LockTime() const;
+    size_t InputCount() const { return m_input_count; }
+    size_t OutputCount() const { return m_output_count; }
+
+    /** Size of the serialization without witness data. */
+    size_t GetStrippedSize() const { return m_io_end - m_io_begin + 8; }
+    size_t GetTotalSize() const { return m_bytes.size(); }
+
+    /** Hash of the serialization without witness data, computed over the original bytes. */
+    Txid GetHash() const;
+    /** Hash of the full serialization, computed over the original bytes. */
+    Wtxid GetWitnessHash() const;
+
+    /** Call fn(const TxInView&) for every input. */
+    template <typename Fn>
+    void ForEachInput(Fn&& fn) const
+    {
+        Span<const std::byte> data{InputsAndOutputs()};
+        const uint64_t count{ReadCount(data)};
+        for (uint64_t i = 0; i < count; ++i) fn(ParseInput(data));
+    }
+
+    /** Call fn(const TxOutView&) for every output. */
+    template <typename Fn>
+    void ForEachOutput(Fn&& fn) const
+    {
+        Span<const std::byte> data{m_bytes.subspan(m_outputs_begin, m_io_end - m_outputs_begin)};
+        const uint64_t count{ReadCount(data)};
+        for (uint64_t i = 0; i < count; ++i) fn(ParseOutput(data));
+    }
+
+    /** Deserialize into a full transaction. */
+    CTransactionRef Materialize() const;
+
+private:
+    Span<const std::byte> m_bytes;
+    //! Offsets into m_bytes of the region shared with the non-witness serialization
+    //! (input count up to the last output) and of the output count within it.
+    size_t m_io_begin{0};
+    size_t m_outputs_begin{0};
+    size_t m_io_end{0};
+    size_t m_input_count{0};
+    size_t m_output_count{0};
+    bool m_has_witness{false};
+
+    Span<const std::byte> InputsAndOutputs() const { return m_bytes.subspan(m_io_begin, m_io_end - m_io_begin); }
+
+    static uint64_t ReadCount(Span<const std::byte>& data);
+    static TxInView ParseInput(Span<const std::byte>& data);
+    static TxOutView ParseOutput(Span<const std::byte>& data);
+};
+
+class BlockView
+{
+public:
+    /**
+     * Parse a serialized block. The whole of data must be consumed.
+     * @throws std::ios_base::failure if the data is not a well formed block
+     */
+    explicit BlockView(Span<const std::byte> data);
+
+    const CBlockHeader& GetHeader() const { return m_header; }
+    uint256 GetHash() const { return m_header.GetHash(); }
+    const std::vector<TxView>& Transactions() const { return m_txs; }
+
+    Span<const std::byte> Bytes() const { return m_bytes; }
+    size_t GetStrippedSize() const;
+    size_t GetTotalSize() const { return m_bytes.size(); }
+    /** Block weight, as GetBlockWeight() would compute for the deserialized block. */
+    int64_t GetWeight() const;
+
+    /** Deserialize into a full block, see DeserializeBlockBatchHashed(). */
+    CBlock Materialize() const;
+
+private:
+    Span<const std::byte> m_bytes;
+    CBlockHeader m_header;
+    std::vector<TxView> m_txs;
+};
+
+/**
+ * Deserialize a block (with witness data) in a single pass. The txids and
+ * wtxids of all transactions are then computed together with SHA256DMany(),
+ * over the byte ranges the transactions were read from. The whole of data
+ * must be consumed.
+ * @throws std::ios_base::failure if the data is not a well formed block
+ */
+CBlock DeserializeBlockBatchHashed(Span<const std::byte> data);
+
+#endif // BITCOIN_PRIMITIVES_BLOCK_VIEW_H
@@ -59,6 +59,10 @@ public:
     std::string ToString() const;
 };
 
+template <>
+inline constexpr bool is_fixed_layout_serializable<COutPoint>{true};
+static_assert(sizeof(COutPoint) == 36 && offsetof(COutPoint, n) == 32);
+
 /** An input of a transaction.  It contains the location of the previous
  * transaction's output that it claims and a signature that matches the
  * output's public key.
@@ -323,6 +327,9 @@ public:
     /** Convert a CMutableTransaction into a CTransaction. */
     explicit CTransaction(const CMutableTransaction& tx);
     explicit CTransaction(CMutableTransaction&& tx);
+    /** Convert a CMutableTransaction whose hashes were already computed, e.g. in a batch
+     *  with SHA256DMany(). The caller is responsible for them matching the transaction. */
+    CTransaction(CMutableTransaction&& tx, const Txid& txid, const Wtxid& wtxid);
 
     template <typename Stream>
     inline void Serialize(Stream& s) const {
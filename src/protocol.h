@@ -15,6 +15,7 @@
 #include <util/time.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 #include <string>
@@ -53,6 +54,10 @@ public:
     uint8_t pchChecksum[CHECKSUM_SIZE]{};
 };
 
+template <>
+inline constexpr bool is_fixed_layout_serializable<CMessageHeader>{true};
+static_assert(sizeof(CMessageHeader) == CMessageHeader::HEADER_SIZE && offsetof(CMessageHeader, nMessageSize) == 16 && offsetof(CMessageHeader, pchChecksum) == 20);
+
 /**
  * Bitcoin protocol message types. When adding new message types, don't forget
  * to update ALL_NET_MESSAGE_TYPES below.
@@ -525,6 +530,10 @@ public:
     uint256 hash;
 };
 
+template <>
+inline constexpr bool is_fixed_layout_serializable<CInv>{true};
+static_assert(sizeof(CInv) == 36 && offsetof(CInv, hash) == 4);
+
 /** Convert a TX/WITNESS_TX/WTX CInv to a GenTxid. */
 GenTxid ToGenTxid(const CInv& inv);
 
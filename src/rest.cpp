@@ -18,6 +18,7 @@
 #include <node/blockstorage.h>
 #include <node/context.h>
 #include <primitives/block.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
 #include <rpc/mempool.h>
@@ -338,10 +339,16 @@ static bool rest_block(const std::any& context,
     }
 
     case RESTResponseFormat::JSON: {
-        CBlock block{};
-        DataStream block_stream{block_data};
-        block_stream >> TX_WITH_WITNESS(block);
-        UniValue objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        UniValue objBlock;
+        if (tx_verbosity == TxVerbosity::SHOW_TXID) {
+            const BlockView block{MakeByteSpan(block_data)};
+            objBlock = blockToJSON(block, *tip, *pblockindex, chainman.GetConsensus().powLimit);
+        } else {
+            CBlock block{};
+            DataStream block_stream{block_data};
+            UnserializeBlockInArena(block_stream, block, TX_WITH_WITNESS);
+            objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+        }
         std::string strJSON = objBlock.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
         req->WriteReply(HTTP_OK, strJSON);
@@ -887,6 +894,7 @@ static bool rest_getutxos(const std::any& context, HTTPRequest* req, const std::
             CCoinsViewMemPool viewMempool(&viewChain, *mempool);
             process_utxos(viewMempool, mempool);
         } else {
+            // Point lookups are served by the coins cache under a short cs_main lock.
             LOCK(cs_main);
             process_utxos(chainman.ActiveChainstate().CoinsTip(), nullptr);
         }
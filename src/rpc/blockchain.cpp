@@ -25,6 +25,7 @@
 #include <index/coinstatsindex.h>
 #include <interfaces/mining.h>
 #include <kernel/coinstats.h>
+#include <kernel/validation_profiler.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
@@ -33,6 +34,7 @@
 #include <node/transaction.h>
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
+#include <primitives/block_view.h>
 #include <primitives/transaction.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
@@ -46,6 +48,7 @@
 #include <undo.h>
 #include <univalue.h>
 #include <util/check.h>
+#include <util/metrics.h>
 #include <util/fs.h>
 #include <util/strencodings.h>
 #include <util/translation.h>
@@ -217,6 +220,22 @@ UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIn
     return result;
 }
 
+UniValue blockToJSON(const BlockView& block, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit)
+{
+    UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
+
+    result.pushKV("strippedsize", (int)block.GetStrippedSize());
+    result.pushKV("size", (int)block.GetTotalSize());
+    result.pushKV("weight", (int)block.GetWeight());
+    UniValue txs(UniValue::VARR);
+    for (const TxView& tx : block.Transactions()) {
+        txs.push_back(tx.GetHash().GetHex());
+    }
+    result.pushKV("tx", std::move(txs));
+
+    return result;
+}
+
 static RPCHelpMan getblockcount()
 {
     return RPCHelpMan{"getblockcount",
@@ -627,7 +646,7 @@ static CBlock GetBlockChecked(BlockManager& blockman, const CBlockIndex& blockin
         CheckBlockDataAvailability(blockman, blockindex, /*check_for_undo=*/false);
     }
 
-    if (!blockman.ReadBlock(block, blockindex)) {
+    if (!blockman.ReadBlock(block, blockindex, /*use_arena=*/true)) {
         // Block not found on disk. This shouldn't normally happen unless the block was
         // pruned right after we released the lock above.
         throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
@@ -793,14 +812,18 @@ static RPCHelpMan getblock()
         return HexStr(block_data);
     }
 
+    if (verbosity == 1) {
+        // Txids and sizes can be read off the serialized block; skip building a CBlock.
+        const BlockView block{MakeByteSpan(block_data)};
+        return blockToJSON(block, *tip, *pblockindex, chainman.GetConsensus().powLimit);
+    }
+
     DataStream block_stream{block_data};
     CBlock block{};
-    block_stream >> TX_WITH_WITNESS(block);
+    UnserializeBlockInArena(block_stream, block, TX_WITH_WITNESS);
 
     TxVerbosity tx_verbosity;
-    if (verbosity == 1) {
-        tx_verbosity = TxVerbosity::SHOW_TXID;
-    } else if (verbosity == 2) {
+    if (verbosity == 2) {
         tx_verbosity = TxVerbosity::SHOW_DETAILS;
     } else {
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
@@ -1001,16 +1024,13 @@ static RPCHelpMan gettxoutsetinfo()
     NodeContext& node = EnsureAnyNodeContext(request.context);
     ChainstateManager& chainman = EnsureChainman(node);
     Chainstate& active_chainstate = chainman.ActiveChainstate();
-    active_chainstate.ForceFlushStateToDisk();
 
-    CCoinsView* coins_view;
-    BlockManager* blockman;
-    {
-        LOCK(::cs_main);
-        coins_view = &active_chainstate.CoinsDB();
-        blockman = &active_chainstate.m_blockman;
-        pindex = blockman->LookupBlockIndex(coins_view->GetBestBlock());
-    }
+    // Compute the statistics over a snapshot of the UTXO set, which only
+    // flushes the cache to the database if it holds many unflushed changes.
+    const auto snapshot{active_chainstate.GetCoinsTipSnapshot()};
+    CCoinsView* coins_view{snapshot->coins.get()};
+    BlockManager* blockman{&active_chainstate.m_blockman};
+    pindex = snapshot->tip;
 
     if (!request.params[1].isNull()) {
         if (!g_coin_stats_index) {
@@ -1129,7 +1149,6 @@ static RPCHelpMan gettxout()
 {
     NodeContext& node = EnsureAnyNodeContext(request.context);
     ChainstateManager& chainman = EnsureChainman(node);
-    LOCK(cs_main);
 
     UniValue ret(UniValue::VOBJ);
 
@@ -1139,6 +1158,9 @@ static RPCHelpMan gettxout()
     if (!request.params[2].isNull())
         fMempool = request.params[2].get_bool();
 
+    // A point lookup is served by the coins cache, which only needs cs_main
+    // for as long as the lookup takes.
+    LOCK(cs_main);
     Chainstate& active_chainstate = chainman.ActiveChainstate();
     CCoinsViewCache* coins_view = &active_chainstate.CoinsTip();
 
@@ -1154,6 +1176,7 @@ static RPCHelpMan gettxout()
     if (!coin) return UniValue::VNULL;
 
     const CBlockIndex* pindex = active_chainstate.m_blockman.LookupBlockIndex(coins_view->GetBestBlock());
+
     ret.pushKV("bestblock", pindex->GetBlockHash().GetHex());
     if (coin->nHeight == MEMPOOL_HEIGHT) {
         ret.pushKV("confirmations", 0);
@@ -2313,17 +2336,12 @@ static RPCHelpMan scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
-        const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
-        {
-            ChainstateManager& chainman = EnsureChainman(node);
-            LOCK(cs_main);
-            Chainstate& active_chainstate = chainman.ActiveChainstate();
-            active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
-            tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
-        }
+        // Scan a snapshot of the UTXO set, so that neither a flush nor
+        // holding cs_main is needed, and block validation can go on meanwhile.
+        const auto snapshot{EnsureChainman(node).ActiveChainstate().GetCoinsTipSnapshot()};
+        std::unique_ptr<CCoinsViewCursor> pcursor{CHECK_NONFATAL(snapshot->coins->Cursor())};
+        const CBlockIndex* tip{CHECK_NONFATAL(snapshot->tip)};
         bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
@@ -3380,6 +3398,117 @@ return RPCHelpMan{
 }
 
 
+static RPCHelpMan getvalidationstats()
+{
+    return RPCHelpMan{
+        "getvalidationstats",
+        "\nReturn how long the stages of validating and connecting blocks took, as distributions since startup\n"
+        "and for each of the last connected blocks. Durations are in milliseconds. Quantiles are the upper bound\n"
+        "of the histogram bucket they fall in, so they are accurate to a factor of two.\n"
+        "Also returns the number of validation notifications waiting to be delivered to each subscriber.\n",
+        {
+            {"nblocks", RPCArg::Type::NUM, RPCArg::Default{10}, "Number of most recently connected blocks to return."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "", {
+                {RPCResult::Type::OBJ_DYN, "stages", "distribution of the durations of each stage", {
+                    {RPCResult::Type::OBJ, "stage", "", {
+                        {RPCResult::Type::NUM, "count", "number of durations recorded"},
+                        {RPCResult::Type::NUM, "total", "sum of the durations"},
+                        {RPCResult::Type::NUM, "mean", "mean duration"},
+                        {RPCResult::Type::NUM, "p50", "median duration"},
+                        {RPCResult::Type::NUM, "p90", "90th percentile duration"},
+                        {RPCResult::Type::NUM, "p99", "99th percentile duration"},
+                    }},
+                }},
+                {RPCResult::Type::ARR, "blocks", "the most recently connected blocks, newest first", {
+                    {RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::NUM, "height", "block height"},
+                        {RPCResult::Type::STR_HEX, "hash", "block hash"},
+                        {RPCResult::Type::NUM, "txs", "number of transactions"},
+                        {RPCResult::Type::OBJ_DYN, "stages", "duration of each stage; header_check is not recorded per block", {
+                            {RPCResult::Type::NUM, "stage", "duration"},
+                        }},
+                    }},
+                }},
+                {RPCResult::Type::ARR, "notification_queues", "the notification queue of each subscriber to validation events, such as wallets and indexes", {
+                    {RPCResult::Type::OBJ, "", "", {
+                        {RPCResult::Type::STR, "name", "subscriber name"},
+                        {RPCResult::Type::NUM, "pending", "number of notifications waiting to be delivered"},
+                    }},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getvalidationstats", "")
+            + HelpExampleRpc("getvalidationstats", "5")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const int nblocks{self.Arg<int>("nblocks")};
+    if (nblocks < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "nblocks must not be negative");
+    }
+    // The profiler is updated and read without cs_main.
+    const kernel::ValidationProfiler& profiler{EnsureAnyChainman(request.context).GetValidationProfiler()};
+    const auto to_ms{[](double micros) { return micros * 1e-3; }};
+
+    UniValue stages{UniValue::VOBJ};
+    for (size_t i = 0; i < kernel::NUM_VALIDATION_STAGES; ++i) {
+        const auto stage{kernel::ValidationStage(i)};
+        const metrics::Histogram& histogram{profiler.GetHistogram(stage)};
+        const auto quantile{[&](double q) {
+            // Report the +Inf bucket as the largest bound.
+            return to_ms(std::min(histogram.Quantile(q), histogram.Bounds().back()));
+        }};
+        const uint64_t count{histogram.Count()};
+        UniValue entry{UniValue::VOBJ};
+        entry.pushKV("count", count);
+        entry.pushKV("total", to_ms(histogram.Sum()));
+        entry.pushKV("mean", count == 0 ? 0.0 : to_ms(histogram.Sum()) / count);
+        entry.pushKV("p50", quantile(0.5));
+        entry.pushKV("p90", quantile(0.9));
+        entry.pushKV("p99", quantile(0.99));
+        stages.pushKV(std::string{kernel::ValidationStageName(stage)}, std::move(entry));
+    }
+
+    UniValue blocks{UniValue::VARR};
+    const std::vector<kernel::BlockProfile> history{profiler.GetHistory()};
+    for (auto it{history.rbegin()}; it != history.rend() && blocks.size() < size_t(nblocks); ++it) {
+        UniValue block{UniValue::VOBJ};
+        block.pushKV("height", it->height);
+        block.pushKV("hash", it->hash.GetHex());
+        block.pushKV("txs", uint64_t(it->tx_count));
+        UniValue block_stages{UniValue::VOBJ};
+        for (size_t i = 0; i < kernel::NUM_VALIDATION_STAGES; ++i) {
+            const auto stage{kernel::ValidationStage(i)};
+            if (stage == kernel::ValidationStage::HEADER_CHECK) continue;
+            block_stages.pushKV(std::string{kernel::ValidationStageName(stage)}, to_ms(it->stages[i].count()));
+        }
+        block.pushKV("stages", std::move(block_stages));
+        blocks.push_back(std::move(block));
+    }
+
+    UniValue queues{UniValue::VARR};
+    const NodeContext& node{EnsureAnyNodeContext(request.context)};
+    if (node.validation_signals) {
+        for (const auto& queue : node.validation_signals->GetSubscriberQueues()) {
+            UniValue entry{UniValue::VOBJ};
+            entry.pushKV("name", queue.name);
+            entry.pushKV("pending", uint64_t(queue.pending));
+            queues.push_back(std::move(entry));
+        }
+    }
+
+    UniValue obj{UniValue::VOBJ};
+    obj.pushKV("stages", std::move(stages));
+    obj.pushKV("blocks", std::move(blocks));
+    obj.pushKV("notification_queues", std::move(queues));
+    return obj;
+}
+    };
+}
+
 void RegisterBlockchainRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
@@ -3407,6 +3536,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &dumptxoutset},
         {"blockchain", &loadtxoutset},
         {"blockchain", &getchainstates},
+        {"blockchain", &getvalidationstats},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"hidden", &waitfornewblock},
@@ -5,6 +5,7 @@
 
 #include <bitcoin-build-config.h> // IWYU pragma: keep
 
+#include <addrman.h>
 #include <chainparams.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
@@ -16,15 +17,20 @@
 #include <interfaces/ipc.h>
 #include <kernel/cs_main.h>
 #include <logging.h>
+#include <memusage.h>
+#include <net_processing.h>
 #include <node/context.h>
 #include <rpc/server.h>
 #include <rpc/server_util.h>
 #include <rpc/util.h>
 #include <scheduler.h>
+#include <sync.h>
+#include <txmempool.h>
 #include <univalue.h>
 #include <util/any.h>
 #include <util/check.h>
 #include <util/time.h>
+#include <validation.h>
 
 #include <stdint.h>
 #ifdef HAVE_MALLOC_INFO
@@ -192,6 +198,237 @@ static RPCHelpMan getmemoryinfo()
     };
 }
 
+static RPCHelpMan getmemoryusage()
+{
+    return RPCHelpMan{"getmemoryusage",
+                "Returns an estimate of the memory used by the main data structures of the node, in bytes.\n"
+                "The estimates count the heap allocations of each structure, so they don't include allocator overhead,\n"
+                "thread stacks or the code, and add up to less than the resident set size of the process.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "total", "Sum of all of the below, except mempool_index, which is part of mempool"},
+                        {RPCResult::Type::NUM, "block_index", "The block index"},
+                        {RPCResult::Type::NUM, "coins_cache", "The UTXO caches of all chainstates"},
+                        {RPCResult::Type::NUM, "mempool", "The mempool, including its indexes"},
+                        {RPCResult::Type::NUM, "mempool_index", "The part of mempool used by its indexes and maps, rather than the transactions"},
+                        {RPCResult::Type::NUM, "orphanage", "Orphan transactions"},
+                        {RPCResult::Type::NUM, "compact_blocks", "Partially downloaded compact blocks, and the extra transactions kept to reconstruct them"},
+                        {RPCResult::Type::NUM, "addrman", "The address manager"},
+                        {RPCResult::Type::NUM, "signature_cache", "The signature cache"},
+                        {RPCResult::Type::NUM, "script_execution_cache", "The script execution cache"},
+                        {RPCResult::Type::NUM, "wallets", "The loaded wallets"},
+                        {RPCResult::Type::OBJ_DYN, "leveldb", "Memory tables and caches of the LevelDB databases, by database",
+                        {
+                            {RPCResult::Type::NUM, "name", "The estimate LevelDB gives as its approximate-memory-usage property"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getmemoryusage", "")
+            + HelpExampleRpc("getmemoryusage", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const NodeContext& node{EnsureAnyNodeContext(request.context)};
+    ChainstateManager& chainman{EnsureChainman(node)};
+
+    UniValue leveldb(UniValue::VOBJ);
+    size_t leveldb_total{0};
+    const auto add_leveldb{[&](const std::string& name, size_t usage) {
+        leveldb.pushKV(name, uint64_t(usage));
+        leveldb_total += usage;
+    }};
+
+    size_t block_index{0};
+    size_t coins_cache{0};
+    {
+        LOCK(cs_main);
+        block_index = memusage::DynamicUsage(chainman.m_blockman.m_block_index);
+        size_t coins_db{0};
+        for (Chainstate* chainstate : chainman.GetAll()) {
+            coins_cache += chainstate->CoinsTip().DynamicMemoryUsage();
+            coins_db += chainstate->CoinsDB().DynamicMemoryUsage();
+        }
+        add_leveldb("block_tree", chainman.m_blockman.m_block_tree_db->DynamicMemoryUsage());
+        add_leveldb("chainstate", coins_db);
+    }
+    if (g_txindex) add_leveldb(g_txindex->GetName(), g_txindex->DynamicMemoryUsage());
+    if (g_coin_stats_index) add_leveldb(g_coin_stats_index->GetName(), g_coin_stats_index->DynamicMemoryUsage());
+    ForEachBlockFilterIndex([&](const BlockFilterIndex& index) { add_leveldb(index.GetName(), index.DynamicMemoryUsage()); });
+
+    size_t mempool{0};
+    size_t mempool_index{0};
+    if (node.mempool) {
+        LOCK(node.mempool->cs);
+        mempool = node.mempool->DynamicMemoryUsage();
+        mempool_index = node.mempool->IndexMemoryUsage();
+    }
+    const PeerManagerMemoryUsage peerman{node.peerman ? node.peerman->GetMemoryUsage() : PeerManagerMemoryUsage{}};
+    const size_t addrman{node.addrman ? node.addrman->DynamicMemoryUsage() : 0};
+    const size_t signature_cache{chainman.m_validation_cache.m_signature_cache.DynamicMemoryUsage()};
+    const size_t script_execution_cache{chainman.m_validation_cache.m_script_execution_cache.memory_usage()};
+    size_t wallets{0};
+    for (const auto& chain_client : node.chain_clients) {
+        wallets += chain_client->getMemoryUsage();
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("total", uint64_t(block_index + coins_cache + mempool + peerman.orphanage + peerman.compact_blocks + addrman +
+                                    signature_cache + script_execution_cache + wallets + leveldb_total));
+    result.pushKV("block_index", uint64_t(block_index));
+    result.pushKV("coins_cache", uint64_t(coins_cache));
+    result.pushKV("mempool", uint64_t(mempool));
+    result.pushKV("mempool_index", uint64_t(mempool_index));
+    result.pushKV("orphanage", uint64_t(peerman.orphanage));
+    result.pushKV("compact_blocks", uint64_t(peerman.compact_blocks));
+    result.pushKV("addrman", uint64_t(addrman));
+    result.pushKV("signature_cache", uint64_t(signature_cache));
+    result.pushKV("script_execution_cache", uint64_t(script_execution_cache));
+    result.pushKV("wallets", uint64_t(wallets));
+    result.pushKV("leveldb", std::move(leveldb));
+    return result;
+},
+    };
+}
+
+static UniValue LockDurationsToJSON(const lockprofile::Durations& durations)
+{
+    const auto micros{[](std::chrono::nanoseconds ns) { return UniValue{Ticks<std::chrono::nanoseconds>(ns) / 1000.0}; }};
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("total_us", micros(durations.total));
+    obj.pushKV("max_us", micros(durations.max));
+    obj.pushKV("p50_us", micros(durations.Quantile(0.5)));
+    obj.pushKV("p90_us", micros(durations.Quantile(0.9)));
+    obj.pushKV("p99_us", micros(durations.Quantile(0.99)));
+    return obj;
+}
+
+static RPCHelpMan getlockprofile()
+{
+    const auto durations_doc{[](const std::string& key, const std::string& what) {
+        return RPCResult{RPCResult::Type::OBJ, key, strprintf("Time the sampled acquisitions %s. Percentiles are upper bounds, accurate to a factor of two", what),
+        {
+            {RPCResult::Type::NUM, "total_us", "Total, in microseconds"},
+            {RPCResult::Type::NUM, "max_us", "Maximum, in microseconds"},
+            {RPCResult::Type::NUM, "p50_us", "Median, in microseconds"},
+            {RPCResult::Type::NUM, "p90_us", "90th percentile, in microseconds"},
+            {RPCResult::Type::NUM, "p99_us", "99th percentile, in microseconds"},
+        }};
+    }};
+    return RPCHelpMan{"getlockprofile",
+                "Returns the lock acquisition sites that waited the longest for their lock, as sampled by the lock profiler.\n"
+                "The profiler is enabled with -lockprofile=<n>, which samples one in n acquisitions.\n",
+                {
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{20}, "The maximum number of sites to return"},
+                    {"reset", RPCArg::Type::BOOL, RPCArg::Default{false}, "Discard the samples taken so far, after returning them"},
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "sample_rate", "One in this many acquisitions is sampled, 0 if the profiler is disabled"},
+                        {RPCResult::Type::ARR, "sites", "Acquisition sites, most total wait time first",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR, "lock", "The locked expression, e.g. cs_main"},
+                                {RPCResult::Type::STR, "file", "Source file of the acquisition"},
+                                {RPCResult::Type::NUM, "line", "Source line of the acquisition"},
+                                {RPCResult::Type::NUM, "samples", "Number of sampled acquisitions"},
+                                {RPCResult::Type::NUM, "contended", "Number of sampled acquisitions that found the lock taken"},
+                                durations_doc("wait", "waited for the lock"),
+                                durations_doc("hold", "held the lock"),
+                            }},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getlockprofile", "")
+            + HelpExampleCli("getlockprofile", "5 true")
+            + HelpExampleRpc("getlockprofile", "5, true")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const int count{self.Arg<int>("count")};
+    if (count < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be non-negative");
+    }
+    const std::vector<lockprofile::SiteStats> stats{lockprofile::GetStats()};
+    if (self.Arg<bool>("reset")) lockprofile::Reset();
+
+    UniValue sites(UniValue::VARR);
+    for (size_t i = 0; i < std::min<size_t>(count, stats.size()); ++i) {
+        const lockprofile::SiteStats& site{stats[i]};
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("lock", site.name);
+        obj.pushKV("file", site.file);
+        obj.pushKV("line", site.line);
+        obj.pushKV("samples", site.samples);
+        obj.pushKV("contended", site.contended);
+        obj.pushKV("wait", LockDurationsToJSON(site.wait));
+        obj.pushKV("hold", LockDurationsToJSON(site.hold));
+        sites.push_back(std::move(obj));
+    }
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("sample_rate", lockprofile::g_sample_rate.load());
+    result.pushKV("sites", std::move(sites));
+    return result;
+},
+    };
+}
+
+static RPCHelpMan getschedulerinfo()
+{
+    return RPCHelpMan{"getschedulerinfo",
+                "Returns information about the background task scheduler, and how long its tasks took to run.\n"
+                "The number of threads running tasks is set with -schedulerthreads.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "threads", "Number of threads running tasks"},
+                        {RPCResult::Type::NUM, "queued", "Number of tasks waiting to run"},
+                        {RPCResult::Type::OBJ_DYN, "tasks", "Statistics of the tasks that have run, by task name",
+                        {
+                            {RPCResult::Type::OBJ, "name", "",
+                            {
+                                {RPCResult::Type::NUM, "runs", "Number of times a task of this name ran"},
+                                {RPCResult::Type::NUM, "total_us", "Total run time, in microseconds"},
+                                {RPCResult::Type::NUM, "max_us", "Longest run time, in microseconds"},
+                                {RPCResult::Type::NUM, "last_us", "Run time of the last run, in microseconds"},
+                                {RPCResult::Type::NUM, "max_delay_us", "Longest time a task started after it was due, in microseconds"},
+                            }},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getschedulerinfo", "")
+            + HelpExampleRpc("getschedulerinfo", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScheduler& scheduler{*CHECK_NONFATAL(EnsureAnyNodeContext(request.context).scheduler)};
+    std::chrono::steady_clock::time_point first, last;
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("threads", scheduler.NumServiceThreads());
+    result.pushKV("queued", uint64_t(scheduler.getQueueInfo(first, last)));
+    UniValue tasks(UniValue::VOBJ);
+    for (const auto& [name, stats] : scheduler.GetTaskStats()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("runs", stats.runs);
+        obj.pushKV("total_us", Ticks<std::chrono::microseconds>(stats.total));
+        obj.pushKV("max_us", Ticks<std::chrono::microseconds>(stats.max));
+        obj.pushKV("last_us", Ticks<std::chrono::microseconds>(stats.last));
+        obj.pushKV("max_delay_us", Ticks<std::chrono::microseconds>(stats.max_delay));
+        tasks.pushKV(name, std::move(obj));
+    }
+    result.pushKV("tasks", std::move(tasks));
+    return result;
+},
+    };
+}
+
 static void EnableOrDisableLogCategories(UniValue cats, bool enable) {
     cats = cats.get_array();
     for (unsigned int i = 0; i < cats.size(); ++i) {
@@ -404,6 +641,9 @@ void RegisterNodeRPCCommands(CRPCTable& t)
 {
     static const CRPCCommand commands[]{
         {"control", &getmemoryinfo},
+        {"control", &getmemoryusage},
+        {"control", &getlockprofile},
+        {"control", &getschedulerinfo},
         {"control", &logging},
         {"util", &getindexinfo},
         {"hidden", &setmocktime},
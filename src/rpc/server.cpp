@@ -19,10 +19,12 @@
 #include <util/strencodings.h>
 #include <util/string.h>
 #include <util/time.h>
+#include <util/trace.h>
 #include <validation.h>
 
 #include <cassert>
 #include <chrono>
+#include <exception>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -40,6 +42,9 @@ static GlobalMutex g_deadline_timers_mutex;
 static std::map<std::string, std::unique_ptr<RPCTimerBase> > deadlineTimers GUARDED_BY(g_deadline_timers_mutex);
 static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler);
 
+TRACEPOINT_SEMAPHORE(rpc, command_start);
+TRACEPOINT_SEMAPHORE(rpc, command_done);
+
 struct RPCCommandExecutionInfo
 {
     std::string method;
@@ -61,10 +66,16 @@ struct RPCCommandExecution
     {
         LOCK(g_rpc_server_info.mutex);
         it = g_rpc_server_info.active_commands.insert(g_rpc_server_info.active_commands.end(), {method, SteadyClock::now()});
+        TRACEPOINT(rpc, command_start, method.c_str());
     }
     ~RPCCommandExecution()
     {
         LOCK(g_rpc_server_info.mutex);
+        // The command failed if the destructor runs because it threw.
+        TRACEPOINT(rpc, command_done,
+            it->method.c_str(),
+            int64_t{Ticks<std::chrono::microseconds>(SteadyClock::now() - it->start)},
+            std::uncaught_exceptions() == 0);
         g_rpc_server_info.active_commands.erase(it);
     }
 };
@@ -5,18 +5,22 @@
 #include <scheduler.h>
 
 #include <sync.h>
+#include <util/check.h>
 #include <util/time.h>
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <functional>
+#include <iterator>
 #include <utility>
 
-CScheduler::CScheduler() = default;
+CScheduler::CScheduler() : m_epoch{std::chrono::steady_clock::now()} {}
 
 CScheduler::~CScheduler()
 {
     assert(nThreadsServicingQueue == 0);
-    if (stopWhenEmpty) assert(taskQueue.empty());
+    if (stopWhenEmpty) assert(m_num_tasks == 0);
 }
 
 
@@ -30,35 +34,45 @@ void CScheduler::serviceQueue()
     // is called.
     while (!shouldStop()) {
         try {
-            while (!shouldStop() && taskQueue.empty()) {
+            while (!shouldStop() && m_num_tasks == 0) {
                 // Wait until there is something to do.
                 newTaskScheduled.wait(lock);
             }
 
-            // Wait until either there is a new task, or until
-            // the time of the first item on the queue:
+            // Wait until either a task is due, or until the next tick at which
+            // tasks move down the wheel:
 
-            while (!shouldStop() && !taskQueue.empty()) {
-                std::chrono::steady_clock::time_point timeToWaitFor = taskQueue.begin()->first;
-                if (newTaskScheduled.wait_until(lock, timeToWaitFor) == std::cv_status::timeout) {
-                    break; // Exit loop after timeout, it means we reached the time of the event
-                }
+            while (!shouldStop() && m_num_tasks > 0) {
+                AdvanceWheel(std::chrono::steady_clock::now());
+                if (!m_due.empty()) break;
+                newTaskScheduled.wait_until(lock, m_epoch + *Assert(NextWheelTick()) * TICK);
             }
 
-            // If there are multiple threads, the queue can empty while we're waiting (another
-            // thread may service the task we were waiting on).
-            if (shouldStop() || taskQueue.empty())
+            // If there are multiple threads, the due tasks can be taken while we're waiting
+            // (another thread may service the task we were waiting on).
+            if (shouldStop() || m_due.empty())
                 continue;
 
-            Function f = taskQueue.begin()->second;
-            taskQueue.erase(taskQueue.begin());
+            Task task = std::move(m_due.front());
+            m_due.pop_front();
+            --m_num_tasks;
+            // Let another thread run the next due task meanwhile.
+            if (!m_due.empty()) newTaskScheduled.notify_one();
 
+            const auto start{std::chrono::steady_clock::now()};
             {
                 // Unlock before calling f, so it can reschedule itself or another task
                 // without deadlocking:
                 REVERSE_LOCK(lock);
-                f();
+                task.f();
             }
+            TaskStats& stats{*task.stats};
+            const auto duration{std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)};
+            ++stats.runs;
+            stats.total += duration;
+            stats.max = std::max(stats.max, duration);
+            stats.last = duration;
+            stats.max_delay = std::max(stats.max_delay, std::chrono::duration_cast<std::chrono::microseconds>(start - task.time));
         } catch (...) {
             --nThreadsServicingQueue;
             throw;
@@ -68,11 +82,102 @@ void CScheduler::serviceQueue()
     newTaskScheduled.notify_one();
 }
 
-void CScheduler::schedule(CScheduler::Function f, std::chrono::steady_clock::time_point t)
+void CScheduler::InsertTask(Task task, std::chrono::steady_clock::time_point now)
+{
+    // Round up, so that a task never runs early.
+    const Tick tick{std::chrono::ceil<std::chrono::milliseconds>(task.time - m_epoch) / TICK};
+    // A task that is due already skips the wheel instead of waiting for the next tick.
+    if (task.time <= now || tick <= m_current_tick) {
+        // Keep due tasks in time order. They are nearly always scheduled for
+        // now, or come out of the wheel in order, so this rarely searches.
+        auto it{m_due.end()};
+        while (it != m_due.begin() && std::prev(it)->time > task.time) --it;
+        m_due.insert(it, std::move(task));
+        return;
+    }
+    // The task goes into the lowest level on which its tick is in the current
+    // rotation. Its slot there comes after the current one, and is moved down
+    // the wheel when the current tick reaches the start of the slot.
+    for (int level{0}; level < WHEEL_LEVELS; ++level) {
+        const int shift{WHEEL_BITS * (level + 1)};
+        if ((tick >> shift) == (m_current_tick >> shift)) {
+            const size_t slot((tick >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+            m_wheel[level].slots[slot].push_back(std::move(task));
+            m_wheel[level].occupied |= uint64_t{1} << slot;
+            return;
+        }
+    }
+    m_overflow.push_back(std::move(task));
+}
+
+std::optional<CScheduler::Tick> CScheduler::NextWheelTick() const
+{
+    std::optional<Tick> next;
+    for (int level{0}; level < WHEEL_LEVELS; ++level) {
+        const int shift{WHEEL_BITS * level};
+        // Slots after the current one in this rotation of the level
+        const size_t current((m_current_tick >> shift) & (WHEEL_SLOTS - 1));
+        const uint64_t later{current + 1 < WHEEL_SLOTS ? m_wheel[level].occupied & (~uint64_t{0} << (current + 1)) : 0};
+        if (later == 0) continue;
+        const Tick rotation_start{(m_current_tick >> (shift + WHEEL_BITS)) << (shift + WHEEL_BITS)};
+        const Tick tick{rotation_start + (Tick(std::countr_zero(later)) << shift)};
+        if (!next || tick < *next) next = tick;
+    }
+    if (!m_overflow.empty()) {
+        constexpr int shift{WHEEL_BITS * WHEEL_LEVELS};
+        const Tick wrap{((m_current_tick >> shift) + 1) << shift};
+        if (!next || wrap < *next) next = wrap;
+    }
+    return next;
+}
+
+void CScheduler::AdvanceWheel(std::chrono::steady_clock::time_point t)
+{
+    const Tick now_tick{std::chrono::floor<std::chrono::milliseconds>(t - m_epoch) / TICK};
+    // Jump from one tick with work to the next; nothing happens in between.
+    for (auto next{NextWheelTick()}; next && *next <= now_tick; next = NextWheelTick()) {
+        m_current_tick = *next;
+        std::vector<Task> moved;
+        if ((m_current_tick & ((Tick{1} << (WHEEL_BITS * WHEEL_LEVELS)) - 1)) == 0) {
+            moved = std::exchange(m_overflow, {});
+        }
+        // Move the tasks of the slots that start at this tick down the wheel,
+        // from the top, so tasks can move down more than one level at once.
+        for (int level{WHEEL_LEVELS - 1}; level >= 0; --level) {
+            const int shift{WHEEL_BITS * level};
+            if ((m_current_tick & ((Tick{1} << shift) - 1)) != 0) continue;
+            const size_t slot((m_current_tick >> shift) & (WHEEL_SLOTS - 1));
+            WheelLevel& wheel_level{m_wheel[level]};
+            if (!(wheel_level.occupied & (uint64_t{1} << slot))) continue;
+            wheel_level.occupied &= ~(uint64_t{1} << slot);
+            std::move(wheel_level.slots[slot].begin(), wheel_level.slots[slot].end(), std::back_inserter(moved));
+            wheel_level.slots[slot].clear();
+        }
+        for (Task& task : moved) InsertTask(std::move(task), t);
+    }
+    m_current_tick = std::max(m_current_tick, now_tick);
+}
+
+template <typename Fn>
+void CScheduler::ForEachTask(Fn&& fn) const
+{
+    for (const Task& task : m_due) fn(task);
+    for (const WheelLevel& level : m_wheel) {
+        for (const std::vector<Task>& slot : level.slots) {
+            for (const Task& task : slot) fn(task);
+        }
+    }
+    for (const Task& task : m_overflow) fn(task);
+}
+
+void CScheduler::schedule(CScheduler::Function f, std::chrono::steady_clock::time_point t, std::string_view name)
 {
     {
         LOCK(newTaskMutex);
-        taskQueue.insert(std::make_pair(t, f));
+        auto it{m_task_stats.find(name)};
+        if (it == m_task_stats.end()) it = m_task_stats.emplace(name, TaskStats{}).first;
+        InsertTask({t, std::move(f), &it->second}, std::chrono::steady_clock::now());
+        ++m_num_tasks;
     }
     newTaskScheduled.notify_one();
 }
@@ -84,42 +189,56 @@ void CScheduler::MockForward(std::chrono::seconds delta_seconds)
     {
         LOCK(newTaskMutex);
 
-        // use temp_queue to maintain updated schedule
-        std::multimap<std::chrono::steady_clock::time_point, Function> temp_queue;
-
-        for (const auto& element : taskQueue) {
-            temp_queue.emplace_hint(temp_queue.cend(), element.first - delta_seconds, element.second);
+        // Take all tasks out of the wheel, and put them back in with their
+        // updated times.
+        std::vector<Task> tasks;
+        tasks.reserve(m_num_tasks);
+        tasks.insert(tasks.end(), std::make_move_iterator(m_due.begin()), std::make_move_iterator(m_due.end()));
+        m_due.clear();
+        for (WheelLevel& level : m_wheel) {
+            for (std::vector<Task>& slot : level.slots) {
+                std::move(slot.begin(), slot.end(), std::back_inserter(tasks));
+                slot.clear();
+            }
+            level.occupied = 0;
+        }
+        std::move(m_overflow.begin(), m_overflow.end(), std::back_inserter(tasks));
+        m_overflow.clear();
+        const auto now{std::chrono::steady_clock::now()};
+        for (Task& task : tasks) {
+            task.time -= delta_seconds;
+            InsertTask(std::move(task), now);
         }
-
-        // point taskQueue to temp_queue
-        taskQueue = std::move(temp_queue);
     }
 
-    // notify that the taskQueue needs to be processed
+    // notify that the tasks need to be processed
     newTaskScheduled.notify_one();
 }
 
-static void Repeat(CScheduler& s, CScheduler::Function f, std::chrono::milliseconds delta)
+static void Repeat(CScheduler& s, CScheduler::Function f, std::chrono::milliseconds delta, const std::string& name)
 {
     f();
-    s.scheduleFromNow([=, &s] { Repeat(s, f, delta); }, delta);
+    s.scheduleFromNow([=, &s] { Repeat(s, f, delta, name); }, delta, name);
 }
 
-void CScheduler::scheduleEvery(CScheduler::Function f, std::chrono::milliseconds delta)
+void CScheduler::scheduleEvery(CScheduler::Function f, std::chrono::milliseconds delta, std::string_view name)
 {
-    scheduleFromNow([this, f, delta] { Repeat(*this, f, delta); }, delta);
+    scheduleFromNow([this, f, delta, name = std::string{name}] { Repeat(*this, f, delta, name); }, delta, name);
 }
 
 size_t CScheduler::getQueueInfo(std::chrono::steady_clock::time_point& first,
                                 std::chrono::steady_clock::time_point& last) const
 {
     LOCK(newTaskMutex);
-    size_t result = taskQueue.size();
-    if (!taskQueue.empty()) {
-        first = taskQueue.begin()->first;
-        last = taskQueue.rbegin()->first;
+    if (m_num_tasks > 0) {
+        first = std::chrono::steady_clock::time_point::max();
+        last = std::chrono::steady_clock::time_point::min();
+        ForEachTask([&](const Task& task) {
+            first = std::min(first, task.time);
+            last = std::max(last, task.time);
+        });
     }
-    return result;
+    return m_num_tasks;
 }
 
 bool CScheduler::AreThreadsServicingQueue() const
@@ -128,6 +247,31 @@ bool CScheduler::AreThreadsServicingQueue() const
     return nThreadsServicingQueue;
 }
 
+int CScheduler::NumServiceThreads() const
+{
+    LOCK(newTaskMutex);
+    return nThreadsServicingQueue;
+}
+
+std::map<std::string, CScheduler::TaskStats> CScheduler::GetTaskStats() const
+{
+    LOCK(newTaskMutex);
+    std::map<std::string, TaskStats> result;
+    for (const auto& [name, stats] : m_task_stats) {
+        if (stats.runs > 0) result.emplace(name, stats);
+    }
+    return result;
+}
+
+void CScheduler::JoinServiceThreads()
+{
+    if (m_service_thread.joinable()) m_service_thread.join();
+    for (std::thread& thread : m_extra_service_threads) {
+        if (thread.joinable()) thread.join();
+    }
+    m_extra_service_threads.clear();
+}
+
 
 void SerialTaskRunner::MaybeScheduleProcessQueue()
 {
@@ -139,7 +283,7 @@ void SerialTaskRunner::MaybeScheduleProcessQueue()
         if (m_are_callbacks_running) return;
         if (m_callbacks_pending.empty()) return;
     }
-    m_scheduler.schedule([this] { this->ProcessQueue(); }, std::chrono::steady_clock::now());
+    m_scheduler.schedule([this] { this->ProcessQueue(); }, std::chrono::steady_clock::now(), "serial_task_runner");
 }
 
 void SerialTaskRunner::ProcessQueue()
@@ -198,3 +342,37 @@ size_t SerialTaskRunner::size()
     LOCK(m_callbacks_mutex);
     return m_callbacks_pending.size();
 }
+
+void ParallelTaskRunner::RunOne()
+{
+    std::function<void()> task;
+    {
+        LOCK(m_tasks_mutex);
+        if (m_tasks_pending.empty()) return;
+        task = std::move(m_tasks_pending.front());
+        m_tasks_pending.pop_front();
+    }
+    task();
+}
+
+void ParallelTaskRunner::insert(std::function<void()> func)
+{
+    WITH_LOCK(m_tasks_mutex, m_tasks_pending.emplace_back(std::move(func)));
+    // Each task gets its own scheduler entry, so that as many run at once as
+    // there are free threads. Entries left over after flush() do nothing.
+    m_scheduler.schedule([this] { RunOne(); }, std::chrono::steady_clock::now(), "parallel_task_runner");
+}
+
+void ParallelTaskRunner::flush()
+{
+    assert(!m_scheduler.AreThreadsServicingQueue());
+    while (WITH_LOCK(m_tasks_mutex, return !m_tasks_pending.empty())) {
+        RunOne();
+    }
+}
+
+size_t ParallelTaskRunner::size()
+{
+    LOCK(m_tasks_mutex);
+    return m_tasks_pending.size();
+}
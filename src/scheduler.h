@@ -10,24 +10,39 @@
 #include <threadsafety.h>
 #include <util/task_runner.h>
 
+#include <array>
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <list>
 #include <map>
+#include <optional>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
+#include <vector>
 
 /**
  * Simple class for background tasks that should be run
  * periodically or once "after a while"
  *
+ * Tasks are kept in a hierarchical timer wheel with a resolution of one
+ * millisecond, so scheduling a task takes constant time however many are
+ * queued. A task never runs before its time, and runs at most one tick late
+ * when a thread is free. Tasks that are due at the same time run in the order
+ * they were scheduled. Any number of threads may run serviceQueue().
+ *
+ * The run time of tasks is recorded per task name, see GetTaskStats().
+ *
  * Usage:
  *
  * CScheduler* s = new CScheduler();
  * s->scheduleFromNow(doSomething, std::chrono::milliseconds{11}); // Assuming a: void doSomething() { }
- * s->scheduleFromNow([=] { this->func(argument); }, std::chrono::milliseconds{3});
+ * s->scheduleFromNow([=] { this->func(argument); }, std::chrono::milliseconds{3}, "func");
  * std::thread* t = new std::thread([&] { s->serviceQueue(); });
  *
  * ... then at program shutdown, make sure to call stop() to clean up the thread(s) running serviceQueue:
@@ -43,16 +58,28 @@ public:
     ~CScheduler();
 
     std::thread m_service_thread;
+    //! Further threads running serviceQueue(), joined together with m_service_thread.
+    std::vector<std::thread> m_extra_service_threads;
 
     typedef std::function<void()> Function;
 
-    /** Call func at/after time t */
-    void schedule(Function f, std::chrono::steady_clock::time_point t) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+    /** Run time statistics of all tasks scheduled under one name. */
+    struct TaskStats {
+        uint64_t runs{0};
+        std::chrono::microseconds total{0};
+        std::chrono::microseconds max{0};
+        std::chrono::microseconds last{0};
+        //! Longest time a task started after it was due, e.g. because all threads were busy.
+        std::chrono::microseconds max_delay{0};
+    };
+
+    /** Call func at/after time t. Its run time is accounted to name. */
+    void schedule(Function f, std::chrono::steady_clock::time_point t, std::string_view name = "unnamed") EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
 
     /** Call f once after the delta has passed */
-    void scheduleFromNow(Function f, std::chrono::milliseconds delta) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
+    void scheduleFromNow(Function f, std::chrono::milliseconds delta, std::string_view name = "unnamed") EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
     {
-        schedule(std::move(f), std::chrono::steady_clock::now() + delta);
+        schedule(std::move(f), std::chrono::steady_clock::now() + delta, name);
     }
 
     /**
@@ -61,7 +88,7 @@ public:
      * The timing is not exact: Every time f is finished, it is rescheduled to run again after delta. If you need more
      * accurate scheduling, don't use this method.
      */
-    void scheduleEvery(Function f, std::chrono::milliseconds delta) EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+    void scheduleEvery(Function f, std::chrono::milliseconds delta, std::string_view name = "unnamed") EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
 
     /**
      * Mock the scheduler to fast forward in time.
@@ -80,14 +107,14 @@ public:
     {
         WITH_LOCK(newTaskMutex, stopRequested = true);
         newTaskScheduled.notify_all();
-        if (m_service_thread.joinable()) m_service_thread.join();
+        JoinServiceThreads();
     }
     /** Tell any threads running serviceQueue to stop when there is no work left to be done */
     void StopWhenDrained() EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex)
     {
         WITH_LOCK(newTaskMutex, stopWhenEmpty = true);
         newTaskScheduled.notify_all();
-        if (m_service_thread.joinable()) m_service_thread.join();
+        JoinServiceThreads();
     }
 
     /**
@@ -101,14 +128,62 @@ public:
     /** Returns true if there are threads actively running in serviceQueue() */
     bool AreThreadsServicingQueue() const EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
 
+    /** Returns the number of threads running serviceQueue() */
+    int NumServiceThreads() const EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+
+    /** Returns the run time statistics of the tasks that have run, by name */
+    std::map<std::string, TaskStats> GetTaskStats() const EXCLUSIVE_LOCKS_REQUIRED(!newTaskMutex);
+
 private:
+    using Tick = int64_t;
+    static constexpr std::chrono::milliseconds TICK{1};
+    //! Each level of the wheel has 2^WHEEL_BITS slots, each covering 2^(WHEEL_BITS * level) ticks.
+    static constexpr int WHEEL_BITS{6};
+    static constexpr size_t WHEEL_SLOTS{size_t{1} << WHEEL_BITS};
+    //! With four levels, tasks up to 2^24 ticks (about 4.6 hours) ahead are kept in the wheel.
+    static constexpr int WHEEL_LEVELS{4};
+
+    struct Task {
+        std::chrono::steady_clock::time_point time;
+        Function f;
+        //! Entry in m_task_stats; entries are never removed, so this stays valid.
+        TaskStats* stats;
+    };
+
+    struct WheelLevel {
+        std::array<std::vector<Task>, WHEEL_SLOTS> slots;
+        //! Bit i is set if slots[i] is not empty.
+        uint64_t occupied{0};
+    };
+
     mutable Mutex newTaskMutex;
     std::condition_variable newTaskScheduled;
-    std::multimap<std::chrono::steady_clock::time_point, Function> taskQueue GUARDED_BY(newTaskMutex);
+    //! Tick 0 starts at construction.
+    const std::chrono::steady_clock::time_point m_epoch;
+    //! All tasks due at or before this tick are in m_due.
+    Tick m_current_tick GUARDED_BY(newTaskMutex){0};
+    std::array<WheelLevel, WHEEL_LEVELS> m_wheel GUARDED_BY(newTaskMutex);
+    //! Tasks beyond the last level, looked at again each time the last level wraps around.
+    std::vector<Task> m_overflow GUARDED_BY(newTaskMutex);
+    //! Tasks that are due, in time order.
+    std::deque<Task> m_due GUARDED_BY(newTaskMutex);
+    size_t m_num_tasks GUARDED_BY(newTaskMutex){0};
+    std::map<std::string, TaskStats, std::less<>> m_task_stats GUARDED_BY(newTaskMutex);
     int nThreadsServicingQueue GUARDED_BY(newTaskMutex){0};
     bool stopRequested GUARDED_BY(newTaskMutex){false};
     bool stopWhenEmpty GUARDED_BY(newTaskMutex){false};
-    bool shouldStop() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return stopRequested || (stopWhenEmpty && taskQueue.empty()); }
+    bool shouldStop() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex) { return stopRequested || (stopWhenEmpty && m_num_tasks == 0); }
+    void JoinServiceThreads();
+
+    //! Put a task in the wheel slot for its time, or in m_due if it is due by now already.
+    void InsertTask(Task task, std::chrono::steady_clock::time_point now) EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex);
+    //! The next tick at which a task becomes due or tasks move down the wheel, or nullopt if the wheel is empty.
+    std::optional<Tick> NextWheelTick() const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex);
+    //! Move the tasks that are due by time t into m_due.
+    void AdvanceWheel(std::chrono::steady_clock::time_point t) EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex);
+    //! Call fn on every queued task.
+    template <typename Fn>
+    void ForEachTask(Fn&& fn) const EXCLUSIVE_LOCKS_REQUIRED(newTaskMutex);
 };
 
 /**
@@ -157,4 +232,36 @@ public:
     size_t size() override EXCLUSIVE_LOCKS_REQUIRED(!m_callbacks_mutex);
 };
 
+/**
+ * Task runner that hands each task to the first free thread of a CScheduler.
+ * Unlike SerialTaskRunner, tasks run concurrently when the scheduler has
+ * several threads, and so may finish in any order. Callers that need some
+ * tasks to run in order must serialize them themselves, as ValidationSignals
+ * does per subscriber.
+ */
+class ParallelTaskRunner : public util::TaskRunnerInterface
+{
+private:
+    CScheduler& m_scheduler;
+
+    Mutex m_tasks_mutex;
+    std::list<std::function<void()>> m_tasks_pending GUARDED_BY(m_tasks_mutex);
+
+    //! Run the oldest pending task, if any.
+    void RunOne() EXCLUSIVE_LOCKS_REQUIRED(!m_tasks_mutex);
+
+public:
+    explicit ParallelTaskRunner(CScheduler& scheduler LIFETIMEBOUND) : m_scheduler{scheduler} {}
+
+    void insert(std::function<void()> func) override EXCLUSIVE_LOCKS_REQUIRED(!m_tasks_mutex);
+
+    /**
+     * Runs all remaining tasks on the calling thread, including those they insert.
+     * Must be called after the CScheduler has no remaining processing threads!
+     */
+    void flush() override EXCLUSIVE_LOCKS_REQUIRED(!m_tasks_mutex);
+
+    size_t size() override EXCLUSIVE_LOCKS_REQUIRED(!m_tasks_mutex);
+};
+
 #endif // BITCOIN_SCHEDULER_H
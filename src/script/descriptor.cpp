@@ -719,11 +719,17 @@ public:
         }
         out.Merge(std::move(subprovider));
 
+        // Multisig descriptors can have many keys, so their IDs are hashed together.
+        std::vector<Span<const unsigned char>> serialized_keys;
+        serialized_keys.reserve(entries.size());
+        for (const auto& entry : entries) serialized_keys.emplace_back(entry.first.data(), entry.first.size());
+        const std::vector<uint160> key_ids{Hash160Many(serialized_keys)};
+
         std::vector<CPubKey> pubkeys;
         pubkeys.reserve(entries.size());
-        for (auto& entry : entries) {
-            pubkeys.push_back(entry.first);
-            out.origins.emplace(entry.first.GetID(), std::make_pair<CPubKey, KeyOriginInfo>(CPubKey(entry.first), std::move(entry.second)));
+        for (size_t i = 0; i < entries.size(); ++i) {
+            pubkeys.push_back(entries[i].first);
+            out.origins.emplace(CKeyID{key_ids[i]}, std::make_pair<CPubKey, KeyOriginInfo>(CPubKey(entries[i].first), std::move(entries[i].second)));
         }
 
         output_scripts = MakeScripts(pubkeys, Span{subscripts}, out);
@@ -59,6 +59,9 @@ public:
     bool Get(const uint256& entry, const bool erase);
 
     void Set(const uint256& entry);
+
+    //! Approximate memory allocated for the cache, in bytes.
+    size_t DynamicMemoryUsage() const { return setValid.memory_usage(); }
 };
 
 class CachingTransactionSignatureChecker : public TransactionSignatureChecker
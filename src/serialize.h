@@ -14,6 +14,7 @@
 #include <span.h>
 
 #include <algorithm>
+#include <bit>
 #include <concepts>
 #include <cstdint>
 #include <cstring>
@@ -23,6 +24,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -743,6 +745,28 @@ template<typename Stream, typename T> void Serialize(Stream& os, const std::uniq
 template<typename Stream, typename T> void Unserialize(Stream& os, std::unique_ptr<const T>& p);
 
 
+/**
+ * Opt-in marker for fixed-layout types: trivially copyable structs whose
+ * serialization is exactly their in-memory representation on a little-endian
+ * host, because every member is serialized in declaration order as its raw
+ * little-endian bytes and there is no padding. A type opts in by specializing
+ * this next to its definition, together with a static_assert on its size and
+ * member offsets.
+ */
+template <typename T>
+inline constexpr bool is_fixed_layout_serializable{false};
+
+/**
+ * Fixed-layout types are (un)serialized with a single stream write or read,
+ * i.e. one bounds check and one memcpy, instead of member by member, and
+ * vectors of them in one go. On big-endian hosts their member functions are
+ * used.
+ */
+template <typename T>
+concept FixedLayout = is_fixed_layout_serializable<std::remove_cvref_t<T>> &&
+                      std::is_trivially_copyable_v<std::remove_cvref_t<T>> &&
+                      std::endian::native == std::endian::little;
+
 /**
  * If none of the specialized versions above matched, default to calling member function.
  */
@@ -752,7 +776,11 @@ template <typename Stream, typename T>
     requires Serializable<T, Stream>
 void Serialize(Stream& os, const T& a)
 {
-    a.Serialize(os);
+    if constexpr (FixedLayout<T>) {
+        os.write(AsBytes(Span{&a, 1}));
+    } else {
+        a.Serialize(os);
+    }
 }
 
 template <class T, class Stream>
@@ -761,7 +789,11 @@ template <typename Stream, typename T>
     requires Unserializable<T, Stream>
 void Unserialize(Stream& is, T&& a)
 {
-    a.Unserialize(is);
+    if constexpr (FixedLayout<T>) {
+        is.read(AsWritableBytes(Span{&a, 1}));
+    } else {
+        a.Unserialize(is);
+    }
 }
 
 /** Default formatter. Serializes objects as themselves.
@@ -848,6 +880,9 @@ void Serialize(Stream& os, const std::vector<T, A>& v)
     if constexpr (BasicByte<T>) { // Use optimized version for unformatted basic bytes
         WriteCompactSize(os, v.size());
         if (!v.empty()) os.write(MakeByteSpan(v));
+    } else if constexpr (FixedLayout<T>) { // The elements' bytes are their serialization
+        WriteCompactSize(os, v.size());
+        if (!v.empty()) os.write(AsBytes(Span{v}));
     } else if constexpr (std::is_same_v<T, bool>) {
         // A special case for std::vector<bool>, as dereferencing
         // std::vector<bool>::const_iterator does not result in a const bool&
@@ -876,6 +911,17 @@ void Unserialize(Stream& is, std::vector<T, A>& v)
             is.read(AsWritableBytes(Span{&v[i], blk}));
             i += blk;
         }
+    } else if constexpr (FixedLayout<T>) {
+        // Allocate in batches, like VectorFormatter, then read each batch at once
+        v.clear();
+        const size_t size{ReadCompactSize(is)};
+        size_t i{0};
+        while (i < size) {
+            const size_t blk{std::min(size - i, MAX_VECTOR_ALLOCATE / sizeof(T))};
+            v.resize(i + blk);
+            is.read(AsWritableBytes(Span{&v[i], blk}));
+            i += blk;
+        }
     } else {
         Unserialize(is, Using<VectorFormatter<DefaultFormatter>>(v));
     }
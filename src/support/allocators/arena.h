@@ -0,0 +1,110 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+#define BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+/**
+ * A monotonic memory resource, similar to std::pmr::monotonic_buffer_resource:
+ *
+ * * Allocations are carved out of large chunks by bumping a pointer.
+ *
+ * * Deallocation is a no-op. All memory is released at once when the arena is
+ *   destroyed.
+ *
+ * * When the current chunk is exhausted a new one is allocated, at least as
+ *   large as the request.
+ *
+ * This suits objects with one shared lifetime, such as the transactions of a
+ * block. MonotonicArena is not thread-safe. It is intended to be used through
+ * ArenaAllocator, which keeps the arena alive for as long as any allocator
+ * (and so, any object allocated with it) refers to it.
+ */
+class MonotonicArena
+{
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    const size_t m_chunk_size;
+    std::byte* m_available_begin{nullptr};
+    std::byte* m_available_end{nullptr};
+    size_t m_allocated_bytes{0};
+
+public:
+    explicit MonotonicArena(size_t chunk_size) : m_chunk_size{std::max<size_t>(chunk_size, 256)} {}
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    void* Allocate(size_t bytes, size_t alignment)
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+        if (m_available_begin) {
+            const auto begin{reinterpret_cast<uintptr_t>(m_available_begin)};
+            const auto aligned{(begin + alignment - 1) & ~uintptr_t(alignment - 1)};
+            if (aligned + bytes <= reinterpret_cast<uintptr_t>(m_available_end)) {
+                m_available_begin += aligned - begin + bytes;
+                return m_available_begin - bytes;
+            }
+        }
+        // new[] of std::byte only guarantees default new alignment.
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) throw std::bad_alloc{};
+        const size_t chunk_size{std::max(m_chunk_size, bytes)};
+        m_chunks.emplace_back(new std::byte[chunk_size]);
+        m_allocated_bytes += chunk_size;
+        m_available_begin = m_chunks.back().get() + bytes;
+        m_available_end = m_chunks.back().get() + chunk_size;
+        return m_chunks.back().get();
+    }
+
+    /** Total size of the chunks allocated so far. */
+    size_t AllocatedBytes() const { return m_allocated_bytes; }
+    size_t NumChunks() const { return m_chunks.size(); }
+};
+
+/**
+ * Allocator that hands out memory from a shared MonotonicArena. Every copy
+ * holds a reference to the arena, so a std::allocate_shared'd object keeps
+ * its arena alive through the allocator stored in its control block; the
+ * arena is freed together with the last such object.
+ */
+template <class T>
+class ArenaAllocator
+{
+    std::shared_ptr<MonotonicArena> m_arena;
+
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(std::shared_ptr<MonotonicArena> arena) noexcept : m_arena{std::move(arena)} {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept : m_arena{other.m_arena} {}
+
+    T* allocate(size_t n)
+    {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length{};
+        return static_cast<T*>(m_arena->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {}
+
+    template <typename U>
+    friend bool operator==(const ArenaAllocator& a, const ArenaAllocator<U>& b) noexcept
+    {
+        return a.m_arena == b.m_arena;
+    }
+};
+
+#endif // BITCOIN_SUPPORT_ALLOCATORS_ARENA_H
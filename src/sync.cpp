@@ -10,11 +10,17 @@
 #include <util/strencodings.h>
 #include <util/threadnames.h>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <set>
+#include <string_view>
 #include <system_error>
 #include <thread>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -321,3 +327,137 @@ bool LockStackEmpty()
 bool g_debug_lockorder_abort = true;
 
 #endif /* DEBUG_LOCKORDER */
+
+namespace lockprofile {
+std::atomic<uint32_t> g_sample_rate{0};
+
+namespace {
+struct AtomicDurations {
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    std::atomic<int64_t> total{0};
+    std::atomic<int64_t> max{0};
+
+    void Record(std::chrono::nanoseconds duration)
+    {
+        const int64_t ns{std::max<int64_t>(0, duration.count())};
+        buckets[std::min<size_t>(std::bit_width(uint64_t(ns)), NUM_BUCKETS - 1)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(ns, std::memory_order_relaxed);
+        int64_t prev{max.load(std::memory_order_relaxed)};
+        while (prev < ns && !max.compare_exchange_weak(prev, ns, std::memory_order_relaxed)) {}
+    }
+
+    void AddTo(Durations& durations) const
+    {
+        for (size_t i = 0; i < NUM_BUCKETS; ++i) durations.buckets[i] += buckets[i].load(std::memory_order_relaxed);
+        durations.total += std::chrono::nanoseconds{total.load(std::memory_order_relaxed)};
+        durations.max = std::max(durations.max, std::chrono::nanoseconds{max.load(std::memory_order_relaxed)});
+    }
+
+    void Reset()
+    {
+        for (auto& bucket : buckets) bucket.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+};
+} // namespace
+
+struct Site {
+    Site(const char* name_in, const char* file_in, int line_in) : name{name_in}, file{file_in}, line{line_in} {}
+
+    // The strings are the literals passed by the LOCK macros, so a site is
+    // identified by their addresses.
+    const char* const name;
+    const char* const file;
+    const int line;
+    std::atomic<uint64_t> contended{0};
+    AtomicDurations wait;
+    AtomicDurations hold;
+};
+
+namespace {
+/**
+ * Open addressing table of all sites seen so far. Sites are inserted with a
+ * compare-and-swap and never removed, so lookups don't take a lock.
+ */
+constexpr size_t MAX_SITES{4096};
+std::array<std::atomic<Site*>, MAX_SITES> g_sites{};
+} // namespace
+
+Site* GetSite(const char* name, const char* file, int line)
+{
+    const size_t hash{(reinterpret_cast<uintptr_t>(file) ^ reinterpret_cast<uintptr_t>(name) * 31 ^ size_t(line) * 0x9E3779B97F4A7C15ULL)};
+    for (size_t i = 0; i < MAX_SITES; ++i) {
+        auto& slot{g_sites[(hash + i) % MAX_SITES]};
+        Site* site{slot.load(std::memory_order_acquire)};
+        if (!site) {
+            auto fresh{std::make_unique<Site>(name, file, line)};
+            if (slot.compare_exchange_strong(site, fresh.get(), std::memory_order_acq_rel)) return fresh.release();
+            // Another thread filled the slot first; site now points to its entry.
+        }
+        if (site->name == name && site->file == file && site->line == line) return site;
+    }
+    return nullptr;
+}
+
+void RecordWait(Site& site, std::chrono::nanoseconds wait, bool contended)
+{
+    if (contended) site.contended.fetch_add(1, std::memory_order_relaxed);
+    site.wait.Record(wait);
+}
+
+void RecordHold(Site& site, std::chrono::nanoseconds hold)
+{
+    site.hold.Record(hold);
+}
+
+std::chrono::nanoseconds Durations::Quantile(double q) const
+{
+    uint64_t count{0};
+    for (const uint64_t n : buckets) count += n;
+    if (count == 0) return {};
+    const auto target{static_cast<uint64_t>(std::ceil(q * count))};
+    uint64_t cumulative{0};
+    for (size_t i = 0; i + 1 < NUM_BUCKETS; ++i) {
+        cumulative += buckets[i];
+        if (cumulative >= target) return std::min(max, std::chrono::nanoseconds{int64_t{1} << i});
+    }
+    return max;
+}
+
+std::vector<SiteStats> GetStats()
+{
+    // The same source location can show up as several sites when a header with
+    // a LOCK is compiled into several translation units, so merge by value.
+    std::map<std::tuple<std::string_view, std::string_view, int>, SiteStats> merged;
+    for (const auto& slot : g_sites) {
+        const Site* site{slot.load(std::memory_order_acquire)};
+        if (!site) continue;
+        SiteStats& stats{merged[{site->name, site->file, site->line}]};
+        stats.name = site->name;
+        stats.file = site->file;
+        stats.line = site->line;
+        stats.contended += site->contended.load(std::memory_order_relaxed);
+        site->wait.AddTo(stats.wait);
+        site->hold.AddTo(stats.hold);
+    }
+    std::vector<SiteStats> result;
+    for (auto& [_, stats] : merged) {
+        for (const uint64_t n : stats.wait.buckets) stats.samples += n;
+        if (stats.samples > 0) result.push_back(std::move(stats));
+    }
+    std::stable_sort(result.begin(), result.end(), [](const SiteStats& a, const SiteStats& b) { return a.wait.total > b.wait.total; });
+    return result;
+}
+
+void Reset()
+{
+    for (const auto& slot : g_sites) {
+        Site* site{slot.load(std::memory_order_acquire)};
+        if (!site) continue;
+        site->contended.store(0, std::memory_order_relaxed);
+        site->wait.Reset();
+        site->hold.Reset();
+    }
+}
+} // namespace lockprofile
@@ -0,0 +1,83 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/block.h>
+#include <streams.h>
+#include <support/allocators/arena.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+BOOST_FIXTURE_TEST_SUITE(arena_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(allocate_and_grow)
+{
+    MonotonicArena arena{1024};
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 0U);
+
+    auto* a = static_cast<std::byte*>(arena.Allocate(1, 1));
+    auto* b = static_cast<std::byte*>(arena.Allocate(8, 8));
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 1U);
+    BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(b) % 8, 0U);
+    BOOST_CHECK(b > a && b < a + 16);
+
+    // Exhausting a chunk starts a new one; oversized requests get a chunk of their own.
+    arena.Allocate(1020, 1);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 2U);
+    arena.Allocate(4096, 16);
+    BOOST_CHECK_EQUAL(arena.NumChunks(), 3U);
+    BOOST_CHECK_EQUAL(arena.AllocatedBytes(), 1024U + 1024U + 4096U);
+}
+
+BOOST_AUTO_TEST_CASE(allocator_keeps_arena_alive)
+{
+    auto arena{std::make_shared<MonotonicArena>(1024)};
+    std::weak_ptr<MonotonicArena> weak{arena};
+    auto first{std::allocate_shared<int>(ArenaAllocator<int>{arena}, 1)};
+    auto second{std::allocate_shared<uint64_t>(ArenaAllocator<uint64_t>{arena}, 2)};
+    arena.reset();
+    BOOST_CHECK(!weak.expired());
+    first.reset();
+    BOOST_CHECK(!weak.expired());
+    BOOST_CHECK_EQUAL(*second, 2U);
+    second.reset();
+    BOOST_CHECK(weak.expired());
+}
+
+BOOST_AUTO_TEST_CASE(unserialize_block_in_arena)
+{
+    CBlock block;
+    block.nVersion = 4;
+    block.hashPrevBlock = m_rng.rand256();
+    for (int i = 0; i < 20; ++i) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), 0});
+        mtx.vin[0].scriptWitness.stack.push_back(m_rng.randbytes(i + 1));
+        mtx.vout.emplace_back(i, CScript() << OP_TRUE);
+        block.vtx.push_back(MakeTransactionRef(std::move(mtx)));
+    }
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+
+    CTransactionRef kept;
+    {
+        CBlock read;
+        UnserializeBlockInArena(stream, read, TX_WITH_WITNESS);
+        BOOST_CHECK(stream.empty());
+        BOOST_CHECK_EQUAL(read.GetHash(), block.GetHash());
+        BOOST_REQUIRE_EQUAL(read.vtx.size(), block.vtx.size());
+        for (size_t i = 0; i < block.vtx.size(); ++i) {
+            BOOST_CHECK_EQUAL(read.vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+        }
+        kept = read.vtx.back();
+    }
+    // A transaction outliving its block stays valid.
+    BOOST_CHECK_EQUAL(kept->GetWitnessHash(), block.vtx.back()->GetWitnessHash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
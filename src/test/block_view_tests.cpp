@@ -0,0 +1,159 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <consensus/validation.h>
+#include <primitives/block.h>
+#include <primitives/block_view.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <ios>
+#include <vector>
+
+BOOST_FIXTURE_TEST_SUITE(block_view_tests, BasicTestingSetup)
+
+static CScript RandomScript(FastRandomContext& rng)
+{
+    const auto bytes{rng.randbytes(rng.randrange(80))};
+    return CScript(bytes.begin(), bytes.end());
+}
+
+static CMutableTransaction RandomTransaction(FastRandomContext& rng, bool witness)
+{
+    CMutableTransaction tx;
+    tx.version = rng.rand32();
+    tx.nLockTime = rng.rand32();
+    const int ins{1 + int(rng.randrange(4))};
+    for (int i = 0; i < ins; ++i) {
+        CTxIn& in{tx.vin.emplace_back(COutPoint{Txid::FromUint256(rng.rand256()), rng.rand32()}, RandomScript(rng), rng.rand32())};
+        if (witness && rng.randbool()) {
+            for (int j = rng.randrange(4); j >= 0; --j) in.scriptWitness.stack.push_back(rng.randbytes(rng.randrange(100)));
+        }
+    }
+    // Make sure a witness transaction actually has a witness.
+    if (witness && !tx.HasWitness()) tx.vin[0].scriptWitness.stack.push_back(rng.randbytes(33));
+    for (int i = rng.randrange(4); i >= 0; --i) {
+        tx.vout.emplace_back(CAmount(rng.randrange(MAX_MONEY)), RandomScript(rng));
+    }
+    return tx;
+}
+
+static std::vector<unsigned char> Serialize(const CBlock& block)
+{
+    DataStream stream;
+    stream << TX_WITH_WITNESS(block);
+    return {UCharCast(stream.data()), UCharCast(stream.data() + stream.size())};
+}
+
+BOOST_AUTO_TEST_CASE(matches_deserialization)
+{
+    CBlock block;
+    block.nVersion = 0x20000000;
+    block.hashPrevBlock = m_rng.rand256();
+    block.hashMerkleRoot = m_rng.rand256();
+    block.nTime = m_rng.rand32();
+    block.nBits = 0x207fffff;
+    block.nNonce = m_rng.rand32();
+    // A transaction without inputs and outputs shares its encoding with the segwit marker.
+    block.vtx.push_back(MakeTransactionRef(CMutableTransaction{}));
+    for (int i = 0; i < 50; ++i) {
+        block.vtx.push_back(MakeTransactionRef(RandomTransaction(m_rng, /*witness=*/i % 3 != 0)));
+    }
+
+    const auto bytes{Serialize(block)};
+    const BlockView view{MakeByteSpan(bytes)};
+
+    BOOST_CHECK_EQUAL(view.GetHash(), block.GetHash());
+    BOOST_CHECK_EQUAL(view.GetHeader().hashPrevBlock, block.hashPrevBlock);
+    BOOST_CHECK_EQUAL(view.GetTotalSize(), ::GetSerializeSize(TX_WITH_WITNESS(block)));
+    BOOST_CHECK_EQUAL(view.GetStrippedSize(), ::GetSerializeSize(TX_NO_WITNESS(block)));
+    BOOST_CHECK_EQUAL(view.GetWeight(), ::GetBlockWeight(block));
+    BOOST_REQUIRE_EQUAL(view.Transactions().size(), block.vtx.size());
+
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        const CTransaction& tx{*block.vtx[i]};
+        const TxView& tx_view{view.Transactions()[i]};
+        BOOST_CHECK_EQUAL(tx_view.GetHash(), tx.GetHash());
+        BOOST_CHECK_EQUAL(tx_view.GetWitnessHash(), tx.GetWitnessHash());
+        BOOST_CHECK_EQUAL(tx_view.HasWitness(), tx.HasWitness());
+        BOOST_CHECK_EQUAL(tx_view.Version(), tx.version);
+        BOOST_CHECK_EQUAL(tx_view.LockTime(), tx.nLockTime);
+        BOOST_CHECK_EQUAL(tx_view.GetTotalSize(), tx.GetTotalSize());
+        BOOST_CHECK_EQUAL(tx_view.GetStrippedSize(), ::GetSerializeSize(TX_NO_WITNESS(tx)));
+        BOOST_REQUIRE_EQUAL(tx_view.InputCount(), tx.vin.size());
+        BOOST_REQUIRE_EQUAL(tx_view.OutputCount(), tx.vout.size());
+
+        size_t n{0};
+        tx_view.ForEachInput([&](const TxInView& in) {
+            BOOST_CHECK(in.prevout == tx.vin[n].prevout);
+            BOOST_CHECK(std::ranges::equal(MakeUCharSpan(in.script_sig), tx.vin[n].scriptSig));
+            BOOST_CHECK_EQUAL(in.sequence, tx.vin[n].nSequence);
+            ++n;
+        });
+        BOOST_CHECK_EQUAL(n, tx.vin.size());
+        n = 0;
+        tx_view.ForEachOutput([&](const TxOutView& out) {
+            BOOST_CHECK_EQUAL(out.value, tx.vout[n].nValue);
+            BOOST_CHECK(std::ranges::equal(MakeUCharSpan(out.script_pub_key), tx.vout[n].scriptPubKey));
+            ++n;
+        });
+        BOOST_CHECK_EQUAL(n, tx.vout.size());
+
+        BOOST_CHECK(*tx_view.Materialize() == tx);
+    }
+
+    // The block-level path hashes all transactions in one batch.
+    const CBlock materialized{view.Materialize()};
+    BOOST_CHECK_EQUAL(materialized.GetHash(), block.GetHash());
+    BOOST_REQUIRE_EQUAL(materialized.vtx.size(), block.vtx.size());
+    for (size_t i = 0; i < block.vtx.size(); ++i) {
+        BOOST_CHECK(*materialized.vtx[i] == *block.vtx[i]);
+        BOOST_CHECK_EQUAL(materialized.vtx[i]->GetHash(), block.vtx[i]->GetHash());
+        BOOST_CHECK_EQUAL(materialized.vtx[i]->GetWitnessHash(), block.vtx[i]->GetWitnessHash());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(malformed)
+{
+    CBlock block;
+    block.vtx.push_back(MakeTransactionRef(RandomTransaction(m_rng, /*witness=*/true)));
+    const auto bytes{Serialize(block)};
+
+    // Every truncation must be rejected, as must trailing data.
+    for (size_t len = 0; len < bytes.size(); ++len) {
+        BOOST_CHECK_THROW(BlockView{MakeByteSpan(Span{bytes}.first(len))}, std::ios_base::failure);
+    }
+    for (size_t len = 0; len < bytes.size(); ++len) {
+        BOOST_CHECK_THROW(DeserializeBlockBatchHashed(MakeByteSpan(Span{bytes}.first(len))), std::ios_base::failure);
+    }
+    auto extended{bytes};
+    extended.push_back(0);
+    BOOST_CHECK_THROW(BlockView{MakeByteSpan(extended)}, std::ios_base::failure);
+    BOOST_CHECK_THROW(DeserializeBlockBatchHashed(MakeByteSpan(extended)), std::ios_base::failure);
+
+    // Flag byte directly follows the 80 byte header, tx count, version and marker.
+    constexpr size_t FLAG_POS{80 + 1 + 4 + 1};
+    BOOST_REQUIRE_EQUAL(bytes[FLAG_POS], 1);
+    auto unknown_flag{bytes};
+    unknown_flag[FLAG_POS] = 3;
+    BOOST_CHECK_THROW(BlockView{MakeByteSpan(unknown_flag)}, std::ios_base::failure);
+
+    // A witness flag with all-empty witness stacks is not a valid encoding.
+    CMutableTransaction mtx{*block.vtx[0]};
+    for (CTxIn& in : mtx.vin) in.scriptWitness.SetNull();
+    DataStream stream;
+    stream << TX_NO_WITNESS(CTransaction{mtx});
+    std::vector<std::byte> superfluous{stream.begin(), stream.end()};
+    superfluous.insert(superfluous.begin() + 4, {std::byte{0}, std::byte{1}});
+    superfluous.insert(superfluous.end() - 4, mtx.vin.size(), std::byte{0});
+    Span<const std::byte> tx_data{superfluous};
+    BOOST_CHECK_THROW(TxView::Parse(tx_data), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
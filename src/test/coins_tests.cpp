@@ -6,7 +6,6 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <streams.h>
-#include <test/util/poolresourcetester.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
 #include <txdb.h>
@@ -84,7 +83,7 @@ public:
     void SelfTest(bool sanity_check = true) const
     {
         // Manually recompute the dynamic usage of the whole data, and compare it.
-        size_t ret = memusage::DynamicUsage(cacheCoins);
+        size_t ret = cacheCoins.DynamicMemoryUsage();
         size_t count = 0;
         for (const auto& entry : cacheCoins) {
             ret += entry.second.coin.DynamicMemoryUsage();
@@ -98,7 +97,6 @@ public:
     }
 
     CCoinsMap& map() const { return cacheCoins; }
-    CoinsCachePair& sentinel() const { return m_sentinel; }
     size_t& usage() const { return cachedCoinsUsage; }
 };
 
@@ -624,14 +622,14 @@ static void SetCoinsValue(const CAmount value, Coin& coin)
     }
 }
 
-static size_t InsertCoinsMapEntry(CCoinsMap& map, CoinsCachePair& sentinel, const CoinEntry& cache_coin)
+static size_t InsertCoinsMapEntry(CCoinsMap& map, const CoinEntry& cache_coin)
 {
-    CCoinsCacheEntry entry;
-    SetCoinsValue(cache_coin.value, entry.coin);
-    auto [iter, inserted] = map.emplace(OUTPOINT, std::move(entry));
+    Coin coin;
+    SetCoinsValue(cache_coin.value, coin);
+    auto [iter, inserted] = map.try_emplace(OUTPOINT, std::move(coin));
     assert(inserted);
-    if (cache_coin.IsDirty()) CCoinsCacheEntry::SetDirty(*iter, sentinel);
-    if (cache_coin.IsFresh()) CCoinsCacheEntry::SetFresh(*iter, sentinel);
+    if (cache_coin.IsDirty()) map.SetDirty(iter);
+    if (cache_coin.IsFresh()) map.SetFresh(iter);
     return iter->second.coin.DynamicMemoryUsage();
 }
 
@@ -647,12 +645,9 @@ static MaybeCoin GetCoinsMapEntry(const CCoinsMap& map, const COutPoint& outp =
 
 static void WriteCoinsViewEntry(CCoinsView& view, const MaybeCoin& cache_coin)
 {
-    CoinsCachePair sentinel{};
-    sentinel.second.SelfRef(sentinel);
-    CCoinsMapMemoryResource resource;
-    CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
-    auto usage{cache_coin ? InsertCoinsMapEntry(map, sentinel, *cache_coin) : 0};
-    auto cursor{CoinsViewCacheCursor(usage, sentinel, map, /*will_erase=*/true)};
+    CCoinsMap map;
+    auto usage{cache_coin ? InsertCoinsMapEntry(map, *cache_coin) : 0};
+    auto cursor{CoinsViewCacheCursor(usage, map, /*will_erase=*/true)};
     BOOST_CHECK(view.BatchWrite(cursor, {}));
 }
 
@@ -663,7 +658,7 @@ public:
     {
         auto base_cache_coin{base_value == ABSENT ? MISSING : CoinEntry{base_value, CoinEntry::State::DIRTY}};
         WriteCoinsViewEntry(base, base_cache_coin);
-        if (cache_coin) cache.usage() += InsertCoinsMapEntry(cache.map(), cache.sentinel(), *cache_coin);
+        if (cache_coin) cache.usage() += InsertCoinsMapEntry(cache.map(), *cache_coin);
     }
 
     CCoinsView root;
@@ -1049,29 +1044,74 @@ BOOST_FIXTURE_TEST_CASE(ccoins_flush_behavior, FlushTest)
     }
 }
 
-BOOST_AUTO_TEST_CASE(coins_resource_is_used)
+BOOST_AUTO_TEST_CASE(coins_map_reserve)
 {
-    CCoinsMapMemoryResource resource;
-    PoolResourceTester::CheckAllDataAccountedFor(resource);
+    CCoinsMap map;
+    BOOST_CHECK_EQUAL(map.DynamicMemoryUsage(), 0U);
 
-    {
-        CCoinsMap map{0, CCoinsMap::hasher{}, CCoinsMap::key_equal{}, &resource};
-        BOOST_TEST(memusage::DynamicUsage(map) >= resource.ChunkSizeBytes());
+    map.reserve(1000);
 
-        map.reserve(1000);
+    // Buckets and entry chunks are preallocated, so inserting doesn't allocate anything else.
+    const auto usage_before = map.DynamicMemoryUsage();
 
-        // The resource has preallocated a chunk, so we should have space for at several nodes without the need to allocate anything else.
-        const auto usage_before = memusage::DynamicUsage(map);
+    COutPoint out_point{};
+    for (size_t i = 0; i < 1000; ++i) {
+        out_point.n = i;
+        BOOST_CHECK(map.try_emplace(out_point).second);
+    }
+    BOOST_CHECK_EQUAL(map.size(), 1000U);
+    BOOST_CHECK_EQUAL(usage_before, map.DynamicMemoryUsage());
 
-        COutPoint out_point{};
-        for (size_t i = 0; i < 1000; ++i) {
-            out_point.n = i;
-            map[out_point];
-        }
-        BOOST_TEST(usage_before == memusage::DynamicUsage(map));
+    // Erased slots are reused.
+    for (size_t i = 0; i < 1000; i += 2) {
+        out_point.n = i;
+        BOOST_CHECK_EQUAL(map.erase(out_point), 1U);
+    }
+    for (size_t i = 0; i < 1000; i += 2) {
+        out_point.n = i + 1000;
+        BOOST_CHECK(map.try_emplace(out_point).second);
+    }
+    BOOST_CHECK_EQUAL(usage_before, map.DynamicMemoryUsage());
+    // The odd keys below 1000 survived, and the even ones from 1000 were added.
+    for (size_t i = 0; i < 2000; ++i) {
+        out_point.n = i;
+        BOOST_CHECK_EQUAL(map.find(out_point) != map.end(), i % 2 == (i < 1000 ? 1 : 0));
     }
+}
 
-    PoolResourceTester::CheckAllDataAccountedFor(resource);
+BOOST_AUTO_TEST_CASE(coins_map_model)
+{
+    // Compare the map against std::map under random insertions, lookups and erasures.
+    CCoinsMap map;
+    std::map<COutPoint, uint32_t> model;
+    std::vector<COutPoint> keys;
+    for (int i = 0; i < 4000; ++i) keys.emplace_back(Txid::FromUint256(m_rng.rand256()), m_rng.rand32());
+    for (uint32_t step = 0; step < 30000; ++step) {
+        const COutPoint& key{keys[m_rng.randrange(keys.size())]};
+        // Insert more often than erase during the first half, so the map grows
+        // through several rehashes, and the other way around in the second half.
+        const auto op{m_rng.randrange(4)};
+        if (op < (step < 15000 ? 2 : 1)) {
+            Coin coin;
+            coin.nHeight = step;
+            const auto [it, inserted] = map.try_emplace(key, std::move(coin));
+            BOOST_CHECK_EQUAL(inserted, model.try_emplace(key, step).second);
+            BOOST_CHECK_EQUAL(it->second.coin.nHeight, model.at(key));
+        } else if (op < 3) {
+            BOOST_CHECK_EQUAL(map.erase(key), model.erase(key));
+        } else {
+            const auto it{map.find(key)};
+            BOOST_REQUIRE_EQUAL(it != map.end(), model.contains(key));
+            if (it != map.end()) BOOST_CHECK_EQUAL(it->second.coin.nHeight, model.at(key));
+        }
+        BOOST_CHECK_EQUAL(map.size(), model.size());
+    }
+    size_t count{0};
+    for (const auto& [key, entry] : map) {
+        BOOST_CHECK_EQUAL(entry.coin.nHeight, model.at(key));
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(count, model.size());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
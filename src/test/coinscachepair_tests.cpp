@@ -6,193 +6,195 @@
 
 #include <boost/test/unit_test.hpp>
 
-#include <list>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(coinscachepair_tests)
 
 static constexpr auto NUM_NODES{4};
 
-std::list<CoinsCachePair> CreatePairs(CoinsCachePair& sentinel)
+static COutPoint Key(uint32_t n) { return COutPoint{Txid{}, n}; }
+
+static CoinsCachePair& Insert(CCoinsMap& map, uint32_t n)
 {
-    std::list<CoinsCachePair> nodes;
-    for (auto i{0}; i < NUM_NODES; ++i) {
-        nodes.emplace_back();
+    Coin coin;
+    coin.out.nValue = n + 1;
+    return *map.try_emplace(Key(n), std::move(coin)).first;
+}
 
-        auto node{std::prev(nodes.end())};
-        CCoinsCacheEntry::SetDirty(*node, sentinel);
+static void CheckIndex(const CCoinsMap& map)
+{
+    for (size_t pos{0}; pos < map.NumFlagged(); ++pos) {
+        const CoinsCachePair& pair{map.Flagged(pos)};
+        BOOST_CHECK_EQUAL(map.FlaggedPos(pair), pos);
+        BOOST_CHECK(pair.second.IsDirty() || pair.second.IsFresh());
+        BOOST_CHECK_EQUAL(&*map.find(pair.first), &pair);
+    }
+}
 
-        BOOST_CHECK(node->second.IsDirty() && !node->second.IsFresh());
-        BOOST_CHECK_EQUAL(node->second.Next(), &sentinel);
-        BOOST_CHECK_EQUAL(sentinel.second.Prev(), &(*node));
+std::vector<CoinsCachePair*> CreatePairs(CCoinsMap& map)
+{
+    std::vector<CoinsCachePair*> nodes;
+    for (auto i{0}; i < NUM_NODES; ++i) {
+        CoinsCachePair& node{Insert(map, i)};
+        map.SetDirty(map.find(node.first));
+        nodes.push_back(&node);
 
-        if (i > 0) {
-            BOOST_CHECK_EQUAL(std::prev(node)->second.Next(), &(*node));
-            BOOST_CHECK_EQUAL(node->second.Prev(), &(*std::prev(node)));
-        }
+        BOOST_CHECK(node.second.IsDirty() && !node.second.IsFresh());
+        BOOST_CHECK_EQUAL(map.NumFlagged(), size_t(i + 1));
+        BOOST_CHECK_EQUAL(&map.Flagged(i), &node);
     }
+    CheckIndex(map);
     return nodes;
 }
 
-BOOST_AUTO_TEST_CASE(linked_list_iteration)
+BOOST_AUTO_TEST_CASE(flagged_index_iteration)
 {
-    CoinsCachePair sentinel;
-    sentinel.second.SelfRef(sentinel);
-    auto nodes{CreatePairs(sentinel)};
-
-    // Check iterating through pairs is identical to iterating through a list
-    auto node{sentinel.second.Next()};
-    for (const auto& expected : nodes) {
-        BOOST_CHECK_EQUAL(&expected, node);
-        node = node->second.Next();
-    }
-    BOOST_CHECK_EQUAL(node, &sentinel);
-
-    // Check iterating through pairs is identical to iterating through a list
-    // Clear the state during iteration
-    node = sentinel.second.Next();
-    for (const auto& expected : nodes) {
-        BOOST_CHECK_EQUAL(&expected, node);
-        auto next = node->second.Next();
-        node->second.SetClean();
-        node = next;
+    CCoinsMap map;
+    auto nodes{CreatePairs(map)};
+    // An unflagged entry is not part of the index.
+    Insert(map, NUM_NODES);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), size_t(NUM_NODES));
+
+    // An erasing cursor visits all flagged entries, from the back of the index, without modifying it
+    size_t usage{0};
+    CoinsViewCacheCursor erasing{usage, map, /*will_erase=*/true};
+    auto node{erasing.Begin()};
+    for (auto expected{nodes.rbegin()}; expected != nodes.rend(); ++expected) {
+        BOOST_CHECK_EQUAL(*expected, node);
+        BOOST_CHECK(erasing.WillErase(*node));
+        node = erasing.NextAndMaybeErase(*node);
     }
-    BOOST_CHECK_EQUAL(node, &sentinel);
-    // Check that sentinel's next and prev are itself
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &sentinel);
-
-    // Delete the nodes from the list to make sure there are no dangling pointers
-    for (auto it{nodes.begin()}; it != nodes.end(); it = nodes.erase(it)) {
-        BOOST_CHECK(!it->second.IsDirty() && !it->second.IsFresh());
+    BOOST_CHECK_EQUAL(node, erasing.End());
+    BOOST_CHECK_EQUAL(map.NumFlagged(), size_t(NUM_NODES));
+
+    // A non-erasing cursor clears the state of the entries it visits
+    CoinsViewCacheCursor cursor{usage, map, /*will_erase=*/false};
+    node = cursor.Begin();
+    for (auto expected{nodes.rbegin()}; expected != nodes.rend(); ++expected) {
+        BOOST_CHECK_EQUAL(*expected, node);
+        BOOST_CHECK(!cursor.WillErase(*node));
+        node = cursor.NextAndMaybeErase(**expected);
+        BOOST_CHECK(!(*expected)->second.IsDirty() && !(*expected)->second.IsFresh());
     }
+    BOOST_CHECK_EQUAL(node, cursor.End());
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 0U);
+    BOOST_CHECK_EQUAL(map.size(), size_t(NUM_NODES + 1));
 }
 
-BOOST_AUTO_TEST_CASE(linked_list_iterate_erase)
+BOOST_AUTO_TEST_CASE(flagged_index_iterate_erase)
 {
-    CoinsCachePair sentinel;
-    sentinel.second.SelfRef(sentinel);
-    auto nodes{CreatePairs(sentinel)};
-
-    // Check iterating through pairs is identical to iterating through a list
-    // Erase the nodes as we iterate through, but don't clear state
-    // The state will be cleared by the CCoinsCacheEntry's destructor
-    auto node{sentinel.second.Next()};
-    for (auto expected{nodes.begin()}; expected != nodes.end(); expected = nodes.erase(expected)) {
-        BOOST_CHECK_EQUAL(&(*expected), node);
-        node = node->second.Next();
+    CCoinsMap map;
+    auto nodes{CreatePairs(map)};
+    size_t usage{0};
+    for (CoinsCachePair* node : nodes) {
+        usage += node->second.coin.DynamicMemoryUsage();
+        node->second.coin.Clear();
     }
-    BOOST_CHECK_EQUAL(node, &sentinel);
 
-    // Check that sentinel's next and prev are itself
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &sentinel);
+    // A non-erasing cursor still erases spent entries from the map
+    CoinsViewCacheCursor cursor{usage, map, /*will_erase=*/false};
+    auto node{cursor.Begin()};
+    for (auto expected{nodes.rbegin()}; expected != nodes.rend(); ++expected) {
+        BOOST_CHECK_EQUAL(*expected, node);
+        BOOST_CHECK(cursor.WillErase(*node));
+        node = cursor.NextAndMaybeErase(*node);
+    }
+    BOOST_CHECK_EQUAL(node, cursor.End());
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 0U);
+    BOOST_CHECK(map.empty());
+    BOOST_CHECK_EQUAL(usage, 0U);
 }
 
-BOOST_AUTO_TEST_CASE(linked_list_random_deletion)
+BOOST_AUTO_TEST_CASE(flagged_index_random_deletion)
 {
-    CoinsCachePair sentinel;
-    sentinel.second.SelfRef(sentinel);
-    auto nodes{CreatePairs(sentinel)};
-
-    // Create linked list sentinel->n1->n2->n3->n4->sentinel
-    auto n1{nodes.begin()};
-    auto n2{std::next(n1)};
-    auto n3{std::next(n2)};
-    auto n4{std::next(n3)};
-
-    // Delete n2
-    // sentinel->n1->n3->n4->sentinel
-    nodes.erase(n2);
-    // Check that n1 now points to n3, and n3 still points to n4
-    // Also check that state was not altered
-    BOOST_CHECK(n1->second.IsDirty() && !n1->second.IsFresh());
-    BOOST_CHECK_EQUAL(n1->second.Next(), &(*n3));
-    BOOST_CHECK(n3->second.IsDirty() && !n3->second.IsFresh());
-    BOOST_CHECK_EQUAL(n3->second.Next(), &(*n4));
-    BOOST_CHECK_EQUAL(n3->second.Prev(), &(*n1));
-
-    // Delete n1
-    // sentinel->n3->n4->sentinel
-    nodes.erase(n1);
-    // Check that sentinel now points to n3, and n3 still points to n4
-    // Also check that state was not altered
-    BOOST_CHECK(n3->second.IsDirty() && !n3->second.IsFresh());
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &(*n3));
-    BOOST_CHECK_EQUAL(n3->second.Next(), &(*n4));
-    BOOST_CHECK_EQUAL(n3->second.Prev(), &sentinel);
-
-    // Delete n4
-    // sentinel->n3->sentinel
-    nodes.erase(n4);
-    // Check that sentinel still points to n3, and n3 points to sentinel
+    CCoinsMap map;
+    auto nodes{CreatePairs(map)};
+
+    // Index n1, n2, n3, n4
+    const COutPoint n1{nodes[0]->first};
+    const COutPoint n2{nodes[1]->first};
+    const COutPoint n3{nodes[2]->first};
+    const COutPoint n4{nodes[3]->first};
+
+    // Erase n2; the last entry takes its place: n1, n4, n3
+    BOOST_CHECK_EQUAL(map.erase(n2), 1U);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 3U);
+    BOOST_CHECK(map.Flagged(1).first == n4);
     // Also check that state was not altered
-    BOOST_CHECK(n3->second.IsDirty() && !n3->second.IsFresh());
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &(*n3));
-    BOOST_CHECK_EQUAL(n3->second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &(*n3));
-
-    // Delete n3
-    // sentinel->sentinel
-    nodes.erase(n3);
-    // Check that sentinel's next and prev are itself
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &sentinel);
+    BOOST_CHECK(map.find(n1)->second.IsDirty() && !map.find(n1)->second.IsFresh());
+    BOOST_CHECK(map.find(n4)->second.IsDirty() && !map.find(n4)->second.IsFresh());
+    CheckIndex(map);
+
+    // Erase n1: n3, n4
+    BOOST_CHECK_EQUAL(map.erase(n1), 1U);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 2U);
+    BOOST_CHECK(map.Flagged(0).first == n3);
+    BOOST_CHECK(map.Flagged(1).first == n4);
+    CheckIndex(map);
+
+    // Erase n4, the last entry: n3
+    BOOST_CHECK_EQUAL(map.erase(n4), 1U);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 1U);
+    BOOST_CHECK(map.Flagged(0).first == n3);
+    BOOST_CHECK(map.find(n3)->second.IsDirty() && !map.find(n3)->second.IsFresh());
+
+    // Erase n3: the index is empty
+    BOOST_CHECK_EQUAL(map.erase(n3), 1U);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 0U);
+    BOOST_CHECK(map.empty());
 }
 
-BOOST_AUTO_TEST_CASE(linked_list_set_state)
+BOOST_AUTO_TEST_CASE(flagged_index_set_state)
 {
-    CoinsCachePair sentinel;
-    sentinel.second.SelfRef(sentinel);
-    CoinsCachePair n1;
-    CoinsCachePair n2;
+    CCoinsMap map;
+    CoinsCachePair& n1{Insert(map, 1)};
+    CoinsCachePair& n2{Insert(map, 2)};
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 0U);
 
-    // Check that setting DIRTY inserts it into linked list and sets state
-    CCoinsCacheEntry::SetDirty(n1, sentinel);
+    // Check that setting DIRTY adds it to the index and sets state
+    map.SetDirty(map.find(n1.first));
     BOOST_CHECK(n1.second.IsDirty() && !n1.second.IsFresh());
-    BOOST_CHECK_EQUAL(n1.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(n1.second.Prev(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &n1);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &n1);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 1U);
+    BOOST_CHECK_EQUAL(&map.Flagged(0), &n1);
 
-    // Check that setting FRESH on new node inserts it after n1
-    CCoinsCacheEntry::SetFresh(n2, sentinel);
+    // Check that setting FRESH on new node adds it after n1
+    map.SetFresh(map.find(n2.first));
     BOOST_CHECK(n2.second.IsFresh() && !n2.second.IsDirty());
-    BOOST_CHECK_EQUAL(n2.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(n2.second.Prev(), &n1);
-    BOOST_CHECK_EQUAL(n1.second.Next(), &n2);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &n2);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 2U);
+    BOOST_CHECK_EQUAL(&map.Flagged(1), &n2);
 
     // Check that we can set extra state, but they don't change our position
-    CCoinsCacheEntry::SetFresh(n1, sentinel);
+    map.SetFresh(map.find(n1.first));
     BOOST_CHECK(n1.second.IsDirty() && n1.second.IsFresh());
-    BOOST_CHECK_EQUAL(n1.second.Next(), &n2);
-    BOOST_CHECK_EQUAL(n1.second.Prev(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &n1);
-    BOOST_CHECK_EQUAL(n2.second.Prev(), &n1);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 2U);
+    BOOST_CHECK_EQUAL(&map.Flagged(0), &n1);
+    BOOST_CHECK_EQUAL(&map.Flagged(1), &n2);
 
     // Check that we can clear state then re-set it
-    n1.second.SetClean();
+    map.SetClean(n1);
     BOOST_CHECK(!n1.second.IsDirty() && !n1.second.IsFresh());
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &n2);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &n2);
-    BOOST_CHECK_EQUAL(n2.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(n2.second.Prev(), &sentinel);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 1U);
+    BOOST_CHECK_EQUAL(&map.Flagged(0), &n2);
+    CheckIndex(map);
 
     // Calling `SetClean` a second time has no effect
-    n1.second.SetClean();
+    map.SetClean(n1);
     BOOST_CHECK(!n1.second.IsDirty() && !n1.second.IsFresh());
-    BOOST_CHECK_EQUAL(sentinel.second.Next(), &n2);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &n2);
-    BOOST_CHECK_EQUAL(n2.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(n2.second.Prev(), &sentinel);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 1U);
+    BOOST_CHECK_EQUAL(&map.Flagged(0), &n2);
 
-    // Adding DIRTY re-inserts it after n2
-    CCoinsCacheEntry::SetDirty(n1, sentinel);
+    // Adding DIRTY re-adds it after n2
+    map.SetDirty(map.find(n1.first));
     BOOST_CHECK(n1.second.IsDirty() && !n1.second.IsFresh());
-    BOOST_CHECK_EQUAL(n2.second.Next(), &n1);
-    BOOST_CHECK_EQUAL(n1.second.Prev(), &n2);
-    BOOST_CHECK_EQUAL(n1.second.Next(), &sentinel);
-    BOOST_CHECK_EQUAL(sentinel.second.Prev(), &n1);
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 2U);
+    BOOST_CHECK_EQUAL(&map.Flagged(0), &n2);
+    BOOST_CHECK_EQUAL(&map.Flagged(1), &n1);
+    CheckIndex(map);
+
+    // Clearing the map empties the index
+    map.clear();
+    BOOST_CHECK_EQUAL(map.NumFlagged(), 0U);
+    BOOST_CHECK(map.empty());
 }
 
 BOOST_AUTO_TEST_SUITE_END()
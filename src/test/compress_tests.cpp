@@ -4,8 +4,10 @@
 
 #include <compressor.h>
 #include <script/script.h>
+#include <streams.h>
 #include <test/util/random.h>
 #include <test/util/setup_common.h>
+#include <util/strencodings.h>
 
 #include <stdint.h>
 
@@ -63,6 +65,34 @@ BOOST_AUTO_TEST_CASE(compress_amounts)
         BOOST_CHECK(TestDecode(i));
 }
 
+BOOST_AUTO_TEST_CASE(compress_amounts_serialization)
+{
+    const auto roundtrip{[](CAmount amount) {
+        DataStream stream;
+        stream << Using<AmountCompression>(amount);
+        CAmount result;
+        stream >> Using<AmountCompression>(result);
+        BOOST_CHECK(stream.empty());
+        return result;
+    }};
+    // Where the compressed amount fits in 64 bits, the encoding is unchanged.
+    for (const CAmount amount : {CAmount{0}, CAmount{1}, CENT, COIN, 50 * COIN, 21000000 * COIN, CAmount{2049638230412172402}}) {
+        DataStream stream;
+        stream << Using<AmountCompression>(amount);
+        BOOST_CHECK_EQUAL(HexStr(stream), HexStr(DataStream{} << VARINT(CompressAmount(amount))));
+        BOOST_CHECK_EQUAL(roundtrip(amount), amount);
+    }
+    // Larger amounts up to MAX_MONEY, whose compressed form needs more bits, round-trip too.
+    for (const CAmount amount : {CAmount{2049638230412172403}, CAmount{4289523295942786149}, MAX_MONEY - 1, MAX_MONEY}) {
+        BOOST_CHECK_EQUAL(roundtrip(amount), amount);
+    }
+    for (int i = 0; i < 10000; ++i) {
+        const CAmount amount{RandMoney(m_rng)};
+        BOOST_CHECK_EQUAL(roundtrip(amount), amount);
+        if (amount < 2049638230412172403) BOOST_CHECK_EQUAL(DecompressAmount(CompressAmount(amount)), uint64_t(amount));
+    }
+}
+
 BOOST_AUTO_TEST_CASE(compress_script_to_ckey_id)
 {
     // case CKeyID
@@ -1073,18 +1073,66 @@ BOOST_AUTO_TEST_CASE(hkdf_hmac_sha256_l32_tests)
 
 BOOST_AUTO_TEST_CASE(sha256d64)
 {
-    for (int i = 0; i <= 32; ++i) {
-        unsigned char in[64 * 32];
-        unsigned char out1[32 * 32], out2[32 * 32];
-        for (int j = 0; j < 64 * i; ++j) {
-            in[j] = m_rng.randbits(8);
+    for (const auto impl : {sha256_implementation::STANDARD, sha256_implementation::USE_SSE4_AND_AVX2, sha256_implementation::USE_SSE4_AND_AVX512, sha256_implementation::USE_SSE4_AND_SHANI, sha256_implementation::USE_ALL}) {
+        SHA256AutoDetect(impl);
+        for (int i = 0; i <= 40; ++i) {
+            unsigned char in[64 * 40];
+            unsigned char out1[32 * 40], out2[32 * 40];
+            for (int j = 0; j < 64 * i; ++j) {
+                in[j] = m_rng.randbits(8);
+            }
+            for (int j = 0; j < i; ++j) {
+                CHash256().Write({in + 64 * j, 64}).Finalize({out1 + 32 * j, 32});
+            }
+            SHA256D64(out2, in, i);
+            BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
         }
-        for (int j = 0; j < i; ++j) {
-            CHash256().Write({in + 64 * j, 64}).Finalize({out1 + 32 * j, 32});
+    }
+    SHA256AutoDetect();
+}
+
+BOOST_AUTO_TEST_CASE(ripemd160_32_many)
+{
+    for (int n = 0; n <= 20; ++n) {
+        const auto in{m_rng.randbytes(32 * n)};
+        std::vector<unsigned char> out1(20 * n), out2(20 * n);
+        for (int i = 0; i < n; ++i) {
+            CRIPEMD160().Write(in.data() + 32 * i, 32).Finalize(out1.data() + 20 * i);
+        }
+        RIPEMD160_32Many(out2.data(), in.data(), n);
+        BOOST_CHECK(out1 == out2);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha256d_many)
+{
+    for (const auto impl : {sha256_implementation::STANDARD, sha256_implementation::USE_SSE4_AND_AVX2, sha256_implementation::USE_SSE4_AND_AVX512, sha256_implementation::USE_SSE4_AND_SHANI, sha256_implementation::USE_ALL}) {
+        SHA256AutoDetect(impl);
+        for (int n = 0; n <= 40; ++n) {
+            // Mix lengths around the one- and two-block padding boundaries with longer messages.
+            std::vector<std::vector<unsigned char>> data;
+            std::vector<Span<const unsigned char>> inputs;
+            for (int i = 0; i < n; ++i) {
+                const size_t len{m_rng.randbool() ? 48 + m_rng.randrange<size_t>(24) : m_rng.randrange<size_t>(300)};
+                data.push_back(m_rng.randbytes(len));
+            }
+            for (const auto& d : data) inputs.emplace_back(d);
+            std::vector<unsigned char> out1(32 * n), out2(32 * n);
+            for (int i = 0; i < n; ++i) {
+                CHash256().Write(data[i]).Finalize(Span{out1}.subspan(32 * i, 32));
+            }
+            SHA256DMany(out2.data(), inputs);
+            BOOST_CHECK(out1 == out2);
+
+            // Single SHA256, as used for the inner step of Hash160.
+            for (int i = 0; i < n; ++i) {
+                CSHA256().Write(data[i].data(), data[i].size()).Finalize(out1.data() + 32 * i);
+            }
+            SHA256Many(out2.data(), inputs);
+            BOOST_CHECK(out1 == out2);
         }
-        SHA256D64(out2, in, i);
-        BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
     }
+    SHA256AutoDetect();
 }
 
 void CryptoTest::TestSHA3_256(const std::string& input, const std::string& output)
@@ -1281,4 +1329,57 @@ BOOST_AUTO_TEST_CASE(muhash_tests)
     BOOST_CHECK_EQUAL(HexStr(out4), "3a31e6903aff0de9f62f9a9f7f8b861de76ce2cda09822b90014319ae5dc2271");
 }
 
+BOOST_AUTO_TEST_CASE(muhash_implementations)
+{
+    // Products of random numbers, and of numbers at or above the modulus.
+    std::vector<std::pair<Num3072, Num3072>> operands;
+    for (int i = 0; i < 50; ++i) {
+        unsigned char a[Num3072::BYTE_SIZE], b[Num3072::BYTE_SIZE];
+        m_rng.fillrand(MakeWritableByteSpan(a));
+        m_rng.fillrand(MakeWritableByteSpan(b));
+        if (i % 5 == 1) std::fill(std::begin(a), std::end(a), 0xff);
+        if (i % 5 == 2) std::fill(std::begin(b), std::end(b), 0xff);
+        if (i % 5 == 3) std::fill(std::begin(b) + 1, std::end(b), 0);
+        operands.emplace_back(Num3072{a}, Num3072{b});
+    }
+
+    std::vector<unsigned char> expected;
+    for (const auto impl : {muhash_implementation::STANDARD, muhash_implementation::USE_SOLINAS, muhash_implementation::USE_ALL}) {
+        Num3072AutoDetect(impl);
+        std::vector<unsigned char> products;
+        for (auto [a, b] : operands) {
+            a.Multiply(b);
+            a.Multiply(a);
+            unsigned char out[Num3072::BYTE_SIZE];
+            a.ToBytes(out);
+            products.insert(products.end(), std::begin(out), std::end(out));
+        }
+        if (expected.empty()) expected = products;
+        BOOST_CHECK(products == expected);
+
+        MuHash3072 acc = FromInt(0);
+        acc *= FromInt(1);
+        acc /= FromInt(2);
+        uint256 out;
+        acc.Finalize(out);
+        BOOST_CHECK_EQUAL(out, uint256{"10d312b100cbd32ada024a6646e40d3482fcff103668d2625f10002a607d5863"});
+    }
+    Num3072AutoDetect();
+
+    // Batched insertion and removal match one element at a time.
+    std::vector<std::vector<unsigned char>> elements;
+    std::vector<Span<const unsigned char>> spans;
+    for (int i = 0; i < 40; ++i) elements.push_back(m_rng.randbytes(m_rng.randrange(100)));
+    for (const auto& element : elements) spans.emplace_back(element);
+    MuHash3072 single, batched;
+    for (const auto& element : Span{elements}.first(30)) single.Insert(element);
+    for (const auto& element : Span{elements}.subspan(30)) single.Remove(element);
+    batched.InsertMany(Span{spans}.first(30));
+    batched.RemoveMany(Span{spans}.subspan(30));
+    uint256 single_out, batched_out;
+    single.Finalize(single_out);
+    batched.Finalize(batched_out);
+    BOOST_CHECK_EQUAL(single_out, batched_out);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -202,6 +202,48 @@ BOOST_AUTO_TEST_CASE(dbwrapper_iterator)
     }
 }
 
+BOOST_AUTO_TEST_CASE(dbwrapper_snapshot)
+{
+    fs::path ph = m_args.GetDataDirBase() / "dbwrapper_snapshot";
+    CDBWrapper dbw({.path = ph, .cache_bytes = 1 << 20, .memory_only = true, .wipe_data = false, .obfuscate = true});
+
+    uint8_t key{'j'};
+    uint256 in = m_rng.rand256();
+    BOOST_CHECK(dbw.Write(key, in));
+    const auto snapshot{dbw.GetSnapshot()};
+
+    // Writes after the snapshot was taken are not visible through it.
+    uint256 in_new = m_rng.rand256();
+    BOOST_CHECK(dbw.Write(key, in_new));
+    uint8_t key2{'k'};
+    BOOST_CHECK(dbw.Write(key2, m_rng.rand256()));
+    uint8_t key3{'i'};
+    BOOST_CHECK(dbw.Write(key3, m_rng.rand256()));
+
+    uint256 res;
+    BOOST_CHECK(snapshot->Read(key, res));
+    BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+    BOOST_CHECK(dbw.Read(key, res));
+    BOOST_CHECK_EQUAL(res.ToString(), in_new.ToString());
+    BOOST_CHECK(!snapshot->Exists(key2));
+    BOOST_CHECK(dbw.Exists(key2));
+
+    // Neither are erasures.
+    BOOST_CHECK(dbw.Erase(key));
+    BOOST_CHECK(snapshot->Exists(key));
+    BOOST_CHECK(!dbw.Exists(key));
+
+    std::unique_ptr<CDBIterator> it(snapshot->NewIterator());
+    it->Seek(key3);
+    uint8_t key_res;
+    BOOST_REQUIRE(it->GetKey(key_res));
+    BOOST_CHECK_EQUAL(key_res, key);
+    BOOST_REQUIRE(it->GetValue(res));
+    BOOST_CHECK_EQUAL(res.ToString(), in.ToString());
+    it->Next();
+    BOOST_CHECK(!it->Valid());
+}
+
 // Test that we do not obfuscation if there is existing data.
 BOOST_AUTO_TEST_CASE(existing_data_no_obfuscate)
 {
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <crypto/common.h>
 #include <crypto/hmac_sha256.h>
 #include <crypto/hmac_sha512.h>
 #include <crypto/ripemd160.h>
@@ -9,10 +10,12 @@
 #include <crypto/sha256.h>
 #include <crypto/sha3.h>
 #include <crypto/sha512.h>
+#include <crypto/siphash.h>
 #include <hash.h>
 #include <test/fuzz/FuzzedDataProvider.h>
 #include <test/fuzz/fuzz.h>
 #include <test/fuzz/util.h>
+#include <uint256.h>
 
 #include <cstdint>
 #include <vector>
@@ -129,3 +132,37 @@ FUZZ_TARGET(crypto)
         KeccakF(state);
     }
 }
+
+FUZZ_TARGET(siphash_many)
+{
+    FuzzedDataProvider fuzzed_data_provider{buffer.data(), buffer.size()};
+    const uint64_t k0{fuzzed_data_provider.ConsumeIntegral<uint64_t>()};
+    const uint64_t k1{fuzzed_data_provider.ConsumeIntegral<uint64_t>()};
+    std::vector<std::vector<uint8_t>> messages;
+    LIMITED_WHILE(fuzzed_data_provider.ConsumeBool(), 64) {
+        messages.push_back(ConsumeRandomLengthByteVector(fuzzed_data_provider, 100));
+    }
+
+    const std::vector<Span<const unsigned char>> data(messages.begin(), messages.end());
+    std::vector<uint64_t> out(data.size());
+    SipHashMany(k0, k1, data, out.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        assert(out[i] == CSipHasher(k0, k1).Write(data[i]).Finalize());
+    }
+
+    // Interpret the messages as (uint256, extra) pairs for the fixed-shape batch functions.
+    std::vector<uint256> vals;
+    std::vector<uint32_t> extras;
+    for (const auto& message : messages) {
+        std::vector<uint8_t> padded{message};
+        padded.resize(uint256::size() + 4);
+        vals.emplace_back(Span{padded}.first(uint256::size()));
+        extras.push_back(ReadLE32(padded.data() + uint256::size()));
+    }
+    std::vector<const uint256*> ptrs;
+    for (const uint256& val : vals) ptrs.push_back(&val);
+    SipHashUint256Many(k0, k1, ptrs, out.data());
+    for (size_t i = 0; i < vals.size(); ++i) assert(out[i] == SipHashUint256(k0, k1, vals[i]));
+    SipHashUint256ExtraMany(k0, k1, ptrs, extras, out.data());
+    for (size_t i = 0; i < vals.size(); ++i) assert(out[i] == SipHashUint256Extra(k0, k1, vals[i], extras[i]));
+}
@@ -72,13 +72,14 @@ FUZZ_TARGET(integer, .init = initialize_integer)
     const Consensus::Params& consensus_params = Params().GetConsensus();
     (void)CheckProofOfWorkImpl(u256, u32, consensus_params);
     if (u64 <= MAX_MONEY) {
-        const uint64_t compressed_money_amount = CompressAmount(u64);
-        assert(u64 == DecompressAmount(compressed_money_amount));
-        static const uint64_t compressed_money_amount_max = CompressAmount(MAX_MONEY - 1);
+        const auto compressed_money_amount = CompressAmountSplit(u64);
+        assert(u64 == DecompressAmountSplit(compressed_money_amount.first, compressed_money_amount.second));
+        static const auto compressed_money_amount_max = CompressAmountSplit(MAX_MONEY - 1);
         assert(compressed_money_amount <= compressed_money_amount_max);
     } else {
-        (void)CompressAmount(u64);
+        (void)CompressAmountSplit(u64);
     }
+    (void)CompressAmount(u64);
     constexpr uint256 u256_min{"0000000000000000000000000000000000000000000000000000000000000000"};
     constexpr uint256 u256_max{"ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"};
     const std::vector<uint256> v256{u256, u256_min, u256_max};
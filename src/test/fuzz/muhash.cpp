@@ -134,6 +134,33 @@ FUZZ_TARGET(num3072_mul)
     assert(std::ranges::equal(buf_num, buf_uint));
 }
 
+FUZZ_TARGET(num3072_mul_implementations)
+{
+    // Test that all multiplication implementations agree with the standard one.
+    FuzzedDataProvider provider{buffer.data(), buffer.size()};
+
+    uint8_t data_a[384] = {0};
+    provider.ConsumeData(data_a, 384);
+    uint8_t data_b[384] = {0};
+    provider.ConsumeData(data_b, 384);
+    const int rounds = provider.ConsumeIntegralInRange(1, 4);
+
+    uint8_t expected[384];
+    for (const auto impl : {muhash_implementation::STANDARD, muhash_implementation::USE_SOLINAS, muhash_implementation::USE_ALL}) {
+        Num3072AutoDetect(impl);
+        Num3072 a{data_a};
+        const Num3072 b{data_b};
+        for (int i = 0; i < rounds; ++i) a.Multiply(b);
+        uint8_t buf[384];
+        a.ToBytes(buf);
+        if (impl == muhash_implementation::STANDARD) {
+            std::ranges::copy(buf, expected);
+        } else {
+            assert(std::ranges::equal(buf, expected));
+        }
+    }
+}
+
 FUZZ_TARGET(num3072_inv)
 {
     // Test inversion
@@ -222,6 +249,18 @@ FUZZ_TARGET(muhash)
             muhash.Remove(data2);
             muhash.Finalize(out);
             out2 = initial_state_hash;
+        },
+        [&] {
+            // Test that batched insertion and removal match single element ones
+            muhash.Finalize(out);
+
+            const std::vector<Span<const unsigned char>> both{data, data2};
+            MuHash3072 batched;
+            batched.InsertMany(both);
+            batched.InsertMany(both);
+            batched.RemoveMany(Span{both}.first(1));
+            batched.Remove(data2);
+            batched.Finalize(out2);
         });
     assert(out == out2);
 }
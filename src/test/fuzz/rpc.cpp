@@ -134,7 +134,9 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getdescriptorinfo",
     "getdifficulty",
     "getindexinfo",
+    "getlockprofile",
     "getmemoryinfo",
+    "getmemoryusage",
     "getmempoolancestors",
     "getmempooldescendants",
     "getmempoolentry",
@@ -151,9 +153,11 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawmempool",
     "getrawtransaction",
     "getrpcinfo",
+    "getschedulerinfo",
     "gettxout",
     "gettxoutsetinfo",
     "gettxspendingprevout",
+    "getvalidationstats",
     "help",
     "invalidateblock",
     "joinpsbts",
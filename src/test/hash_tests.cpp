@@ -12,6 +12,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(hash_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(murmurhash3)
@@ -149,4 +152,61 @@ BOOST_AUTO_TEST_CASE(siphash)
     }
 }
 
+BOOST_AUTO_TEST_CASE(siphash_many)
+{
+    // Counts around the 4- and 8-lane widths exercise both the SIMD groups and the scalar remainder.
+    for (size_t count : {0, 1, 3, 4, 7, 8, 9, 17, 33}) {
+        const uint64_t k0{m_rng.rand64()}, k1{m_rng.rand64()};
+        std::vector<uint256> vals;
+        std::vector<const uint256*> ptrs;
+        std::vector<uint32_t> extras;
+        for (size_t i = 0; i < count; ++i) {
+            vals.push_back(m_rng.rand256());
+            extras.push_back(m_rng.rand32());
+        }
+        for (const uint256& val : vals) ptrs.push_back(&val);
+        std::vector<uint64_t> out(count);
+        SipHashUint256Many(k0, k1, ptrs, out.data());
+        for (size_t i = 0; i < count; ++i) BOOST_CHECK_EQUAL(out[i], SipHashUint256(k0, k1, vals[i]));
+        SipHashUint256ExtraMany(k0, k1, ptrs, extras, out.data());
+        for (size_t i = 0; i < count; ++i) BOOST_CHECK_EQUAL(out[i], SipHashUint256Extra(k0, k1, vals[i], extras[i]));
+    }
+
+    // Arbitrary-length messages, mixing lengths that share a block count with longer ones.
+    const uint64_t k0{m_rng.rand64()}, k1{m_rng.rand64()};
+    std::vector<std::vector<unsigned char>> messages;
+    for (size_t len = 0; len <= 90; ++len) {
+        for (int i = 0; i < 3; ++i) messages.push_back(m_rng.randbytes(len));
+    }
+    std::shuffle(messages.begin(), messages.end(), m_rng);
+    const std::vector<Span<const unsigned char>> data(messages.begin(), messages.end());
+    std::vector<uint64_t> out(data.size());
+    SipHashMany(k0, k1, data, out.data());
+    for (size_t i = 0; i < data.size(); ++i) {
+        BOOST_CHECK_EQUAL(out[i], CSipHasher(k0, k1).Write(data[i]).Finalize());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(hash160_many)
+{
+    for (const auto impl : {sha256_implementation::STANDARD, sha256_implementation::USE_ALL}) {
+        SHA256AutoDetect(impl);
+        // Compressed and uncompressed public key sizes, plus arbitrary script lengths.
+        std::vector<std::vector<unsigned char>> data;
+        for (int i = 0; i < 45; ++i) {
+            const size_t len{i % 3 == 0 ? 33 : i % 3 == 1 ? 65 : m_rng.randrange<size_t>(200)};
+            data.push_back(m_rng.randbytes(len));
+        }
+        for (size_t n : {size_t{0}, size_t{1}, size_t{7}, size_t{8}, size_t{9}, data.size()}) {
+            const std::vector<Span<const unsigned char>> inputs(data.begin(), data.begin() + n);
+            const std::vector<uint160> hashes{Hash160Many(inputs)};
+            BOOST_REQUIRE_EQUAL(hashes.size(), n);
+            for (size_t i = 0; i < n; ++i) {
+                BOOST_CHECK_EQUAL(hashes[i], Hash160(data[i]));
+            }
+        }
+    }
+    SHA256AutoDetect();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,12 +5,21 @@
 #include <chainparams.h>
 #include <consensus/validation.h>
 #include <interfaces/chain.h>
+#include <interfaces/handler.h>
 #include <test/util/setup_common.h>
 #include <script/solver.h>
+#include <tinyformat.h>
+#include <util/time.h>
 #include <validation.h>
+#include <validationinterface.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
 using interfaces::FoundBlock;
 
 BOOST_FIXTURE_TEST_SUITE(interfaces_tests, TestChain100Setup)
@@ -162,4 +171,77 @@ BOOST_AUTO_TEST_CASE(hasBlocks)
     BOOST_CHECK(!chain->hasBlocks(active.Tip()->GetBlockHash(), 6, 50));
 }
 
+//! Records the notifications a client receives, in order.
+class NotificationsRecorder : public interfaces::Chain::Notifications
+{
+public:
+    void blockConnected(ChainstateRole role, const interfaces::BlockInfo& block) override
+    {
+        m_events.push_back(strprintf("block %d", block.height));
+    }
+    void blocksConnected(ChainstateRole role, const std::vector<interfaces::BlockInfo>& blocks) override
+    {
+        std::string event{"blocks"};
+        for (const interfaces::BlockInfo& block : blocks) event += strprintf(" %d", block.height);
+        m_events.push_back(std::move(event));
+    }
+    void updatedBlockTip() override { m_events.emplace_back("tip"); }
+    void chainStateFlushed(ChainstateRole role, const CBlockLocator& locator) override { m_events.emplace_back("flushed"); }
+
+    std::vector<std::string> m_events;
+};
+
+BOOST_AUTO_TEST_CASE(notifications_batching)
+{
+    std::vector<const CBlockIndex*> blocks;
+    {
+        LOCK(Assert(m_node.chainman)->GetMutex());
+        const CChain& active = m_node.chainman->ActiveChain();
+        for (int height = 1; height <= active.Height(); ++height) blocks.push_back(active[height]);
+    }
+    BOOST_REQUIRE_EQUAL(blocks.size(), 100U);
+
+    ValidationSignals& signals{*Assert(m_node.validation_signals)};
+    auto recorder{std::make_shared<NotificationsRecorder>()};
+    auto handler{m_node.chain->handleNotifications(recorder)};
+    const auto block{std::make_shared<const CBlock>()};
+    const auto connect{[&](int height) { signals.BlockConnected(ChainstateRole::NORMAL, block, blocks[height - 1]); }};
+    const auto tip{[&] { signals.UpdatedBlockTip(blocks.back(), blocks.front(), /*fInitialDownload=*/false); }};
+    const auto events{[&] {
+        signals.SyncWithValidationInterfaceQueue();
+        return std::exchange(recorder->m_events, {});
+    }};
+    using Events = std::vector<std::string>;
+
+    // Far behind the clock, connected blocks are held back. Any other event
+    // delivers them first, as one batch, so the order of events is kept.
+    SetMockTime(blocks.back()->Time().time_since_epoch() + std::chrono::days{1000});
+    for (int height : {1, 2, 3}) connect(height);
+    BOOST_CHECK(events() == Events{});
+    signals.ChainStateFlushed(ChainstateRole::NORMAL, CBlockLocator{});
+    for (int height : {4, 5}) connect(height);
+    tip();
+    BOOST_CHECK(events() == (Events{"blocks 1 2 3", "flushed", "blocks 4 5", "tip"}));
+
+    // A full batch is delivered without waiting for another event.
+    std::string full_batch{"blocks"};
+    for (int i = 0; i < 128; ++i) {
+        const int height{i % 100 + 1};
+        connect(height);
+        full_batch += strprintf(" %d", height);
+    }
+    connect(29);
+    BOOST_CHECK(events() == Events{full_batch});
+    tip();
+    BOOST_CHECK(events() == (Events{"block 29", "tip"}));
+
+    // Near the tip, every block is delivered on its own right away.
+    SetMockTime(blocks.back()->Time().time_since_epoch());
+    connect(99);
+    connect(100);
+    BOOST_CHECK(events() == (Events{"block 99", "block 100"}));
+    tip();
+    BOOST_CHECK(events() == Events{"tip"});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
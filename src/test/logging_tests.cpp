@@ -10,6 +10,7 @@
 
 #include <chrono>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <unordered_map>
 #include <utility>
@@ -215,6 +216,55 @@ BOOST_FIXTURE_TEST_CASE(logging_SeverityLevels, LogSetup)
     BOOST_CHECK_EQUAL_COLLECTIONS(log_lines.begin(), log_lines.end(), expected.begin(), expected.end());
 }
 
+BOOST_FIXTURE_TEST_CASE(logging_async, LogSetup)
+{
+    LogInstance().m_log_timestamps = true;
+    const auto dropped_before{LogInstance().AsyncLinesDropped()};
+    LogInstance().StartAsyncLogging(/*capacity=*/4);
+
+    // Timestamps are taken when a line is logged, not when it is written.
+    SetMockTime(1'600'000'000s);
+    LogInfo("foo1");
+    SetMockTime(1'600'000'001s);
+    LogInfo("foo2");
+    LogInstance().FlushAsyncLogging();
+
+    // Block the background thread while it writes the next line, so that the
+    // queue fills up behind it.
+    std::promise<void> writing;
+    std::promise<void> resume;
+    const auto cb{LogInstance().PushBackCallback([&, resumed = resume.get_future().share()](const std::string& str) {
+        if (str.find("block") == std::string::npos) return;
+        writing.set_value();
+        resumed.wait();
+    })};
+    LogInfo("block");
+    writing.get_future().wait();
+    for (int i{0}; i < 6; ++i) LogInfo("line%d", i);
+    BOOST_CHECK_EQUAL(LogInstance().AsyncLinesDropped() - dropped_before, 2U);
+    resume.set_value();
+    LogInstance().StopAsyncLogging();
+    LogInstance().DeleteCallback(cb);
+
+    std::ifstream file{tmp_log_path};
+    std::vector<std::string> log_lines;
+    for (std::string log; std::getline(file, log);) {
+        // Strip the wall clock time.
+        log_lines.push_back(log.substr(log.find(' ') + 1));
+    }
+    std::vector<std::string> expected = {
+        "(mocktime: 2020-09-13T12:26:40Z) foo1",
+        "(mocktime: 2020-09-13T12:26:41Z) foo2",
+        "(mocktime: 2020-09-13T12:26:41Z) block",
+        "(mocktime: 2020-09-13T12:26:41Z) [warning] Asynchronous log queue overflowed, 2 log lines dropped.",
+        "(mocktime: 2020-09-13T12:26:41Z) line0",
+        "(mocktime: 2020-09-13T12:26:41Z) line1",
+        "(mocktime: 2020-09-13T12:26:41Z) line2",
+        "(mocktime: 2020-09-13T12:26:41Z) line3",
+    };
+    BOOST_CHECK_EQUAL_COLLECTIONS(log_lines.begin(), log_lines.end(), expected.begin(), expected.end());
+}
+
 BOOST_FIXTURE_TEST_CASE(logging_Conf, LogSetup)
 {
     // Set global log level
@@ -0,0 +1,95 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/metrics.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace metrics;
+
+BOOST_AUTO_TEST_SUITE(metrics_tests)
+
+BOOST_AUTO_TEST_CASE(exponential_buckets)
+{
+    BOOST_CHECK(ExponentialBuckets(10, 4, 4) == (std::vector<uint64_t>{10, 40, 160, 640}));
+    // Bounds that round to the same integer are merged.
+    BOOST_CHECK(ExponentialBuckets(1, 1.2, 4) == (std::vector<uint64_t>{1, 2}));
+}
+
+BOOST_AUTO_TEST_CASE(histogram)
+{
+    Registry registry;
+    Histogram histogram{"test_seconds", "help", {10, 100, 1000}, /*scale=*/1e-3, {}, registry};
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.5), 0U);
+
+    // Bounds are inclusive.
+    for (uint64_t value : {0, 10, 11, 100, 5000}) histogram.Observe(value);
+    histogram.ObserveDuration(std::chrono::milliseconds{1});
+    BOOST_CHECK_EQUAL(histogram.BucketCount(0), 2U);
+    BOOST_CHECK_EQUAL(histogram.BucketCount(1), 2U);
+    BOOST_CHECK_EQUAL(histogram.BucketCount(2), 1U);
+    BOOST_CHECK_EQUAL(histogram.BucketCount(3), 1U);
+    BOOST_CHECK_EQUAL(histogram.Count(), 6U);
+    BOOST_CHECK_EQUAL(histogram.Sum(), 6121U);
+
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.3), 10U);
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.5), 100U);
+    BOOST_CHECK_EQUAL(histogram.Quantile(0.8), 1000U);
+    BOOST_CHECK_EQUAL(histogram.Quantile(1.0), std::numeric_limits<uint64_t>::max());
+
+    BOOST_CHECK_EQUAL(registry.Render(),
+                      "# HELP test_seconds help\n"
+                      "# TYPE test_seconds histogram\n"
+                      "test_seconds_bucket{le=\"0.01\"} 2\n"
+                      "test_seconds_bucket{le=\"0.1\"} 4\n"
+                      "test_seconds_bucket{le=\"1\"} 5\n"
+                      "test_seconds_bucket{le=\"+Inf\"} 6\n"
+                      "test_seconds_sum 6.121\n"
+                      "test_seconds_count 6\n");
+}
+
+BOOST_AUTO_TEST_CASE(registry_render)
+{
+    Registry registry;
+    Gauge gauge{"test_gauge", "A gauge", {}, registry};
+    Counter hits{"test_total", "Lookups", R"(result="hit")", /*scale=*/1.0, registry};
+    Counter time{"test_time_seconds_total", "Time", {}, /*scale=*/1e-6, registry};
+    Callback callback{"test_callback", "A callback", Metric::Type::GAUGE, [] { return 2.5; }, {}, registry};
+    std::optional<Counter> misses{std::in_place, "test_total", "Lookups", R"(result="miss")", /*scale=*/1.0, registry};
+
+    gauge.Set(5);
+    gauge.Add(-7);
+    hits.Inc(3);
+    misses->Inc();
+    time.Inc(1500);
+
+    // Grouped by name, with HELP and TYPE once per name.
+    BOOST_CHECK_EQUAL(registry.Render(),
+                      "# HELP test_callback A callback\n"
+                      "# TYPE test_callback gauge\n"
+                      "test_callback 2.5\n"
+                      "# HELP test_gauge A gauge\n"
+                      "# TYPE test_gauge gauge\n"
+                      "test_gauge -2\n"
+                      "# HELP test_time_seconds_total Time\n"
+                      "# TYPE test_time_seconds_total counter\n"
+                      "test_time_seconds_total 0.0015\n"
+                      "# HELP test_total Lookups\n"
+                      "# TYPE test_total counter\n"
+                      "test_total{result=\"hit\"} 3\n"
+                      "test_total{result=\"miss\"} 1\n");
+
+    // Destroyed metrics are no longer rendered.
+    misses.reset();
+    BOOST_CHECK(registry.Render().find("miss") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
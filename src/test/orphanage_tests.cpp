@@ -4,6 +4,7 @@
 
 #include <arith_uint256.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <pubkey.h>
@@ -562,4 +563,29 @@ BOOST_AUTO_TEST_CASE(peer_worksets)
         }
     }
 }
+
+BOOST_AUTO_TEST_CASE(memory_usage)
+{
+    FastRandomContext det_rand{true};
+    TxOrphanage orphanage;
+    const size_t empty_usage{orphanage.DynamicMemoryUsage()};
+
+    auto parent = MakeTransactionSpending(/*outpoints=*/{}, det_rand);
+    auto child = MakeTransactionSpending({{parent->GetHash(), 0}, {parent->GetHash(), 1}}, det_rand);
+    BOOST_CHECK(orphanage.AddTx(child, /*peer=*/0));
+    const size_t one_usage{orphanage.DynamicMemoryUsage()};
+    // At least the transaction itself, and the entries indexing it.
+    BOOST_CHECK_GT(one_usage, empty_usage + RecursiveDynamicUsage(*child));
+
+    // A second announcer adds a little, but the transaction is only counted once.
+    BOOST_CHECK(orphanage.AddAnnouncer(child->GetWitnessHash(), /*peer=*/1));
+    BOOST_CHECK_GT(orphanage.DynamicMemoryUsage(), one_usage);
+    BOOST_CHECK_LT(orphanage.DynamicMemoryUsage(), one_usage + RecursiveDynamicUsage(*child));
+
+    BOOST_CHECK_EQUAL(orphanage.EraseTx(child->GetWitnessHash()), 1);
+    orphanage.EraseForPeer(0);
+    orphanage.EraseForPeer(1);
+    // The vector used for random eviction keeps its capacity.
+    BOOST_CHECK_LT(orphanage.DynamicMemoryUsage(), one_usage - RecursiveDynamicUsage(*child));
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -8,7 +8,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <functional>
+#include <future>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -212,4 +214,116 @@ BOOST_AUTO_TEST_CASE(mockforward)
     BOOST_CHECK(delta > 2*60 && delta < 3*60);
 }
 
+BOOST_AUTO_TEST_CASE(timer_wheel_order)
+{
+    CScheduler scheduler;
+
+    // Tasks from a little in the past to well beyond the first level of the
+    // wheel, scheduled in random order, must run in time order and never early.
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto now{std::chrono::steady_clock::now()};
+    std::vector<std::chrono::steady_clock::time_point> times;
+    for (int i = 0; i < 200; ++i) {
+        times.push_back(now + std::chrono::microseconds{-5000 + int64_t(rng.randrange(300'000))});
+    }
+    std::vector<std::chrono::steady_clock::time_point> ran;
+    bool early{false};
+    for (const auto& time : times) {
+        scheduler.schedule([&ran, &early, time] {
+            early |= std::chrono::steady_clock::now() < time;
+            ran.push_back(time);
+        }, time);
+    }
+
+    std::thread thread{[&] { scheduler.serviceQueue(); }};
+    scheduler.StopWhenDrained();
+    if (thread.joinable()) thread.join();
+
+    BOOST_CHECK(!early);
+    std::sort(times.begin(), times.end());
+    BOOST_CHECK(ran == times);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel_far_future)
+{
+    CScheduler scheduler;
+    std::thread thread{[&] { scheduler.serviceQueue(); }};
+
+    int counter{0};
+    // Beyond the last level of the wheel, so these move into it later.
+    scheduler.scheduleFromNow([&counter] { ++counter; }, std::chrono::hours{2});
+    scheduler.scheduleFromNow([&counter] { ++counter; }, std::chrono::hours{5} + std::chrono::minutes{30});
+    scheduler.scheduleFromNow([&counter] { ++counter; }, std::chrono::hours{30});
+
+    const auto sync{[&] {
+        std::promise<void> promise;
+        scheduler.scheduleFromNow([&promise] { promise.set_value(); }, std::chrono::milliseconds{1});
+        promise.get_future().wait();
+    }};
+    std::chrono::steady_clock::time_point first, last;
+    for (int hour = 1; hour <= 6; ++hour) {
+        scheduler.MockForward(std::chrono::hours{1});
+        sync();
+        BOOST_CHECK_EQUAL(counter, hour < 2 ? 0 : hour < 6 ? 1 : 2);
+    }
+    BOOST_CHECK_EQUAL(scheduler.getQueueInfo(first, last), 1U);
+    const auto remaining{std::chrono::duration_cast<std::chrono::hours>(first - std::chrono::steady_clock::now())};
+    BOOST_CHECK(remaining >= std::chrono::hours{23} && remaining <= std::chrono::hours{24});
+
+    scheduler.stop();
+    if (thread.joinable()) thread.join();
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel_immediate)
+{
+    CScheduler scheduler;
+    std::thread thread{[&] { scheduler.serviceQueue(); }};
+
+    // A chain of tasks that each schedule the next one for now, as the
+    // validation interface queues do. Due tasks must not wait for the next
+    // tick of the wheel, which would take at least a millisecond per task.
+    constexpr int CHAIN{1000};
+    std::promise<void> done;
+    int runs{0};
+    std::function<void()> next{[&] {
+        if (++runs == CHAIN) return done.set_value();
+        scheduler.schedule(next, std::chrono::steady_clock::now());
+    }};
+    const auto start{std::chrono::steady_clock::now()};
+    scheduler.schedule(next, start);
+    done.get_future().wait();
+    const auto elapsed{std::chrono::steady_clock::now() - start};
+    BOOST_CHECK_MESSAGE(elapsed < CHAIN * std::chrono::milliseconds{1} / 2,
+                        "took " << Ticks<std::chrono::milliseconds>(elapsed) << "ms");
+
+    scheduler.stop();
+    if (thread.joinable()) thread.join();
+}
+
+BOOST_AUTO_TEST_CASE(task_stats)
+{
+    CScheduler scheduler;
+    std::thread thread{[&] { scheduler.serviceQueue(); }};
+
+    std::promise<void> done;
+    int runs{0};
+    scheduler.scheduleEvery([&] {
+        UninterruptibleSleep(std::chrono::milliseconds{2});
+        if (++runs == 3) done.set_value();
+    }, std::chrono::milliseconds{1}, "sleeper");
+    scheduler.scheduleFromNow([] {}, std::chrono::milliseconds{0});
+    done.get_future().wait();
+    scheduler.stop();
+    if (thread.joinable()) thread.join();
+
+    const auto stats{scheduler.GetTaskStats()};
+    BOOST_CHECK_EQUAL(stats.size(), 2U);
+    BOOST_CHECK_EQUAL(stats.at("unnamed").runs, 1U);
+    const CScheduler::TaskStats& sleeper{stats.at("sleeper")};
+    BOOST_CHECK_EQUAL(sleeper.runs, 3U);
+    BOOST_CHECK(sleeper.last >= std::chrono::milliseconds{2});
+    BOOST_CHECK(sleeper.max >= sleeper.last);
+    BOOST_CHECK(sleeper.total >= 3 * std::chrono::milliseconds{2});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -4,6 +4,9 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <hash.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <protocol.h>
 #include <serialize.h>
 #include <streams.h>
 #include <test/util/setup_common.h>
@@ -385,6 +388,124 @@ public:
     }
 };
 
+//! Fixed-layout types must serialize exactly as their members would.
+BOOST_AUTO_TEST_CASE(fixed_layout)
+{
+    if constexpr (std::endian::native == std::endian::little) {
+        static_assert(FixedLayout<CBlockHeader> && FixedLayout<COutPoint> && FixedLayout<CInv> && FixedLayout<CMessageHeader>);
+    }
+    static_assert(!FixedLayout<CBlock> && !FixedLayout<CTxOut>);
+
+    CBlockHeader header;
+    header.nVersion = 0x20000004;
+    header.hashPrevBlock = m_rng.rand256();
+    header.hashMerkleRoot = m_rng.rand256();
+    header.nTime = m_rng.rand32();
+    header.nBits = m_rng.rand32();
+    header.nNonce = m_rng.rand32();
+    DataStream memberwise{};
+    SerializeMany(memberwise, header.nVersion, header.hashPrevBlock, header.hashMerkleRoot, header.nTime, header.nBits, header.nNonce);
+    DataStream ss{};
+    ss << header;
+    BOOST_CHECK_EQUAL(HexStr(ss), HexStr(memberwise));
+    BOOST_CHECK_EQUAL(GetSerializeSize(header), 80U);
+    CBlockHeader header_read;
+    ss >> header_read;
+    BOOST_CHECK_EQUAL(header_read.GetHash(), header.GetHash());
+
+    // A block's header is read in place.
+    CBlock block{header};
+    ss << TX_WITH_WITNESS(block);
+    CBlock block_read;
+    ss >> TX_WITH_WITNESS(block_read);
+    BOOST_CHECK_EQUAL(block_read.GetHash(), header.GetHash());
+
+    // Vectors are (un)serialized in one go, with the usual size prefix.
+    std::vector<COutPoint> outpoints;
+    for (uint32_t i = 0; i < 100; ++i) outpoints.emplace_back(Txid::FromUint256(m_rng.rand256()), i);
+    memberwise.clear();
+    WriteCompactSize(memberwise, outpoints.size());
+    for (const COutPoint& outpoint : outpoints) SerializeMany(memberwise, outpoint.hash, outpoint.n);
+    ss << outpoints;
+    BOOST_CHECK_EQUAL(HexStr(ss), HexStr(memberwise));
+    std::vector<COutPoint> outpoints_read{COutPoint{}};
+    ss >> outpoints_read;
+    BOOST_CHECK(outpoints_read == outpoints);
+
+    // Reading past the end fails without a partial result being relied upon.
+    ss << outpoints;
+    ss.resize(ss.size() - 1);
+    BOOST_CHECK_THROW(ss >> outpoints_read, std::ios_base::failure);
+}
+
+/** Stream wrapper counting the reads from the underlying stream. */
+class ReadCountingStream
+{
+    DataStream& m_stream;
+
+public:
+    size_t m_reads{0};
+
+    explicit ReadCountingStream(DataStream& stream) : m_stream{stream} {}
+
+    void read(Span<std::byte> dst)
+    {
+        ++m_reads;
+        m_stream.read(dst);
+    }
+
+    template <typename T>
+    ReadCountingStream& operator>>(T&& obj)
+    {
+        ::Unserialize(*this, obj);
+        return *this;
+    }
+};
+
+//! Vectors of fixed-layout types are read in MAX_VECTOR_ALLOCATE-sized batches, not element by element.
+BOOST_AUTO_TEST_CASE(fixed_layout_vector_batches)
+{
+    if constexpr (std::endian::native != std::endian::little) return;
+
+    // Enough headers to take more than one batch.
+    const size_t per_batch{MAX_VECTOR_ALLOCATE / sizeof(CBlockHeader)};
+    std::vector<CBlockHeader> headers(per_batch + 10);
+    for (CBlockHeader& header : headers) {
+        header.nVersion = m_rng.rand32();
+        header.hashPrevBlock = m_rng.rand256();
+        header.hashMerkleRoot = m_rng.rand256();
+        header.nTime = m_rng.rand32();
+        header.nBits = m_rng.rand32();
+        header.nNonce = m_rng.rand32();
+    }
+    DataStream ss{};
+    ss << headers;
+
+    std::vector<CBlockHeader> headers_read;
+    ReadCountingStream counting{ss};
+    counting >> headers_read;
+    // Two reads for the size prefix (its 0xfe marker and 32-bit value), then one per batch.
+    BOOST_CHECK_EQUAL(counting.m_reads, 4U);
+    BOOST_CHECK(ss.empty());
+    BOOST_REQUIRE_EQUAL(headers_read.size(), headers.size());
+    for (size_t i = 0; i < headers.size(); ++i) {
+        BOOST_CHECK_EQUAL(headers_read[i].GetHash(), headers[i].GetHash());
+    }
+
+    std::vector<CInv> invs;
+    for (uint32_t i = 0; i < 50; ++i) invs.emplace_back(MSG_WITNESS_TX, m_rng.rand256());
+    ss << invs;
+    std::vector<CInv> invs_read;
+    ReadCountingStream counting_invs{ss};
+    counting_invs >> invs_read;
+    BOOST_CHECK_EQUAL(counting_invs.m_reads, 2U);
+    BOOST_REQUIRE_EQUAL(invs_read.size(), invs.size());
+    for (size_t i = 0; i < invs.size(); ++i) {
+        BOOST_CHECK_EQUAL(invs_read[i].type, invs[i].type);
+        BOOST_CHECK_EQUAL(invs_read[i].hash, invs[i].hash);
+    }
+}
+
 //! Test creating a stream with multiple parameters and making sure
 //! serialization code requiring different parameters can retrieve them. Also
 //! test that earlier parameters take precedence if the same parameter type is
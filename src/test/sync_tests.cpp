@@ -4,11 +4,15 @@
 
 #include <sync.h>
 #include <test/util/setup_common.h>
+#include <util/time.h>
 
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <mutex>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
 
 namespace {
 template <typename MutexType>
@@ -140,4 +144,56 @@ BOOST_AUTO_TEST_CASE(inconsistent_lock_order_detected)
 #endif // DEBUG_LOCKORDER
 }
 
+BOOST_AUTO_TEST_CASE(lock_profiler)
+{
+    const auto find_site{[](std::string_view name) {
+        const auto stats{lockprofile::GetStats()};
+        const auto it{std::find_if(stats.begin(), stats.end(), [&](const auto& site) { return site.name == name; })};
+        BOOST_REQUIRE(it != stats.end());
+        return *it;
+    }};
+    lockprofile::Reset();
+    lockprofile::g_sample_rate = 2;
+
+    // Sites are named after the locked expression.
+    Mutex mutex;
+    Mutex& held{mutex};
+    for (int i{0}; i < 10; ++i) {
+        LOCK(held);
+        UninterruptibleSleep(1ms);
+    }
+    // One in two acquisitions is sampled.
+    const auto held_site{find_site("held")};
+    BOOST_CHECK_EQUAL(held_site.file, __FILE__);
+    BOOST_CHECK_EQUAL(held_site.samples, 5U);
+    BOOST_CHECK_EQUAL(held_site.contended, 0U);
+    BOOST_CHECK(held_site.hold.max >= 1ms);
+    BOOST_CHECK(held_site.hold.total >= 5ms);
+    BOOST_CHECK(held_site.hold.Quantile(0.5) >= 1ms / 2);
+
+    // Make another thread wait for the mutex. It may not reach the lock before
+    // the mutex is released, so retry with longer holds until it did.
+    lockprofile::g_sample_rate = 1;
+    Mutex& contended{mutex};
+    uint64_t waits{0};
+    for (int attempt{1}; waits == 0; ++attempt) {
+        BOOST_REQUIRE_LE(attempt, 10);
+        std::thread thread;
+        {
+            LOCK(held);
+            thread = std::thread{[&] { LOCK(contended); }};
+            UninterruptibleSleep(10ms * attempt);
+        }
+        thread.join();
+        waits = find_site("contended").contended;
+    }
+    const auto contended_site{find_site("contended")};
+    BOOST_CHECK(contended_site.wait.max > 0ns);
+    BOOST_CHECK(contended_site.wait.Quantile(1.0) > 0ns);
+
+    lockprofile::g_sample_rate = 0;
+    lockprofile::Reset();
+    BOOST_CHECK(lockprofile::GetStats().empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
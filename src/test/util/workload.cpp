@@ -0,0 +1,309 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/workload.h>
+
+#include <addresstype.h>
+#include <consensus/validation.h>
+#include <key.h>
+#include <policy/policy.h>
+#include <pubkey.h>
+#include <script/interpreter.h>
+#include <script/sign.h>
+#include <script/solver.h>
+#include <util/check.h>
+#include <util/translation.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <set>
+
+namespace {
+//! Keys per output kind; outputs reuse them.
+constexpr size_t NUM_KEYS{64};
+//! Change below this is left to the fee.
+constexpr CAmount MIN_CHANGE{1000};
+
+enum : size_t { SINGLE, CHAIN, FAN_OUT, FAN_IN };
+
+std::vector<unsigned char> DummySig(size_t size)
+{
+    std::vector<unsigned char> sig(size);
+    sig[0] = 0x30;
+    return sig;
+}
+} // namespace
+
+WorkloadGenerator::WorkloadGenerator(const uint256& seed, bool sign, std::array<uint32_t, 3> output_weights)
+    : m_rng{seed}, m_sign{sign}, m_output_weights{output_weights}
+{
+    std::vector<CPubKey> pubkeys;
+    while (pubkeys.size() < NUM_KEYS) {
+        CKey key;
+        const auto secret{m_rng.randbytes(32)};
+        key.Set(secret.begin(), secret.end(), /*fCompressedIn=*/true);
+        if (!key.IsValid()) continue;
+        const CPubKey& pubkey{pubkeys.emplace_back(key.GetPubKey())};
+        m_provider.keys.emplace(pubkey.GetID(), key);
+        m_provider.pubkeys.emplace(pubkey.GetID(), pubkey);
+
+        m_scripts[size_t(WorkloadOutput::P2WPKH)].push_back(GetScriptForDestination(WitnessV0KeyHash{pubkey}));
+
+        TaprootBuilder builder;
+        builder.Finalize(XOnlyPubKey{pubkey});
+        const WitnessV1Taproot output{builder.GetOutput()};
+        m_provider.tr_trees.emplace(output, builder);
+        m_scripts[size_t(WorkloadOutput::P2TR)].push_back(GetScriptForDestination(output));
+    }
+    for (size_t i = 0; i < NUM_KEYS; ++i) {
+        const CScript witness_script{GetScriptForMultisig(2, {pubkeys[i], pubkeys[(i + 1) % NUM_KEYS], pubkeys[(i + 2) % NUM_KEYS]})};
+        const CScript& script{m_scripts[size_t(WorkloadOutput::P2WSH_MULTISIG)].emplace_back(GetScriptForDestination(WitnessV0ScriptHash{witness_script}))};
+        m_provider.scripts.emplace(CScriptID{witness_script}, witness_script);
+        m_witness_scripts.emplace(script, witness_script);
+    }
+}
+
+template <size_t N>
+size_t WorkloadGenerator::Pick(const std::array<uint32_t, N>& weights)
+{
+    uint64_t r{m_rng.randrange(std::accumulate(weights.begin(), weights.end(), uint64_t{0}))};
+    for (size_t i = 0; i < N; ++i) {
+        if (r < weights[i]) return i;
+        r -= weights[i];
+    }
+    assert(false);
+}
+
+CScript WorkloadGenerator::RandomScript()
+{
+    return m_scripts[Pick(m_output_weights)][m_rng.randrange(NUM_KEYS)];
+}
+
+CAmount WorkloadGenerator::RandomFeerate(double min, double max)
+{
+    // Log-uniform, so low feerates are more common than high ones, in sat/kvB.
+    const double u{double(m_rng.rand64()) / double(std::numeric_limits<uint64_t>::max())};
+    return CAmount(std::llround(1000 * min * std::pow(max / min, u)));
+}
+
+WorkloadGenerator::Spendable WorkloadGenerator::Fund(Workload& workload, CAmount value)
+{
+    Spendable spendable{COutPoint{Txid::FromUint256(m_rng.rand256()), 0}, CTxOut{value, RandomScript()}};
+    workload.coins.emplace(spendable.outpoint, Coin{spendable.txout, /*nHeightIn=*/1, /*fCoinBaseIn=*/false});
+    return spendable;
+}
+
+void WorkloadGenerator::Satisfy(CMutableTransaction& tx, const std::vector<Spendable>& spent, bool sign)
+{
+    for (auto& txin : tx.vin) {
+        txin.scriptSig.clear();
+        txin.scriptWitness.SetNull();
+    }
+    if (sign) {
+        std::map<COutPoint, Coin> coins;
+        for (const auto& s : spent) coins.emplace(s.outpoint, Coin{s.txout, /*nHeightIn=*/1, /*fCoinBaseIn=*/false});
+        std::map<int, bilingual_str> input_errors;
+        Assert(SignTransaction(tx, &m_provider, coins, SIGHASH_DEFAULT, input_errors));
+        return;
+    }
+    for (size_t i = 0; i < tx.vin.size(); ++i) {
+        auto& stack{tx.vin[i].scriptWitness.stack};
+        const CScript& script{spent[i].txout.scriptPubKey};
+        std::vector<std::vector<unsigned char>> solutions;
+        switch (Solver(script, solutions)) {
+        case TxoutType::WITNESS_V0_KEYHASH:
+            stack = {DummySig(72), std::vector<unsigned char>(CPubKey::COMPRESSED_SIZE, 0x02)};
+            break;
+        case TxoutType::WITNESS_V0_SCRIPTHASH:
+            if (const auto it{m_witness_scripts.find(script)}; it != m_witness_scripts.end()) {
+                stack = {{}, DummySig(72), DummySig(72), {it->second.begin(), it->second.end()}};
+            } else {
+                stack = {DummySig(72), {}};
+            }
+            break;
+        case TxoutType::WITNESS_V1_TAPROOT:
+            stack = {DummySig(64)};
+            break;
+        case TxoutType::SCRIPTHASH:
+            // Assume P2SH-P2WPKH.
+            tx.vin[i].scriptSig = CScript{} << std::vector<unsigned char>(22);
+            stack = {DummySig(72), std::vector<unsigned char>(CPubKey::COMPRESSED_SIZE, 0x02)};
+            break;
+        case TxoutType::PUBKEYHASH:
+            tx.vin[i].scriptSig = CScript{} << DummySig(72) << std::vector<unsigned char>(CPubKey::COMPRESSED_SIZE, 0x02);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+std::vector<WorkloadGenerator::Spendable> WorkloadGenerator::AddTx(Workload& workload, const std::vector<Spendable>& inputs, const std::vector<CTxOut>& payments,
+                                                                   const CScript& change_script, CAmount feerate, bool sign)
+{
+    CMutableTransaction tx;
+    CAmount in_value{0};
+    for (const auto& input : inputs) {
+        tx.vin.emplace_back(input.outpoint);
+        in_value += input.txout.nValue;
+    }
+    CAmount out_value{0};
+    for (const auto& payment : payments) {
+        tx.vout.push_back(payment);
+        out_value += payment.nValue;
+    }
+    tx.vout.emplace_back(0, change_script);
+    // Size the fee with dummy witnesses, which are as large as real ones.
+    Satisfy(tx, inputs, /*sign=*/false);
+    // Deep in a chain the coins may be too small for a high feerate; pay what is left instead.
+    const CAmount fee{std::min(feerate * GetVirtualTransactionSize(CTransaction{tx}) / 1000, in_value - out_value)};
+    const CAmount change{in_value - out_value - fee};
+    if (change < MIN_CHANGE) {
+        tx.vout.pop_back();
+    } else {
+        tx.vout.back().nValue = change;
+        out_value += change;
+    }
+    Assert(out_value <= in_value);
+    if (sign) Satisfy(tx, inputs, /*sign=*/true);
+
+    const auto& ref{workload.txs.emplace_back(MakeTransactionRef(std::move(tx)))};
+    workload.fees.push_back(in_value - out_value);
+    std::vector<Spendable> outputs;
+    for (uint32_t n = 0; n < ref->vout.size(); ++n) outputs.push_back({COutPoint{ref->GetHash(), n}, ref->vout[n]});
+    return outputs;
+}
+
+Workload WorkloadGenerator::Mempool(const MempoolWorkloadOptions& options)
+{
+    Assume(options.max_cluster_size >= 2);
+    const auto feerate{[&] { return RandomFeerate(options.min_feerate, options.max_feerate); }};
+    const auto fund{[&](Workload& workload) { return Fund(workload, 10'000'000 + m_rng.randrange(90'000'000)); }};
+    const auto pay{[&](CAmount value, uint32_t min_percent, uint32_t max_percent) {
+        return CTxOut{value * (min_percent + m_rng.randrange(max_percent - min_percent + 1)) / 100, RandomScript()};
+    }};
+    const auto largest{[](const std::vector<Spendable>& outputs) {
+        return *std::max_element(outputs.begin(), outputs.end(), [](const auto& a, const auto& b) { return a.txout.nValue < b.txout.nValue; });
+    }};
+
+    Workload workload;
+    uint64_t vsize{0};
+    while (vsize < options.vsize) {
+        const size_t first{workload.txs.size()};
+        switch (Pick(options.cluster_weights)) {
+        case SINGLE: {
+            std::vector<Spendable> inputs(1 + m_rng.randrange(3));
+            for (auto& input : inputs) input = fund(workload);
+            AddTx(workload, inputs, {pay(inputs[0].txout.nValue, 10, 50)}, RandomScript(), feerate(), m_sign);
+            break;
+        }
+        case CHAIN: {
+            // Short chains, mostly CPFP, are far more common than long ones.
+            const size_t length{2 + std::min(m_rng.randrange(options.max_cluster_size - 1), m_rng.randrange(options.max_cluster_size - 1))};
+            Spendable tip{fund(workload)};
+            for (size_t i = 0; i < length; ++i) {
+                tip = largest(AddTx(workload, {tip}, {pay(tip.txout.nValue, 1, 10)}, RandomScript(), feerate(), m_sign));
+            }
+            break;
+        }
+        case FAN_OUT: {
+            const size_t children{1 + m_rng.randrange(options.max_cluster_size - 1)};
+            // Batched payouts come from large coins.
+            const Spendable input{Fund(workload, 100'000'000 + m_rng.randrange(900'000'000))};
+            std::vector<CTxOut> payments;
+            for (size_t i = 0; i < children; ++i) payments.push_back(pay(input.txout.nValue / (2 * children), 50, 100));
+            const auto outputs{AddTx(workload, {input}, payments, RandomScript(), feerate(), m_sign)};
+            for (size_t i = 0; i < children; ++i) {
+                AddTx(workload, {outputs[i]}, {pay(outputs[i].txout.nValue, 20, 80)}, RandomScript(), feerate(), m_sign);
+            }
+            break;
+        }
+        case FAN_IN: {
+            const size_t parents{2 + m_rng.randrange(std::min<size_t>(options.max_cluster_size - 1, 10) - 1)};
+            std::vector<Spendable> inputs;
+            for (size_t i = 0; i < parents; ++i) {
+                const Spendable input{fund(workload)};
+                inputs.push_back(AddTx(workload, {input}, {pay(input.txout.nValue, 10, 50)}, RandomScript(), feerate(), m_sign)[0]);
+            }
+            const CAmount total{std::accumulate(inputs.begin(), inputs.end(), CAmount{0}, [](CAmount sum, const auto& s) { return sum + s.txout.nValue; })};
+            AddTx(workload, inputs, {pay(total, 50, 90)}, RandomScript(), feerate(), m_sign);
+            break;
+        }
+        }
+        for (size_t i = first; i < workload.txs.size(); ++i) vsize += GetVirtualTransactionSize(*workload.txs[i]);
+    }
+    return workload;
+}
+
+Workload WorkloadGenerator::Block(const BlockWorkloadOptions& options)
+{
+    Workload workload;
+    std::vector<Spendable> created;
+    uint64_t weight{0};
+    while (true) {
+        std::vector<Spendable> inputs;
+        std::vector<COutPoint> funded;
+        if (!created.empty() && m_rng.randrange(100u) < options.in_block_spend_percent) {
+            const size_t i{m_rng.randrange(created.size())};
+            inputs.push_back(created[i]);
+            created[i] = created.back();
+            created.pop_back();
+        } else {
+            for (size_t i = 1 + m_rng.randrange(3); i > 0; --i) {
+                inputs.push_back(Fund(workload, 1'000'000 + m_rng.randrange(99'000'000)));
+                funded.push_back(inputs.back().outpoint);
+            }
+        }
+        std::vector<CTxOut> payments;
+        for (size_t i = 1 + m_rng.randrange(2); i > 0; --i) payments.emplace_back(inputs[0].txout.nValue * (10 + m_rng.randrange(30)) / 100, RandomScript());
+        const auto outputs{AddTx(workload, inputs, payments, RandomScript(), RandomFeerate(1, 100), m_sign)};
+
+        weight += GetTransactionWeight(*workload.txs.back());
+        if (weight > options.weight) {
+            workload.txs.pop_back();
+            workload.fees.pop_back();
+            for (const auto& outpoint : funded) workload.coins.erase(outpoint);
+            break;
+        }
+        created.insert(created.end(), outputs.begin(), outputs.end());
+    }
+    return workload;
+}
+
+std::vector<CTransactionRef> WorkloadGenerator::WalletHistory(const std::vector<CScript>& wallet_scripts, const WalletWorkloadOptions& options)
+{
+    Assume(!wallet_scripts.empty());
+    const std::set<CScript> mine(wallet_scripts.begin(), wallet_scripts.end());
+    const auto wallet_script{[&] { return wallet_scripts[m_rng.randrange(wallet_scripts.size())]; }};
+
+    Workload workload;
+    std::vector<Spendable> owned;
+    for (size_t n = 0; n < options.num_txs; ++n) {
+        std::vector<Spendable> outputs;
+        if (owned.empty() || m_rng.randrange(100u) < options.receive_percent) {
+            std::vector<Spendable> inputs(1 + m_rng.randrange(2));
+            for (auto& input : inputs) input = Fund(workload, 1'000'000 + m_rng.randrange(99'000'000));
+            const CTxOut payment{inputs[0].txout.nValue * (5 + m_rng.randrange(90)) / 100, wallet_script()};
+            outputs = AddTx(workload, inputs, {payment}, RandomScript(), RandomFeerate(1, 50), /*sign=*/false);
+        } else {
+            // Spend random coins, as coin selection would, rather than the oldest.
+            std::vector<Spendable> inputs;
+            for (size_t i = 1 + m_rng.randrange(3); i > 0 && !owned.empty(); --i) {
+                const size_t j{m_rng.randrange(owned.size())};
+                inputs.push_back(owned[j]);
+                owned[j] = owned.back();
+                owned.pop_back();
+            }
+            const CTxOut payment{inputs[0].txout.nValue * (5 + m_rng.randrange(60)) / 100, RandomScript()};
+            outputs = AddTx(workload, inputs, {payment}, wallet_script(), RandomFeerate(1, 50), /*sign=*/false);
+        }
+        for (const auto& output : outputs) {
+            if (mine.contains(output.txout.scriptPubKey)) owned.push_back(output);
+        }
+    }
+    return std::move(workload.txs);
+}
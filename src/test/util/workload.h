@@ -0,0 +1,134 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_TEST_UTIL_WORKLOAD_H
+#define BITCOIN_TEST_UTIL_WORKLOAD_H
+
+#include <coins.h>
+#include <consensus/amount.h>
+#include <consensus/consensus.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <script/signingprovider.h>
+#include <uint256.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+/** Kinds of output the generated transactions pay to and spend. */
+enum class WorkloadOutput : uint8_t {
+    P2WPKH,         //!< Segwit v0 single key.
+    P2WSH_MULTISIG, //!< Segwit v0 2-of-3 multisig.
+    P2TR,           //!< Taproot, spent with the key path.
+};
+
+/** Transactions and the coins they spend that none of them create. */
+struct Workload {
+    //! Coins to add to the view the transactions are checked against.
+    std::map<COutPoint, Coin> coins;
+    //! Transactions, parents before children.
+    std::vector<CTransactionRef> txs;
+    //! Fee paid by each transaction in txs.
+    std::vector<CAmount> fees;
+};
+
+struct MempoolWorkloadOptions {
+    //! Stop once the transactions add up to this many virtual bytes.
+    uint64_t vsize{1'000'000};
+    //! Relative frequency of single transactions, chains, one parent with
+    //! many children (batched payouts), and many parents with one child
+    //! (consolidations).
+    std::array<uint32_t, 4> cluster_weights{75, 10, 8, 7};
+    //! Largest cluster, which keeps them within the default ancestor and descendant limits.
+    size_t max_cluster_size{25};
+    //! Feerates are log-uniform between these, in sat/vB.
+    double min_feerate{1.0};
+    double max_feerate{500.0};
+};
+
+struct BlockWorkloadOptions {
+    //! Stop before the transactions would exceed this weight.
+    uint64_t weight{MAX_BLOCK_WEIGHT - 4000};
+    //! Percentage of transactions that spend an output of an earlier one in the block.
+    uint32_t in_block_spend_percent{10};
+};
+
+struct WalletWorkloadOptions {
+    size_t num_txs{100'000};
+    //! Percentage of transactions that pay to the wallet rather than spend from it.
+    uint32_t receive_percent{60};
+};
+
+/**
+ * Deterministic generator of large, realistic datasets for benchmarks: the
+ * same seed and options always produce the same transactions.
+ *
+ * Outputs are a mix of segwit v0 and taproot, with the frequencies given by
+ * output_weights. With sign set, every input spending a generated output
+ * carries a valid signature, so the transactions pass script verification
+ * against Workload::coins; otherwise the witnesses are dummies of the same size,
+ * which is much faster to generate. Deriving keys and signing need the ECC
+ * context, e.g. from a BasicTestingSetup.
+ */
+class WorkloadGenerator
+{
+public:
+    explicit WorkloadGenerator(const uint256& seed = uint256::ZERO, bool sign = false,
+                               std::array<uint32_t, 3> output_weights = {55, 10, 35});
+
+    /** Clusters of mempool transactions, with realistic shapes and feerates. */
+    Workload Mempool(const MempoolWorkloadOptions& options = {});
+
+    /** Transactions filling a block, without the coinbase. */
+    Workload Block(const BlockWorkloadOptions& options = {});
+
+    /**
+     * The history of a wallet that owns wallet_scripts: payments to it, and
+     * spends of its outputs with change back to it. Inputs from outside the
+     * wallet spend made-up coins and are never signed.
+     */
+    std::vector<CTransactionRef> WalletHistory(const std::vector<CScript>& wallet_scripts, const WalletWorkloadOptions& options = {});
+
+    /** The provider holding the keys of the generated outputs. */
+    const FlatSigningProvider& Provider() const { return m_provider; }
+
+private:
+    struct Spendable {
+        COutPoint outpoint;
+        CTxOut txout;
+    };
+
+    FastRandomContext m_rng;
+    const bool m_sign;
+    const std::array<uint32_t, 3> m_output_weights;
+    FlatSigningProvider m_provider;
+    //! Output scripts of each kind, one per key.
+    std::array<std::vector<CScript>, 3> m_scripts;
+    //! Witness scripts of the multisig outputs, by output script.
+    std::map<CScript, CScript> m_witness_scripts;
+
+    template <size_t N>
+    size_t Pick(const std::array<uint32_t, N>& weights);
+    CScript RandomScript();
+    //! In sat/kvB.
+    CAmount RandomFeerate(double min, double max);
+    //! A coin that none of the transactions create, added to coins.
+    Spendable Fund(Workload& workload, CAmount value);
+    //! Fill in the scriptSig and witness of each input: signatures, or dummies of the same size.
+    void Satisfy(CMutableTransaction& tx, const std::vector<Spendable>& spent, bool sign);
+    /**
+     * Build and add a transaction spending inputs, with the given payments and
+     * whatever is left after the fee going to change_script. Returns the
+     * outputs of the transaction.
+     */
+    std::vector<Spendable> AddTx(Workload& workload, const std::vector<Spendable>& inputs, const std::vector<CTxOut>& payments,
+                                 const CScript& change_script, CAmount feerate, bool sign);
+};
+
+#endif // BITCOIN_TEST_UTIL_WORKLOAD_H
@@ -147,4 +147,144 @@ BOOST_FIXTURE_TEST_CASE(chainstate_update_tip, TestChain100Setup)
     BOOST_CHECK_EQUAL(curr_tip, get_notify_tip());
 }
 
+//! Test that a UTXO snapshot combines the database with the unflushed cache
+//! entries, and is not affected by later changes to the chainstate.
+BOOST_FIXTURE_TEST_CASE(chainstate_coins_tip_snapshot, TestChain100Setup)
+{
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    Chainstate& chainstate = chainman.ActiveChainstate();
+
+    const auto read_all{[](const CCoinsView& view) {
+        std::vector<std::pair<COutPoint, Coin>> coins;
+        for (auto cursor{view.Cursor()}; cursor->Valid(); cursor->Next()) {
+            auto& [outpoint, coin]{coins.emplace_back()};
+            BOOST_REQUIRE(cursor->GetKey(outpoint));
+            BOOST_REQUIRE(cursor->GetValue(coin));
+        }
+        return coins;
+    }};
+
+    COutPoint added, spent, modified;
+    size_t db_count;
+    {
+        LOCK(::cs_main);
+        chainstate.ForceFlushStateToDisk();
+        const auto db_coins{read_all(chainstate.CoinsDB())};
+        BOOST_REQUIRE_GE(db_count = db_coins.size(), 2U);
+        // A new coin, a spent one, and one replaced in the cache.
+        added = AddTestCoin(m_rng, chainstate.CoinsTip());
+        spent = db_coins[0].first;
+        BOOST_REQUIRE(chainstate.CoinsTip().SpendCoin(spent));
+        modified = db_coins[1].first;
+        BOOST_REQUIRE(chainstate.CoinsTip().SpendCoin(modified));
+        Coin coin{db_coins[1].second};
+        coin.out.nValue += 1;
+        chainstate.CoinsTip().AddCoin(modified, std::move(coin), /*possible_overwrite=*/false);
+    }
+
+    const auto snapshot{chainstate.GetCoinsTipSnapshot()};
+    BOOST_CHECK_EQUAL(snapshot, chainstate.GetCoinsTipSnapshot());
+    BOOST_CHECK_EQUAL(snapshot->tip, WITH_LOCK(::cs_main, return chainman.ActiveTip()));
+    BOOST_CHECK_EQUAL(snapshot->coins->GetBestBlock(), snapshot->tip->GetBlockHash());
+    BOOST_CHECK_EQUAL(snapshot->coins->DeltaSize(), 3U);
+
+    const auto check_snapshot{[&] {
+        const CCoinsViewDBSnapshot& view{*snapshot->coins};
+        BOOST_CHECK(view.HaveCoin(added));
+        BOOST_CHECK(!view.HaveCoin(spent));
+        BOOST_CHECK(!view.GetCoin(spent));
+        const auto coins{read_all(view)};
+        BOOST_CHECK_EQUAL(coins.size(), db_count);
+        for (size_t i = 0; i < coins.size(); ++i) {
+            if (i > 0) BOOST_CHECK(coins[i - 1].first < coins[i].first);
+            BOOST_CHECK(coins[i].first != spent);
+            const auto coin{view.GetCoin(coins[i].first)};
+            BOOST_REQUIRE(coin);
+            BOOST_CHECK(coin->out == coins[i].second.out);
+        }
+    }};
+    check_snapshot();
+    {
+        LOCK(::cs_main);
+        for (const COutPoint& outpoint : {added, spent, modified}) {
+            const auto expected{chainstate.CoinsTip().GetCoin(outpoint)};
+            const auto coin{snapshot->coins->GetCoin(outpoint)};
+            BOOST_REQUIRE_EQUAL(coin.has_value(), expected.has_value());
+            if (coin) BOOST_CHECK(coin->out == expected->out);
+        }
+    }
+
+    // A new tip replaces the cached snapshot, while the old one is unaffected
+    // by the block and by the flush.
+    mineBlocks(1);
+    WITH_LOCK(::cs_main, chainstate.ForceFlushStateToDisk());
+    const auto next{chainstate.GetCoinsTipSnapshot()};
+    BOOST_CHECK(next != snapshot);
+    BOOST_CHECK_EQUAL(next->tip->pprev, snapshot->tip);
+    BOOST_CHECK_EQUAL(next->coins->DeltaSize(), 0U);
+    check_snapshot();
+
+    // Beyond MAX_COINS_TIP_SNAPSHOT_DELTA unflushed entries, the cache is
+    // flushed rather than copied.
+    COutPoint last;
+    {
+        LOCK(::cs_main);
+        for (size_t i = 0; i <= MAX_COINS_TIP_SNAPSHOT_DELTA; ++i) last = AddTestCoin(m_rng, chainstate.CoinsTip());
+        BOOST_CHECK_GT(chainstate.CoinsTip().GetDirtyCount(), MAX_COINS_TIP_SNAPSHOT_DELTA);
+    }
+    mineBlocks(1);
+    const auto flushed{chainstate.GetCoinsTipSnapshot()};
+    BOOST_CHECK_EQUAL(flushed->coins->DeltaSize(), 0U);
+    BOOST_CHECK(flushed->coins->HaveCoin(last));
+    BOOST_CHECK_EQUAL(WITH_LOCK(::cs_main, return chainstate.CoinsTip().GetDirtyCount()), 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(chainstate_validation_profiler, TestChain100Setup)
+{
+    ChainstateManager& chainman = *Assert(m_node.chainman);
+    const kernel::ValidationProfiler& profiler{chainman.GetValidationProfiler()};
+    const uint64_t total_count{profiler.GetHistogram(kernel::ValidationStage::TOTAL).Count()};
+    const uint64_t header_count{profiler.GetHistogram(kernel::ValidationStage::HEADER_CHECK).Count()};
+
+    const CBlock block{CreateAndProcessBlock({}, CScript{} << OP_TRUE)};
+    BOOST_CHECK_EQUAL(profiler.GetHistogram(kernel::ValidationStage::TOTAL).Count(), total_count + 1);
+    BOOST_CHECK_EQUAL(profiler.GetHistogram(kernel::ValidationStage::HEADER_CHECK).Count(), header_count + 1);
+
+    // The setup's blocks and the new one are in the history, newest last.
+    const auto history{profiler.GetHistory()};
+    BOOST_REQUIRE_GE(history.size(), 2U);
+    const kernel::BlockProfile& profile{history.back()};
+    BOOST_CHECK_EQUAL(profile.hash, block.GetHash());
+    BOOST_CHECK_EQUAL(profile.height, 101);
+    BOOST_CHECK_EQUAL(profile.tx_count, block.vtx.size());
+    BOOST_CHECK_EQUAL(history[history.size() - 2].height, 100);
+    // The block was passed in, so it wasn't read, and the header check is never recorded per block.
+    BOOST_CHECK(profile.stages[size_t(kernel::ValidationStage::READ)].count() == 0);
+    BOOST_CHECK(profile.stages[size_t(kernel::ValidationStage::HEADER_CHECK)].count() == 0);
+    std::chrono::microseconds sum{0};
+    for (auto stage : {kernel::ValidationStage::CHECK, kernel::ValidationStage::FORKS, kernel::ValidationStage::UTXO_FETCH,
+                       kernel::ValidationStage::SCRIPT_CHECK, kernel::ValidationStage::UNDO_WRITE, kernel::ValidationStage::INDEX,
+                       kernel::ValidationStage::FLUSH, kernel::ValidationStage::CHAINSTATE_WRITE, kernel::ValidationStage::POSTPROCESS}) {
+        sum += profile.stages[size_t(stage)];
+    }
+    BOOST_CHECK(sum <= profile.stages[size_t(kernel::ValidationStage::TOTAL)]);
+
+    // The history is a ring buffer.
+    metrics::Registry registry;
+    kernel::ValidationProfiler small{/*history=*/2, registry};
+    for (int height = 0; height < 3; ++height) {
+        small.BeginBlock();
+        small.Record(kernel::ValidationStage::CHECK, std::chrono::milliseconds{height});
+        small.EndBlock(uint256{uint8_t(height)}, height, /*tx_count=*/1);
+    }
+    small.RecordEnded(uint256{uint8_t(2)}, kernel::ValidationStage::NOTIFY, std::chrono::microseconds{5});
+    const auto small_history{small.GetHistory()};
+    BOOST_REQUIRE_EQUAL(small_history.size(), 2U);
+    BOOST_CHECK_EQUAL(small_history[0].height, 1);
+    BOOST_CHECK_EQUAL(small_history[1].height, 2);
+    BOOST_CHECK(small_history[1].stages[size_t(kernel::ValidationStage::CHECK)] == std::chrono::milliseconds{2});
+    BOOST_CHECK(small_history[1].stages[size_t(kernel::ValidationStage::NOTIFY)] == std::chrono::microseconds{5});
+    BOOST_CHECK_EQUAL(small.GetHistogram(kernel::ValidationStage::CHECK).Count(), 3U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
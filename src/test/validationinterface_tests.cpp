@@ -6,12 +6,16 @@
 #include <consensus/validation.h>
 #include <primitives/block.h>
 #include <scheduler.h>
+#include <test/util/logging.h>
 #include <test/util/setup_common.h>
 #include <util/check.h>
 #include <kernel/chain.h>
 #include <validationinterface.h>
 
 #include <atomic>
+#include <future>
+#include <string>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(validationinterface_tests, ChainTestingSetup)
 
@@ -101,4 +105,77 @@ BOOST_AUTO_TEST_CASE(unregister_all_during_call)
     BOOST_CHECK(destroyed);
 }
 
+class FlushRecorder final : public CValidationInterface
+{
+public:
+    FlushRecorder(std::string name, std::function<void(size_t)> on_flush) : m_name{std::move(name)}, m_on_flush{std::move(on_flush)} {}
+    void ChainStateFlushed(ChainstateRole, const CBlockLocator& locator) override
+    {
+        m_hashes.push_back(locator.vHave.front());
+        m_on_flush(m_hashes.size());
+    }
+    std::string ValidationInterfaceName() const override { return m_name; }
+
+    const std::string m_name;
+    const std::function<void(size_t)> m_on_flush;
+    //! Only accessed by the subscriber's notifications, or once they are synced.
+    std::vector<uint256> m_hashes;
+};
+
+BOOST_AUTO_TEST_CASE(per_subscriber_queues)
+{
+    CScheduler scheduler;
+    scheduler.m_service_thread = std::thread([&] { scheduler.serviceQueue(); });
+    scheduler.m_extra_service_threads.emplace_back([&] { scheduler.serviceQueue(); });
+    ValidationSignals signals{std::make_unique<ParallelTaskRunner>(scheduler), /*per_subscriber_queues=*/true};
+
+    constexpr size_t EVENTS{100};
+    std::promise<void> release;
+    std::shared_future<void> released{release.get_future()};
+    std::promise<void> fast_done;
+    // The slow subscriber is stuck in its first notification until released.
+    auto slow{std::make_shared<FlushRecorder>("slow", [&](size_t) { released.wait(); })};
+    auto fast{std::make_shared<FlushRecorder>("fast", [&](size_t count) { if (count == EVENTS) fast_done.set_value(); })};
+    signals.RegisterSharedValidationInterface(slow);
+    signals.RegisterSharedValidationInterface(fast);
+
+    std::vector<uint256> expected;
+    for (size_t i = 0; i < EVENTS; ++i) {
+        expected.emplace_back(uint8_t(i));
+        signals.ChainStateFlushed(ChainstateRole::NORMAL, CBlockLocator{{expected.back()}});
+    }
+
+    // The fast subscriber gets all its notifications while the slow one is stuck.
+    fast_done.get_future().wait();
+    for (const auto& queue : signals.GetSubscriberQueues()) {
+        BOOST_CHECK_EQUAL(queue.pending, queue.name == "slow" ? EVENTS - 1 : 0);
+    }
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), EVENTS - 1);
+
+    // Syncing waits for the slow subscriber too, and both saw the events in order.
+    release.set_value();
+    signals.SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(signals.CallbacksPending(), 0U);
+    BOOST_CHECK(slow->m_hashes == expected);
+    BOOST_CHECK(fast->m_hashes == expected);
+
+    // Notifications are only queued for subscribers registered at the time.
+    signals.UnregisterSharedValidationInterface(slow);
+    signals.ChainStateFlushed(ChainstateRole::NORMAL, CBlockLocator{{uint256::ONE}});
+    signals.SyncWithValidationInterfaceQueue();
+    BOOST_CHECK_EQUAL(slow->m_hashes.size(), EVENTS);
+    BOOST_CHECK_EQUAL(fast->m_hashes.size(), EVENTS + 1);
+    BOOST_CHECK_EQUAL(signals.GetSubscriberQueues().size(), 1U);
+
+    // Dispatching an event is logged, as it is without per-subscriber queues.
+    {
+        ASSERT_DEBUG_LOG("[validation] ChainStateFlushed: block hash=" + uint256::ONE.ToString());
+        signals.ChainStateFlushed(ChainstateRole::NORMAL, CBlockLocator{{uint256::ONE}});
+        signals.SyncWithValidationInterfaceQueue();
+    }
+
+    scheduler.stop();
+    signals.FlushBackgroundCallbacks();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
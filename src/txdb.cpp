@@ -15,6 +15,7 @@
 #include <uint256.h>
 #include <util/vector.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <iterator>
@@ -50,19 +51,25 @@ struct CoinEntry {
 CCoinsViewDB::CCoinsViewDB(DBParams db_params, CoinsViewOptions options) :
     m_db_params{std::move(db_params)},
     m_options{std::move(options)},
-    m_db{std::make_unique<CDBWrapper>(m_db_params)} { }
+    m_db{std::make_shared<CDBWrapper>(m_db_params)} { }
 
 void CCoinsViewDB::ResizeCache(size_t new_cache_size)
 {
     // We can't do this operation with an in-memory DB since we'll lose all the coins upon
     // reset.
     if (!m_db_params.memory_only) {
+        // The database can't be reopened while a snapshot keeps it open, and
+        // the resize is only an optimization, so skip it.
+        if (m_db.use_count() > 1) {
+            LogPrintf("Not resizing the coins database cache, a snapshot of it is in use\n");
+            return;
+        }
         // Have to do a reset first to get the original `m_db` state to release its
         // filesystem lock.
         m_db.reset();
         m_db_params.cache_bytes = new_cache_size;
         m_db_params.wipe_data = false;
-        m_db = std::make_unique<CDBWrapper>(m_db_params);
+        m_db = std::make_shared<CDBWrapper>(m_db_params);
     }
 }
 
@@ -177,25 +184,30 @@ private:
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
 
+    //! Position the cursor at the first coin.
+    void SeekToFirstCoin();
+
     friend class CCoinsViewDB;
+    friend class CCoinsViewDBSnapshot;
 };
 
-std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
+void CCoinsViewDBCursor::SeekToFirstCoin()
 {
-    auto i = std::make_unique<CCoinsViewDBCursor>(
-        const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
-    /* It seems that there are no "const iterators" for LevelDB.  Since we
-       only need read operations on it, use a const-cast to get around
-       that restriction.  */
-    i->pcursor->Seek(DB_COIN);
+    pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
+    if (pcursor->Valid()) {
+        CoinEntry entry(&keyTmp.second);
+        pcursor->GetKey(entry);
+        keyTmp.first = entry.key;
     } else {
-        i->keyTmp.first = 0; // Make sure Valid() and GetKey() return false
+        keyTmp.first = 0; // Make sure Valid() and GetKey() return false
     }
+}
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
+{
+    auto i = std::make_unique<CCoinsViewDBCursor>(m_db->NewIterator(), GetBestBlock());
+    i->SeekToFirstCoin();
     return i;
 }
 
@@ -229,3 +241,122 @@ void CCoinsViewDBCursor::Next()
         keyTmp.first = entry.key;
     }
 }
+
+std::unique_ptr<CCoinsViewDBSnapshot> CCoinsViewDB::GetSnapshot(std::vector<std::pair<COutPoint, Coin>> delta, const uint256& best_block) const
+{
+    return std::make_unique<CCoinsViewDBSnapshot>(m_db, std::move(delta), best_block);
+}
+
+static std::vector<std::pair<COutPoint, Coin>> SortedDelta(std::vector<std::pair<COutPoint, Coin>> delta)
+{
+    std::sort(delta.begin(), delta.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    return delta;
+}
+
+CCoinsViewDBSnapshot::CCoinsViewDBSnapshot(std::shared_ptr<const CDBWrapper> db, std::vector<std::pair<COutPoint, Coin>> delta, const uint256& best_block) :
+    m_db{std::move(db)},
+    m_snapshot{m_db->GetSnapshot()},
+    m_delta{SortedDelta(std::move(delta))},
+    m_best_block{best_block} {}
+
+const std::pair<COutPoint, Coin>* CCoinsViewDBSnapshot::FindDelta(const COutPoint& outpoint) const
+{
+    const auto it{std::lower_bound(m_delta.begin(), m_delta.end(), outpoint, [](const auto& entry, const COutPoint& key) { return entry.first < key; })};
+    if (it == m_delta.end() || it->first != outpoint) return nullptr;
+    return &*it;
+}
+
+std::optional<Coin> CCoinsViewDBSnapshot::GetCoin(const COutPoint& outpoint) const
+{
+    if (const auto* entry{FindDelta(outpoint)}) {
+        if (entry->second.IsSpent()) return std::nullopt;
+        return entry->second;
+    }
+    if (Coin coin; m_snapshot->Read(CoinEntry(&outpoint), coin)) return coin;
+    return std::nullopt;
+}
+
+bool CCoinsViewDBSnapshot::HaveCoin(const COutPoint& outpoint) const
+{
+    if (const auto* entry{FindDelta(outpoint)}) return !entry->second.IsSpent();
+    return m_snapshot->Exists(CoinEntry(&outpoint));
+}
+
+size_t CCoinsViewDBSnapshot::EstimateSize() const
+{
+    return m_db->EstimateSize(DB_COIN, uint8_t(DB_COIN + 1));
+}
+
+namespace {
+/**
+ * Merges the sorted delta of a CCoinsViewDBSnapshot into a cursor over its
+ * database snapshot. Both are in outpoint order, since the database key
+ * serializes the txid followed by an order-preserving VARINT of the index.
+ * A delta entry replaces the database entry for the same outpoint, and
+ * spent delta entries are skipped.
+ */
+class CCoinsViewDBSnapshotCursor : public CCoinsViewCursor
+{
+    std::unique_ptr<CCoinsViewCursor> m_db_cursor;
+    std::vector<std::pair<COutPoint, Coin>>::const_iterator m_delta_it;
+    const std::vector<std::pair<COutPoint, Coin>>::const_iterator m_delta_end;
+    //! Whether the current entry comes from the delta rather than the database.
+    bool m_at_delta{false};
+
+    //! Advance past spent delta entries and database entries they replace.
+    void Settle()
+    {
+        for (; m_delta_it != m_delta_end; ++m_delta_it) {
+            COutPoint db_key;
+            const bool db_valid{m_db_cursor->GetKey(db_key)};
+            if (db_valid && db_key < m_delta_it->first) break;
+            if (db_valid && db_key == m_delta_it->first) m_db_cursor->Next();
+            if (!m_delta_it->second.IsSpent()) {
+                m_at_delta = true;
+                return;
+            }
+        }
+        m_at_delta = false;
+    }
+
+public:
+    CCoinsViewDBSnapshotCursor(std::unique_ptr<CCoinsViewCursor> db_cursor, const std::vector<std::pair<COutPoint, Coin>>& delta, const uint256& hash_block) :
+        CCoinsViewCursor(hash_block), m_db_cursor{std::move(db_cursor)}, m_delta_it{delta.begin()}, m_delta_end{delta.end()}
+    {
+        Settle();
+    }
+
+    bool GetKey(COutPoint& key) const override
+    {
+        if (!m_at_delta) return m_db_cursor->GetKey(key);
+        key = m_delta_it->first;
+        return true;
+    }
+
+    bool GetValue(Coin& coin) const override
+    {
+        if (!m_at_delta) return m_db_cursor->GetValue(coin);
+        coin = m_delta_it->second;
+        return true;
+    }
+
+    bool Valid() const override { return m_at_delta || m_db_cursor->Valid(); }
+
+    void Next() override
+    {
+        if (m_at_delta) {
+            ++m_delta_it;
+        } else {
+            m_db_cursor->Next();
+        }
+        Settle();
+    }
+};
+} // namespace
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewDBSnapshot::Cursor() const
+{
+    auto db_cursor{std::make_unique<CCoinsViewDBCursor>(m_snapshot->NewIterator(), m_best_block)};
+    db_cursor->SeekToFirstCoin();
+    return std::make_unique<CCoinsViewDBSnapshotCursor>(std::move(db_cursor), m_delta, m_best_block);
+}
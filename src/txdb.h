@@ -16,6 +16,7 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <utility>
 #include <vector>
 
 class COutPoint;
@@ -33,13 +34,16 @@ struct CoinsViewOptions {
     int simulate_crash_ratio = 0;
 };
 
+class CCoinsViewDBSnapshot;
+
 /** CCoinsView backed by the coin database (chainstate/) */
 class CCoinsViewDB final : public CCoinsView
 {
 protected:
     DBParams m_db_params;
     CoinsViewOptions m_options;
-    std::unique_ptr<CDBWrapper> m_db;
+    //! Shared with any CCoinsViewDBSnapshot taken from it, which keep it open.
+    std::shared_ptr<CDBWrapper> m_db;
 public:
     explicit CCoinsViewDB(DBParams db_params, CoinsViewOptions options);
 
@@ -57,8 +61,55 @@ public:
     //! Dynamically alter the underlying leveldb cache size.
     void ResizeCache(size_t new_cache_size) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Take a read-only snapshot of the database, with the not yet flushed
+     * changes in delta (see CCoinsViewCache::GetDirtyCoins()) applied on top.
+     * The caller must make sure no flush runs concurrently, which holding
+     * cs_main does.
+     *
+     * @param[in] delta       Unflushed cache entries; spent coins mark deletions.
+     * @param[in] best_block  The block the database plus delta correspond to.
+     */
+    std::unique_ptr<CCoinsViewDBSnapshot> GetSnapshot(std::vector<std::pair<COutPoint, Coin>> delta, const uint256& best_block) const
+        EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
     //! @returns filesystem path to on-disk storage or std::nullopt if in memory.
     std::optional<fs::path> StoragePath() { return m_db->StoragePath(); }
+
+    //! Estimate of the memory used by LevelDB for the coin database, in bytes.
+    size_t DynamicMemoryUsage() const { return m_db->DynamicMemoryUsage(); }
+};
+
+/**
+ * Consistent, read-only view of the UTXO set at one block: a LevelDB
+ * snapshot of the coin database plus an immutable copy of the cache entries
+ * that were not yet flushed to it. Nothing in it changes after construction,
+ * so it can be read from any number of threads without holding cs_main,
+ * in parallel with block validation.
+ */
+class CCoinsViewDBSnapshot final : public CCoinsView
+{
+    const std::shared_ptr<const CDBWrapper> m_db;
+    const std::unique_ptr<CDBSnapshot> m_snapshot;
+    //! Sorted by outpoint, matching the database key order.
+    const std::vector<std::pair<COutPoint, Coin>> m_delta;
+    const uint256 m_best_block;
+
+    //! Return the delta entry for outpoint, or nullptr if the database copy applies.
+    const std::pair<COutPoint, Coin>* FindDelta(const COutPoint& outpoint) const;
+
+public:
+    CCoinsViewDBSnapshot(std::shared_ptr<const CDBWrapper> db, std::vector<std::pair<COutPoint, Coin>> delta, const uint256& best_block);
+
+    std::optional<Coin> GetCoin(const COutPoint& outpoint) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    uint256 GetBestBlock() const override { return m_best_block; }
+    //! Iterate over all unspent coins, in outpoint order.
+    std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    size_t EstimateSize() const override;
+
+    //! Number of cache entries layered on top of the database snapshot.
+    size_t DeltaSize() const { return m_delta.size(); }
 };
 
 #endif // BITCOIN_TXDB_H
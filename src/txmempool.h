@@ -670,6 +670,8 @@ public:
     std::vector<TxMempoolInfo> infoAll() const;
 
     size_t DynamicMemoryUsage() const;
+    /** The part of DynamicMemoryUsage() used by the indexes and maps of the mempool, rather than the transactions */
+    size_t IndexMemoryUsage() const;
 
     /** Adds a transaction to the unbroadcast set */
     void AddUnbroadcastTx(const uint256& txid)
@@ -5,7 +5,9 @@
 #include <txorphanage.h>
 
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <logging.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <util/time.h>
@@ -361,3 +363,19 @@ void TxOrphanage::SanityCheck() const
         }
     }
 }
+
+size_t TxOrphanage::DynamicMemoryUsage() const
+{
+    size_t usage{memusage::DynamicUsage(m_orphans) + memusage::DynamicUsage(m_outpoint_to_orphan_it) +
+                 memusage::DynamicUsage(m_orphan_list) + memusage::DynamicUsage(m_peer_orphanage_info)};
+    for (const auto& [wtxid, orphan] : m_orphans) {
+        usage += RecursiveDynamicUsage(orphan.tx) + memusage::DynamicUsage(orphan.announcers);
+    }
+    for (const auto& [outpoint, orphans] : m_outpoint_to_orphan_it) {
+        usage += memusage::DynamicUsage(orphans);
+    }
+    for (const auto& [peer, info] : m_peer_orphanage_info) {
+        usage += memusage::DynamicUsage(info.m_work_set);
+    }
+    return usage;
+}
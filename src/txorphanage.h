@@ -109,6 +109,10 @@ public:
      * match what is cached. */
     void SanityCheck() const;
 
+    /** Approximate memory used by the orphans and the maps that index them, in bytes. Unlike
+     * TotalOrphanUsage(), this is heap memory rather than weight. */
+    size_t DynamicMemoryUsage() const;
+
 protected:
     struct OrphanTx : public OrphanTxBase {
         size_t list_pos;
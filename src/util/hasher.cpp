@@ -8,15 +8,37 @@
 #include <span.h>
 #include <util/hasher.h>
 
+#include <algorithm>
+#include <array>
+
 SaltedTxidHasher::SaltedTxidHasher() :
     k0{FastRandomContext().rand64()},
     k1{FastRandomContext().rand64()} {}
 
+/** The batched hashers work in chunks, so the scratch space fits on the stack. */
+static constexpr size_t HASH_MANY_CHUNK{64};
+
 SaltedOutpointHasher::SaltedOutpointHasher(bool deterministic) :
     k0{deterministic ? 0x8e819f2607a18de6 : FastRandomContext().rand64()},
     k1{deterministic ? 0xf4020d2e3983b0eb : FastRandomContext().rand64()}
 {}
 
+void SaltedOutpointHasher::HashMany(Span<const COutPoint> ids, size_t* out) const noexcept
+{
+    std::array<const uint256*, HASH_MANY_CHUNK> vals;
+    std::array<uint32_t, HASH_MANY_CHUNK> extras;
+    std::array<uint64_t, HASH_MANY_CHUNK> hashes;
+    for (size_t begin = 0; begin < ids.size(); begin += HASH_MANY_CHUNK) {
+        const size_t n{std::min(HASH_MANY_CHUNK, ids.size() - begin)};
+        for (size_t i = 0; i < n; ++i) {
+            vals[i] = &ids[begin + i].hash.ToUint256();
+            extras[i] = ids[begin + i].n;
+        }
+        SipHashUint256ExtraMany(k0, k1, Span{vals}.first(n), Span{extras}.first(n), hashes.data());
+        std::copy_n(hashes.begin(), n, out + begin);
+    }
+}
+
 SaltedSipHasher::SaltedSipHasher() :
     m_k0{FastRandomContext().rand64()},
     m_k1{FastRandomContext().rand64()} {}
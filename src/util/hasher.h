@@ -50,6 +50,9 @@ public:
     size_t operator()(const COutPoint& id) const noexcept {
         return SipHashUint256Extra(k0, k1, id.hash, id.n);
     }
+
+    /** Hash several outpoints at once: out[i] = operator()(ids[i]). */
+    void HashMany(Span<const COutPoint> ids, size_t* out) const noexcept;
 };
 
 struct FilterHeaderHasher
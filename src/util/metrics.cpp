@@ -0,0 +1,167 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/metrics.h>
+
+#include <tinyformat.h>
+#include <util/check.h>
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace metrics {
+
+Registry& GetRegistry()
+{
+    static Registry g_registry;
+    return g_registry;
+}
+
+Metric::Metric(Registry& registry, std::string name, std::string help, std::string labels, Type type)
+    : m_registry{registry}, m_name{std::move(name)}, m_help{std::move(help)}, m_labels{std::move(labels)}, m_type{type}
+{
+    m_registry.Add(*this);
+}
+
+Metric::~Metric()
+{
+    m_registry.Remove(*this);
+}
+
+namespace {
+std::string FormatValue(double value)
+{
+    if (std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+    return strprintf("%.10g", value);
+}
+
+/** Append one sample line, merging the metric's labels with an extra one. */
+void AppendSample(std::string& out, const std::string& name, const std::string& labels, const std::string& extra_label, const std::string& value)
+{
+    out += name;
+    if (!labels.empty() || !extra_label.empty()) {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra_label.empty()) out += ',';
+        out += extra_label;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+const char* TypeName(Metric::Type type)
+{
+    switch (type) {
+    case Metric::Type::COUNTER: return "counter";
+    case Metric::Type::GAUGE: return "gauge";
+    case Metric::Type::HISTOGRAM: return "histogram";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+} // namespace
+
+void Counter::Render(std::string& out) const
+{
+    AppendSample(out, Name(), Labels(), {}, m_scale == 1.0 ? std::to_string(Get()) : FormatValue(Get() * m_scale));
+}
+
+void Gauge::Render(std::string& out) const
+{
+    AppendSample(out, Name(), Labels(), {}, std::to_string(Get()));
+}
+
+void Callback::Render(std::string& out) const
+{
+    AppendSample(out, Name(), Labels(), {}, FormatValue(m_fn()));
+}
+
+Histogram::Histogram(std::string name, std::string help, std::vector<uint64_t> bounds, double scale, std::string labels, Registry& registry)
+    : Metric(registry, std::move(name), std::move(help), std::move(labels), Type::HISTOGRAM),
+      m_bounds{std::move(bounds)},
+      m_scale{scale},
+      m_counts{std::make_unique<std::atomic<uint64_t>[]>(m_bounds.size() + 1)}
+{
+    Assume(std::is_sorted(m_bounds.begin(), m_bounds.end()));
+}
+
+uint64_t Histogram::Count() const
+{
+    uint64_t count{0};
+    for (size_t i = 0; i <= m_bounds.size(); ++i) count += BucketCount(i);
+    return count;
+}
+
+uint64_t Histogram::Quantile(double q) const
+{
+    const uint64_t count{Count()};
+    if (count == 0) return 0;
+    const auto target{static_cast<uint64_t>(std::ceil(q * count))};
+    uint64_t cumulative{0};
+    for (size_t i = 0; i < m_bounds.size(); ++i) {
+        cumulative += BucketCount(i);
+        if (cumulative >= target) return m_bounds[i];
+    }
+    return std::numeric_limits<uint64_t>::max();
+}
+
+void Histogram::Render(std::string& out) const
+{
+    // Buckets are read one by one while observations may be going on, so the
+    // count is taken as the final cumulative bucket count to stay consistent.
+    uint64_t cumulative{0};
+    for (size_t i = 0; i < m_bounds.size(); ++i) {
+        cumulative += BucketCount(i);
+        AppendSample(out, Name() + "_bucket", Labels(), strprintf("le=\"%s\"", FormatValue(m_bounds[i] * m_scale)), std::to_string(cumulative));
+    }
+    cumulative += BucketCount(m_bounds.size());
+    AppendSample(out, Name() + "_bucket", Labels(), "le=\"+Inf\"", std::to_string(cumulative));
+    AppendSample(out, Name() + "_sum", Labels(), {}, FormatValue(Sum() * m_scale));
+    AppendSample(out, Name() + "_count", Labels(), {}, std::to_string(cumulative));
+}
+
+std::vector<uint64_t> ExponentialBuckets(uint64_t start, double factor, size_t count)
+{
+    std::vector<uint64_t> bounds;
+    bounds.reserve(count);
+    double bound = start;
+    for (size_t i = 0; i < count; ++i) {
+        const auto rounded{static_cast<uint64_t>(std::llround(bound))};
+        if (bounds.empty() || rounded > bounds.back()) bounds.push_back(rounded);
+        bound *= factor;
+    }
+    return bounds;
+}
+
+void Registry::Add(const Metric& metric)
+{
+    LOCK(m_mutex);
+    m_metrics.push_back(&metric);
+}
+
+void Registry::Remove(const Metric& metric)
+{
+    LOCK(m_mutex);
+    std::erase(m_metrics, &metric);
+}
+
+std::string Registry::Render() const
+{
+    LOCK(m_mutex);
+    std::vector<const Metric*> metrics{m_metrics};
+    std::stable_sort(metrics.begin(), metrics.end(), [](const Metric* a, const Metric* b) { return a->Name() < b->Name(); });
+    std::string out;
+    for (size_t i = 0; i < metrics.size(); ++i) {
+        const Metric& metric{*metrics[i]};
+        if (i == 0 || metrics[i - 1]->Name() != metric.Name()) {
+            out += strprintf("# HELP %s %s\n# TYPE %s %s\n", metric.Name(), metric.Help(), metric.Name(), TypeName(metric.GetType()));
+        }
+        metric.Render(out);
+    }
+    return out;
+}
+
+} // namespace metrics
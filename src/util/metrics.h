@@ -0,0 +1,183 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_METRICS_H
+#define BITCOIN_UTIL_METRICS_H
+
+#include <sync.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Process-wide metrics, exported in the Prometheus text exposition format.
+ *
+ * Counter, Gauge and Histogram are updated with relaxed atomic operations, so
+ * they are cheap enough for hot paths, and can be read at any time without
+ * the locks of the code that updates them. A metric registers itself with a
+ * Registry when constructed and unregisters when destroyed; most are defined
+ * at namespace scope in the file that updates them.
+ */
+namespace metrics {
+
+class Registry;
+
+//! The registry that is served at the /metrics HTTP endpoint.
+Registry& GetRegistry();
+
+/** Base class of all metrics: a name, help text and label set. */
+class Metric
+{
+public:
+    enum class Type { COUNTER, GAUGE, HISTOGRAM };
+
+    /**
+     * @param[in] name    Metric name, e.g. "atcoin_mempool_accept_seconds".
+     * @param[in] help    One-line description.
+     * @param[in] labels  Label set without braces, e.g. R"(stage="check")". Metrics
+     *                    sharing a name must have the same type and help text.
+     */
+    Metric(Registry& registry, std::string name, std::string help, std::string labels, Type type);
+    virtual ~Metric();
+
+    Metric(const Metric&) = delete;
+    Metric& operator=(const Metric&) = delete;
+
+    const std::string& Name() const { return m_name; }
+    const std::string& Help() const { return m_help; }
+    const std::string& Labels() const { return m_labels; }
+    Type GetType() const { return m_type; }
+
+    //! Append the sample lines of this metric to out.
+    virtual void Render(std::string& out) const = 0;
+
+private:
+    Registry& m_registry;
+    const std::string m_name;
+    const std::string m_help;
+    const std::string m_labels;
+    const Type m_type;
+};
+
+/** A monotonically increasing count, rendered multiplied by scale. */
+class Counter final : public Metric
+{
+    std::atomic<uint64_t> m_value{0};
+    const double m_scale;
+
+public:
+    Counter(std::string name, std::string help, std::string labels = {}, double scale = 1.0, Registry& registry = GetRegistry())
+        : Metric(registry, std::move(name), std::move(help), std::move(labels), Type::COUNTER), m_scale{scale} {}
+
+    void Inc(uint64_t n = 1) noexcept { m_value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t Get() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+    void Render(std::string& out) const override;
+};
+
+/** A value that can go up and down. */
+class Gauge final : public Metric
+{
+    std::atomic<int64_t> m_value{0};
+
+public:
+    Gauge(std::string name, std::string help, std::string labels = {}, Registry& registry = GetRegistry())
+        : Metric(registry, std::move(name), std::move(help), std::move(labels), Type::GAUGE) {}
+
+    void Set(int64_t value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+    void Add(int64_t n) noexcept { m_value.fetch_add(n, std::memory_order_relaxed); }
+    int64_t Get() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+    void Render(std::string& out) const override;
+};
+
+/**
+ * A metric whose value is computed when rendered. The callback runs on the
+ * thread serving the scrape, and so must not take locks that are held for
+ * long, such as cs_main.
+ */
+class Callback final : public Metric
+{
+    const std::function<double()> m_fn;
+
+public:
+    Callback(std::string name, std::string help, Type type, std::function<double()> fn, std::string labels = {}, Registry& registry = GetRegistry())
+        : Metric(registry, std::move(name), std::move(help), std::move(labels), type), m_fn{std::move(fn)} {}
+
+    void Render(std::string& out) const override;
+};
+
+/**
+ * Distribution of integer observations (e.g. microseconds) over fixed
+ * buckets. Bucket bounds are inclusive upper bounds; observations above the
+ * last one land in an implicit +Inf bucket. Bounds and the sum are rendered
+ * multiplied by scale, so microseconds can be exported as seconds.
+ */
+class Histogram final : public Metric
+{
+    const std::vector<uint64_t> m_bounds;
+    const double m_scale;
+    //! Non-cumulative counts, one per bound plus the +Inf bucket.
+    const std::unique_ptr<std::atomic<uint64_t>[]> m_counts;
+    std::atomic<uint64_t> m_sum{0};
+
+public:
+    Histogram(std::string name, std::string help, std::vector<uint64_t> bounds, double scale = 1.0, std::string labels = {}, Registry& registry = GetRegistry());
+
+    void Observe(uint64_t value) noexcept
+    {
+        const size_t bucket = std::lower_bound(m_bounds.begin(), m_bounds.end(), value) - m_bounds.begin();
+        m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    //! Observe a duration in microseconds.
+    template <typename Rep, typename Period>
+    void ObserveDuration(std::chrono::duration<Rep, Period> duration) noexcept
+    {
+        Observe(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+    }
+
+    const std::vector<uint64_t>& Bounds() const { return m_bounds; }
+    //! Non-cumulative count of the given bucket; bucket == Bounds().size() is +Inf.
+    uint64_t BucketCount(size_t bucket) const { return m_counts[bucket].load(std::memory_order_relaxed); }
+    uint64_t Count() const;
+    uint64_t Sum() const { return m_sum.load(std::memory_order_relaxed); }
+
+    //! Smallest bound below which at least fraction q of the observations lie, or
+    //! UINT64_MAX if that is in the +Inf bucket. Zero without observations.
+    uint64_t Quantile(double q) const;
+
+    void Render(std::string& out) const override;
+};
+
+//! count bucket bounds: start, start * factor, start * factor^2, ...
+std::vector<uint64_t> ExponentialBuckets(uint64_t start, double factor, size_t count);
+
+/** The set of live metrics, and their rendering. */
+class Registry
+{
+    mutable Mutex m_mutex;
+    std::vector<const Metric*> m_metrics GUARDED_BY(m_mutex);
+
+public:
+    void Add(const Metric& metric) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void Remove(const Metric& metric) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Render all metrics in the Prometheus text exposition format, grouped by
+     * name. Metrics can't be destroyed while this runs.
+     */
+    std::string Render() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+} // namespace metrics
+
+#endif // BITCOIN_UTIL_METRICS_H
@@ -54,6 +54,7 @@
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/hasher.h>
+#include <util/metrics.h>
 #include <util/moneystr.h>
 #include <util/rbf.h>
 #include <util/result.h>
@@ -81,6 +82,7 @@ using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
 using kernel::ComputeUTXOStats;
 using kernel::Notifications;
+using kernel::ValidationStage;
 
 using fsbridge::FopenFn;
 using node::BlockManager;
@@ -114,9 +116,31 @@ static constexpr int PRUNE_LOCK_BUFFER{10};
 
 TRACEPOINT_SEMAPHORE(validation, block_connected);
 TRACEPOINT_SEMAPHORE(utxocache, flush);
+TRACEPOINT_SEMAPHORE(validation, block_data_flushed);
 TRACEPOINT_SEMAPHORE(mempool, replaced);
 TRACEPOINT_SEMAPHORE(mempool, rejected);
 
+namespace {
+/** Running total and per-block average of a stage, for the BCLog::BENCH log. */
+std::string StageTotals(const kernel::ValidationProfiler& profiler, ValidationStage stage)
+{
+    const metrics::Histogram& histogram{profiler.GetHistogram(stage)};
+    const uint64_t count{histogram.Count()};
+    return strprintf("[%.2fs (%.2fms/blk)]", histogram.Sum() * 1e-6, count == 0 ? 0.0 : histogram.Sum() * 1e-3 / count);
+}
+
+metrics::Counter g_coins_cache_hits{"atcoin_coins_cache_lookups_total", "UTXO cache lookups, by whether the coin was already cached", R"(result="hit")"};
+metrics::Counter g_coins_cache_misses{"atcoin_coins_cache_lookups_total", "UTXO cache lookups, by whether the coin was already cached", R"(result="miss")"};
+metrics::Gauge g_coins_cache_bytes{"atcoin_coins_cache_bytes", "Memory usage of the UTXO cache of the active chainstate"};
+metrics::Gauge g_coins_cache_entries{"atcoin_coins_cache_entries", "Number of entries in the UTXO cache of the active chainstate"};
+metrics::Gauge g_chain_height{"atcoin_chain_height", "Height of the active chain tip"};
+
+metrics::Histogram g_mempool_accept_time{"atcoin_mempool_accept_seconds", "Time taken to evaluate a transaction for the mempool",
+                                         metrics::ExponentialBuckets(/*start=*/10, /*factor=*/2, /*count=*/18), /*scale=*/1e-6};
+metrics::Counter g_mempool_accepted{"atcoin_mempool_accept_total", "Transactions evaluated for the mempool, by result", R"(result="accepted")"};
+metrics::Counter g_mempool_rejected{"atcoin_mempool_accept_total", "Transactions evaluated for the mempool, by result", R"(result="rejected")"};
+} // namespace
+
 const CBlockIndex* Chainstate::FindForkInGlobalIndex(const CBlockLocator& locator) const
 {
     AssertLockHeld(cs_main);
@@ -1884,9 +1908,12 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
     assert(active_chainstate.GetMempool() != nullptr);
     CTxMemPool& pool{*active_chainstate.GetMempool()};
 
+    const auto time_start{SteadyClock::now()};
     std::vector<COutPoint> coins_to_uncache;
     auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept);
     MempoolAcceptResult result = MemPoolAccept(pool, active_chainstate).AcceptSingleTransaction(tx, args);
+    g_mempool_accept_time.ObserveDuration(SteadyClock::now() - time_start);
+    (result.m_result_type == MempoolAcceptResult::ResultType::VALID ? g_mempool_accepted : g_mempool_rejected).Inc();
     if (result.m_result_type != MempoolAcceptResult::ResultType::VALID) {
         // Remove coins that were not present in the coins cache before calling
         // AcceptSingleTransaction(); this is to prevent memory DoS in case we receive a large
@@ -2007,6 +2034,7 @@ void Chainstate::InitCoinsCache(size_t cache_size_bytes)
     assert(m_coins_views != nullptr);
     m_coinstip_cache_size_bytes = cache_size_bytes;
     m_coins_views->InitCache();
+    m_coins_views->m_cacheview->SetLookupCounters(&g_coins_cache_hits, &g_coins_cache_misses);
 }
 
 // Note that though this is marked const, we may end up modifying `m_cached_finished_ibd`, which
@@ -2479,8 +2507,6 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     uint256 hashPrevBlock = pindex->pprev == nullptr ? uint256() : pindex->pprev->GetBlockHash();
     assert(hashPrevBlock == view.GetBestBlock());
 
-    m_chainman.num_blocks_total++;
-
     // Special case for the genesis block, skipping connection of its transactions
     // (its coinbase is unspendable)
     if (block_hash == params.GetConsensus().hashGenesisBlock) {
@@ -2521,11 +2547,10 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
 
     const auto time_1{SteadyClock::now()};
-    m_chainman.time_check += time_1 - time_start;
-    LogDebug(BCLog::BENCH, "    - Sanity checks: %.2fms [%.2fs (%.2fms/blk)]\n",
+    m_chainman.m_validation_profiler.Record(ValidationStage::CHECK, time_1 - time_start);
+    LogDebug(BCLog::BENCH, "    - Sanity checks: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_1 - time_start),
-             Ticks<SecondsDouble>(m_chainman.time_check),
-             Ticks<MillisecondsDouble>(m_chainman.time_check) / m_chainman.num_blocks_total);
+             StageTotals(m_chainman.m_validation_profiler, ValidationStage::CHECK));
 
     // Do not allow blocks that contain transactions which 'overwrite' older transactions,
     // unless those are already completely spent.
@@ -2623,11 +2648,10 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     unsigned int flags{GetBlockScriptFlags(*pindex, m_chainman)};
 
     const auto time_2{SteadyClock::now()};
-    m_chainman.time_forks += time_2 - time_1;
-    LogDebug(BCLog::BENCH, "    - Fork checks: %.2fms [%.2fs (%.2fms/blk)]\n",
+    m_chainman.m_validation_profiler.Record(ValidationStage::FORKS, time_2 - time_1);
+    LogDebug(BCLog::BENCH, "    - Fork checks: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_2 - time_1),
-             Ticks<SecondsDouble>(m_chainman.time_forks),
-             Ticks<MillisecondsDouble>(m_chainman.time_forks) / m_chainman.num_blocks_total);
+             StageTotals(m_chainman.m_validation_profiler, ValidationStage::FORKS));
 
     CBlockUndo blockundo;
 
@@ -2715,12 +2739,11 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         UpdateCoins(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
     }
     const auto time_3{SteadyClock::now()};
-    m_chainman.time_connect += time_3 - time_2;
-    LogDebug(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) [%.2fs (%.2fms/blk)]\n", (unsigned)block.vtx.size(),
+    m_chainman.m_validation_profiler.Record(ValidationStage::UTXO_FETCH, time_3 - time_2);
+    LogDebug(BCLog::BENCH, "      - Connect %u transactions: %.2fms (%.3fms/tx, %.3fms/txin) %s\n", (unsigned)block.vtx.size(),
              Ticks<MillisecondsDouble>(time_3 - time_2), Ticks<MillisecondsDouble>(time_3 - time_2) / block.vtx.size(),
              nInputs <= 1 ? 0 : Ticks<MillisecondsDouble>(time_3 - time_2) / (nInputs - 1),
-             Ticks<SecondsDouble>(m_chainman.time_connect),
-             Ticks<MillisecondsDouble>(m_chainman.time_connect) / m_chainman.num_blocks_total);
+             StageTotals(m_chainman.m_validation_profiler, ValidationStage::UTXO_FETCH));
 
     CAmount blockReward = nFees + GetBlockSubsidy(pindex->nHeight, params.GetConsensus());
     if (block.vtx[0]->GetValueOut() > blockReward && state.IsValid()) {
@@ -2737,12 +2760,12 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
         return false;
     }
     const auto time_4{SteadyClock::now()};
-    m_chainman.time_verify += time_4 - time_2;
-    LogDebug(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin) [%.2fs (%.2fms/blk)]\n", nInputs - 1,
+    m_chainman.m_validation_profiler.Record(ValidationStage::SCRIPT_CHECK, time_4 - time_3);
+    LogDebug(BCLog::BENCH, "    - Verify %u txins: %.2fms (%.3fms/txin), waited %.2fms for script checks %s\n", nInputs - 1,
              Ticks<MillisecondsDouble>(time_4 - time_2),
              nInputs <= 1 ? 0 : Ticks<MillisecondsDouble>(time_4 - time_2) / (nInputs - 1),
-             Ticks<SecondsDouble>(m_chainman.time_verify),
-             Ticks<MillisecondsDouble>(m_chainman.time_verify) / m_chainman.num_blocks_total);
+             Ticks<MillisecondsDouble>(time_4 - time_3),
+             StageTotals(m_chainman.m_validation_profiler, ValidationStage::SCRIPT_CHECK));
 
     if (fJustCheck) {
         return true;
@@ -2753,11 +2776,10 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     }
 
     const auto time_5{SteadyClock::now()};
-    m_chainman.time_undo += time_5 - time_4;
-    LogDebug(BCLog::BENCH, "    - Write undo data: %.2fms [%.2fs (%.2fms/blk)]\n",
+    m_chainman.m_validation_profiler.Record(ValidationStage::UNDO_WRITE, time_5 - time_4);
+    LogDebug(BCLog::BENCH, "    - Write undo data: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_5 - time_4),
-             Ticks<SecondsDouble>(m_chainman.time_undo),
-             Ticks<MillisecondsDouble>(m_chainman.time_undo) / m_chainman.num_blocks_total);
+             StageTotals(m_chainman.m_validation_profiler, ValidationStage::UNDO_WRITE));
 
     if (!pindex->IsValid(BLOCK_VALID_SCRIPTS)) {
         pindex->RaiseValidity(BLOCK_VALID_SCRIPTS);
@@ -2768,11 +2790,10 @@ bool Chainstate::ConnectBlock(const CBlock& block, BlockValidationState& state,
     view.SetBestBlock(pindex->GetBlockHash());
 
     const auto time_6{SteadyClock::now()};
-    m_chainman.time_index += time_6 - time_5;
-    LogDebug(BCLog::BENCH, "    - Index writing: %.2fms [%.2fs (%.2fms/blk)]\n",
+    m_chainman.m_validation_profiler.Record(ValidationStage::INDEX, time_6 - time_5);
+    LogDebug(BCLog::BENCH, "    - Index writing: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_6 - time_5),
-             Ticks<SecondsDouble>(m_chainman.time_index),
-             Ticks<MillisecondsDouble>(m_chainman.time_index) / m_chainman.num_blocks_total);
+             StageTotals(m_chainman.m_validation_profiler, ValidationStage::INDEX));
 
     TRACEPOINT(validation, block_connected,
         block_hash.data(),
@@ -2903,6 +2924,7 @@ bool Chainstate::FlushStateToDisk(
             if (!CheckDiskSpace(m_blockman.m_opts.blocks_dir)) {
                 return FatalError(m_chainman.GetNotifications(), state, _("Disk space is too low!"));
             }
+            const auto time_start{SteadyClock::now()};
             {
                 LOG_TIME_MILLIS_WITH_CATEGORY("write block and undo data to disk", BCLog::BENCH);
 
@@ -2913,6 +2935,7 @@ bool Chainstate::FlushStateToDisk(
                     LogPrintLevel(BCLog::VALIDATION, BCLog::Level::Warning, "%s: Failed to flush block file.\n", __func__);
                 }
             }
+            const auto time_block_files{SteadyClock::now()};
 
             // Then update all block file information (which may refer to block and undo files).
             {
@@ -2922,12 +2945,19 @@ bool Chainstate::FlushStateToDisk(
                     return FatalError(m_chainman.GetNotifications(), state, _("Failed to write to block index database."));
                 }
             }
+            const auto time_block_index{SteadyClock::now()};
             // Finally remove any pruned files
             if (fFlushForPrune) {
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
                 m_blockman.UnlinkPrunedFiles(setFilesToPrune);
             }
+            TRACEPOINT(validation, block_data_flushed,
+                   int64_t{Ticks<std::chrono::microseconds>(time_block_files - time_start)},
+                   int64_t{Ticks<std::chrono::microseconds>(time_block_index - time_block_files)},
+                   int64_t{Ticks<std::chrono::microseconds>(SteadyClock::now() - time_block_index)},
+                   (uint64_t)setFilesToPrune.size(),
+                   (uint32_t)mode);
             m_last_write = nNow;
         }
         // Flush best chain related state. This can only be done if the blocks / block index write was also done.
@@ -2969,6 +2999,29 @@ bool Chainstate::FlushStateToDisk(
     return true;
 }
 
+std::shared_ptr<const CoinsTipSnapshot> Chainstate::GetCoinsTipSnapshot()
+{
+    {
+        LOCK(m_coins_tip_snapshot_mutex);
+        if (m_coins_tip_snapshot) return m_coins_tip_snapshot;
+    }
+    // Holding cs_main keeps the cache and the database consistent with each
+    // other, and with the tip, while the snapshot is taken.
+    LOCK(::cs_main);
+    if (CoinsTip().GetDirtyCount() > MAX_COINS_TIP_SNAPSHOT_DELTA) {
+        // Rather than copying an unbounded number of entries while holding
+        // cs_main, write them out, which has to happen at some point anyway.
+        ForceFlushStateToDisk();
+    }
+    LOCK(m_coins_tip_snapshot_mutex);
+    if (!m_coins_tip_snapshot) {
+        const CCoinsViewCache& coins_tip{CoinsTip()};
+        m_coins_tip_snapshot = std::make_shared<const CoinsTipSnapshot>(
+            m_chain.Tip(), CoinsDB().GetSnapshot(coins_tip.GetDirtyCoins(), coins_tip.GetBestBlock()));
+    }
+    return m_coins_tip_snapshot;
+}
+
 void Chainstate::ForceFlushStateToDisk()
 {
     BlockValidationState state;
@@ -3010,6 +3063,7 @@ static void UpdateTipLog(
 void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
 {
     AssertLockHeld(::cs_main);
+    ResetCoinsTipSnapshot();
     const auto& coins_tip = this->CoinsTip();
 
     // The remainder of the function isn't relevant if we are not acting on
@@ -3027,6 +3081,9 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
     if (m_mempool) {
         m_mempool->AddTransactionsUpdated(1);
     }
+    g_chain_height.Set(pindexNew->nHeight);
+    g_coins_cache_bytes.Set(coins_tip.DynamicMemoryUsage());
+    g_coins_cache_entries.Set(coins_tip.GetCacheSize());
 
     std::vector<bilingual_str> warning_messages;
     if (!m_chainman.IsInitialBlockDownload()) {
@@ -3175,6 +3232,8 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     if (m_mempool) AssertLockHeld(m_mempool->cs);
 
     assert(pindexNew->pprev == m_chain.Tip());
+    kernel::ValidationProfiler& profiler{m_chainman.m_validation_profiler};
+    profiler.BeginBlock();
     // Read block from disk.
     const auto time_1{SteadyClock::now()};
     std::shared_ptr<const CBlock> pthisBlock;
@@ -3184,6 +3243,7 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
             return FatalError(m_chainman.GetNotifications(), state, _("Failed to read block."));
         }
         pthisBlock = pblockNew;
+        profiler.Record(ValidationStage::READ, SteadyClock::now() - time_1);
     } else {
         LogDebug(BCLog::BENCH, "  - Using cached block\n");
         pthisBlock = pblock;
@@ -3192,8 +3252,6 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     // Apply the block atomically to the chain state.
     const auto time_2{SteadyClock::now()};
     SteadyClock::time_point time_3;
-    // When adding aggregate statistics in the future, keep in mind that
-    // num_blocks_total may be zero until the ConnectBlock() call below.
     LogDebug(BCLog::BENCH, "  - Load block from disk: %.2fms\n",
              Ticks<MillisecondsDouble>(time_2 - time_1));
     {
@@ -3209,31 +3267,25 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
             return false;
         }
         time_3 = SteadyClock::now();
-        m_chainman.time_connect_total += time_3 - time_2;
-        assert(m_chainman.num_blocks_total > 0);
-        LogDebug(BCLog::BENCH, "  - Connect total: %.2fms [%.2fs (%.2fms/blk)]\n",
-                 Ticks<MillisecondsDouble>(time_3 - time_2),
-                 Ticks<SecondsDouble>(m_chainman.time_connect_total),
-                 Ticks<MillisecondsDouble>(m_chainman.time_connect_total) / m_chainman.num_blocks_total);
+        LogDebug(BCLog::BENCH, "  - Connect total: %.2fms\n",
+                 Ticks<MillisecondsDouble>(time_3 - time_2));
         bool flushed = view.Flush();
         assert(flushed);
     }
     const auto time_4{SteadyClock::now()};
-    m_chainman.time_flush += time_4 - time_3;
-    LogDebug(BCLog::BENCH, "  - Flush: %.2fms [%.2fs (%.2fms/blk)]\n",
+    profiler.Record(ValidationStage::FLUSH, time_4 - time_3);
+    LogDebug(BCLog::BENCH, "  - Flush: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_4 - time_3),
-             Ticks<SecondsDouble>(m_chainman.time_flush),
-             Ticks<MillisecondsDouble>(m_chainman.time_flush) / m_chainman.num_blocks_total);
+             StageTotals(profiler, ValidationStage::FLUSH));
     // Write the chain state to disk, if necessary.
     if (!FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
         return false;
     }
     const auto time_5{SteadyClock::now()};
-    m_chainman.time_chainstate += time_5 - time_4;
-    LogDebug(BCLog::BENCH, "  - Writing chainstate: %.2fms [%.2fs (%.2fms/blk)]\n",
+    profiler.Record(ValidationStage::CHAINSTATE_WRITE, time_5 - time_4);
+    LogDebug(BCLog::BENCH, "  - Writing chainstate: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_5 - time_4),
-             Ticks<SecondsDouble>(m_chainman.time_chainstate),
-             Ticks<MillisecondsDouble>(m_chainman.time_chainstate) / m_chainman.num_blocks_total);
+             StageTotals(profiler, ValidationStage::CHAINSTATE_WRITE));
     // Remove conflicting transactions from the mempool.;
     if (m_mempool) {
         m_mempool->removeForBlock(blockConnecting.vtx, pindexNew->nHeight);
@@ -3244,16 +3296,15 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     UpdateTip(pindexNew);
 
     const auto time_6{SteadyClock::now()};
-    m_chainman.time_post_connect += time_6 - time_5;
-    m_chainman.time_total += time_6 - time_1;
-    LogDebug(BCLog::BENCH, "  - Connect postprocess: %.2fms [%.2fs (%.2fms/blk)]\n",
+    profiler.Record(ValidationStage::POSTPROCESS, time_6 - time_5);
+    profiler.Record(ValidationStage::TOTAL, time_6 - time_1);
+    profiler.EndBlock(pindexNew->GetBlockHash(), pindexNew->nHeight, blockConnecting.vtx.size());
+    LogDebug(BCLog::BENCH, "  - Connect postprocess: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_6 - time_5),
-             Ticks<SecondsDouble>(m_chainman.time_post_connect),
-             Ticks<MillisecondsDouble>(m_chainman.time_post_connect) / m_chainman.num_blocks_total);
-    LogDebug(BCLog::BENCH, "- Connect block: %.2fms [%.2fs (%.2fms/blk)]\n",
+             StageTotals(profiler, ValidationStage::POSTPROCESS));
+    LogDebug(BCLog::BENCH, "- Connect block: %.2fms %s\n",
              Ticks<MillisecondsDouble>(time_6 - time_1),
-             Ticks<SecondsDouble>(m_chainman.time_total),
-             Ticks<MillisecondsDouble>(m_chainman.time_total) / m_chainman.num_blocks_total);
+             StageTotals(profiler, ValidationStage::TOTAL));
 
     // If we are the background validation chainstate, check to see if we are done
     // validating the snapshot (i.e. our tip has reached the snapshot's base block).
@@ -3549,7 +3600,9 @@ bool Chainstate::ActivateBestChain(BlockValidationState& state, std::shared_ptr<
                 for (const PerBlockConnectTrace& trace : connectTrace.GetBlocksConnected()) {
                     assert(trace.pblock && trace.pindex);
                     if (m_chainman.m_options.signals) {
+                        const auto time_notify{SteadyClock::now()};
                         m_chainman.m_options.signals->BlockConnected(chainstate_role, trace.pblock, trace.pindex);
+                        m_chainman.m_validation_profiler.RecordEnded(trace.pindex->GetBlockHash(), ValidationStage::NOTIFY, SteadyClock::now() - time_notify);
                     }
                 }
 
@@ -4342,7 +4395,10 @@ bool ChainstateManager::AcceptBlockHeader(const CBlockHeader& block, BlockValida
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, GetConsensus())) {
+        const auto time_check{SteadyClock::now()};
+        const bool header_valid{CheckBlockHeader(block, state, GetConsensus())};
+        m_validation_profiler.Record(ValidationStage::HEADER_CHECK, SteadyClock::now() - time_check);
+        if (!header_valid) {
             LogDebug(BCLog::VALIDATION, "%s: Consensus::CheckBlockHeader: %s, %s\n", __func__, hash.ToString(), state.ToString());
             return false;
         }
@@ -4705,6 +4761,7 @@ void PruneBlockFilesManual(Chainstate& active_chainstate, int nManualPruneHeight
 bool Chainstate::LoadChainTip()
 {
     AssertLockHeld(cs_main);
+    ResetCoinsTipSnapshot();
     const CCoinsViewCache& coins_cache = CoinsTip();
     assert(!coins_cache.GetBestBlock().IsNull()); // Never called when the coins view is empty
     const CBlockIndex* tip = m_chain.Tip();
@@ -4798,7 +4855,7 @@ VerifyDBResult CVerifyDB::VerifyDB(
         }
         CBlock block;
         // check level 0: read from disk
-        if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+        if (!chainstate.m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
             LogPrintf("Verification error: ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
             return VerifyDBResult::CORRUPTED_BLOCK_DB;
         }
@@ -4864,7 +4921,7 @@ VerifyDBResult CVerifyDB::VerifyDB(
             m_notifications.progress(_("Verifying blocks…"), percentageDone, false);
             pindex = chainstate.m_chain.Next(pindex);
             CBlock block;
-            if (!chainstate.m_blockman.ReadBlock(block, *pindex)) {
+            if (!chainstate.m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
                 LogPrintf("Verification error: ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
                 return VerifyDBResult::CORRUPTED_BLOCK_DB;
             }
@@ -4893,7 +4950,7 @@ bool Chainstate::RollforwardBlock(const CBlockIndex* pindex, CCoinsViewCache& in
     AssertLockHeld(cs_main);
     // TODO: merge with ConnectBlock
     CBlock block;
-    if (!m_blockman.ReadBlock(block, *pindex)) {
+    if (!m_blockman.ReadBlock(block, *pindex, /*use_arena=*/true)) {
         LogError("ReplayBlock(): ReadBlock failed at %d, hash=%s\n", pindex->nHeight, pindex->GetBlockHash().ToString());
         return false;
     }
@@ -4951,7 +5008,7 @@ bool Chainstate::ReplayBlocks()
     while (pindexOld != pindexFork) {
         if (pindexOld->nHeight > 0) { // Never disconnect the genesis block.
             CBlock block;
-            if (!m_blockman.ReadBlock(block, *pindexOld)) {
+            if (!m_blockman.ReadBlock(block, *pindexOld, /*use_arena=*/true)) {
                 LogError("RollbackBlock(): ReadBlock() failed at %d, hash=%s\n", pindexOld->nHeight, pindexOld->GetBlockHash().ToString());
                 return false;
             }
@@ -5594,6 +5651,8 @@ bool Chainstate::ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
     size_t old_coinstip_size = m_coinstip_cache_size_bytes;
     m_coinstip_cache_size_bytes = coinstip_size;
     m_coinsdb_cache_size_bytes = coinsdb_size;
+    // Release our own reference to the database, which would keep it open.
+    ResetCoinsTipSnapshot();
     CoinsDB().ResizeCache(coinsdb_size);
 
     LogPrintf("[%s] resized coinsdb cache to %.1f MiB\n",
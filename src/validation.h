@@ -18,6 +18,7 @@
 #include <kernel/chainparams.h>
 #include <kernel/chainstatemanager_opts.h>
 #include <kernel/cs_main.h> // IWYU pragma: export
+#include <kernel/validation_profiler.h>
 #include <node/blockstorage.h>
 #include <policy/feerate.h>
 #include <policy/packages.h>
@@ -82,6 +83,9 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
 
+/** Maximum number of unflushed coins cache entries copied into a UTXO snapshot while holding cs_main */
+static constexpr size_t MAX_COINS_TIP_SNAPSHOT_DELTA{50'000};
+
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
     INIT_REINDEX,
@@ -488,6 +492,17 @@ enum class CoinsCacheSizeState
     OK = 0
 };
 
+/**
+ * A read-only view of the UTXO set together with the chain tip it reflects.
+ * @see Chainstate::GetCoinsTipSnapshot()
+ */
+struct CoinsTipSnapshot {
+    //! The chainstate's tip when the snapshot was taken.
+    const CBlockIndex* tip;
+    //! The UTXO set as of tip. Reading from it needs no locks.
+    std::unique_ptr<CCoinsViewDBSnapshot> coins;
+};
+
 /**
  * Chainstate stores and provides an API to update our local knowledge of the
  * current best chain.
@@ -535,6 +550,19 @@ protected:
     //! Cached result of LookupBlockIndex(*m_from_snapshot_blockhash)
     const CBlockIndex* m_cached_snapshot_base GUARDED_BY(::cs_main) {nullptr};
 
+    //! Protects m_coins_tip_snapshot. Lock order: ::cs_main, then this.
+    Mutex m_coins_tip_snapshot_mutex;
+    //! Snapshot of the UTXO set at the current tip, taken on first request.
+    //! Reset whenever the tip or the coins views change.
+    std::shared_ptr<const CoinsTipSnapshot> m_coins_tip_snapshot GUARDED_BY(m_coins_tip_snapshot_mutex);
+
+    //! Drop the cached UTXO snapshot, so the next request takes a new one.
+    void ResetCoinsTipSnapshot() EXCLUSIVE_LOCKS_REQUIRED(!m_coins_tip_snapshot_mutex)
+    {
+        LOCK(m_coins_tip_snapshot_mutex);
+        m_coins_tip_snapshot.reset();
+    }
+
 public:
     //! Reference to a BlockManager instance which itself is shared across all
     //! Chainstate instances.
@@ -638,7 +666,11 @@ public:
     }
 
     //! Destructs all objects related to accessing the UTXO set.
-    void ResetCoinsViews() { m_coins_views.reset(); }
+    void ResetCoinsViews() EXCLUSIVE_LOCKS_REQUIRED(!m_coins_tip_snapshot_mutex)
+    {
+        ResetCoinsTipSnapshot();
+        m_coins_views.reset();
+    }
 
     //! Does this chainstate have a UTXO set attached?
     bool HasCoinsViews() const { return (bool)m_coins_views; }
@@ -652,7 +684,24 @@ public:
     //! Resize the CoinsViews caches dynamically and flush state to disk.
     //! @returns true unless an error occurred during the flush.
     bool ResizeCoinsCaches(size_t coinstip_size, size_t coinsdb_size)
-        EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
+        EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_coins_tip_snapshot_mutex);
+
+    /**
+     * Return a consistent, read-only snapshot of the UTXO set at the current
+     * tip, which can be read from without holding cs_main. It is shared by all
+     * callers until the tip changes; only the first request after that takes
+     * cs_main, to copy the unflushed cache entries. If there are more than
+     * MAX_COINS_TIP_SNAPSHOT_DELTA of them, the cache is flushed first instead,
+     * so the copy is bounded.
+     *
+     * This is meant for scanning the UTXO set. Point lookups are cheaper
+     * served from CoinsTip() under cs_main.
+     *
+     * A snapshot keeps the coins database open, so it should be dropped once
+     * done with rather than stored.
+     */
+    std::shared_ptr<const CoinsTipSnapshot> GetCoinsTipSnapshot()
+        EXCLUSIVE_LOCKS_REQUIRED(!m_coins_tip_snapshot_mutex) LOCKS_EXCLUDED(::cs_main);
 
     /**
      * Update the on-disk chain state.
@@ -950,20 +999,8 @@ private:
     //! A queue for script verifications that have to be performed by worker threads.
     CCheckQueue<CScriptCheck> m_script_check_queue;
 
-    //! Timers and counters used for benchmarking validation in both background
-    //! and active chainstates.
-    SteadyClock::duration GUARDED_BY(::cs_main) time_check{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_forks{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_connect{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_verify{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_undo{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_index{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_total{};
-    int64_t GUARDED_BY(::cs_main) num_blocks_total{0};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_connect_total{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_flush{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_chainstate{};
-    SteadyClock::duration GUARDED_BY(::cs_main) time_post_connect{};
+    //! Stage timings of block validation in both background and active chainstates.
+    kernel::ValidationProfiler m_validation_profiler;
 
 public:
     using Options = kernel::ChainstateManagerOpts;
@@ -1325,6 +1362,9 @@ public:
 
     CCheckQueue<CScriptCheck>& GetCheckQueue() { return m_script_check_queue; }
 
+    //! Stage timings of the last connected blocks. Can be read without cs_main.
+    const kernel::ValidationProfiler& GetValidationProfiler() const { return m_validation_profiler; }
+
     ~ChainstateManager();
 };
 
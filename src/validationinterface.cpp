@@ -16,10 +16,70 @@
 #include <util/check.h>
 #include <util/task_runner.h>
 
+#include <algorithm>
+#include <atomic>
+#include <deque>
 #include <future>
+#include <list>
 #include <unordered_map>
 #include <utility>
 
+/**
+ * Queue of the events of one subscriber, when ValidationSignals queues events
+ * per subscriber. While the queue is not empty, a task that runs its next
+ * event is in the task runner, so the events of one subscriber run one at a
+ * time and in order, while those of different subscribers can run in
+ * parallel. Tasks keep the queue alive, so it can be released by the event it
+ * is running.
+ */
+class SubscriberQueue : public std::enable_shared_from_this<SubscriberQueue>
+{
+private:
+    util::TaskRunnerInterface& m_task_runner;
+    Mutex m_mutex;
+    std::deque<std::function<void()>> m_pending GUARDED_BY(m_mutex);
+    //! Whether a task running the next event is in the task runner.
+    bool m_scheduled GUARDED_BY(m_mutex){false};
+
+    void RunNext() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::function<void()> event;
+        {
+            LOCK(m_mutex);
+            event = std::move(m_pending.front());
+            m_pending.pop_front();
+        }
+        event();
+        {
+            LOCK(m_mutex);
+            m_scheduled = !m_pending.empty();
+            if (!m_scheduled) return;
+        }
+        // Give other subscribers' tasks a turn before running the next event.
+        m_task_runner.insert([self = shared_from_this()] { self->RunNext(); });
+    }
+
+public:
+    explicit SubscriberQueue(util::TaskRunnerInterface& task_runner) : m_task_runner{task_runner} {}
+
+    void Insert(std::function<void()> event) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        {
+            LOCK(m_mutex);
+            m_pending.emplace_back(std::move(event));
+            if (m_scheduled) return;
+            m_scheduled = true;
+        }
+        m_task_runner.insert([self = shared_from_this()] { self->RunNext(); });
+    }
+
+    size_t Size() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        return m_pending.size();
+    }
+};
+
 /**
  * ValidationSignalsImpl manages a list of shared_ptr<CValidationInterface> callbacks.
  *
@@ -35,22 +95,53 @@ private:
     //! List entries consist of a callback pointer and reference count. The
     //! count is equal to the number of current executions of that entry, plus 1
     //! if it's registered. It cannot be 0 because that would imply it is
-    //! unregistered and also not being executed (so shouldn't exist).
-    struct ListEntry { std::shared_ptr<CValidationInterface> callbacks; int count = 1; };
+    //! unregistered and also not being executed (so shouldn't exist). With
+    //! per-subscriber queues, events in the queue count as executions.
+    struct ListEntry {
+        std::shared_ptr<CValidationInterface> callbacks;
+        int count = 1;
+        bool registered = true;
+        std::shared_ptr<SubscriberQueue> queue;
+    };
     std::list<ListEntry> m_list GUARDED_BY(m_mutex);
     std::unordered_map<CValidationInterface*, std::list<ListEntry>::iterator> m_map GUARDED_BY(m_mutex);
 
+    //! Registered entries, each with its count incremented for an event to
+    //! be queued. Queueing happens without m_mutex, as the task runner may
+    //! run the event right away.
+    std::vector<std::list<ListEntry>::iterator> AcquireRegistered() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        std::vector<std::list<ListEntry>::iterator> entries;
+        entries.reserve(m_map.size());
+        for (const auto& [_, it] : m_map) {
+            ++it->count;
+            entries.push_back(it);
+        }
+        return entries;
+    }
+
+    void Release(std::list<ListEntry>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        LOCK(m_mutex);
+        if (!--it->count) m_list.erase(it);
+    }
+
 public:
     std::unique_ptr<util::TaskRunnerInterface> m_task_runner;
+    const bool m_per_subscriber_queues;
 
-    explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner)
-        : m_task_runner{std::move(Assert(task_runner))} {}
+    explicit ValidationSignalsImpl(std::unique_ptr<util::TaskRunnerInterface> task_runner, bool per_subscriber_queues)
+        : m_task_runner{std::move(Assert(task_runner))}, m_per_subscriber_queues{per_subscriber_queues} {}
 
     void Register(std::shared_ptr<CValidationInterface> callbacks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
     {
         LOCK(m_mutex);
         auto inserted = m_map.emplace(callbacks.get(), m_list.end());
-        if (inserted.second) inserted.first->second = m_list.emplace(m_list.end());
+        if (inserted.second) {
+            inserted.first->second = m_list.emplace(m_list.end());
+            if (m_per_subscriber_queues) inserted.first->second->queue = std::make_shared<SubscriberQueue>(*m_task_runner);
+        }
         inserted.first->second->callbacks = std::move(callbacks);
     }
 
@@ -59,6 +150,7 @@ public:
         LOCK(m_mutex);
         auto it = m_map.find(callbacks);
         if (it != m_map.end()) {
+            it->second->registered = false;
             if (!--it->second->count) m_list.erase(it->second);
             m_map.erase(it);
         }
@@ -72,6 +164,7 @@ public:
     {
         LOCK(m_mutex);
         for (const auto& entry : m_map) {
+            entry.second->registered = false;
             if (!--entry.second->count) m_list.erase(entry.second);
         }
         m_map.clear();
@@ -89,10 +182,84 @@ public:
             it = --it->count ? std::next(it) : m_list.erase(it);
         }
     }
+
+    //! Queue an event for all registered subscribers. log is called once, when
+    //! the event is dispatched; with per-subscriber queues, by the first queue
+    //! to get to it.
+    template <typename L, typename F>
+    void Enqueue(L log, F f) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (!m_per_subscriber_queues) {
+            m_task_runner->insert([this, log, f] {
+                log();
+                Iterate(f);
+            });
+            return;
+        }
+        const auto entries{AcquireRegistered()};
+        if (entries.empty()) {
+            log();
+            return;
+        }
+        // Share the event's arguments between the subscriber queues.
+        auto event{std::make_shared<const F>(std::move(f))};
+        auto shared_log{std::make_shared<const L>(std::move(log))};
+        auto logged{std::make_shared<std::atomic_flag>()};
+        for (const auto& it : entries) {
+            it->queue->Insert([this, it, event, shared_log, logged] {
+                if (!logged->test_and_set()) (*shared_log)();
+                // Events still queued for an unregistered subscriber are dropped.
+                if (WITH_LOCK(m_mutex, return it->registered)) (*event)(*it->callbacks);
+                Release(it);
+            });
+        }
+    }
+
+    //! Call func once all events queued so far have been dispatched.
+    void CallWhenDispatched(std::function<void()> func) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (!m_per_subscriber_queues) {
+            m_task_runner->insert(std::move(func));
+            return;
+        }
+        const auto entries{AcquireRegistered()};
+        if (entries.empty()) {
+            m_task_runner->insert(std::move(func));
+            return;
+        }
+        // The last subscriber queue to reach this point calls func.
+        auto remaining{std::make_shared<std::atomic<size_t>>(entries.size())};
+        auto shared_func{std::make_shared<std::function<void()>>(std::move(func))};
+        for (const auto& it : entries) {
+            it->queue->Insert([this, it, remaining, shared_func] {
+                if (--*remaining == 0) (*shared_func)();
+                Release(it);
+            });
+        }
+    }
+
+    size_t Pending() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        if (!m_per_subscriber_queues) return m_task_runner->size();
+        LOCK(m_mutex);
+        size_t pending{0};
+        for (const auto& entry : m_list) pending = std::max(pending, entry.queue->Size());
+        return pending;
+    }
+
+    template <typename F>
+    std::vector<ValidationSignals::SubscriberQueueInfo> GetQueues(F&& name) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        std::vector<ValidationSignals::SubscriberQueueInfo> queues;
+        if (!m_per_subscriber_queues) return queues;
+        LOCK(m_mutex);
+        for (const auto& [_, it] : m_map) queues.push_back({name(*it->callbacks), it->queue->Size()});
+        return queues;
+    }
 };
 
-ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner)
-    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner))} {}
+ValidationSignals::ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner, bool per_subscriber_queues)
+    : m_internals{std::make_unique<ValidationSignalsImpl>(std::move(task_runner), per_subscriber_queues)} {}
 
 ValidationSignals::~ValidationSignals() = default;
 
@@ -103,7 +270,12 @@ void ValidationSignals::FlushBackgroundCallbacks()
 
 size_t ValidationSignals::CallbacksPending()
 {
-    return m_internals->m_task_runner->size();
+    return m_internals->Pending();
+}
+
+std::vector<ValidationSignals::SubscriberQueueInfo> ValidationSignals::GetSubscriberQueues()
+{
+    return m_internals->GetQueues([](const CValidationInterface& callbacks) { return callbacks.ValidationInterfaceName(); });
 }
 
 void ValidationSignals::RegisterSharedValidationInterface(std::shared_ptr<CValidationInterface> callbacks)
@@ -137,7 +309,7 @@ void ValidationSignals::UnregisterAllValidationInterfaces()
 
 void ValidationSignals::CallFunctionInValidationInterfaceQueue(std::function<void()> func)
 {
-    m_internals->m_task_runner->insert(std::move(func));
+    m_internals->CallWhenDispatched(std::move(func));
 }
 
 void ValidationSignals::SyncWithValidationInterfaceQueue()
@@ -159,10 +331,9 @@ void ValidationSignals::SyncWithValidationInterfaceQueue()
     do {                                                       \
         auto local_name = (name);                              \
         LOG_EVENT("Enqueuing " fmt, local_name, __VA_ARGS__);  \
-        m_internals->m_task_runner->insert([=] { \
+        m_internals->Enqueue([=] {                             \
             LOG_EVENT(fmt, local_name, __VA_ARGS__);           \
-            event();                                           \
-        });                                                    \
+        }, event);                                             \
     } while (0)
 
 #define LOG_EVENT(fmt, ...) \
@@ -173,8 +344,8 @@ void ValidationSignals::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlo
     // the chain actually updates. One way to ensure this is for the caller to invoke this signal
     // in the same critical section where the chain is updated
 
-    auto event = [pindexNew, pindexFork, fInitialDownload, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload); });
+    auto event = [pindexNew, pindexFork, fInitialDownload](CValidationInterface& callbacks) {
+        callbacks.UpdatedBlockTip(pindexNew, pindexFork, fInitialDownload);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: new block hash=%s fork block hash=%s (in IBD=%s)", __func__,
                           pindexNew->GetBlockHash().ToString(),
@@ -190,8 +361,8 @@ void ValidationSignals::ActiveTipChange(const CBlockIndex& new_tip, bool is_ibd)
 
 void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
 {
-    auto event = [tx, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionAddedToMempool(tx, mempool_sequence); });
+    auto event = [tx, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionAddedToMempool(tx, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s", __func__,
                           tx.info.m_tx->GetHash().ToString(),
@@ -199,8 +370,8 @@ void ValidationSignals::TransactionAddedToMempool(const NewMempoolTransactionInf
 }
 
 void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason reason, uint64_t mempool_sequence) {
-    auto event = [tx, reason, mempool_sequence, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence); });
+    auto event = [tx, reason, mempool_sequence](CValidationInterface& callbacks) {
+        callbacks.TransactionRemovedFromMempool(tx, reason, mempool_sequence);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: txid=%s wtxid=%s reason=%s", __func__,
                           tx->GetHash().ToString(),
@@ -209,8 +380,8 @@ void ValidationSignals::TransactionRemovedFromMempool(const CTransactionRef& tx,
 }
 
 void ValidationSignals::BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock> &pblock, const CBlockIndex *pindex) {
-    auto event = [role, pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockConnected(role, pblock, pindex); });
+    auto event = [role, pblock, pindex](CValidationInterface& callbacks) {
+        callbacks.BlockConnected(role, pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -219,8 +390,8 @@ void ValidationSignals::BlockConnected(ChainstateRole role, const std::shared_pt
 
 void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight)
 {
-    auto event = [txs_removed_for_block, nBlockHeight, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight); });
+    auto event = [txs_removed_for_block, nBlockHeight](CValidationInterface& callbacks) {
+        callbacks.MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block height=%s txs removed=%s", __func__,
                           nBlockHeight,
@@ -229,8 +400,8 @@ void ValidationSignals::MempoolTransactionsRemovedForBlock(const std::vector<Rem
 
 void ValidationSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindex)
 {
-    auto event = [pblock, pindex, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.BlockDisconnected(pblock, pindex); });
+    auto event = [pblock, pindex](CValidationInterface& callbacks) {
+        callbacks.BlockDisconnected(pblock, pindex);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s block height=%d", __func__,
                           pblock->GetHash().ToString(),
@@ -238,8 +409,8 @@ void ValidationSignals::BlockDisconnected(const std::shared_ptr<const CBlock>& p
 }
 
 void ValidationSignals::ChainStateFlushed(ChainstateRole role, const CBlockLocator &locator) {
-    auto event = [role, locator, this] {
-        m_internals->Iterate([&](CValidationInterface& callbacks) { callbacks.ChainStateFlushed(role, locator); });
+    auto event = [role, locator](CValidationInterface& callbacks) {
+        callbacks.ChainStateFlushed(role, locator);
     };
     ENQUEUE_AND_LOG_EVENT(event, "%s: block hash=%s", __func__,
                           locator.IsNull() ? "null" : locator.vHave.front().ToString());
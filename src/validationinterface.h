@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace util {
@@ -157,6 +158,11 @@ protected:
      * has been received and connected to the headers tree, though not validated yet.
      */
     virtual void NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& block) {};
+    /**
+     * Name under which the number of notifications queued for this subscriber
+     * is reported.
+     */
+    virtual std::string ValidationInterfaceName() const { return "unnamed"; }
     friend class ValidationSignals;
     friend class ValidationInterfaceTest;
 };
@@ -168,17 +174,33 @@ private:
 
 public:
     // The task runner will block validation if it calls its insert method's
-    // func argument synchronously. In this class func contains a loop that
-    // dispatches a single validation event to all subscribers sequentially.
-    explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner);
+    // func argument synchronously. By default func contains a loop that
+    // dispatches a single validation event to all subscribers sequentially,
+    // so the task runner must run tasks one at a time, in order.
+    //
+    // With per_subscriber_queues, every subscriber gets its own queue of
+    // events, and func dispatches the next event of a single subscriber. The
+    // task runner may then run tasks in parallel, so that a slow subscriber
+    // does not hold up the others, while each subscriber still receives its
+    // events in order. Events are only queued for the subscribers registered
+    // at the time.
+    explicit ValidationSignals(std::unique_ptr<util::TaskRunnerInterface> task_runner, bool per_subscriber_queues = false);
 
     ~ValidationSignals();
 
     /** Call any remaining callbacks on the calling thread */
     void FlushBackgroundCallbacks();
 
+    /** Number of pending events; with per-subscriber queues, the most of any subscriber. */
     size_t CallbacksPending();
 
+    struct SubscriberQueueInfo {
+        std::string name;
+        size_t pending;
+    };
+    /** Pending events of each subscriber. Empty unless events are queued per subscriber. */
+    std::vector<SubscriberQueueInfo> GetSubscriberQueues();
+
     /** Register subscriber */
     void RegisterValidationInterface(CValidationInterface* callbacks);
     /** Unregister subscriber. DEPRECATED. This is not safe to use when the RPC server or main message handler thread is running. */
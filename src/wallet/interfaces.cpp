@@ -597,6 +597,14 @@ public:
     void stop() override { return StopWallets(m_context); }
     void setMockTime(int64_t time) override { return SetMockTime(time); }
     void schedulerMockForward(std::chrono::seconds delta) override { Assert(m_context.scheduler)->MockForward(delta); }
+    size_t getMemoryUsage() override
+    {
+        size_t usage{0};
+        for (const std::shared_ptr<CWallet>& wallet : GetWallets(m_context)) {
+            usage += wallet->DynamicMemoryUsage();
+        }
+        return usage;
+    }
 
     //! WalletLoader methods
     util::Result<std::unique_ptr<Wallet>> createWallet(const std::string& name, const SecureString& passphrase, uint64_t wallet_creation_flags, std::vector<bilingual_str>& warnings) override
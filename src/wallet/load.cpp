@@ -161,9 +161,9 @@ void StartWallets(WalletContext& context)
 
     // Schedule periodic wallet flushes and tx rebroadcasts
     if (context.args->GetBoolArg("-flushwallet", DEFAULT_FLUSHWALLET)) {
-        context.scheduler->scheduleEvery([&context] { MaybeCompactWalletDB(context); }, 500ms);
+        context.scheduler->scheduleEvery([&context] { MaybeCompactWalletDB(context); }, 500ms, "wallet_flush");
     }
-    context.scheduler->scheduleEvery([&context] { MaybeResendWalletTxs(context); }, 1min);
+    context.scheduler->scheduleEvery([&context] { MaybeResendWalletTxs(context); }, 1min, "wallet_resend");
 }
 
 void FlushWallets(WalletContext& context)
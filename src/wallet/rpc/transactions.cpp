@@ -440,20 +440,7 @@ static std::vector<RPCResult> TransactionDescriptionString()
 
 RPCHelpMan listtransactions()
 {
-    return RPCHelpMan{"listtransactions",
-                "\nIf a label name is provided, this will return only incoming transactions paying to addresses with the specified label.\n"
-                "\nReturns up to 'count' most recent transactions skipping the first 'from' transactions.\n",
-                {
-                    {"label", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "If set, should be a valid label name to return only incoming transactions\n"
-                          "with the specified label, or \"*\" to disable filtering and return all transactions."},
-                    {"count", RPCArg::Type::NUM, RPCArg::Default{10}, "The number of transactions to return"},
-                    {"skip", RPCArg::Type::NUM, RPCArg::Default{0}, "The number of transactions to skip"},
-                    {"include_watchonly", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true for watch-only wallets, otherwise false"}, "Include transactions to watch-only addresses (see 'importaddress')"},
-                },
-                RPCResult{
-                    RPCResult::Type::ARR, "", "",
-                    {
-                        {RPCResult::Type::OBJ, "", "", Cat(Cat<std::vector<RPCResult>>(
+    const RPCResult entry_result{RPCResult::Type::OBJ, "", "", Cat(Cat<std::vector<RPCResult>>(
                         {
                             {RPCResult::Type::BOOL, "involvesWatchonly", /*optional=*/true, "Only returns true if imported addresses were involved in transaction."},
                             {RPCResult::Type::STR, "address",  /*optional=*/true, "The bitcoin address of the transaction (not returned if the output does not have an address, e.g. OP_RETURN null data)."},
@@ -473,14 +460,47 @@ RPCHelpMan listtransactions()
                         TransactionDescriptionString()),
                         {
                             {RPCResult::Type::BOOL, "abandoned", "'true' if the transaction has been abandoned (inputs are respendable)."},
-                        })},
-                    }
+                        })};
+
+    return RPCHelpMan{"listtransactions",
+                "\nIf a label name is provided, this will return only incoming transactions paying to addresses with the specified label.\n"
+                "\nReturns up to 'count' most recent transactions skipping the first 'from' transactions.\n"
+                "\nIf 'cursor' is set, pages are taken from the wallet's transaction order instead. Each page holds whole transactions,\n"
+                "newest first, until at least 'count' entries were returned. Pass \"\" to get the most recent page and the returned\n"
+                "'next_cursor' to get the page before it. Cursors remain valid while new transactions arrive.\n",
+                {
+                    {"label", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "If set, should be a valid label name to return only incoming transactions\n"
+                          "with the specified label, or \"*\" to disable filtering and return all transactions."},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{10}, "The number of transactions to return"},
+                    {"skip", RPCArg::Type::NUM, RPCArg::Default{0}, "The number of transactions to skip. Cannot be combined with 'cursor'."},
+                    {"include_watchonly", RPCArg::Type::BOOL, RPCArg::DefaultHint{"true for watch-only wallets, otherwise false"}, "Include transactions to watch-only addresses (see 'importaddress')"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Return the page of transactions preceding this cursor, or the most recent page if empty."},
+                },
+                {
+                    RPCResult{"if cursor is not set",
+                        RPCResult::Type::ARR, "", "",
+                        {
+                            entry_result,
+                        }
+                    },
+                    RPCResult{"if cursor is set",
+                        RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::ARR, "transactions", "Entries of this page, oldest to newest",
+                            {
+                                entry_result,
+                            }},
+                            {RPCResult::Type::STR, "next_cursor", /*optional=*/true, "The cursor of the preceding page, if there are older transactions"},
+                        }
+                    },
                 },
                 RPCExamples{
             "\nList the most recent 10 transactions in the systems\n"
             + HelpExampleCli("listtransactions", "") +
             "\nList transactions 100 to 120\n"
             + HelpExampleCli("listtransactions", "\"*\" 20 100") +
+            "\nPage through all transactions, 100 entries at a time\n"
+            + HelpExampleCli("-named listtransactions", "count=100 cursor=\"\"") +
             "\nAs a JSON-RPC call\n"
             + HelpExampleRpc("listtransactions", "\"*\", 20, 100")
                 },
@@ -517,6 +537,39 @@ RPCHelpMan listtransactions()
     if (nFrom < 0)
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative from");
 
+    if (!request.params[4].isNull()) {
+        if (nFrom != 0) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "skip cannot be combined with cursor");
+        }
+        // An empty page would have no oldest transaction to continue from
+        if (nCount < 1) throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+        LOCK(pwallet->cs_wallet);
+
+        // The cursor is the order position of the oldest transaction returned so far
+        auto it{pwallet->wtxOrdered.cend()};
+        const std::string& cursor{request.params[4].get_str()};
+        if (!cursor.empty()) {
+            const auto order_pos{ToIntegral<int64_t>(cursor)};
+            if (!order_pos) throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+            it = pwallet->wtxOrdered.lower_bound(*order_pos);
+        }
+
+        // Only the transactions on this page are visited; a page always ends on a
+        // transaction boundary so that the next cursor does not split one.
+        std::vector<UniValue> page;
+        while (it != pwallet->wtxOrdered.cbegin() && (int)page.size() < nCount) {
+            --it;
+            ListTransactions(*pwallet, *it->second, 0, true, page, filter, filter_label);
+        }
+
+        UniValue transactions{UniValue::VARR};
+        transactions.push_backV(std::make_move_iterator(page.rbegin()), std::make_move_iterator(page.rend())); // Return oldest to newest
+        UniValue result{UniValue::VOBJ};
+        result.pushKV("transactions", std::move(transactions));
+        if (it != pwallet->wtxOrdered.cbegin()) result.pushKV("next_cursor", util::ToString(it->first));
+        return result;
+    }
+
     std::vector<UniValue> ret;
     {
         LOCK(pwallet->cs_wallet);
@@ -552,7 +605,10 @@ RPCHelpMan listsinceblock()
     return RPCHelpMan{"listsinceblock",
                 "\nGet all transactions in blocks since block [blockhash], or all transactions if omitted.\n"
                 "If \"blockhash\" is no longer a part of the main chain, transactions from the fork point onward are included.\n"
-                "Additionally, if include_removed is set, transactions affecting the wallet which were removed are returned in the \"removed\" array.\n",
+                "Additionally, if include_removed is set, transactions affecting the wallet which were removed are returned in the \"removed\" array.\n"
+                "Transactions are listed by the height of the block that confirmed them, unconfirmed transactions last. If 'count' is set,\n"
+                "whole transactions are returned until at least 'count' entries were listed, and \"next_cursor\" is set if more remain;\n"
+                "pass it as 'cursor' to get the next page.\n",
                 {
                     {"blockhash", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "If set, the block hash to list transactions since, otherwise list all transactions."},
                     {"target_confirmations", RPCArg::Type::NUM, RPCArg::Default{1}, "Return the nth block hash from the main chain. e.g. 1 would mean the best block hash. Note: this is not used as a filter, but only affects [lastblock] in the return value"},
@@ -561,6 +617,8 @@ RPCHelpMan listsinceblock()
                                                                        "(not guaranteed to work on pruned nodes)"},
                     {"include_change", RPCArg::Type::BOOL, RPCArg::Default{false}, "Also add entries for change outputs.\n"},
                     {"label", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Return only incoming transactions paying to addresses with the specified label.\n"},
+                    {"count", RPCArg::Type::NUM, RPCArg::DefaultHint{"no limit"}, "The number of transaction entries to return per page"},
+                    {"cursor", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "Continue after the page that returned this \"next_cursor\". The \"removed\" array is only returned with the first page."},
                 },
                 RPCResult{
                     RPCResult::Type::OBJ, "", "",
@@ -589,10 +647,11 @@ RPCHelpMan listsinceblock()
                                 {RPCResult::Type::STR, "label", /*optional=*/true, "A comment for the address/transaction, if any"},
                             })},
                         }},
-                        {RPCResult::Type::ARR, "removed", /*optional=*/true, "<structure is the same as \"transactions\" above, only present if include_removed=true>\n"
+                        {RPCResult::Type::ARR, "removed", /*optional=*/true, "<structure is the same as \"transactions\" above, only present if include_removed=true and cursor is not set>\n"
                             "Note: transactions that were re-added in the active chain will appear as-is in this array, and may thus have a positive confirmation count."
                         , {{RPCResult::Type::ELISION, "", ""},}},
                         {RPCResult::Type::STR_HEX, "lastblock", "The hash of the block (target_confirmations-1) from the best block on the main chain, or the genesis hash if the referenced block does not exist yet. This is typically used to feed back into listsinceblock the next time you call it. So you would generally use a target_confirmations of say 6, so you will be continually re-notified of transactions until they've reached 6 confirmations plus any new ones"},
+                        {RPCResult::Type::STR, "next_cursor", /*optional=*/true, "Only if count is set and more transactions remain. Pass as cursor to get the next page."},
                     }
                 },
                 RPCExamples{
@@ -646,12 +705,37 @@ RPCHelpMan listsinceblock()
     std::optional<std::string> filter_label;
     if (!request.params[5].isNull()) filter_label.emplace(LabelFromValue(request.params[5]));
 
+    std::optional<size_t> count;
+    if (!request.params[6].isNull()) {
+        const int n{request.params[6].getInt<int>()};
+        if (n < 1) throw JSONRPCError(RPC_INVALID_PARAMETER, "count must be positive");
+        count = n;
+    }
+
     int depth = height ? wallet.GetLastBlockHeight() + 1 - *height : -1;
 
-    UniValue transactions(UniValue::VARR);
+    // Transactions confirmed or conflicted at or below the requested height are
+    // not visited at all; the height index starts right above it.
+    auto it{height ? wallet.m_txs_by_height.lower_bound({*height + 1, Txid{}}) : wallet.m_txs_by_height.begin()};
+    const bool first_page{request.params[7].isNull()};
+    if (!first_page) {
+        const std::string& cursor{request.params[7].get_str()};
+        const auto sep{cursor.find(':')};
+        const auto cursor_height{ToIntegral<int>(cursor.substr(0, sep))};
+        const auto cursor_txid{sep == std::string::npos ? std::nullopt : Txid::FromHex(cursor.substr(sep + 1))};
+        if (!cursor_height || !cursor_txid) throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid cursor");
+        const std::pair<int, Txid> cursor_key{*cursor_height, *cursor_txid};
+        if (it != wallet.m_txs_by_height.end() && *it <= cursor_key) it = wallet.m_txs_by_height.upper_bound(cursor_key);
+    }
 
-    for (const std::pair<const uint256, CWalletTx>& pairWtx : wallet.mapWallet) {
-        const CWalletTx& tx = pairWtx.second;
+    UniValue transactions(UniValue::VARR);
+    std::optional<std::pair<int, Txid>> next_cursor;
+    for (; it != wallet.m_txs_by_height.end(); ++it) {
+        if (count && transactions.size() >= *count) {
+            next_cursor = *std::prev(it);
+            break;
+        }
+        const CWalletTx& tx = wallet.mapWallet.at(it->second);
 
         if (depth == -1 || abs(wallet.GetTxDepthInMainChain(tx)) < depth) {
             ListTransactions(wallet, tx, 0, true, transactions, filter, filter_label, include_change);
@@ -661,7 +745,7 @@ RPCHelpMan listsinceblock()
     // when a reorg'd block is requested, we also list any relevant transactions
     // in the blocks of the chain that was detached
     UniValue removed(UniValue::VARR);
-    while (include_removed && altheight && *altheight > *height) {
+    while (include_removed && first_page && altheight && *altheight > *height) {
         CBlock block;
         if (!wallet.chain().findBlock(blockId, FoundBlock().data(block)) || block.IsNull()) {
             throw JSONRPCError(RPC_INTERNAL_ERROR, "Can't read block from disk");
@@ -684,8 +768,9 @@ RPCHelpMan listsinceblock()
 
     UniValue ret(UniValue::VOBJ);
     ret.pushKV("transactions", std::move(transactions));
-    if (include_removed) ret.pushKV("removed", std::move(removed));
+    if (include_removed && first_page) ret.pushKV("removed", std::move(removed));
     ret.pushKV("lastblock", lastblock.GetHex());
+    if (next_cursor) ret.pushKV("next_cursor", strprintf("%d:%s", next_cursor->first, next_cursor->second.GetHex()));
 
     return ret;
 },
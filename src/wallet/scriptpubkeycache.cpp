@@ -0,0 +1,108 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <wallet/scriptpubkeycache.h>
+
+#include <crypto/siphash.h>
+#include <memusage.h>
+#include <random.h>
+#include <util/check.h>
+
+#include <algorithm>
+#include <optional>
+
+namespace wallet {
+//! Initial number of slots. Must be a power of two.
+static constexpr size_t INITIAL_SLOTS{64};
+//! Slots per filter word, i.e. 16 filter bits per slot (at least 21 per key given the 3/4 load factor).
+static constexpr size_t SLOTS_PER_FILTER_WORD{4};
+
+ScriptPubKeyCache::ScriptPubKeyCache() :
+    m_k0{FastRandomContext().rand64()},
+    m_k1{FastRandomContext().rand64()},
+    m_slots(INITIAL_SLOTS),
+    m_filter(INITIAL_SLOTS / SLOTS_PER_FILTER_WORD),
+    m_mask{INITIAL_SLOTS - 1}
+{
+}
+
+uint64_t ScriptPubKeyCache::Hash(const CScript& script) const
+{
+    return CSipHasher(m_k0, m_k1).Write(script).Finalize();
+}
+
+uint32_t ScriptPubKeyCache::OwnerId(ScriptPubKeyMan* spkm)
+{
+    const auto it{std::find(m_owners.begin(), m_owners.end(), spkm)};
+    if (it != m_owners.end()) return it - m_owners.begin();
+    m_owners.push_back(spkm);
+    return m_owners.size() - 1;
+}
+
+void ScriptPubKeyCache::PlaceSlot(const Slot& slot)
+{
+    size_t pos{slot.hash & m_mask};
+    while (!m_slots[pos].IsEmpty()) pos = (pos + 1) & m_mask;
+    m_slots[pos] = slot;
+    m_filter[FilterWord(slot.hash)] |= FilterBits(slot.hash);
+}
+
+void ScriptPubKeyCache::Grow()
+{
+    std::vector<Slot> old_slots(m_slots.size() * 2);
+    old_slots.swap(m_slots);
+    m_filter.assign(m_slots.size() / SLOTS_PER_FILTER_WORD, 0);
+    m_mask = m_slots.size() - 1;
+    for (const Slot& slot : old_slots) {
+        if (!slot.IsEmpty()) PlaceSlot(slot);
+    }
+}
+
+bool ScriptPubKeyCache::Insert(const CScript& script, ScriptPubKeyMan* spkm, int32_t index)
+{
+    Assume(spkm);
+    const uint64_t hash{Hash(script)};
+    const uint32_t owner{OwnerId(spkm)};
+
+    // Look for the pair itself, or for the same script under another owner so its bytes can be shared.
+    std::optional<uint32_t> script_offset;
+    for (size_t pos = hash & m_mask; !m_slots[pos].IsEmpty(); pos = (pos + 1) & m_mask) {
+        Slot& slot{m_slots[pos]};
+        if (slot.hash != hash || !Matches(slot, script)) continue;
+        if (slot.owner == owner) {
+            slot.index = index;
+            return false;
+        }
+        script_offset = slot.script_offset;
+    }
+
+    // Keep the load factor at or below 3/4 so probe sequences stay short.
+    if ((m_size + 1) * 4 > m_slots.size() * 3) Grow();
+
+    if (!script_offset) {
+        script_offset = m_scripts.size();
+        m_scripts.insert(m_scripts.end(), script.begin(), script.end());
+    }
+    PlaceSlot(Slot{.hash = hash, .script_offset = *script_offset, .script_size = static_cast<uint32_t>(script.size()), .owner = owner, .index = index});
+    ++m_size;
+    return true;
+}
+
+ScriptPubKeyCache::Entry ScriptPubKeyCache::Find(const CScript& script) const
+{
+    const uint64_t hash{Hash(script)};
+    if (!MayContain(hash)) return {nullptr, 0};
+    for (size_t pos = hash & m_mask; !m_slots[pos].IsEmpty(); pos = (pos + 1) & m_mask) {
+        const Slot& slot{m_slots[pos]};
+        if (slot.hash == hash && Matches(slot, script)) return {m_owners[slot.owner], slot.index};
+    }
+    return {nullptr, 0};
+}
+
+size_t ScriptPubKeyCache::DynamicMemoryUsage() const
+{
+    return memusage::DynamicUsage(m_slots) + memusage::DynamicUsage(m_filter) +
+           memusage::DynamicUsage(m_scripts) + memusage::DynamicUsage(m_owners);
+}
+} // namespace wallet
@@ -0,0 +1,128 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_WALLET_SCRIPTPUBKEYCACHE_H
+#define BITCOIN_WALLET_SCRIPTPUBKEYCACHE_H
+
+#include <script/script.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace wallet {
+class ScriptPubKeyMan;
+
+/**
+ * Wallet-wide index from scriptPubKey to the ScriptPubKeyMan(s) that own it
+ * and the descriptor range index at which each of them derived it.
+ *
+ * This is consulted for every output of every transaction the wallet sees, and
+ * almost all of those lookups are misses. The table is therefore laid out for
+ * that case:
+ *  - a small blocked Bloom filter (two bits within a single 64-bit word per
+ *    key) answers most misses without touching the table at all,
+ *  - the table itself is open-addressed with linear probing over fixed-size
+ *    slots, so a lookup is one salted SipHash and usually one cache line,
+ *  - script bytes are stored once in a contiguous arena instead of one
+ *    CScript allocation per map node.
+ *
+ * A script owned by several ScriptPubKeyMans occupies one slot per owner;
+ * the script bytes are shared between them. Entries are never removed, which
+ * matches how the wallet uses its scriptPubKey cache.
+ */
+class ScriptPubKeyCache
+{
+public:
+    struct Entry {
+        ScriptPubKeyMan* spkm;
+        int32_t index;
+    };
+
+    ScriptPubKeyCache();
+
+    /**
+     * Record that spkm derives script at the given range index. If the pair is
+     * already present only the index is updated.
+     * @returns true if a new (script, spkm) pair was added.
+     */
+    bool Insert(const CScript& script, ScriptPubKeyMan* spkm, int32_t index);
+
+    /** Cheap pre-check. False means the script is definitely not cached. */
+    bool MayContain(const CScript& script) const { return MayContain(Hash(script)); }
+
+    /** Return the first owner of script, or an entry with spkm == nullptr if there is none. */
+    Entry Find(const CScript& script) const;
+
+    /** Call fn(const Entry&) for every owner of script. */
+    template <typename Fn>
+    void ForEach(const CScript& script, Fn&& fn) const
+    {
+        const uint64_t hash{Hash(script)};
+        if (!MayContain(hash)) return;
+        for (size_t pos = hash & m_mask;; pos = (pos + 1) & m_mask) {
+            const Slot& slot{m_slots[pos]};
+            if (slot.IsEmpty()) return;
+            if (slot.hash == hash && Matches(slot, script)) fn(Entry{m_owners[slot.owner], slot.index});
+        }
+    }
+
+    bool Contains(const CScript& script) const { return Find(script).spkm != nullptr; }
+
+    /** Number of (script, spkm) pairs. */
+    size_t Size() const { return m_size; }
+    bool Empty() const { return m_size == 0; }
+
+    size_t DynamicMemoryUsage() const;
+
+private:
+    static constexpr uint32_t NO_OWNER{std::numeric_limits<uint32_t>::max()};
+
+    struct Slot {
+        uint64_t hash{0};
+        uint32_t script_offset{0};
+        uint32_t script_size{0};
+        uint32_t owner{NO_OWNER};
+        int32_t index{0};
+
+        bool IsEmpty() const { return owner == NO_OWNER; }
+    };
+    static_assert(sizeof(Slot) == 24);
+
+    //! SipHash salt, so that scripts chosen by a third party cannot be used to degrade probing.
+    const uint64_t m_k0, m_k1;
+
+    std::vector<Slot> m_slots;
+    std::vector<uint64_t> m_filter;
+    std::vector<unsigned char> m_scripts;
+    //! Distinct owners, referenced by Slot::owner. Wallets have few ScriptPubKeyMans.
+    std::vector<ScriptPubKeyMan*> m_owners;
+    size_t m_mask{0};
+    size_t m_size{0};
+
+    uint64_t Hash(const CScript& script) const;
+    bool Matches(const Slot& slot, const CScript& script) const
+    {
+        return slot.script_size == script.size() && std::equal(script.begin(), script.end(), m_scripts.begin() + slot.script_offset);
+    }
+    uint32_t OwnerId(ScriptPubKeyMan* spkm);
+
+    static uint64_t FilterBits(uint64_t hash) { return (uint64_t{1} << ((hash >> 52) & 63)) | (uint64_t{1} << ((hash >> 58) & 63)); }
+    size_t FilterWord(uint64_t hash) const { return ((hash * 0x9E3779B97F4A7C15ULL) >> 32) & (m_filter.size() - 1); }
+    bool MayContain(uint64_t hash) const
+    {
+        if (m_size == 0) return false;
+        const uint64_t bits{FilterBits(hash)};
+        return (m_filter[FilterWord(hash)] & bits) == bits;
+    }
+
+    //! Double the table (and filter) capacity and reinsert every slot.
+    void Grow();
+    void PlaceSlot(const Slot& slot);
+};
+} // namespace wallet
+
+#endif // BITCOIN_WALLET_SCRIPTPUBKEYCACHE_H
@@ -53,8 +53,8 @@ public:
     virtual bool WithEncryptionKey(std::function<bool (const CKeyingMaterial&)> cb) const = 0;
     virtual bool HasEncryptionKeys() const = 0;
     virtual bool IsLocked() const = 0;
-    //! Callback function for after TopUp completes containing any scripts that were added by a SPKMan
-    virtual void TopUpCallback(const std::set<CScript>&, ScriptPubKeyMan*) = 0;
+    //! Callback function for after TopUp completes containing any scripts that were added by a SPKMan, with their range index
+    virtual void TopUpCallback(const std::map<CScript, int32_t>&, ScriptPubKeyMan*) = 0;
 };
 
 //! Constant representing an unknown spkm creation time
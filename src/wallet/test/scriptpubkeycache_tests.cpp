@@ -0,0 +1,78 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <script/script.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <wallet/scriptpubkeycache.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <set>
+#include <vector>
+
+namespace wallet {
+BOOST_FIXTURE_TEST_SUITE(scriptpubkeycache_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(scriptpubkeycache_insert_find)
+{
+    ScriptPubKeyCache cache;
+    // Owners are only used as opaque pointers
+    auto* spkm_a{reinterpret_cast<ScriptPubKeyMan*>(uintptr_t{0x10})};
+    auto* spkm_b{reinterpret_cast<ScriptPubKeyMan*>(uintptr_t{0x20})};
+
+    std::vector<CScript> scripts;
+    for (int i = 0; i < 5000; ++i) {
+        scripts.push_back(CScript() << OP_0 << m_rng.randbytes(20));
+        BOOST_CHECK(cache.Insert(scripts.back(), spkm_a, i));
+    }
+    BOOST_CHECK_EQUAL(cache.Size(), scripts.size());
+
+    for (size_t i = 0; i < scripts.size(); ++i) {
+        const auto entry{cache.Find(scripts[i])};
+        BOOST_CHECK(entry.spkm == spkm_a);
+        BOOST_CHECK_EQUAL(entry.index, int32_t(i));
+    }
+
+    // Unknown scripts, including prefixes of known ones, are not found
+    BOOST_CHECK(!cache.Contains(CScript() << OP_0 << m_rng.randbytes(20)));
+    BOOST_CHECK(!cache.Contains(CScript(scripts[0].begin(), scripts[0].end() - 1)));
+    BOOST_CHECK(!cache.Contains(CScript()));
+
+    // Re-inserting an existing pair only updates the index
+    BOOST_CHECK(!cache.Insert(scripts[7], spkm_a, 42));
+    BOOST_CHECK_EQUAL(cache.Find(scripts[7]).index, 42);
+    BOOST_CHECK_EQUAL(cache.Size(), scripts.size());
+
+    // A second owner for the same script is reported alongside the first
+    BOOST_CHECK(cache.Insert(scripts[7], spkm_b, 3));
+    std::set<ScriptPubKeyMan*> owners;
+    cache.ForEach(scripts[7], [&](const ScriptPubKeyCache::Entry& entry) { owners.insert(entry.spkm); });
+    BOOST_CHECK(owners == (std::set<ScriptPubKeyMan*>{spkm_a, spkm_b}));
+    BOOST_CHECK_EQUAL(cache.Size(), scripts.size() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(scriptpubkeycache_filter)
+{
+    ScriptPubKeyCache cache;
+    auto* spkm{reinterpret_cast<ScriptPubKeyMan*>(uintptr_t{0x10})};
+    BOOST_CHECK(!cache.MayContain(CScript() << OP_TRUE));
+
+    for (int i = 0; i < 10000; ++i) {
+        const CScript script{CScript() << OP_1 << m_rng.randbytes(32)};
+        cache.Insert(script, spkm, i);
+        // No false negatives
+        BOOST_CHECK(cache.MayContain(script));
+    }
+
+    // The filter should reject the vast majority of unknown scripts
+    int false_positives{0};
+    for (int i = 0; i < 10000; ++i) {
+        if (cache.MayContain(CScript() << OP_1 << m_rng.randbytes(32))) ++false_positives;
+    }
+    BOOST_CHECK_LT(false_positives, 500);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+} // namespace wallet
@@ -19,6 +19,7 @@
 #include <consensus/amount.h>
 #include <consensus/consensus.h>
 #include <consensus/validation.h>
+#include <core_memusage.h>
 #include <external_signer.h>
 #include <interfaces/chain.h>
 #include <interfaces/handler.h>
@@ -28,6 +29,7 @@
 #include <key.h>
 #include <key_io.h>
 #include <logging.h>
+#include <memusage.h>
 #include <node/types.h>
 #include <outputtype.h>
 #include <policy/feerate.h>
@@ -1007,6 +1009,7 @@ bool CWallet::MarkReplaced(const uint256& originalHash, const uint256& newHash)
 
     // Refresh mempool status without waiting for transactionRemovedFromMempool or transactionAddedToMempool
     RefreshMempoolStatus(wtx, chain());
+    UpdateTxHeightIndex(wtx);
 
     WalletBatch batch(GetDatabase());
 
@@ -1125,6 +1128,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
             fUpdated = true;
         }
     }
+    UpdateTxHeightIndex(wtx);
 
     // Mark inactive coinbase transactions and their descendants as abandoned
     if (wtx.IsCoinBase() && wtx.isInactive()) {
@@ -1136,6 +1140,7 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
             CWalletTx* desc_tx = txs.back();
             txs.pop_back();
             desc_tx->m_state = inactive_state;
+            UpdateTxHeightIndex(*desc_tx);
             // Break caches since we have changed the state
             desc_tx->MarkDirty();
             batch.WriteTx(*desc_tx);
@@ -1198,6 +1203,23 @@ CWalletTx* CWallet::AddToWallet(CTransactionRef tx, const TxState& state, const
     return &wtx;
 }
 
+int CWallet::GetTxIndexHeight(const CWalletTx& wtx)
+{
+    if (auto* conf = wtx.state<TxStateConfirmed>()) return conf->confirmed_block_height;
+    if (auto* conf = wtx.state<TxStateBlockConflicted>()) return conf->conflicting_block_height;
+    return TX_HEIGHT_UNCONFIRMED;
+}
+
+void CWallet::UpdateTxHeightIndex(CWalletTx& wtx)
+{
+    AssertLockHeld(cs_wallet);
+    const int height{GetTxIndexHeight(wtx)};
+    if (wtx.m_indexed_height == height) return;
+    if (wtx.m_indexed_height) m_txs_by_height.erase({*wtx.m_indexed_height, wtx.GetHash()});
+    m_txs_by_height.emplace(height, wtx.GetHash());
+    wtx.m_indexed_height = height;
+}
+
 bool CWallet::LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx)
 {
     const auto& ins = mapWallet.emplace(std::piecewise_construct, std::forward_as_tuple(hash), std::forward_as_tuple(nullptr, TxStateInactive{}));
@@ -1212,7 +1234,10 @@ bool CWallet::LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx
     }
     if (/* insertion took place */ ins.second) {
         wtx.m_it_wtxOrdered = wtxOrdered.insert(std::make_pair(wtx.nOrderPos, &wtx));
+        // fill_wtx may have copied the index position of a transaction in another wallet
+        wtx.m_indexed_height.reset();
     }
+    UpdateTxHeightIndex(wtx);
     AddToSpends(wtx);
     for (const CTxIn& txin : wtx.tx->vin) {
         auto it = mapWallet.find(txin.prevout.hash);
@@ -1403,6 +1428,7 @@ void CWallet::RecursiveUpdateTxState(WalletBatch* batch, const uint256& tx_hash,
 
         TxUpdate update_state = try_updating_state(wtx);
         if (update_state != TxUpdate::UNCHANGED) {
+            UpdateTxHeightIndex(wtx);
             wtx.MarkDirty();
             if (batch) batch->WriteTx(wtx);
             // Iterate over all its outputs, and update those tx states as well (if applicable)
@@ -1444,6 +1470,7 @@ void CWallet::transactionAddedToMempool(const CTransactionRef& tx) {
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        UpdateTxHeightIndex(it->second);
     }
 
     const Txid& txid = tx->GetHash();
@@ -1466,6 +1493,7 @@ void CWallet::transactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRe
     auto it = mapWallet.find(tx->GetHash());
     if (it != mapWallet.end()) {
         RefreshMempoolStatus(it->second, chain());
+        UpdateTxHeightIndex(it->second);
     }
     // Handle transactions that were removed from the mempool because they
     // conflict with transactions in a newly connected block.
@@ -1518,8 +1546,27 @@ void CWallet::blockConnected(ChainstateRole role, const interfaces::BlockInfo& b
     if (role == ChainstateRole::BACKGROUND) {
         return;
     }
-    assert(block.data);
     LOCK(cs_wallet);
+    ConnectBlock(block);
+}
+
+void CWallet::blocksConnected(ChainstateRole role, const std::vector<interfaces::BlockInfo>& blocks)
+{
+    if (role == ChainstateRole::BACKGROUND) {
+        return;
+    }
+    // Process the whole batch under one lock, so that other users of the wallet
+    // wait once for the batch instead of competing with it between blocks.
+    LOCK(cs_wallet);
+    for (const interfaces::BlockInfo& block : blocks) {
+        ConnectBlock(block);
+    }
+}
+
+void CWallet::ConnectBlock(const interfaces::BlockInfo& block)
+{
+    AssertLockHeld(cs_wallet);
+    assert(block.data);
 
     m_last_block_processed_height = block.height;
     m_last_block_processed = block.hash;
@@ -1628,16 +1675,10 @@ isminetype CWallet::IsMine(const CScript& script) const
 {
     AssertLockHeld(cs_wallet);
 
-    // Search the cache so that IsMine is called only on the relevant SPKMs instead of on everything in m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
-        isminetype res = ISMINE_NO;
-        for (const auto& spkm : it->second) {
-            res = std::max(res, spkm->IsMine(script));
-        }
-        Assume(res == ISMINE_SPENDABLE);
-        return res;
-    }
+    // Every script in the cache was derived by a descriptor SPKM, which makes it spendable, so
+    // there is no need to ask the SPKMs themselves. Most scripts are not ours, and those are
+    // usually rejected by the cache's filter without probing the table.
+    if (m_cached_spks.Contains(script)) return ISMINE_SPENDABLE;
 
     // Legacy wallet
     if (LegacyScriptPubKeyMan* spkm = GetLegacyScriptPubKeyMan()) {
@@ -2443,6 +2484,7 @@ util::Result<void> CWallet::RemoveTxs(WalletBatch& batch, std::vector<uint256>&
         for (const auto& it : erased_txs) {
             const uint256 hash{it->first};
             wtxOrdered.erase(it->second.m_it_wtxOrdered);
+            if (it->second.m_indexed_height) m_txs_by_height.erase({*it->second.m_indexed_height, it->second.GetHash()});
             for (const auto& txin : it->second.tx->vin)
                 mapTxSpends.erase(txin.prevout);
             mapWallet.erase(it);
@@ -2560,6 +2602,16 @@ size_t CWallet::KeypoolCountExternalKeys() const
     return count;
 }
 
+size_t CWallet::DynamicMemoryUsage() const
+{
+    LOCK(cs_wallet);
+    size_t usage{memusage::DynamicUsage(mapWallet) + memusage::DynamicUsage(mapTxSpends) + m_cached_spks.DynamicMemoryUsage()};
+    for (const auto& [txid, wtx] : mapWallet) {
+        usage += RecursiveDynamicUsage(wtx.tx);
+    }
+    return usage;
+}
+
 unsigned int CWallet::GetKeyPoolSize() const
 {
     AssertLockHeld(cs_wallet);
@@ -3594,10 +3646,7 @@ std::set<ScriptPubKeyMan*> CWallet::GetScriptPubKeyMans(const CScript& script) c
     std::set<ScriptPubKeyMan*> spk_mans;
 
     // Search the cache for relevant SPKMs instead of iterating m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
-        spk_mans.insert(it->second.begin(), it->second.end());
-    }
+    m_cached_spks.ForEach(script, [&](const ScriptPubKeyCache::Entry& entry) { spk_mans.insert(entry.spkm); });
     SignatureData sigdata;
     Assume(std::all_of(spk_mans.begin(), spk_mans.end(), [&script, &sigdata](ScriptPubKeyMan* spkm) { return spkm->CanProvide(script, sigdata); }));
 
@@ -3625,11 +3674,10 @@ std::unique_ptr<SigningProvider> CWallet::GetSolvingProvider(const CScript& scri
 std::unique_ptr<SigningProvider> CWallet::GetSolvingProvider(const CScript& script, SignatureData& sigdata) const
 {
     // Search the cache for relevant SPKMs instead of iterating m_spk_managers
-    const auto& it = m_cached_spks.find(script);
-    if (it != m_cached_spks.end()) {
+    if (const auto entry{m_cached_spks.Find(script)}; entry.spkm) {
         // All spkms for a given script must already be able to make a SigningProvider for the script, so just return the first one.
-        Assume(it->second.at(0)->CanProvide(script, sigdata));
-        return it->second.at(0)->GetSolvingProvider(script);
+        Assume(entry.spkm->CanProvide(script, sigdata));
+        return entry.spkm->GetSolvingProvider(script);
     }
 
     // Legacy wallet
@@ -4113,9 +4161,9 @@ util::Result<void> CWallet::ApplyMigrationData(WalletBatch& local_wallet_batch,
 
     // When the legacy wallet has no spendable scripts, the main wallet will be empty, leaving its script cache empty as well.
     // The watch-only and/or solvable wallet(s) will contain the scripts in their respective caches.
-    if (!data.desc_spkms.empty()) Assume(!m_cached_spks.empty());
-    if (!data.watch_descs.empty()) Assume(!data.watchonly_wallet->m_cached_spks.empty());
-    if (!data.solvable_descs.empty()) Assume(!data.solvable_wallet->m_cached_spks.empty());
+    if (!data.desc_spkms.empty()) Assume(!m_cached_spks.Empty());
+    if (!data.watch_descs.empty()) Assume(!data.watchonly_wallet->m_cached_spks.Empty());
+    if (!data.solvable_descs.empty()) Assume(!data.solvable_wallet->m_cached_spks.Empty());
 
     for (auto& desc_spkm : data.desc_spkms) {
         if (m_spk_managers.count(desc_spkm->GetID()) > 0) {
@@ -4625,14 +4673,14 @@ util::Result<MigrationResult> MigrateLegacyToDescriptor(std::shared_ptr<CWallet>
     return res;
 }
 
-void CWallet::CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
+void CWallet::CacheNewScriptPubKeys(const std::map<CScript, int32_t>& spks, ScriptPubKeyMan* spkm)
 {
-    for (const auto& script : spks) {
-        m_cached_spks[script].push_back(spkm);
+    for (const auto& [script, index] : spks) {
+        m_cached_spks.Insert(script, spkm, index);
     }
 }
 
-void CWallet::TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm)
+void CWallet::TopUpCallback(const std::map<CScript, int32_t>& spks, ScriptPubKeyMan* spkm)
 {
     // Update scriptPubKey cache
     CacheNewScriptPubKeys(spks, spkm);
@@ -29,6 +29,7 @@
 #include <util/ui_change_type.h>
 #include <wallet/crypter.h>
 #include <wallet/db.h>
+#include <wallet/scriptpubkeycache.h>
 #include <wallet/scriptpubkeyman.h>
 #include <wallet/transaction.h>
 #include <wallet/types.h>
@@ -372,6 +373,9 @@ private:
 
     void SyncTransaction(const CTransactionRef& tx, const SyncTxState& state, bool update_tx = true, bool rescanning_old_block = false) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
 
+    /** Update the last processed block and sync the transactions of a newly connected block */
+    void ConnectBlock(const interfaces::BlockInfo& block) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     /** WalletFlags set on this wallet. */
     std::atomic<uint64_t> m_wallet_flags{0};
 
@@ -425,8 +429,8 @@ private:
     /** Store wallet flags */
     void SetWalletFlagWithDB(WalletBatch& batch, uint64_t flags);
 
-    //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to set of spkms
-    std::unordered_map<CScript, std::vector<ScriptPubKeyMan*>, SaltedSipHasher> m_cached_spks;
+    //! Cache of descriptor ScriptPubKeys used for IsMine. Maps ScriptPubKey to the owning spkms and range indexes
+    ScriptPubKeyCache m_cached_spks;
 
     /**
      * Catch wallet up to current chain, scanning new blocks, updating the best
@@ -486,6 +490,18 @@ public:
     typedef std::multimap<int64_t, CWalletTx*> TxItems;
     TxItems wtxOrdered;
 
+    //! Height used in m_txs_by_height for transactions that are neither confirmed nor conflicted by a block
+    static constexpr int TX_HEIGHT_UNCONFIRMED{std::numeric_limits<int>::max()};
+    /**
+     * All wallet transactions, ordered by the height of the block that confirmed
+     * (or conflicted) them, unconfirmed transactions last. Ties are broken by txid
+     * so that (height, txid) can serve as a stable pagination cursor. Kept up to
+     * date by UpdateTxHeightIndex() whenever a transaction's state changes.
+     */
+    std::set<std::pair<int, Txid>> m_txs_by_height GUARDED_BY(cs_wallet);
+    static int GetTxIndexHeight(const CWalletTx& wtx);
+    void UpdateTxHeightIndex(CWalletTx& wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
+
     int64_t nOrderPosNext GUARDED_BY(cs_wallet) = 0;
 
     std::map<CTxDestination, CAddressBookData> m_address_book GUARDED_BY(cs_wallet);
@@ -611,6 +627,7 @@ public:
     bool LoadToWallet(const uint256& hash, const UpdateWalletTxFn& fill_wtx) EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     void transactionAddedToMempool(const CTransactionRef& tx) override;
     void blockConnected(ChainstateRole role, const interfaces::BlockInfo& block) override;
+    void blocksConnected(ChainstateRole role, const std::vector<interfaces::BlockInfo>& blocks) override;
     void blockDisconnected(const interfaces::BlockInfo& block) override;
     void updatedBlockTip() override;
     int64_t RescanFromTime(int64_t startTime, const WalletRescanReserver& reserver, bool update);
@@ -739,6 +756,9 @@ public:
     size_t KeypoolCountExternalKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
     bool TopUpKeyPool(unsigned int kpSize = 0);
 
+    //! Approximate memory used by the wallet transactions, the spends index and the scriptPubKey cache, in bytes.
+    size_t DynamicMemoryUsage() const EXCLUSIVE_LOCKS_REQUIRED(!cs_wallet);
+
     std::optional<int64_t> GetOldestKeyPoolTime() const;
 
     // Filter struct for 'ListAddrBookAddresses'
@@ -1059,9 +1079,9 @@ public:
     bool CanGrindR() const;
 
     //! Add scriptPubKeys for this ScriptPubKeyMan into the scriptPubKey cache
-    void CacheNewScriptPubKeys(const std::set<CScript>& spks, ScriptPubKeyMan* spkm);
+    void CacheNewScriptPubKeys(const std::map<CScript, int32_t>& spks, ScriptPubKeyMan* spkm);
 
-    void TopUpCallback(const std::set<CScript>& spks, ScriptPubKeyMan* spkm) override;
+    void TopUpCallback(const std::map<CScript, int32_t>& spks, ScriptPubKeyMan* spkm) override;
 
     //! Retrieve the xpubs in use by the active descriptors
     std::set<CExtPubKey> GetActiveHDPubKeys() const EXCLUSIVE_LOCKS_REQUIRED(cs_wallet);
@@ -4,21 +4,51 @@
 
 #include <zmq/zmqabstractnotifier.h>
 
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <serialize.h>
+#include <streams.h>
+
 #include <cassert>
 
 const int CZMQAbstractNotifier::DEFAULT_ZMQ_SNDHWM;
 
+const ZMQSerialized& ZMQTransaction::Serialized() const
+{
+    if (!m_serialized) {
+        std::vector<uint8_t> data;
+        data.reserve(m_tx.GetTotalSize());
+        VectorWriter{data, 0, TX_WITH_WITNESS(m_tx)};
+        m_serialized = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    }
+    return m_serialized;
+}
+
+const ZMQSerialized& ZMQBlock::Serialized(const ReadBlockFn& read_block) const
+{
+    if (!m_serialized) {
+        std::vector<uint8_t> data;
+        if (m_block) {
+            VectorWriter{data, 0, TX_WITH_WITNESS(*m_block)};
+        } else if (!read_block(data, m_index)) {
+            return m_serialized;
+        }
+        m_serialized = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+    }
+    return m_serialized;
+}
+
 CZMQAbstractNotifier::~CZMQAbstractNotifier()
 {
     assert(!psocket);
 }
 
-bool CZMQAbstractNotifier::NotifyBlock(const CBlockIndex * /*CBlockIndex*/)
+bool CZMQAbstractNotifier::NotifyBlock(const ZMQBlock& /*block*/)
 {
     return true;
 }
 
-bool CZMQAbstractNotifier::NotifyTransaction(const CTransaction &/*transaction*/)
+bool CZMQAbstractNotifier::NotifyTransaction(const ZMQTransaction& /*transaction*/)
 {
     return true;
 }
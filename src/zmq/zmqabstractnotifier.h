@@ -9,13 +9,64 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
+class CBlock;
 class CBlockIndex;
 class CTransaction;
 class CZMQAbstractNotifier;
+class ZMQPublisher;
+struct ZMQPublishStats;
 
 using CZMQNotifierFactory = std::function<std::unique_ptr<CZMQAbstractNotifier>()>;
 
+//! A serialized block or transaction, shared by all notifiers that publish it.
+using ZMQSerialized = std::shared_ptr<const std::vector<uint8_t>>;
+
+/**
+ * A transaction being notified. It is serialized the first time a notifier
+ * needs the raw bytes, and the result is shared with the other notifiers.
+ */
+class ZMQTransaction
+{
+public:
+    explicit ZMQTransaction(const CTransaction& tx, ZMQSerialized serialized = {})
+        : m_tx{tx}, m_serialized{std::move(serialized)} {}
+
+    const CTransaction& Get() const { return m_tx; }
+    //! The transaction with witness data.
+    const ZMQSerialized& Serialized() const;
+    //! The serialization if a notifier has needed it, or nullptr.
+    const ZMQSerialized& SerializedIfComputed() const { return m_serialized; }
+
+private:
+    const CTransaction& m_tx;
+    mutable ZMQSerialized m_serialized;
+};
+
+/**
+ * A block being notified, with the block itself when it is still in memory.
+ * Like ZMQTransaction, it is serialized at most once.
+ */
+class ZMQBlock
+{
+public:
+    using ReadBlockFn = std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)>;
+
+    ZMQBlock(const CBlockIndex& index, std::shared_ptr<const CBlock> block)
+        : m_index{index}, m_block{std::move(block)} {}
+
+    const CBlockIndex& Index() const { return m_index; }
+    //! The block with witness data, read with read_block if it is not in memory.
+    //! Returns nullptr if reading fails.
+    const ZMQSerialized& Serialized(const ReadBlockFn& read_block) const;
+
+private:
+    const CBlockIndex& m_index;
+    const std::shared_ptr<const CBlock> m_block;
+    mutable ZMQSerialized m_serialized;
+};
+
 class CZMQAbstractNotifier
 {
 public:
@@ -41,11 +92,14 @@ public:
         }
     }
 
-    virtual bool Initialize(void *pcontext) = 0;
+    //! Set up the socket in pcontext. Messages are sent by publisher.
+    virtual bool Initialize(void *pcontext, ZMQPublisher& publisher) = 0;
     virtual void Shutdown() = 0;
+    //! Message counts, once initialized.
+    virtual const ZMQPublishStats* GetStats() const { return nullptr; }
 
     // Notifies of ConnectTip result, i.e., new active tip only
-    virtual bool NotifyBlock(const CBlockIndex *pindex);
+    virtual bool NotifyBlock(const ZMQBlock& block);
     // Notifies of every block connection
     virtual bool NotifyBlockConnect(const CBlockIndex *pindex);
     // Notifies of every block disconnection
@@ -55,7 +109,7 @@ public:
     // Notifies of every mempool removal, except inclusion in blocks
     virtual bool NotifyTransactionRemoval(const CTransaction &transaction, uint64_t mempool_sequence);
     // Notifies of transactions added to mempool or appearing in blocks
-    virtual bool NotifyTransaction(const CTransaction &transaction);
+    virtual bool NotifyTransaction(const ZMQTransaction& transaction);
 
 protected:
     void* psocket{nullptr};
@@ -4,6 +4,7 @@
 
 #include <zmq/zmqnotificationinterface.h>
 
+#include <chain.h>
 #include <common/args.h>
 #include <kernel/chain.h>
 #include <kernel/mempool_entry.h>
@@ -13,11 +14,13 @@
 #include <primitives/transaction.h>
 #include <validationinterface.h>
 #include <zmq/zmqabstractnotifier.h>
+#include <zmq/zmqpublisher.h>
 #include <zmq/zmqpublishnotifier.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
 
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <string>
@@ -40,7 +43,7 @@ std::list<const CZMQAbstractNotifier*> CZMQNotificationInterface::GetActiveNotif
     return result;
 }
 
-std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)> get_block_by_index)
+std::unique_ptr<CZMQNotificationInterface> CZMQNotificationInterface::Create(ZMQBlock::ReadBlockFn get_block_by_index)
 {
     std::map<std::string, CZMQNotifierFactory> factories;
     factories["pubhashblock"] = CZMQAbstractNotifier::Create<CZMQPublishHashBlockNotifier>;
@@ -101,8 +104,10 @@ bool CZMQNotificationInterface::Initialize()
         return false;
     }
 
+    m_publisher = std::make_unique<ZMQPublisher>();
+
     for (auto& notifier : notifiers) {
-        if (notifier->Initialize(pcontext)) {
+        if (notifier->Initialize(pcontext, *m_publisher)) {
             LogDebug(BCLog::ZMQ, "Notifier %s ready (address = %s)\n", notifier->GetType(), notifier->GetAddress());
         } else {
             LogDebug(BCLog::ZMQ, "Notifier %s failed (address = %s)\n", notifier->GetType(), notifier->GetAddress());
@@ -123,6 +128,7 @@ void CZMQNotificationInterface::Shutdown()
             LogDebug(BCLog::ZMQ, "Shutdown notifier %s at %s\n", notifier->GetType(), notifier->GetAddress());
             notifier->Shutdown();
         }
+        m_publisher.reset();
         zmq_ctx_term(pcontext);
 
         pcontext = nullptr;
@@ -147,13 +153,33 @@ void TryForEachAndRemoveFailed(std::list<std::unique_ptr<CZMQAbstractNotifier>>&
 
 } // anonymous namespace
 
+void CZMQNotificationInterface::NotifyTransaction(const CTransaction& tx)
+{
+    ZMQSerialized kept;
+    if (const auto it{m_kept_txs.find(tx.GetWitnessHash())}; it != m_kept_txs.end()) {
+        kept = std::move(it->second);
+        m_kept_tx_bytes -= kept->size();
+        m_kept_txs.erase(it);
+    }
+    const ZMQTransaction transaction{tx, std::move(kept)};
+    TryForEachAndRemoveFailed(notifiers, [&transaction](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyTransaction(transaction);
+    });
+}
+
 void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload)
 {
+    // Publish the tip from memory when it is the block that was just connected,
+    // rather than reading it back from disk.
+    std::shared_ptr<const CBlock> block{std::move(m_last_connected_block)};
+    if (block && block->GetHash() != pindexNew->GetBlockHash()) block.reset();
+
     if (fInitialDownload || pindexNew == pindexFork) // In IBD or blocks were disconnected without any new ones
         return;
 
-    TryForEachAndRemoveFailed(notifiers, [pindexNew](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyBlock(pindexNew);
+    const ZMQBlock zmq_block{*pindexNew, std::move(block)};
+    TryForEachAndRemoveFailed(notifiers, [&zmq_block](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyBlock(zmq_block);
     });
 }
 
@@ -161,9 +187,29 @@ void CZMQNotificationInterface::TransactionAddedToMempool(const NewMempoolTransa
 {
     const CTransaction& tx = *(ptx.info.m_tx);
 
-    TryForEachAndRemoveFailed(notifiers, [&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
-        return notifier->NotifyTransaction(tx) && notifier->NotifyTransactionAcceptance(tx, mempool_sequence);
+    const ZMQTransaction transaction{tx};
+    TryForEachAndRemoveFailed(notifiers, [&transaction, mempool_sequence](CZMQAbstractNotifier* notifier) {
+        return notifier->NotifyTransaction(transaction) && notifier->NotifyTransactionAcceptance(transaction.Get(), mempool_sequence);
     });
+
+    // Keep the serialization, if one was needed, for when the transaction is mined.
+    if (const ZMQSerialized& serialized{transaction.SerializedIfComputed()}) {
+        if (m_kept_txs.emplace(tx.GetWitnessHash(), serialized).second) {
+            m_kept_txs_order.push_back(tx.GetWitnessHash());
+            m_kept_tx_bytes += serialized->size();
+        }
+        while (m_kept_tx_bytes > MAX_KEPT_TX_BYTES) {
+            if (const auto it{m_kept_txs.find(m_kept_txs_order.front())}; it != m_kept_txs.end()) {
+                m_kept_tx_bytes -= it->second->size();
+                m_kept_txs.erase(it);
+            }
+            m_kept_txs_order.pop_front();
+        }
+        // Drop the ids of transactions that are no longer kept, so the queue stays bounded.
+        if (m_kept_txs_order.size() > 2 * m_kept_txs.size() + 1000) {
+            std::erase_if(m_kept_txs_order, [&](const Wtxid& wtxid) { return !m_kept_txs.contains(wtxid); });
+        }
+    }
 }
 
 void CZMQNotificationInterface::TransactionRemovedFromMempool(const CTransactionRef& ptx, MemPoolRemovalReason reason, uint64_t mempool_sequence)
@@ -171,6 +217,11 @@ void CZMQNotificationInterface::TransactionRemovedFromMempool(const CTransaction
     // Called for all non-block inclusion reasons
     const CTransaction& tx = *ptx;
 
+    if (const auto it{m_kept_txs.find(tx.GetWitnessHash())}; it != m_kept_txs.end()) {
+        m_kept_tx_bytes -= it->second->size();
+        m_kept_txs.erase(it);
+    }
+
     TryForEachAndRemoveFailed(notifiers, [&tx, mempool_sequence](CZMQAbstractNotifier* notifier) {
         return notifier->NotifyTransactionRemoval(tx, mempool_sequence);
     });
@@ -181,11 +232,9 @@ void CZMQNotificationInterface::BlockConnected(ChainstateRole role, const std::s
     if (role == ChainstateRole::BACKGROUND) {
         return;
     }
+    m_last_connected_block = pblock;
     for (const CTransactionRef& ptx : pblock->vtx) {
-        const CTransaction& tx = *ptx;
-        TryForEachAndRemoveFailed(notifiers, [&tx](CZMQAbstractNotifier* notifier) {
-            return notifier->NotifyTransaction(tx);
-        });
+        NotifyTransaction(*ptx);
     }
 
     // Next we notify BlockConnect listeners for *all* blocks
@@ -197,10 +246,7 @@ void CZMQNotificationInterface::BlockConnected(ChainstateRole role, const std::s
 void CZMQNotificationInterface::BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected)
 {
     for (const CTransactionRef& ptx : pblock->vtx) {
-        const CTransaction& tx = *ptx;
-        TryForEachAndRemoveFailed(notifiers, [&tx](CZMQAbstractNotifier* notifier) {
-            return notifier->NotifyTransaction(tx);
-        });
+        NotifyTransaction(*ptx);
     }
 
     // Next we notify BlockDisconnect listeners for *all* blocks
@@ -7,17 +7,22 @@
 #define BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
 
 #include <primitives/transaction.h>
+#include <util/hasher.h>
 #include <validationinterface.h>
+#include <zmq/zmqabstractnotifier.h>
+#include <zmq/zmqpublisher.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <list>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class CBlock;
 class CBlockIndex;
-class CZMQAbstractNotifier;
 struct NewMempoolTransactionInfo;
 
 class CZMQNotificationInterface final : public CValidationInterface
@@ -27,7 +32,10 @@ public:
 
     std::list<const CZMQAbstractNotifier*> GetActiveNotifiers() const;
 
-    static std::unique_ptr<CZMQNotificationInterface> Create(std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)> get_block_by_index);
+    static std::unique_ptr<CZMQNotificationInterface> Create(ZMQBlock::ReadBlockFn get_block_by_index);
+
+    //! Limit on the serialized transactions kept for when they are mined.
+    static constexpr size_t MAX_KEPT_TX_BYTES{32 << 20};
 
 protected:
     bool Initialize();
@@ -39,12 +47,27 @@ protected:
     void BlockConnected(ChainstateRole role, const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexConnected) override;
     void BlockDisconnected(const std::shared_ptr<const CBlock>& pblock, const CBlockIndex* pindexDisconnected) override;
     void UpdatedBlockTip(const CBlockIndex *pindexNew, const CBlockIndex *pindexFork, bool fInitialDownload) override;
+    std::string ValidationInterfaceName() const override { return "zmq"; }
 
 private:
     CZMQNotificationInterface();
 
+    //! Notify of a transaction, reusing its serialization if it was kept.
+    void NotifyTransaction(const CTransaction& tx);
+
     void* pcontext{nullptr};
+    std::unique_ptr<ZMQPublisher> m_publisher;
     std::list<std::unique_ptr<CZMQAbstractNotifier>> notifiers;
+
+    // Validation interface callbacks are serialized, so the members below need no lock.
+
+    //! The last block connected to the active chain, for the tip notification that follows.
+    std::shared_ptr<const CBlock> m_last_connected_block;
+    //! Serializations of transactions published when they entered the mempool.
+    std::unordered_map<Wtxid, ZMQSerialized, SaltedTxidHasher> m_kept_txs;
+    //! Kept transactions, oldest first. May also list transactions no longer kept.
+    std::deque<Wtxid> m_kept_txs_order;
+    size_t m_kept_tx_bytes{0};
 };
 
 extern std::unique_ptr<CZMQNotificationInterface> g_zmq_notification_interface;
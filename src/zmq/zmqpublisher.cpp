@@ -0,0 +1,135 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <zmq/zmqpublisher.h>
+
+#include <tinyformat.h>
+#include <util/threadnames.h>
+#include <zmq/zmqpublishnotifier.h>
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+ZMQPublishStats::ZMQPublishStats(const std::string& topic, const std::string& address)
+    : published{"atcoin_zmq_published_total", "ZMQ messages handed to libzmq, by notifier",
+                strprintf(R"(topic="%s",address="%s")", topic, address)},
+      dropped{"atcoin_zmq_dropped_total", "ZMQ messages dropped because the publish queue was full, by notifier",
+              strprintf(R"(topic="%s",address="%s")", topic, address)},
+      queued{"atcoin_zmq_queued", "ZMQ messages waiting to be published, by notifier",
+             strprintf(R"(topic="%s",address="%s")", topic, address)},
+      // 1us to ~8s, doubling.
+      queue_time{"atcoin_zmq_queue_seconds", "Time ZMQ messages spent in the publish queue, by notifier",
+                 metrics::ExponentialBuckets(/*start=*/1, /*factor=*/2, /*count=*/24), /*scale=*/1e-6,
+                 strprintf(R"(topic="%s",address="%s")", topic, address)}
+{
+}
+
+ZMQPublisher::ZMQPublisher(size_t capacity)
+    : m_mask{std::bit_ceil(std::max<size_t>(capacity, 2)) - 1},
+      m_slots{std::make_unique<Slot[]>(m_mask + 1)}
+{
+    for (size_t i = 0; i <= m_mask; ++i) m_slots[i].seq.store(i, std::memory_order_relaxed);
+    m_thread = std::thread{[this] { Run(); }};
+}
+
+ZMQPublisher::~ZMQPublisher()
+{
+    {
+        LOCK(m_mutex);
+        m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+}
+
+bool ZMQPublisher::Ready() const
+{
+    return m_slots[m_dequeue_pos & m_mask].seq.load() == m_dequeue_pos + 1;
+}
+
+bool ZMQPublisher::Pop(ZMQMessage& message)
+{
+    if (!Ready()) return false;
+    Slot& slot{m_slots[m_dequeue_pos & m_mask]};
+    message = std::move(slot.message);
+    slot.seq.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+    ++m_dequeue_pos;
+    return true;
+}
+
+bool ZMQPublisher::Push(ZMQMessage&& message)
+{
+    size_t pos{m_enqueue_pos.load(std::memory_order_relaxed)};
+    Slot* slot;
+    while (true) {
+        slot = &m_slots[pos & m_mask];
+        const auto diff{static_cast<std::make_signed_t<size_t>>(slot->seq.load(std::memory_order_acquire) - pos)};
+        if (diff == 0) {
+            if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            // The slot still holds a message from the previous lap: full.
+            return false;
+        } else {
+            pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    slot->message = std::move(message);
+    slot->seq.store(pos + 1);
+
+    if (m_idle.load()) {
+        // Taking the mutex orders the wakeup after the publisher started waiting.
+        { LOCK(m_mutex); }
+        m_cv.notify_one();
+    }
+    return true;
+}
+
+void ZMQPublisher::Flush()
+{
+    const size_t target{m_enqueue_pos.load()};
+    WAIT_LOCK(m_mutex, lock);
+    m_flushed_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_published >= target; });
+}
+
+void ZMQPublisher::Run()
+{
+    util::ThreadRename("zmqpub");
+    std::vector<ZMQMessage> batch;
+    batch.reserve(MAX_BATCH);
+    ZMQMessage message;
+    while (true) {
+        while (batch.size() < MAX_BATCH && Pop(message)) {
+            batch.push_back(std::move(message));
+        }
+        if (!batch.empty()) {
+            // Send the messages of each socket together, keeping their order.
+            std::stable_sort(batch.begin(), batch.end(), [](const ZMQMessage& a, const ZMQMessage& b) {
+                return std::less<const void*>{}(a.notifier->Socket(), b.notifier->Socket());
+            });
+            for (const ZMQMessage& queued : batch) {
+                queued.notifier->Publish(queued);
+            }
+            batch.clear();
+            {
+                LOCK(m_mutex);
+                m_published = m_dequeue_pos;
+            }
+            m_flushed_cv.notify_all();
+            continue;
+        }
+
+        WAIT_LOCK(m_mutex, lock);
+        // Sequentially consistent, like the publishing store and the load of
+        // m_idle in Push(): either the producer sees the thread idle and wakes
+        // it, or the thread sees the new message.
+        m_idle.store(true);
+        m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_stop || Ready(); });
+        m_idle.store(false, std::memory_order_relaxed);
+        if (m_stop && !Ready()) break;
+    }
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2024-2025 The W-DEVELOP developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ZMQ_ZMQPUBLISHER_H
+#define BITCOIN_ZMQ_ZMQPUBLISHER_H
+
+#include <sync.h>
+#include <threadsafety.h>
+#include <util/metrics.h>
+#include <util/time.h>
+#include <zmq/zmqabstractnotifier.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+class CZMQAbstractPublishNotifier;
+
+/** Message counts of one publish notifier, exported as metrics labelled with its topic and address. */
+struct ZMQPublishStats {
+    metrics::Counter published;
+    //! Messages dropped because the publish queue was full.
+    metrics::Counter dropped;
+    //! Messages queued and not yet handed to libzmq.
+    metrics::Gauge queued;
+    //! Time from queueing a message to handing it to libzmq, in microseconds.
+    metrics::Histogram queue_time;
+    //! Largest value queued has had.
+    std::atomic<int64_t> max_queued{0};
+
+    ZMQPublishStats(const std::string& topic, const std::string& address);
+};
+
+/** A message waiting to be published. */
+struct ZMQMessage {
+    CZMQAbstractPublishNotifier* notifier{nullptr};
+    const char* command{nullptr};
+    ZMQSerialized data;
+    uint32_t sequence{0};
+    SteadyClock::time_point queued;
+};
+
+/**
+ * Publishes ZMQ messages on a dedicated thread, so that validation interface
+ * callbacks only queue them and never wait for libzmq.
+ *
+ * The queue is bounded and lock-free, with the same scheme as the asynchronous
+ * logger: queueing is one compare-and-swap and one store, and a message that
+ * doesn't fit is dropped rather than waited for. The thread takes the queued
+ * messages in batches and sends those of each socket together.
+ *
+ * Sockets of the notifiers are only used by this thread while it has messages
+ * of theirs; Flush() before closing one.
+ */
+class ZMQPublisher
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY{1 << 14};
+
+    explicit ZMQPublisher(size_t capacity = DEFAULT_CAPACITY);
+    //! Publishes the queued messages before returning.
+    ~ZMQPublisher();
+
+    ZMQPublisher(const ZMQPublisher&) = delete;
+    ZMQPublisher& operator=(const ZMQPublisher&) = delete;
+
+    //! Queue a message. Returns false, dropping it, if the queue is full.
+    bool Push(ZMQMessage&& message);
+    //! Wait until the messages queued before this call have been published.
+    void Flush() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Slot {
+        std::atomic<size_t> seq;
+        ZMQMessage message;
+    };
+
+    //! Messages taken from the queue at once.
+    static constexpr size_t MAX_BATCH{256};
+
+    const size_t m_mask;
+    const std::unique_ptr<Slot[]> m_slots;
+
+    alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+
+    alignas(64) size_t m_dequeue_pos{0}; //!< Only used by the publisher thread.
+    std::atomic<bool> m_idle{false};
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;         //!< Wakes the publisher thread.
+    std::condition_variable m_flushed_cv; //!< Signals progress of m_published.
+    bool m_stop GUARDED_BY(m_mutex){false};
+    size_t m_published GUARDED_BY(m_mutex){0};
+
+    std::thread m_thread;
+
+    bool Ready() const;
+    bool Pop(ZMQMessage& message);
+    void Run() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+#endif // BITCOIN_ZMQ_ZMQPUBLISHER_H
@@ -19,6 +19,7 @@
 #include <streams.h>
 #include <sync.h>
 #include <uint256.h>
+#include <util/time.h>
 #include <zmq/zmqutil.h>
 
 #include <zmq.h>
@@ -29,6 +30,7 @@
 #include <cstdint>
 #include <cstring>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
@@ -46,7 +48,7 @@ static const char *MSG_RAWBLOCK  = "rawblock";
 static const char *MSG_RAWTX     = "rawtx";
 static const char *MSG_SEQUENCE  = "sequence";
 
-// Internal function to send multipart message
+// Internal function to send multipart message without blocking
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
 {
     va_list args;
@@ -69,7 +71,7 @@ static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
 
         data = va_arg(args, const void*);
 
-        rc = zmq_msg_send(&msg, sock, data ? ZMQ_SNDMORE : 0);
+        rc = zmq_msg_send(&msg, sock, ZMQ_DONTWAIT | (data ? ZMQ_SNDMORE : 0));
         if (rc == -1)
         {
             zmqError("Unable to send ZMQ msg");
@@ -102,9 +104,11 @@ static bool IsZMQAddressIPV6(const std::string &zmq_address)
     return false;
 }
 
-bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
+bool CZMQAbstractPublishNotifier::Initialize(void *pcontext, ZMQPublisher& publisher)
 {
     assert(!psocket);
+    m_publisher = &publisher;
+    m_stats = std::make_unique<ZMQPublishStats>(type, address);
 
     // check if address is being used by other publish notifier
     std::multimap<std::string, CZMQAbstractPublishNotifier*>::iterator i = mapPublishNotifiers.find(address);
@@ -174,6 +178,9 @@ void CZMQAbstractPublishNotifier::Shutdown()
     // Early return if Initialize was not called
     if (!psocket) return;
 
+    // The publisher thread may still be sending queued messages on the socket.
+    m_publisher->Flush();
+
     int count = mapPublishNotifiers.count(address);
 
     // remove this notifier from the list of publishers using this address
@@ -202,24 +209,54 @@ void CZMQAbstractPublishNotifier::Shutdown()
 
 bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, const void* data, size_t size)
 {
-    assert(psocket);
+    const auto* bytes{static_cast<const uint8_t*>(data)};
+    return SendZmqMessage(command, std::make_shared<const std::vector<uint8_t>>(bytes, bytes + size));
+}
 
-    /* send three parts, command & data & a LE 4byte sequence number */
-    unsigned char msgseq[sizeof(uint32_t)];
-    WriteLE32(msgseq, nSequence);
-    int rc = zmq_send_multipart(psocket, command, strlen(command), data, size, msgseq, (size_t)sizeof(uint32_t), nullptr);
-    if (rc == -1)
-        return false;
+bool CZMQAbstractPublishNotifier::SendZmqMessage(const char *command, ZMQSerialized data)
+{
+    assert(psocket);
+    if (m_failed.load(std::memory_order_relaxed)) return false;
+
+    // Count the message before the publisher thread can take it.
+    m_stats->queued.Add(1);
+    if (m_publisher->Push({.notifier = this, .command = command, .data = std::move(data), .sequence = nSequence, .queued = SteadyClock::now()})) {
+        const int64_t queued{m_stats->queued.Get()};
+        if (queued > m_stats->max_queued.load(std::memory_order_relaxed)) {
+            m_stats->max_queued.store(queued, std::memory_order_relaxed);
+        }
+    } else {
+        m_stats->queued.Add(-1);
+        m_stats->dropped.Inc();
+    }
 
-    /* increment memory only sequence number after sending */
+    /* increment memory only sequence number after queueing */
     nSequence++;
 
     return true;
 }
 
-bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
+void CZMQAbstractPublishNotifier::Publish(const ZMQMessage& message)
 {
-    uint256 hash = pindex->GetBlockHash();
+    m_stats->queued.Add(-1);
+    if (m_failed.load(std::memory_order_relaxed)) return;
+
+    /* send three parts, command & data & a LE 4byte sequence number */
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(msgseq, message.sequence);
+    m_stats->queue_time.ObserveDuration(SteadyClock::now() - message.queued);
+    int rc = zmq_send_multipart(psocket, message.command, strlen(message.command), message.data->data(), message.data->size(), msgseq, (size_t)sizeof(uint32_t), nullptr);
+    if (rc == -1) {
+        // The notifier is removed the next time it is notified.
+        m_failed.store(true, std::memory_order_relaxed);
+        return;
+    }
+    m_stats->published.Inc();
+}
+
+bool CZMQPublishHashBlockNotifier::NotifyBlock(const ZMQBlock& block)
+{
+    uint256 hash = block.Index().GetBlockHash();
     LogDebug(BCLog::ZMQ, "Publish hashblock %s to %s\n", hash.GetHex(), this->address);
     uint8_t data[32];
     for (unsigned int i = 0; i < 32; i++) {
@@ -228,9 +265,9 @@ bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
     return SendZmqMessage(MSG_HASHBLOCK, data, 32);
 }
 
-bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
+bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const ZMQTransaction& transaction)
 {
-    uint256 hash = transaction.GetHash();
+    uint256 hash = transaction.Get().GetHash();
     LogDebug(BCLog::ZMQ, "Publish hashtx %s to %s\n", hash.GetHex(), this->address);
     uint8_t data[32];
     for (unsigned int i = 0; i < 32; i++) {
@@ -239,26 +276,24 @@ bool CZMQPublishHashTransactionNotifier::NotifyTransaction(const CTransaction &t
     return SendZmqMessage(MSG_HASHTX, data, 32);
 }
 
-bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
+bool CZMQPublishRawBlockNotifier::NotifyBlock(const ZMQBlock& block)
 {
-    LogDebug(BCLog::ZMQ, "Publish rawblock %s to %s\n", pindex->GetBlockHash().GetHex(), this->address);
+    LogDebug(BCLog::ZMQ, "Publish rawblock %s to %s\n", block.Index().GetBlockHash().GetHex(), this->address);
 
-    std::vector<uint8_t> block{};
-    if (!m_get_block_by_index(block, *pindex)) {
+    const ZMQSerialized& data{block.Serialized(m_get_block_by_index)};
+    if (!data) {
         zmqError("Can't read block from disk");
         return false;
     }
 
-    return SendZmqMessage(MSG_RAWBLOCK, block.data(), block.size());
+    return SendZmqMessage(MSG_RAWBLOCK, data);
 }
 
-bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
+bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const ZMQTransaction& transaction)
 {
-    uint256 hash = transaction.GetHash();
+    uint256 hash = transaction.Get().GetHash();
     LogDebug(BCLog::ZMQ, "Publish rawtx %s to %s\n", hash.GetHex(), this->address);
-    DataStream ss;
-    ss << TX_WITH_WITNESS(transaction);
-    return SendZmqMessage(MSG_RAWTX, &(*ss.begin()), ss.size());
+    return SendZmqMessage(MSG_RAWTX, transaction.Serialized());
 }
 
 // Helper function to send a 'sequence' topic message with the following structure:
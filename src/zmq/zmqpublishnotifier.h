@@ -6,10 +6,13 @@
 #define BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H
 
 #include <zmq/zmqabstractnotifier.h>
+#include <zmq/zmqpublisher.h>
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <vector>
 
 class CBlockIndex;
@@ -19,48 +22,61 @@ class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
 {
 private:
     uint32_t nSequence {0U}; //!< upcounting per message sequence number
+    ZMQPublisher* m_publisher{nullptr};
+    std::unique_ptr<ZMQPublishStats> m_stats;
+    //! Set by the publisher thread when sending fails, which disables the notifier.
+    std::atomic<bool> m_failed{false};
 
 public:
 
-    /* send zmq multipart message
+    /* queue zmq multipart message
        parts:
           * command
           * data
           * message sequence number
+       Messages dropped because the queue is full still use up a sequence
+       number, so subscribers can tell they were lost.
     */
     bool SendZmqMessage(const char *command, const void* data, size_t size);
+    bool SendZmqMessage(const char *command, ZMQSerialized data);
 
-    bool Initialize(void *pcontext) override;
+    //! Send a queued message. Only called by the publisher thread.
+    void Publish(const ZMQMessage& message);
+    const void* Socket() const { return psocket; }
+
+    bool Initialize(void *pcontext, ZMQPublisher& publisher) override;
     void Shutdown() override;
+    const ZMQPublishStats* GetStats() const override { return m_stats.get(); }
 };
 
 class CZMQPublishHashBlockNotifier : public CZMQAbstractPublishNotifier
 {
 public:
-    bool NotifyBlock(const CBlockIndex *pindex) override;
+    bool NotifyBlock(const ZMQBlock& block) override;
 };
 
 class CZMQPublishHashTransactionNotifier : public CZMQAbstractPublishNotifier
 {
 public:
-    bool NotifyTransaction(const CTransaction &transaction) override;
+    bool NotifyTransaction(const ZMQTransaction& transaction) override;
 };
 
 class CZMQPublishRawBlockNotifier : public CZMQAbstractPublishNotifier
 {
 private:
-    const std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)> m_get_block_by_index;
+    //! Used only when the block is no longer in memory.
+    const ZMQBlock::ReadBlockFn m_get_block_by_index;
 
 public:
-    CZMQPublishRawBlockNotifier(std::function<bool(std::vector<uint8_t>&, const CBlockIndex&)> get_block_by_index)
+    CZMQPublishRawBlockNotifier(ZMQBlock::ReadBlockFn get_block_by_index)
         : m_get_block_by_index{std::move(get_block_by_index)} {}
-    bool NotifyBlock(const CBlockIndex *pindex) override;
+    bool NotifyBlock(const ZMQBlock& block) override;
 };
 
 class CZMQPublishRawTransactionNotifier : public CZMQAbstractPublishNotifier
 {
 public:
-    bool NotifyTransaction(const CTransaction &transaction) override;
+    bool NotifyTransaction(const ZMQTransaction& transaction) override;
 };
 
 class CZMQPublishSequenceNotifier : public CZMQAbstractPublishNotifier
@@ -8,9 +8,11 @@
 #include <rpc/util.h>
 #include <zmq/zmqabstractnotifier.h>
 #include <zmq/zmqnotificationinterface.h>
+#include <zmq/zmqpublisher.h>
 
 #include <univalue.h>
 
+#include <algorithm>
 #include <list>
 #include <string>
 
@@ -31,6 +33,16 @@ static RPCHelpMan getzmqnotifications()
                             {RPCResult::Type::STR, "type", "Type of notification"},
                             {RPCResult::Type::STR, "address", "Address of the publisher"},
                             {RPCResult::Type::NUM, "hwm", "Outbound message high water mark"},
+                            {RPCResult::Type::NUM, "published", "Messages handed to libzmq, which may still drop them for subscribers at the high water mark"},
+                            {RPCResult::Type::NUM, "dropped", "Messages dropped because the publish queue was full"},
+                            {RPCResult::Type::NUM, "queued", "Messages waiting to be published"},
+                            {RPCResult::Type::NUM, "max_queued", "Most messages that have been waiting at once"},
+                            {RPCResult::Type::OBJ, "queue_time", "Time messages spent waiting to be published, as bucket upper bounds",
+                            {
+                                {RPCResult::Type::NUM, "p50_us", "Median, in microseconds"},
+                                {RPCResult::Type::NUM, "p90_us", "90th percentile, in microseconds"},
+                                {RPCResult::Type::NUM, "p99_us", "99th percentile, in microseconds"},
+                            }},
                         }},
                     }
                 },
@@ -47,6 +59,21 @@ static RPCHelpMan getzmqnotifications()
             obj.pushKV("type", n->GetType());
             obj.pushKV("address", n->GetAddress());
             obj.pushKV("hwm", n->GetOutboundMessageHighWaterMark());
+            if (const ZMQPublishStats* stats{n->GetStats()}) {
+                const auto quantile{[&](double q) {
+                    // Report the +Inf bucket as the largest bound.
+                    return std::min(stats->queue_time.Quantile(q), stats->queue_time.Bounds().back());
+                }};
+                obj.pushKV("published", stats->published.Get());
+                obj.pushKV("dropped", stats->dropped.Get());
+                obj.pushKV("queued", std::max<int64_t>(0, stats->queued.Get()));
+                obj.pushKV("max_queued", stats->max_queued.load(std::memory_order_relaxed));
+                UniValue queue_time{UniValue::VOBJ};
+                queue_time.pushKV("p50_us", quantile(0.5));
+                queue_time.pushKV("p90_us", quantile(0.9));
+                queue_time.pushKV("p99_us", quantile(0.99));
+                obj.pushKV("queue_time", std::move(queue_time));
+            }
             result.push_back(std::move(obj));
         }
     }
@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024-2025 The W-DEVELOP developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+""" Tests the rpc:* and http:* tracepoint API interface.
+    See doc/tracing.md#context-rpc and doc/tracing.md#context-http
+"""
+
+import ctypes
+
+# Test will be skipped if we don't have bcc installed
+try:
+    from bcc import BPF, USDT # type: ignore[import]
+except ImportError:
+    pass
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+
+MAX_METHOD_LENGTH = 32
+MAX_URI_LENGTH = 64
+
+rpc_tracepoints_program = """
+#include <uapi/linux/ptrace.h>
+
+#define MAX_METHOD_LENGTH    """ + str(MAX_METHOD_LENGTH) + """
+#define MAX_URI_LENGTH       """ + str(MAX_URI_LENGTH) + """
+
+struct command_done
+{
+    char    method[MAX_METHOD_LENGTH];
+    s64     duration;
+    bool    success;
+};
+
+struct request_completed
+{
+    char    method[MAX_METHOD_LENGTH];
+    char    uri[MAX_URI_LENGTH];
+    s32     status;
+    u64     size;
+    s64     duration;
+};
+
+BPF_PERF_OUTPUT(command_done_events);
+BPF_PERF_OUTPUT(request_completed_events);
+
+int trace_command_done(struct pt_regs *ctx) {
+    struct command_done done = {};
+    void *pmethod = NULL;
+    bpf_usdt_readarg(1, ctx, &pmethod);
+    bpf_probe_read_user_str(&done.method, sizeof(done.method), pmethod);
+    bpf_usdt_readarg(2, ctx, &done.duration);
+    bpf_usdt_readarg(3, ctx, &done.success);
+    command_done_events.perf_submit(ctx, &done, sizeof(done));
+    return 0;
+}
+
+int trace_request_completed(struct pt_regs *ctx) {
+    struct request_completed req = {};
+    void *pmethod = NULL, *puri = NULL;
+    bpf_usdt_readarg(1, ctx, &pmethod);
+    bpf_probe_read_user_str(&req.method, sizeof(req.method), pmethod);
+    bpf_usdt_readarg(2, ctx, &puri);
+    bpf_probe_read_user_str(&req.uri, sizeof(req.uri), puri);
+    bpf_usdt_readarg(3, ctx, &req.status);
+    bpf_usdt_readarg(4, ctx, &req.size);
+    bpf_usdt_readarg(5, ctx, &req.duration);
+    request_completed_events.perf_submit(ctx, &req, sizeof(req));
+    return 0;
+}
+"""
+
+
+class CommandDone(ctypes.Structure):
+    _fields_ = [
+        ("method", ctypes.c_char * MAX_METHOD_LENGTH),
+        ("duration", ctypes.c_int64),
+        ("success", ctypes.c_bool),
+    ]
+
+
+class RequestCompleted(ctypes.Structure):
+    _fields_ = [
+        ("method", ctypes.c_char * MAX_METHOD_LENGTH),
+        ("uri", ctypes.c_char * MAX_URI_LENGTH),
+        ("status", ctypes.c_int32),
+        ("size", ctypes.c_uint64),
+        ("duration", ctypes.c_int64),
+    ]
+
+
+class RPCTracepointTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def skip_test_if_missing_module(self):
+        self.skip_if_platform_not_linux()
+        self.skip_if_no_bitcoind_tracepoints()
+        self.skip_if_no_python_bcc()
+        self.skip_if_no_bpf_permissions()
+
+    def run_test(self):
+        node = self.nodes[0]
+        commands = []
+        requests = []
+
+        self.log.info("hook into the rpc:command_done and http:request_completed tracepoints")
+        ctx = USDT(pid=node.process.pid)
+        ctx.enable_probe(probe="rpc:command_done", fn_name="trace_command_done")
+        ctx.enable_probe(probe="http:request_completed", fn_name="trace_request_completed")
+        bpf = BPF(text=rpc_tracepoints_program, usdt_contexts=[ctx], debug=0, cflags=["-Wno-error=implicit-function-declaration"])
+
+        def handle_command_done(_, data, __):
+            commands.append(ctypes.cast(data, ctypes.POINTER(CommandDone)).contents)
+
+        def handle_request_completed(_, data, __):
+            requests.append(ctypes.cast(data, ctypes.POINTER(RequestCompleted)).contents)
+
+        bpf["command_done_events"].open_perf_buffer(handle_command_done)
+        bpf["request_completed_events"].open_perf_buffer(handle_request_completed)
+
+        self.log.info("call a succeeding and a failing RPC")
+        node.getblockcount()
+        assert_raises_rpc_error(-8, "Block height out of range", node.getblockhash, 1000)
+        bpf.perf_buffer_poll(timeout=200)
+
+        self.log.info("check the traced commands")
+        traced = [c for c in commands if c.method.decode() in ("getblockcount", "getblockhash")]
+        assert_equal([(c.method.decode(), c.success) for c in traced], [("getblockcount", True), ("getblockhash", False)])
+        assert all(c.duration >= 0 for c in traced)
+
+        self.log.info("check the traced HTTP requests")
+        assert len(requests) >= 2
+        for request in requests:
+            assert_equal(request.method.decode(), "POST")
+            # JSON-RPC 2.0 errors are replied to with status 200 as well.
+            assert_equal(request.status, 200)
+            assert request.size > 0
+            assert request.duration >= 0
+
+        bpf.cleanup()
+
+
+if __name__ == '__main__':
+    RPCTracepointTest(__file__).main()
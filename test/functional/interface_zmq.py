@@ -252,12 +252,17 @@ class ZMQTest (BitcoinTestFramework):
 
 
         self.log.info("Test the getzmqnotifications RPC")
-        assert_equal(self.nodes[0].getzmqnotifications(), [
+        notifications = self.nodes[0].getzmqnotifications()
+        assert_equal([{key: n[key] for key in ("type", "address", "hwm")} for n in notifications], [
             {"type": "pubhashblock", "address": address, "hwm": 1000},
             {"type": "pubhashtx", "address": address, "hwm": 1000},
             {"type": "pubrawblock", "address": address, "hwm": 1000},
             {"type": "pubrawtx", "address": address, "hwm": 1000},
         ])
+        for n in notifications:
+            assert n["published"] > 0
+            assert_equal(n["dropped"], 0)
+            assert_equal(sorted(n["queue_time"]), ["p50_us", "p90_us", "p99_us"])
 
         assert_equal(self.nodes[1].getzmqnotifications(), [])
         if unix:
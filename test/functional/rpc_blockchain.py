@@ -79,6 +79,7 @@ class BlockchainTest(BitcoinTestFramework):
         self.wallet = MiniWallet(self.nodes[0])
         self._test_prune_disk_space()
         self.mine_chain()
+        self._test_getvalidationstats()
         self._test_max_future_block_time()
         self.restart_node(
             0,
@@ -288,6 +289,30 @@ class BlockchainTest(BitcoinTestFramework):
         last = self.generate(self.nodes[0], 6)[-1]
         assert_equal(self.nodes[0].getblockheader(last)["mediantime"], time_2106)
 
+    def _test_getvalidationstats(self):
+        self.log.info("Test getvalidationstats")
+        node = self.nodes[0]
+        res = node.getvalidationstats()
+        stages = ["header_check", "read", "check", "forks", "utxo_fetch", "script_check", "undo_write",
+                  "index", "flush", "chainstate_write", "postprocess", "notify", "total"]
+        assert_equal(sorted(res["stages"].keys()), sorted(stages))
+        total = res["stages"]["total"]
+        assert_greater_than_or_equal(total["count"], HEIGHT)
+        assert total["p50"] <= total["p90"] <= total["p99"]
+
+        # Newest first, and without the header check
+        assert_equal(len(res["blocks"]), 10)
+        tip = node.getblockheader(node.getbestblockhash())
+        assert_equal(res["blocks"][0]["hash"], tip["hash"])
+        assert_equal(res["blocks"][0]["height"], tip["height"])
+        assert_equal(res["blocks"][1]["height"], tip["height"] - 1)
+        assert_equal(res["blocks"][0]["txs"], tip["nTx"])
+        assert_equal(sorted(res["blocks"][0]["stages"].keys()), sorted(stages[1:]))
+
+        assert_equal(len(node.getvalidationstats(3)["blocks"]), 3)
+        assert_equal(node.getvalidationstats(0)["blocks"], [])
+        assert_raises_rpc_error(-8, "nblocks must not be negative", node.getvalidationstats, -1)
+
     def _test_getchaintxstats(self):
         self.log.info("Test getchaintxstats")
 
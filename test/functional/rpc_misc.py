@@ -20,6 +20,7 @@ class RpcMiscTest(BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 1
         self.supports_cli = False
+        self.extra_args = [["-lockprofile=1", "-schedulerthreads=3"]]
 
     def run_test(self):
         node = self.nodes[0]
@@ -54,6 +55,48 @@ class RpcMiscTest(BitcoinTestFramework):
 
         assert_raises_rpc_error(-8, "unknown mode foobar", node.getmemoryinfo, mode="foobar")
 
+        self.log.info("test getmemoryusage")
+        usage = node.getmemoryusage()
+        components = ['block_index', 'coins_cache', 'mempool', 'orphanage', 'compact_blocks', 'addrman',
+                      'signature_cache', 'script_execution_cache', 'wallets']
+        assert_equal(usage['total'], sum(usage[c] for c in components) + sum(usage['leveldb'].values()))
+        for component in ('block_index', 'coins_cache', 'addrman', 'signature_cache', 'script_execution_cache'):
+            assert_greater_than(usage[component], 0)
+        assert_greater_than_or_equal(usage['mempool'], usage['mempool_index'])
+        assert_equal(sorted(usage['leveldb']), ['block_tree', 'chainstate'])
+        assert_greater_than(usage['leveldb']['block_tree'], 0)
+
+        self.log.info("test getlockprofile")
+        profile = node.getlockprofile(count=1000)
+        assert_equal(profile['sample_rate'], 1)
+        assert any('cs_main' in site['lock'] for site in profile['sites'])
+        for site in profile['sites']:
+            assert_greater_than(site['samples'], 0)
+            assert_greater_than_or_equal(site['samples'], site['contended'])
+            for durations in (site['wait'], site['hold']):
+                assert_greater_than_or_equal(durations['total_us'], durations['max_us'])
+                assert_greater_than_or_equal(durations['max_us'], durations['p99_us'])
+                assert_greater_than_or_equal(durations['p99_us'], durations['p50_us'])
+        waits = [site['wait']['total_us'] for site in profile['sites']]
+        assert_equal(waits, sorted(waits, reverse=True))
+        assert_equal(len(node.getlockprofile(count=1)['sites']), 1)
+        node.getlockprofile(count=0, reset=True)
+        assert_greater_than(len(profile['sites']), len(node.getlockprofile(1000)['sites']))
+        assert_raises_rpc_error(-8, "count must be non-negative", node.getlockprofile, -1)
+
+        self.log.info("test getschedulerinfo")
+        self.generate(node, 1)
+        info = node.getschedulerinfo()
+        assert_equal(info['threads'], 3)
+        # The periodic tasks, such as the peers.dat dump, are waiting to run.
+        assert_greater_than(info['queued'], 0)
+        # Validation notifications of the new block ran as scheduler tasks.
+        assert_greater_than(info['tasks']['parallel_task_runner']['runs'], 0)
+        for stats in info['tasks'].values():
+            assert_greater_than(stats['runs'], 0)
+            assert_greater_than_or_equal(stats['total_us'], stats['max_us'])
+            assert_greater_than_or_equal(stats['max_us'], stats['last_us'])
+
         self.log.info("test logging rpc and help")
 
         # Test toggling a logging category on/off/on with the logging RPC.
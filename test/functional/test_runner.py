@@ -223,6 +223,7 @@ BASE_SCRIPTS = [
     'interface_usdt_coinselection.py',
     'interface_usdt_mempool.py',
     'interface_usdt_net.py',
+    'interface_usdt_rpc.py',
     'interface_usdt_utxocache.py',
     'interface_usdt_validation.py',
     'rpc_users.py',
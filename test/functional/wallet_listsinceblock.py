@@ -50,6 +50,7 @@ class ListSinceBlockTest(BitcoinTestFramework):
         self.test_send_to_self()
         self.test_op_return()
         self.test_label()
+        self.test_cursor()
 
     def test_no_blockhash(self):
         self.log.info("Test no blockhash")
@@ -503,6 +504,28 @@ class ListSinceBlockTest(BitcoinTestFramework):
             if label == "new_addr":
                 assert_equal(new_addr_transactions[0]["address"], new_addr)
 
+    def test_cursor(self):
+        self.log.info("Test paging through listsinceblock with a cursor")
+        node = self.nodes[0]
+        # Leave one transaction unconfirmed so that the last page holds mempool transactions
+        node.sendtoaddress(node.getnewaddress(), 0.1)
+        everything = node.listsinceblock()
+
+        paged = []
+        page = node.listsinceblock(count=2)
+        while True:
+            paged += page["transactions"]
+            assert_equal(page["lastblock"], everything["lastblock"])
+            if "next_cursor" not in page:
+                break
+            assert len(page["transactions"]) >= 2
+            page = node.listsinceblock(count=2, cursor=page["next_cursor"])
+            assert "removed" not in page
+        assert_equal(paged, everything["transactions"])
+
+        assert_raises_rpc_error(-8, "Invalid cursor", node.listsinceblock, cursor="1")
+        assert_raises_rpc_error(-8, "count must be positive", node.listsinceblock, count=0)
+
 
 if __name__ == '__main__':
     ListSinceBlockTest(__file__).main()
@@ -114,6 +114,7 @@ class ListTransactionsTest(BitcoinTestFramework):
         self.run_coinjoin_test()
         self.run_invalid_parameters_test()
         self.test_op_return()
+        self.test_cursor()
 
     def run_rbf_opt_in_test(self):
         """Test the opt-in-rbf flag for sent and received transactions."""
@@ -316,6 +317,10 @@ class ListTransactionsTest(BitcoinTestFramework):
         self.nodes[0].listtransactions(label="*")
         assert_raises_rpc_error(-8, "Negative count", self.nodes[0].listtransactions, count=-1)
         assert_raises_rpc_error(-8, "Negative from", self.nodes[0].listtransactions, skip=-1)
+        assert_raises_rpc_error(-8, "skip cannot be combined with cursor", self.nodes[0].listtransactions, skip=1, cursor="")
+        assert_raises_rpc_error(-8, "Invalid cursor", self.nodes[0].listtransactions, cursor="abc")
+        assert_raises_rpc_error(-8, "count must be positive", self.nodes[0].listtransactions, count=0, cursor="")
+        assert_raises_rpc_error(-8, "count must be positive", self.nodes[0].listtransactions, count=0, cursor="1")
 
     def test_op_return(self):
         """Test if OP_RETURN outputs will be displayed correctly."""
@@ -328,6 +333,26 @@ class ListTransactionsTest(BitcoinTestFramework):
 
         assert 'address' not in op_ret_tx
 
+    def test_cursor(self):
+        self.log.info("Test paging through listtransactions with a cursor")
+        node = self.nodes[0]
+        everything = node.listtransactions(count=1000)
+        paged = []
+        page = node.listtransactions(count=3, cursor="")
+        first_cursor = page["next_cursor"]
+        while True:
+            assert len(page["transactions"]) >= 3 or "next_cursor" not in page
+            paged = page["transactions"] + paged
+            if "next_cursor" not in page:
+                break
+            page = node.listtransactions(count=3, cursor=page["next_cursor"])
+        assert_equal(paged, everything)
+
+        self.log.info("Test that cursors are stable when new transactions arrive")
+        second_page = node.listtransactions(count=3, cursor=first_cursor)
+        node.sendtoaddress(node.getnewaddress(), 0.1)
+        assert_equal(node.listtransactions(count=3, cursor=first_cursor), second_page)
+
 
 if __name__ == '__main__':
     ListTransactionsTest(__file__).main()